@@ -0,0 +1,149 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "helper/bytetrack_reference.hpp"
+#include "modules/bytetrack/BYTETracker.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct Detection {
+    int label;
+    float prob;
+    float x, y, width, height;
+};
+
+struct TrackRecord {
+    int track_id;
+    int target_id;
+    float tlwh[4];
+
+    bool operator==(const TrackRecord &other) const {
+        return track_id == other.track_id && target_id == other.target_id && tlwh[0] == other.tlwh[0]
+            && tlwh[1] == other.tlwh[1] && tlwh[2] == other.tlwh[2] && tlwh[3] == other.tlwh[3];
+    }
+};
+
+using Sequence = std::vector<std::vector<Detection>>;
+using Records = std::vector<std::vector<TrackRecord>>;
+
+/**
+ * @brief 匀速运动的目标，带检测抖动、漏检、低分检测和目标进出画面
+ */
+static Sequence make_sequence(const int targets, const int frames) {
+    std::mt19937 rng(targets);
+    std::uniform_real_distribution<float> uniform(0, 1);
+    std::normal_distribution<float> jitter(0, 1.5);
+
+    const float width = 3840, height = 2160;
+    struct Target {
+        float x, y, w, h, vx, vy;
+        int life;
+    };
+    auto spawn = [&]() {
+        float w = 20 + uniform(rng) * 60;
+        float x = uniform(rng) * (width - w), y = uniform(rng) * (height - w * 2);
+        float vx = (uniform(rng) - 0.5f) * 8, vy = (uniform(rng) - 0.5f) * 8;
+        return Target{x, y, w, w * 2, vx, vy, (int)(50 + uniform(rng) * 200)};
+    };
+
+    std::vector<Target> objects;
+    for (int i = 0; i < targets; i++) { objects.push_back(spawn()); }
+
+    Sequence sequence(frames);
+    for (auto &detections : sequence) {
+        for (auto &object : objects) {
+            object.x += object.vx;
+            object.y += object.vy;
+            if (--object.life < 0 || object.x < 0 || object.y < 0 || object.x + object.w > width
+                || object.y + object.h > height) {
+                object = spawn();
+            }
+
+            float chance = uniform(rng);
+            if (chance < 0.05f) { continue; }// 漏检
+            float prob = chance < 0.15f ? 0.2f + uniform(rng) * 0.3f : 0.6f + uniform(rng) * 0.4f;
+            float x = object.x + jitter(rng), y = object.y + jitter(rng);
+            detections.push_back({0, prob, x, y, object.w + jitter(rng), object.h + jitter(rng)});
+        }
+        std::shuffle(detections.begin(), detections.end(), rng);
+    }
+    return sequence;
+}
+
+/**
+ * @brief 在新线程中运行，两个实现的 track_id 计数器都从 1 开始
+ */
+template<class Func>
+static double run_in_thread(Func &&func) {
+    double time_used = 0;
+    std::thread([&]() {
+        auto time_start = std::chrono::high_resolution_clock::now();
+        func();
+        time_used = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+    }).join();
+    return time_used;
+}
+
+static void bench(const int targets, const int frames) {
+    auto sequence = make_sequence(targets, frames);
+
+    Records reference_records(frames);
+    double reference_time = run_in_thread([&]() {
+        reference::BYTETracker tracker;
+        std::vector<reference::Object> objects;
+        for (int i = 0; i < frames; i++) {
+            objects.clear();
+            for (const auto &det : sequence[i]) {
+                objects.push_back({i, det.label, det.prob, {det.x, det.y, det.width, det.height}});
+            }
+            for (const auto &track : tracker.update(objects)) {
+                reference_records[i].push_back(
+                    {track.track_id, track.target_id, {track.tlwh[0], track.tlwh[1], track.tlwh[2], track.tlwh[3]}});
+            }
+        }
+    });
+
+    Records records(frames);
+    double time = run_in_thread([&]() {
+        BYTETracker tracker;
+        std::vector<Object> objects;
+        for (int i = 0; i < frames; i++) {
+            objects.clear();
+            for (const auto &det : sequence[i]) {
+                objects.push_back({i, det.label, det.prob, {det.x, det.y, det.width, det.height}});
+            }
+            for (const auto *track : tracker.update(objects)) {
+                const float *tlwh = track->tlwh;
+                records[i].push_back({track->track_id, track->target_id, {tlwh[0], tlwh[1], tlwh[2], tlwh[3]}});
+            }
+        }
+    });
+
+    int mismatch = -1;
+    for (int i = 0; i < frames && mismatch < 0; i++) {
+        if (records[i] != reference_records[i]) { mismatch = i; }
+    }
+
+    std::cout << std::setw(8) << targets << std::fixed << std::setprecision(1) << std::setw(12)
+              << frames / reference_time << std::setw(12) << frames / time << std::setw(10) << reference_time / time
+              << "x" << std::setw(10) << reference_records.back().size() << "  "
+              << (mismatch < 0 ? "identical" : "MISMATCH at frame " + std::to_string(mismatch)) << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 300;
+    std::vector<int> targets{100, 500, 1000, 2000};
+    if (argc > 2) { targets.assign(1, std::atoi(argv[2])); }
+
+    std::cout << "# " << frames << " frames per sequence" << std::endl;
+    std::cout << std::setw(8) << "targets" << std::setw(12) << "ref fps" << std::setw(12) << "new fps" << std::setw(11)
+              << "speedup" << std::setw(10) << "tracks" << "  ids" << std::endl;
+    for (auto count : targets) { bench(count, frames); }
+    return 0;
+}
@@ -0,0 +1,275 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "modules/codec/av_object_pool.hpp"
+#include "modules/codec/decode_video_v3.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <errno.h>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// 统计全部堆分配次数，替换 glibc 的 malloc 系列函数，FFmpeg 的 av_malloc 也经过这里
+static std::atomic_int64_t g_alloc_count{0};
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) { return memalign(alignment, size); }
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+    *ptr = memalign(alignment, size);
+    return *ptr ? 0 : ENOMEM;
+}
+
+void free(void *ptr) { __libc_free(ptr); }
+}
+
+using namespace av_wrapper;
+using Packets = std::vector<std::shared_ptr<AVPacket>>;
+
+/**
+ * @brief 用软件编码器生成测试码流: 移动的渐变和色块，每 gop_size 帧一个关键帧
+ */
+static Packets make_synthetic_h264(int width, int height, int frames, int gop_size) {
+    auto encoder = avcodec_find_encoder_by_name("libx264");
+    if (!encoder) { encoder = avcodec_find_encoder(AV_CODEC_ID_H264); }
+    if (!encoder) { return {}; }
+
+    auto codec_ctx = std::shared_ptr<AVCodecContext>(avcodec_alloc_context3(encoder),
+                                                     [](AVCodecContext *ptr) { avcodec_free_context(&ptr); });
+    codec_ctx->width = width;
+    codec_ctx->height = height;
+    codec_ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    codec_ctx->time_base = {1, 25};
+    codec_ctx->framerate = {25, 1};
+    codec_ctx->gop_size = gop_size;
+    codec_ctx->max_b_frames = 2;
+    codec_ctx->bit_rate = 500000;
+    if (avcodec_open2(codec_ctx.get(), encoder, nullptr) < 0) { return {}; }
+
+    auto frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = width;
+    frame->height = height;
+    av_frame_get_buffer(frame.get(), 32);
+
+    Packets packets;
+    auto receive = [&]() {
+        while (true) {
+            auto packet = std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *ptr) { av_packet_free(&ptr); });
+            if (avcodec_receive_packet(codec_ctx.get(), packet.get()) < 0) { break; }
+            packets.push_back(packet);
+        }
+    };
+
+    for (int i = 0; i <= frames; i++) {
+        if (i == frames) {
+            avcodec_send_frame(codec_ctx.get(), nullptr);
+            receive();
+            break;
+        }
+
+        av_frame_make_writable(frame.get());
+        for (int plane = 0; plane < 3; plane++) {
+            int rows = plane == 0 ? height : height / 2;
+            int cols = plane == 0 ? width : width / 2;
+            for (int y = 0; y < rows; y++) {
+                auto line = frame->data[plane] + y * frame->linesize[plane];
+                for (int x = 0; x < cols; x++) { line[x] = (x + y + i * (plane + 1) * 3) & 0xff; }
+            }
+        }
+        frame->pts = i;
+        avcodec_send_frame(codec_ctx.get(), frame.get());
+        receive();
+    }
+    return packets;
+}
+
+static std::shared_ptr<AVCodecContext> open_decoder() {
+    auto decoder = avcodec_find_decoder(AV_CODEC_ID_H264);
+    auto codec_ctx = std::shared_ptr<AVCodecContext>(avcodec_alloc_context3(decoder),
+                                                     [](AVCodecContext *ptr) { avcodec_free_context(&ptr); });
+    codec_ctx->thread_count = 1;
+    avcodec_open2(codec_ctx.get(), decoder, nullptr);
+    return codec_ctx;
+}
+
+/**
+ * @brief 原实现: 解封装每次读取新分配 AVPacket，解码每次接收新分配 AVFrame
+ */
+static int64_t decode_legacy(AVCodecContext *codec_ctx, const Packets &packets) {
+    int64_t frames = 0;
+    for (const auto &source : packets) {
+        auto packet = std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *ptr) { av_packet_free(&ptr); });
+        av_packet_ref(packet.get(), source.get());
+        avcodec_send_packet(codec_ctx, packet.get());
+        while (true) {
+            auto avframe = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+            if (avcodec_receive_frame(codec_ctx, avframe.get()) < 0) { break; }
+            ++frames;
+        }
+    }
+    return frames;
+}
+
+/**
+ * @brief 与 Demuxer_v3 / Decoder_v3 相同，包和帧都从每路流的池中取
+ */
+static int64_t decode_pooled(AVCodecContext *codec_ctx, const Packets &packets, PacketPool &packet_pool,
+                             FramePool &frame_pool) {
+    int64_t frames = 0;
+    for (const auto &source : packets) {
+        auto packet = packet_pool.acquire();
+        av_packet_ref(packet.get(), source.get());
+        avcodec_send_packet(codec_ctx, packet.get());
+        while (true) {
+            auto avframe = frame_pool.acquire();
+            if (avcodec_receive_frame(codec_ctx, avframe.get()) < 0) { break; }
+            ++frames;
+        }
+    }
+    return frames;
+}
+
+/**
+ * @brief 完整的 Decoder_v3 路径，包含码流过滤和跳帧处理
+ */
+static int64_t decode_wrapper(Decoder_v3 &decoder, const Packets &packets, PacketPool &packet_pool) {
+    for (const auto &source : packets) {
+        auto packet = packet_pool.acquire();
+        av_packet_ref(packet.get(), source.get());
+        decoder.decode_packet(packet);
+    }
+    return 0;
+}
+
+enum class Mode { kLegacy, kPooled, kDecoderV3 };
+
+static void bench_decode(const char *title, Mode mode, const Packets &packets, int streams, int loops,
+                         int threads) {
+    auto codecpar = std::shared_ptr<AVCodecParameters>(avcodec_parameters_alloc(),
+                                                       [](AVCodecParameters *ptr) { avcodec_parameters_free(&ptr); });
+    codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+    codecpar->codec_id = AV_CODEC_ID_H264;
+
+    // 每路流独立的解码器和对象池，按线程平均分配
+    struct Stream {
+        std::shared_ptr<AVCodecContext> codec_ctx;
+        std::unique_ptr<Decoder_v3> decoder;
+        PacketPool packet_pool;
+        FramePool frame_pool;
+        std::atomic_int64_t frames{0};
+    };
+    std::vector<std::unique_ptr<Stream>> stream_list;
+    for (int i = 0; i < streams; i++) {
+        auto stream = std::make_unique<Stream>();
+        if (mode == Mode::kDecoderV3) {
+            stream->decoder = std::make_unique<Decoder_v3>();
+            auto counter = &stream->frames;
+            stream->decoder->register_deocde_callback([counter](const int64_t, const std::shared_ptr<AVFrame> &) {
+                counter->fetch_add(1, std::memory_order_relaxed);
+                return true;
+            });
+            stream->decoder->open_decoder(codecpar);
+        } else {
+            stream->codec_ctx = open_decoder();
+        }
+        stream_list.push_back(std::move(stream));
+    }
+
+    auto run = [&](int loop_count) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                for (int loop = 0; loop < loop_count; loop++) {
+                    for (int i = t; i < streams; i += threads) {
+                        auto &stream = *stream_list[i];
+                        switch (mode) {
+                            case Mode::kLegacy:
+                                stream.frames += decode_legacy(stream.codec_ctx.get(), packets);
+                                break;
+                            case Mode::kPooled:
+                                stream.frames += decode_pooled(stream.codec_ctx.get(), packets, stream.packet_pool,
+                                                               stream.frame_pool);
+                                break;
+                            case Mode::kDecoderV3: decode_wrapper(*stream.decoder, packets, stream.packet_pool); break;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto &worker : workers) { worker.join(); }
+    };
+
+    // 预热，填满解码器内部缓冲池和对象池
+    run(1);
+
+    int64_t frames_start = 0;
+    for (auto &stream : stream_list) { frames_start += stream->frames; }
+    auto alloc_count_start = g_alloc_count.load();
+    auto time_start = std::chrono::steady_clock::now();
+    run(loops);
+    auto time_used = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+    auto alloc_count = g_alloc_count.load() - alloc_count_start;
+
+    int64_t frames = -frames_start;
+    for (auto &stream : stream_list) { frames += stream->frames; }
+
+    // ns/frame 为单线程解码一帧的耗时
+    std::cout << std::setw(12) << std::left << title << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << frames / time_used << " frames/s" << std::setw(10)
+              << time_used * threads * 1e9 / frames << " ns/frame" << std::setw(12) << alloc_count / time_used
+              << " allocs/s" << std::setw(8) << std::setprecision(2) << (double)alloc_count / frames
+              << " allocs/frame" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int streams = argc > 1 ? std::atoi(argv[1]) : 64;
+    int loops = argc > 2 ? std::atoi(argv[2]) : 4;
+    int threads = std::max(1, std::min<int>(streams, std::thread::hardware_concurrency()));
+    const int width = 352, height = 288, frame_count = 250, gop_size = 25;
+
+    av_log_set_level(AV_LOG_ERROR);
+    auto packets = make_synthetic_h264(width, height, frame_count, gop_size);
+    if (packets.empty()) {
+        std::cerr << "No H.264 encoder available to generate the test stream" << std::endl;
+        return 1;
+    }
+
+    std::cout << "# " << streams << " streams, " << threads << " threads, H.264 " << width << "x" << height << ", "
+              << packets.size() << " packets x " << loops << " loops, software decode" << std::endl;
+    bench_decode("legacy", Mode::kLegacy, packets, streams, loops, threads);
+    bench_decode("pooled", Mode::kPooled, packets, streams, loops, threads);
+    bench_decode("Decoder_v3", Mode::kDecoderV3, packets, streams, loops, threads);
+    return 0;
+}
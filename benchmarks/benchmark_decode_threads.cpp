@@ -0,0 +1,146 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "modules/codec/decode_video_v3.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace av_wrapper;
+using Packets = std::vector<std::shared_ptr<AVPacket>>;
+
+/**
+ * @brief 用软件编码器生成测试码流: 移动的渐变，每 gop_size 帧一个关键帧
+ */
+static Packets make_synthetic_h264(int width, int height, int frames, int gop_size) {
+    auto encoder = avcodec_find_encoder_by_name("libx264");
+    if (!encoder) { encoder = avcodec_find_encoder(AV_CODEC_ID_H264); }
+    if (!encoder) { return {}; }
+
+    auto codec_ctx = std::shared_ptr<AVCodecContext>(avcodec_alloc_context3(encoder),
+                                                     [](AVCodecContext *ptr) { avcodec_free_context(&ptr); });
+    codec_ctx->width = width;
+    codec_ctx->height = height;
+    codec_ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    codec_ctx->time_base = {1, 25};
+    codec_ctx->framerate = {25, 1};
+    codec_ctx->gop_size = gop_size;
+    codec_ctx->max_b_frames = 2;
+    codec_ctx->bit_rate = (int64_t)width * height * 2;
+    if (avcodec_open2(codec_ctx.get(), encoder, nullptr) < 0) { return {}; }
+
+    auto frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = width;
+    frame->height = height;
+    av_frame_get_buffer(frame.get(), 32);
+
+    Packets packets;
+    auto receive = [&]() {
+        while (true) {
+            auto packet = std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *ptr) { av_packet_free(&ptr); });
+            if (avcodec_receive_packet(codec_ctx.get(), packet.get()) < 0) { break; }
+            packets.push_back(packet);
+        }
+    };
+
+    for (int i = 0; i < frames; i++) {
+        av_frame_make_writable(frame.get());
+        for (int plane = 0; plane < 3; plane++) {
+            int rows = plane == 0 ? height : height / 2;
+            int cols = plane == 0 ? width : width / 2;
+            for (int y = 0; y < rows; y++) {
+                auto line = frame->data[plane] + y * frame->linesize[plane];
+                for (int x = 0; x < cols; x++) { line[x] = (x + y + i * (plane + 1) * 3) & 0xff; }
+            }
+        }
+        frame->pts = i;
+        avcodec_send_frame(codec_ctx.get(), frame.get());
+        receive();
+    }
+    avcodec_send_frame(codec_ctx.get(), nullptr);
+    receive();
+    return packets;
+}
+
+/**
+ * @brief streams 路流各由一个线程送包，统计所有流合计的解码帧率
+ *
+ * @param total_threads 软件解码线程预算，1 表示每路流单线程解码(原实现)
+ */
+static void bench_decode(const Packets &packets, int width, int height, int streams, int loops, int total_threads) {
+    DecodeThreadBudget::get_instance().set_total_threads(total_threads);
+
+    auto codecpar = std::shared_ptr<AVCodecParameters>(avcodec_parameters_alloc(),
+                                                       [](AVCodecParameters *ptr) { avcodec_parameters_free(&ptr); });
+    codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+    codecpar->codec_id = AV_CODEC_ID_H264;
+    codecpar->width = width;
+    codecpar->height = height;
+
+    std::atomic_int64_t frames{0};
+    std::vector<std::unique_ptr<Decoder_v3>> decoders;
+    for (int i = 0; i < streams; i++) {
+        auto decoder = std::make_unique<Decoder_v3>();
+        decoder->set_decode_mode(DecodeMode::kSoftware);
+        decoder->register_deocde_callback([&frames](const int64_t, const std::shared_ptr<AVFrame> &) {
+            frames.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        });
+        decoder->open_decoder(codecpar);
+        decoders.push_back(std::move(decoder));
+    }
+
+    // 与各路解码器相同的分配结果
+    DecodeThreadBudget replica(total_threads);
+    int threads_per_stream = 0;
+    for (int i = 0; i < streams; i++) { threads_per_stream = replica.threads(replica.add_stream(width * height)); }
+
+    auto time_start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (auto &decoder : decoders) {
+        workers.emplace_back([&packets, loops, decoder = decoder.get()]() {
+            for (int loop = 0; loop < loops; loop++) {
+                for (const auto &packet : packets) { decoder->decode_packet(packet); }
+            }
+        });
+    }
+    for (auto &worker : workers) { worker.join(); }
+    auto time_used = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+
+    std::cout << std::setw(8) << streams << std::setw(10) << total_threads << std::setw(10) << threads_per_stream
+              << std::fixed << std::setprecision(1) << std::setw(12) << frames / time_used << std::setw(12)
+              << frames / time_used / streams << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int max_streams = argc > 1 ? std::atoi(argv[1]) : 64;
+    int loops = argc > 2 ? std::atoi(argv[2]) : 2;
+    int cpus = std::max(1u, std::thread::hardware_concurrency());
+    const int frame_count = 100, gop_size = 25;
+
+    av_log_set_level(AV_LOG_ERROR);
+    for (auto [width, height] : std::vector<std::pair<int, int>>{{1920, 1080}, {640, 360}}) {
+        auto packets = make_synthetic_h264(width, height, frame_count, gop_size);
+        if (packets.empty()) {
+            std::cerr << "No H.264 encoder available to generate the test stream" << std::endl;
+            return 1;
+        }
+
+        std::cout << "# H.264 " << width << "x" << height << ", " << packets.size() << " packets x " << loops
+                  << " loops, " << cpus << " cpus" << std::endl;
+        std::cout << std::setw(8) << "streams" << std::setw(10) << "budget" << std::setw(10) << "threads"
+                  << std::setw(12) << "fps" << std::setw(12) << "fps/stream" << std::endl;
+        for (int streams = 1; streams <= max_streams; streams *= 2) {
+            bench_decode(packets, width, height, streams, loops, 1);
+            bench_decode(packets, width, height, streams, loops, cpus);
+        }
+    }
+    return 0;
+}
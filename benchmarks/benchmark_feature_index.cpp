@@ -0,0 +1,104 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "modules/algorithm/feature_index.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace gddi::algo;
+
+static const uint32_t kDim = 512;
+
+static double seconds_since(const std::chrono::high_resolution_clock::time_point &time_start) {
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+}
+
+/**
+ * @brief 原路径: 逐条计算余弦相似度取最大值
+ */
+static uint32_t linear_search(const std::vector<float> &library, const std::vector<float> &norms, const float *query) {
+    uint32_t best = 0;
+    float best_similarity = -2;
+    for (size_t i = 0; i < norms.size(); i++) {
+        float similarity = feature_dot(library.data() + i * kDim, query, kDim) / norms[i];
+        if (similarity > best_similarity) {
+            best_similarity = similarity;
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief 库中随机向量加噪声作为查询，模拟同一个人的不同照片；以线性搜索的 top-1 为真值统计 recall@1
+ */
+static void bench(size_t count, size_t num_queries) {
+    std::mt19937 rng(count);
+    std::normal_distribution<float> normal;
+    std::vector<float> library(count * kDim);
+    for (auto &value : library) { value = normal(rng); }
+
+    std::vector<float> norms(count);
+    for (size_t i = 0; i < count; i++) {
+        norms[i] = std::sqrt(feature_dot(library.data() + i * kDim, library.data() + i * kDim, kDim));
+    }
+
+    std::vector<float> queries(num_queries * kDim);
+    for (size_t i = 0; i < num_queries; i++) {
+        size_t source = rng() % count;
+        for (uint32_t j = 0; j < kDim; j++) { queries[i * kDim + j] = library[source * kDim + j] + normal(rng) * 0.5f; }
+    }
+
+    auto time_start = std::chrono::high_resolution_clock::now();
+    std::vector<uint32_t> truth(num_queries);
+    for (size_t i = 0; i < num_queries; i++) { truth[i] = linear_search(library, norms, queries.data() + i * kDim); }
+    double linear_qps = num_queries / seconds_since(time_start);
+
+    time_start = std::chrono::high_resolution_clock::now();
+    FeatureIndex build_index(kDim);
+    for (size_t i = 0; i < count; i++) { build_index.add(i, library.data() + i * kDim); }
+    double build_time = seconds_since(time_start);
+
+    // 检索使用 mmap 加载的索引
+    auto path = "benchmark_feature_index_" + std::to_string(count) + ".idx";
+    build_index.save(path);
+    FeatureIndex index(kDim);
+    index.load(path);
+
+    std::cout << "# " << count << " vectors, build " << std::fixed << std::setprecision(1) << build_time << " s, "
+              << count / build_time << " inserts/s" << std::endl;
+    std::cout << std::setw(12) << std::left << "linear" << std::right << std::setw(12) << linear_qps << " q/s"
+              << std::setw(10) << std::setprecision(3) << 1.0 << " recall@1" << std::endl;
+
+    for (uint32_t ef : {16, 32, 64, 128}) {
+        size_t hits = 0;
+        time_start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < num_queries; i++) {
+            auto results = index.search(queries.data() + i * kDim, 1, ef);
+            if (!results.empty() && results[0].label == truth[i]) { ++hits; }
+        }
+        double qps = num_queries / seconds_since(time_start);
+
+        std::cout << std::setw(12) << std::left << "hnsw ef=" + std::to_string(ef) << std::right << std::setw(12)
+                  << std::setprecision(1) << qps << " q/s" << std::setw(10) << std::setprecision(3)
+                  << (double)hits / num_queries << " recall@1" << std::endl;
+    }
+
+    std::remove(path.c_str());
+}
+
+int main(int argc, char *argv[]) {
+    size_t num_queries = argc > 1 ? std::atoi(argv[1]) : 200;
+    std::vector<size_t> counts{10000, 100000, 1000000};
+    if (argc > 2) { counts.assign(1, std::atoi(argv[2])); }
+
+    for (auto count : counts) { bench(count, num_queries); }
+    return 0;
+}
@@ -0,0 +1,193 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "node_msg_def.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+// 统计 C++ 堆分配的次数和字节数
+static std::atomic_int64_t g_new_count{0};
+static std::atomic_int64_t g_new_bytes{0};
+
+void *operator new(std::size_t size) {
+    g_new_count.fetch_add(1, std::memory_order_relaxed);
+    g_new_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size)) { return ptr; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace gddi;
+using namespace gddi::nodes;
+
+static const int kNumClasses = 80;
+static const int kNumTargets = 20;
+
+/**
+ * @brief 构造一帧检测结果，标签、颜色映射与 Inference_v2 一致，每帧重新赋值
+ */
+static std::shared_ptr<msgs::cv_frame> make_detection_frame(int64_t frame_idx,
+                                                            const std::map<int, std::string> &labels) {
+    auto frame = std::make_shared<msgs::cv_frame>("bench");
+    frame->frame_info = std::make_shared<FrameInfo>(frame_idx, nullptr);
+
+    auto &ext_info = frame->frame_info->ext_info.emplace_back(AlgoType::kDetection, "mod_id", "mod_name", 0.3);
+    ext_info.map_class_label = labels;
+    for (const auto &[class_id, _] : labels) { ext_info.map_class_color[class_id] = {0, 0, 255, 1}; }
+    for (int i = 0; i < kNumTargets; i++) {
+        ext_info.map_target_box[i] = BoxInfo{.prev_id = i,
+                                             .class_id = i % kNumClasses,
+                                             .prob = 0.3f + 0.03f * i,
+                                             .box = {10.0f * i, 20.0f * i, 50, 100}};
+    }
+    ext_info.infer_target_info = ext_info.map_target_box;
+    return frame;
+}
+
+/**
+ * @brief 原实现: 拷贝帧时深拷贝所有推理阶段，包括标签、颜色映射
+ */
+static std::shared_ptr<msgs::cv_frame> deep_clone(const std::shared_ptr<msgs::cv_frame> &frame) {
+    auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
+    for (size_t i = 0; i < clone_frame->frame_info->ext_info.size(); i++) {
+        auto &ext_info = clone_frame->frame_info->ext_info.mutable_at(i);
+        ext_info.map_class_label = ext_info.map_class_label.get();
+        ext_info.map_class_color = ext_info.map_class_color.get();
+        ext_info.infer_target_info = ext_info.infer_target_info.get();
+    }
+    return clone_frame;
+}
+
+static std::shared_ptr<msgs::cv_frame> cow_clone(const std::shared_ptr<msgs::cv_frame> &frame) {
+    return std::make_shared<msgs::cv_frame>(frame);
+}
+
+/**
+ * @brief 模拟 检测 → 跟踪 → 过滤 → ROI → 计数 → 上报 链路上 10 个节点对帧信息的读写
+ */
+template<class Clone_>
+static std::shared_ptr<msgs::cv_frame> run_chain(std::shared_ptr<msgs::cv_frame> frame, Clone_ clone) {
+    // 1. TargetTracker_v2: 原地写入跟踪结果
+    {
+        auto &back_ext_info = frame->frame_info->ext_info.mutable_back();
+        for (auto &[idx, item] : back_ext_info.map_target_box) {
+            item.track_id = idx + 100;
+            back_ext_info.tracked_box[item.track_id] =
+                TrackInfo{.target_id = idx, .class_id = item.class_id, .prob = item.prob, .box = item.box};
+        }
+    }
+
+    // 2. ProbFilter_v2: 拷贝帧，删除低置信度目标
+    frame = clone(frame);
+    {
+        auto &back_ext_info = frame->frame_info->ext_info.mutable_back();
+        for (auto iter = back_ext_info.map_target_box.begin(); iter != back_ext_info.map_target_box.end();) {
+            iter = iter->second.prob < 0.35f ? back_ext_info.map_target_box.erase(iter) : ++iter;
+        }
+    }
+
+    // 3. LogicGate_v2: 只读
+    {
+        const auto &back_ext_info = frame->frame_info->ext_info.back();
+        size_t count = 0;
+        for (const auto &[idx, target] : back_ext_info.map_target_box) {
+            count += back_ext_info.map_class_label.at(target.class_id).size();
+        }
+        if (count == 0) { frame->frame_type = FrameType::kBase; }
+    }
+
+    // 4. RoiFilter_v2: 拷贝帧，按区域重写目标框
+    frame = clone(frame);
+    {
+        frame->frame_info->roi_points["0"] = {{0, 0}, {1920, 0}, {1920, 1080}, {0, 1080}};
+        auto &back_ext_info = frame->frame_info->ext_info.mutable_back();
+        for (auto &[idx, target] : back_ext_info.map_target_box) { target.roi_id = "0"; }
+    }
+
+    // 5. BoxFilter_v2: 拷贝帧，按尺寸过滤
+    frame = clone(frame);
+    {
+        auto &back_ext_info = frame->frame_info->ext_info.mutable_back();
+        for (auto iter = back_ext_info.map_target_box.begin(); iter != back_ext_info.map_target_box.end();) {
+            iter = iter->second.box.width < 10 ? back_ext_info.map_target_box.erase(iter) : ++iter;
+        }
+    }
+
+    // 6. CrossCounter_v2: 拷贝帧，写入越界计数
+    frame = clone(frame);
+    {
+        auto &back_ext_info = frame->frame_info->ext_info.mutable_back();
+        back_ext_info.border_points = {{{0, 540}, {1920, 540}}};
+        back_ext_info.cross_count = {{{"person", {1, 2}}}};
+    }
+
+    // 7. LabelCounterCondition_v2: 只读
+    {
+        const auto &back_ext_info = frame->frame_info->ext_info.back();
+        int count = 0;
+        for (const auto &[idx, target] : back_ext_info.map_target_box) {
+            if (back_ext_info.map_class_label.at(target.class_id) == "0") { ++count; }
+        }
+        if (count > 0) { frame->frame_type = FrameType::kReport; }
+    }
+
+    // 8. TargetCounter_v2: 原地写入计数
+    frame->frame_info->ext_info.mutable_back().target_counts["0"] = 1;
+
+    // 9. Graphics_v2: 只读
+    {
+        const auto &back_ext_info = frame->frame_info->ext_info.back();
+        float sum = 0;
+        for (const auto &[idx, item] : back_ext_info.map_target_box) {
+            sum += back_ext_info.map_class_color.at(item.class_id).r + item.box.x;
+        }
+        if (sum < 0) { frame->frame_type = FrameType::kNone; }
+    }
+
+    // 10. Report_v2: 只读
+    frame->check_report_callback_(frame->frame_info->ext_info);
+    return frame;
+}
+
+template<class Clone_>
+static void bench_chain(const char *title, int total, Clone_ clone) {
+    std::map<int, std::string> labels;
+    for (int i = 0; i < kNumClasses; i++) { labels[i] = "label_" + std::to_string(i); }
+
+    int64_t new_count = 0;
+    int64_t new_bytes = 0;
+    double time_used = 0;
+    for (int i = 0; i < total; i++) {
+        // 只统计检测节点之后的链路
+        auto frame = make_detection_frame(i, labels);
+        auto new_count_start = g_new_count.load();
+        auto new_bytes_start = g_new_bytes.load();
+        auto time_start = std::chrono::high_resolution_clock::now();
+        auto output = run_chain(frame, clone);
+        time_used += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+        new_count += g_new_count.load() - new_count_start;
+        new_bytes += g_new_bytes.load() - new_bytes_start;
+    }
+
+    std::cout << std::setw(8) << std::left << title << std::right << std::setw(10) << std::fixed
+              << std::setprecision(2) << time_used * 1e6 / total << " us/frame" << std::setw(10)
+              << std::setprecision(1) << (double)new_count / total << " new/frame" << std::setw(10)
+              << (double)new_bytes / total << " bytes/frame" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int total = argc > 1 ? std::atoi(argv[1]) : 10000;
+
+    std::cout << "# detection -> tracking -> roi -> report, " << kNumClasses << " classes, " << kNumTargets
+              << " targets, " << total << " frames" << std::endl;
+    bench_chain("deep", total, deep_clone);
+    bench_chain("cow", total, cow_clone);
+    return 0;
+}
@@ -0,0 +1,102 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "modules/wrapper/tsing_wrapper.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+// 统计 C++ 堆分配次数，FFmpeg 的 av_malloc 不经过这里
+static std::atomic_int64_t g_new_count{0};
+
+void *operator new(std::size_t size) {
+    g_new_count.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size)) { return ptr; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace gddi;
+
+static std::shared_ptr<AVFrame> make_yuv420p(int width, int height) {
+    auto frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = width;
+    frame->height = height;
+    av_frame_get_buffer(frame.get(), 32);
+    for (int plane = 0; plane < 3; plane++) {
+        int rows = plane == 0 ? height : height / 2;
+        for (int y = 0; y < rows; y++) {
+            memset(frame->data[plane] + y * frame->linesize[plane], (y + plane) & 0xff, frame->linesize[plane]);
+        }
+    }
+    return frame;
+}
+
+/**
+ * @brief 原实现: 每帧创建 SwsContext，并用 alloc_mem_detach + av_frame_get_buffer 分配目标帧
+ */
+static std::shared_ptr<MemObject<AVFrame>> legacy_image_from_avframe(ImagePool &mem_pool,
+                                                                     const std::shared_ptr<AVFrame> &frame) {
+    auto mem_obj = mem_pool.alloc_mem_detach(frame->width, frame->height);
+    mem_obj->data = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    mem_obj->data->format = AV_PIX_FMT_NV12;
+    mem_obj->data->width = frame->width;
+    mem_obj->data->height = frame->height;
+    av_frame_get_buffer(mem_obj->data.get(), 1);
+
+    auto sws_ctx = sws_getContext(frame->width, frame->height, AV_PIX_FMT_YUV420P, frame->width, frame->height,
+                                  AV_PIX_FMT_NV12, SWS_BICUBIC, nullptr, nullptr, nullptr);
+    sws_scale(sws_ctx, frame->data, frame->linesize, 0, frame->height, mem_obj->data->data, mem_obj->data->linesize);
+    sws_freeContext(sws_ctx);
+    return mem_obj;
+}
+
+/**
+ * @brief 模拟下游同时持有 inflight 帧，统计稳定后的单帧耗时和 C++ 堆分配次数
+ */
+template<class Convert_>
+void bench_convert(const char *title, int width, int height, int total, int inflight, Convert_ convert) {
+    ImagePool mem_pool;
+    auto src_frame = make_yuv420p(width, height);
+    std::deque<std::shared_ptr<MemObject<AVFrame>>> holding;
+
+    // 预热，填满内存池
+    for (int i = 0; i < inflight * 2; i++) {
+        holding.push_back(convert(mem_pool, src_frame));
+        if ((int)holding.size() > inflight) { holding.pop_front(); }
+    }
+
+    auto new_count_start = g_new_count.load();
+    auto time_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < total; i++) {
+        holding.push_back(convert(mem_pool, src_frame));
+        if ((int)holding.size() > inflight) { holding.pop_front(); }
+    }
+    auto time_used = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+    auto new_count = g_new_count.load() - new_count_start;
+
+    std::cout << std::setw(10) << std::left << title << std::right << std::setw(5) << width << "x" << std::setw(4)
+              << std::left << height << std::right << std::setw(10) << std::fixed << std::setprecision(3)
+              << time_used * 1e3 / total << " ms/frame" << std::setw(8) << std::setprecision(1)
+              << (double)new_count / total << " new/frame" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int total = argc > 1 ? std::atoi(argv[1]) : 200;
+    int inflight = 4;
+
+    std::cout << "# YUV420P -> NV12, " << total << " frames, " << inflight << " frames in flight" << std::endl;
+    for (auto size : {std::make_pair(1920, 1080), std::make_pair(3840, 2160)}) {
+        bench_convert("legacy", size.first, size.second, total, inflight, legacy_image_from_avframe);
+        bench_convert("pooled", size.first, size.second, total, inflight, image_wrapper::image_from_avframe);
+    }
+    return 0;
+}
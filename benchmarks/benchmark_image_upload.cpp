@@ -0,0 +1,154 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "json.hpp"
+#include "modules/network/upload_parser.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <hv/HttpClient.h>
+#include <hv/HttpServer.h>
+#include <hv/base64.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace gddi;
+
+static std::atomic_int64_t g_images{0};
+
+static int reply(const HttpContextPtr &ctx, const size_t images) {
+    g_images += images;
+    return ctx->send("{\"success\":true}");
+}
+
+/**
+ * @brief 只测上传解析，不解码不推理
+ *        /json      - 原路径: DOM 解析 + base64
+ *        /json-sax  - SAX 解析 + base64
+ *        /binary    - application/octet-stream，一张图
+ *        /multipart - multipart/form-data，多张图 + metadata
+ */
+static void register_routes(HttpService &router) {
+    router.POST("/json", [](const HttpContextPtr &ctx) {
+        auto req_obj = nlohmann::json::parse(ctx->body());
+        auto raw_data = req_obj["image"].get<std::string>();
+        std::vector<unsigned char> image(BASE64_DECODE_OUT_SIZE(raw_data.size()));
+        hv_base64_decode(raw_data.data(), raw_data.size(), image.data());
+        return reply(ctx, 1);
+    });
+
+    router.POST("/json-sax", [](const HttpContextPtr &ctx) {
+        std::string raw_data;
+        std::map<std::string, network::RegionMap> regions;
+        network::parse_upload_json(ctx->body(), regions, &raw_data);
+        std::vector<unsigned char> image(BASE64_DECODE_OUT_SIZE(raw_data.size()));
+        hv_base64_decode(raw_data.data(), raw_data.size(), image.data());
+        return reply(ctx, 1);
+    });
+
+    router.POST("/binary", [](const HttpContextPtr &ctx) { return reply(ctx, ctx->body().empty() ? 0 : 1); });
+
+    router.POST("/multipart", [](const HttpContextPtr &ctx) {
+        std::vector<network::FormPart> parts;
+        std::map<std::string, network::RegionMap> regions;
+        network::parse_multipart(ctx->header("Content-Type"), ctx->body(), parts);
+        size_t images = 0;
+        for (const auto &part : parts) {
+            if (part.name == "metadata") {
+                network::parse_upload_json(part.data, regions);
+            } else {
+                ++images;
+            }
+        }
+        return reply(ctx, images);
+    });
+}
+
+struct Payload {
+    std::string path;
+    std::string content_type;
+    std::string body;
+};
+
+static std::vector<Payload> make_payloads(const size_t image_size, const size_t batch) {
+    std::string image(image_size, 0);
+    std::mt19937 rng(0);
+    for (auto &c : image) { c = rng() & 0xff; }
+
+    std::string encoded(BASE64_ENCODE_OUT_SIZE(image.size()), 0);
+    encoded.resize(hv_base64_encode((const unsigned char *)image.data(), image.size(), &encoded[0]));
+    std::string regions = R"({"regions_with_label": {"door": [[10, 20], [300, 20], [300, 400], [10, 400]]}})";
+    auto json_body = R"({"image": "data:image/jpeg;base64,)" + encoded + R"(", "additional": )" + regions + "}";
+
+    const std::string boundary = "----gddi-benchmark";
+    std::string multipart_body;
+    nlohmann::json metadata;
+    for (size_t i = 0; i < batch; i++) {
+        auto name = "img" + std::to_string(i);
+        metadata[name] = nlohmann::json::parse(regions);
+        multipart_body += "--" + boundary + "\r\nContent-Disposition: form-data; name=\"" + name + "\"; filename=\""
+            + name + ".jpg\"\r\nContent-Type: image/jpeg\r\n\r\n" + image + "\r\n";
+    }
+    multipart_body = "--" + boundary + "\r\nContent-Disposition: form-data; name=\"metadata\"\r\n\r\n" + metadata.dump()
+        + "\r\n" + multipart_body + "--" + boundary + "--\r\n";
+
+    return {{"/json", "application/json", json_body},
+            {"/json-sax", "application/json", json_body},
+            {"/binary", "application/octet-stream", image},
+            {"/multipart", "multipart/form-data; boundary=" + boundary, multipart_body}};
+}
+
+static void bench(const int port, const Payload &payload, const int clients, const int requests) {
+    g_images = 0;
+    auto time_start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; i++) {
+        threads.emplace_back([&]() {
+            hv::HttpClient client;
+            HttpRequest req;
+            req.method = HTTP_POST;
+            req.url = "http://127.0.0.1:" + std::to_string(port) + payload.path;
+            req.headers["Content-Type"] = payload.content_type;
+            req.body = payload.body;
+            for (int n = 0; n < requests; n++) {
+                HttpResponse resp;
+                client.send(&req, &resp);
+            }
+        });
+    }
+    for (auto &thread : threads) { thread.join(); }
+
+    auto time_used = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+    std::cout << std::setw(12) << std::left << payload.path << std::right << std::setw(10) << std::fixed
+              << std::setprecision(1) << g_images / time_used << " images/s" << std::setw(10)
+              << payload.body.size() * requests * clients / time_used / 1024 / 1024 << " MB/s" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int port = 19092;
+    size_t image_size = argc > 1 ? std::atoi(argv[1]) : 2 * 1024 * 1024;
+    int clients = argc > 2 ? std::atoi(argv[2]) : 4;
+    int requests = argc > 3 ? std::atoi(argv[3]) : 50;
+    size_t batch = 8;
+
+    HttpService router;
+    register_routes(router);
+
+    http_server_t server;
+    server.service = &router;
+    server.port = port;
+    server.worker_threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    http_server_run(&server, 0);
+
+    std::cout << "# image " << image_size / 1024 << " KB, " << clients << " clients x " << requests
+              << " requests, multipart batch " << batch << std::endl;
+    for (const auto &payload : make_payloads(image_size, batch)) { bench(port, payload, clients, requests); }
+
+    http_server_stop(&server);
+    return 0;
+}
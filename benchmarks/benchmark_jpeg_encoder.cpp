@@ -0,0 +1,102 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "modules/wrapper/jpeg_encoder.h"
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+using namespace codec;
+
+static std::shared_ptr<AVFrame> make_nv12(int width, int height) {
+    auto frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    frame->format = AV_PIX_FMT_NV12;
+    frame->width = width;
+    frame->height = height;
+    av_frame_get_buffer(frame.get(), 32);
+    for (int y = 0; y < height; y++) { memset(frame->data[0] + y * frame->linesize[0], y & 0xff, frame->linesize[0]); }
+    for (int y = 0; y < height / 2; y++) {
+        memset(frame->data[1] + y * frame->linesize[1], (y * 7) & 0xff, frame->linesize[1]);
+    }
+    return frame;
+}
+
+/**
+ * @brief 原 CPU 路径: NV12 转 BGR 后 cv::imencode，单线程
+ */
+static void bench_opencv(const std::shared_ptr<AVFrame> &frame, int total) {
+    cv::Mat nv12(frame->height * 3 / 2, frame->width, CV_8UC1);
+    for (int y = 0; y < frame->height; y++) {
+        memcpy(nv12.ptr(y), frame->data[0] + y * frame->linesize[0], frame->width);
+    }
+    for (int y = 0; y < frame->height / 2; y++) {
+        memcpy(nv12.ptr(frame->height + y), frame->data[1] + y * frame->linesize[1], frame->width);
+    }
+
+    std::vector<uchar> jpeg_data;
+    auto time_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < total; i++) {
+        cv::Mat bgr;
+        cv::cvtColor(nv12, bgr, cv::COLOR_YUV2BGR_NV12);
+        cv::imencode(".jpg", bgr, jpeg_data, std::vector<int>{cv::IMWRITE_JPEG_QUALITY, 85});
+    }
+    auto time_used = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+
+    std::cout << std::setw(12) << std::left << "opencv" << std::right << std::setw(10) << std::fixed
+              << std::setprecision(1) << total / time_used << " fps" << std::setw(10) << jpeg_data.size() / 1024
+              << " KB" << std::endl;
+}
+
+/**
+ * @brief 同时保持 inflight 帧在线程池中编码，统计吞吐
+ */
+static void bench_pool(const std::shared_ptr<AVFrame> &frame, int total, size_t inflight) {
+    auto &pool = JpegEncodePool::get_instance();
+    std::deque<std::future<std::vector<uint8_t>>> pending;
+    std::vector<std::vector<uint8_t>> buffers;
+    size_t jpeg_size = 0;
+
+    auto time_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < total; i++) {
+        if (pending.size() >= inflight) {
+            buffers.emplace_back(pending.front().get());
+            pending.pop_front();
+        }
+        std::vector<uint8_t> buffer;
+        if (!buffers.empty()) {
+            buffer = std::move(buffers.back());
+            buffers.pop_back();
+        }
+        pending.emplace_back(pool.encode(frame, 85, std::move(buffer)));
+    }
+    while (!pending.empty()) {
+        jpeg_size = pending.front().get().size();
+        pending.pop_front();
+    }
+    auto time_used = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+
+    std::cout << std::setw(8) << std::left << "turbo x" << std::setw(4) << inflight << std::right << std::setw(10)
+              << std::fixed << std::setprecision(1) << total / time_used << " fps" << std::setw(10) << jpeg_size / 1024
+              << " KB" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int total = argc > 1 ? std::atoi(argv[1]) : 200;
+    auto frame = make_nv12(1920, 1080);
+
+    std::cout << "# 1920x1080 NV12 -> JPEG q85, " << total << " frames" << std::endl;
+    bench_opencv(frame, total);
+    if (!JpegEncodePool::available()) {
+        std::cout << "built without libjpeg-turbo" << std::endl;
+        return 0;
+    }
+    for (size_t inflight = 1; inflight <= JpegEncodePool::get_instance().thread_num(); inflight *= 2) {
+        bench_pool(frame, total, inflight);
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "node_any_basic.hpp"
+#include "runnable_node.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+
+using namespace gddi;
+
+class BenchMessage : public ngraph::Message {
+public:
+    explicit BenchMessage(int64_t idx) : idx_(idx) {}
+    int64_t idx_;
+
+    std::string name() const override { return "BenchMessage"; }
+    std::string to_string() const override { return std::to_string(idx_); }
+};
+
+class BenchRelay : public nodes::node_any_basic<BenchRelay> {
+public:
+    explicit BenchRelay(std::string name) : node_any_basic<BenchRelay>(std::move(name)) {
+        register_input_message_handler_(&BenchRelay::on_message, this);
+        output_ = register_output_message_<BenchMessage>();
+    }
+
+private:
+    void on_message(const std::shared_ptr<BenchMessage> &message) { output_(message); }
+    message_pipe<BenchMessage> output_;
+};
+
+class BenchSink : public nodes::node_any_basic<BenchSink> {
+public:
+    explicit BenchSink(std::string name, int64_t expected)
+        : node_any_basic<BenchSink>(std::move(name)), expected_(expected) {
+        register_input_message_handler_(&BenchSink::on_message, this);
+    }
+
+    void wait_all() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return received_ >= expected_; });
+    }
+
+private:
+    void on_message(const std::shared_ptr<BenchMessage> &message) {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        if (++received_ >= expected_) { cv_.notify_all(); }
+    }
+
+    int64_t expected_;
+    int64_t received_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+/**
+ * @brief 旧的分发方式(dynamic_pointer_cast)与类型化端点(static_pointer_cast)的单次分发开销
+ */
+void bench_handler_dispatch(int64_t total) {
+    int64_t sum = 0;
+    auto on_message = [&sum](const std::shared_ptr<BenchMessage> &message) { sum += message->idx_; };
+
+    std::function<void(const ngraph::MessagePtr &)> legacy = [&](const ngraph::MessagePtr &message) {
+        auto msg = std::dynamic_pointer_cast<BenchMessage>(message);
+        if (msg) { on_message(msg); }
+    };
+    std::function<void(const ngraph::MessagePtr &)> typed = [&](const ngraph::MessagePtr &message) {
+        on_message(std::static_pointer_cast<BenchMessage>(message));
+    };
+
+    ngraph::MessagePtr message = std::make_shared<BenchMessage>(1);
+    auto run = [&](const char *title, const std::function<void(const ngraph::MessagePtr &)> &handler) {
+        auto time_start = std::chrono::high_resolution_clock::now();
+        for (int64_t i = 0; i < total; i++) { handler(message); }
+        auto time_used = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+        std::cout << std::setw(24) << std::left << title << std::right << std::setw(10) << std::fixed
+                  << std::setprecision(2) << time_used * 1e9 / total << " ns/msg" << std::endl;
+    };
+
+    std::cout << "# handler dispatch, " << total << " messages" << std::endl;
+    run("dynamic_pointer_cast", legacy);
+    run("static_pointer_cast", typed);
+    std::cout << "(checksum: " << sum << ")" << std::endl << std::endl;
+}
+
+/**
+ * @brief 消息经过 chain_length 个节点(每个节点一个 Runner)后到达 sink 的吞吐
+ */
+template<class NodeType_>
+void bench_chain(const char *title, int chain_length, int64_t total, bool pooled) {
+    auto executor = pooled ? ngraph::RunnerExecutor::shared_instance() : nullptr;
+    std::vector<std::shared_ptr<ngraph::Runner>> runners;
+    std::vector<std::shared_ptr<ngraph::NodeAny>> chain;
+
+    auto make_runner = [&](int idx) {
+        runners.emplace_back(std::make_shared<ngraph::Runner>("bench-" + std::to_string(idx), executor));
+        return runners.back();
+    };
+
+    auto head = std::make_shared<BenchRelay>("head");
+    head->bind_runner(make_runner(0));
+    chain.push_back(head);
+
+    for (int i = 0; i < chain_length; i++) {
+        auto node = std::make_shared<NodeType_>("node-" + std::to_string(i));
+        node->bind_runner(make_runner(i + 1));
+        if (!chain.back()->connect_to(node)) {
+            std::cerr << "fail to connect chain node: " << i << std::endl;
+            return;
+        }
+        chain.push_back(node);
+    }
+
+    auto sink = std::make_shared<BenchSink>("sink", total);
+    sink->bind_runner(make_runner(chain_length + 1));
+    chain.back()->connect_to(sink);
+
+    for (auto &r : runners) { r->start(); }
+
+    auto time_start = std::chrono::high_resolution_clock::now();
+    for (int64_t i = 0; i < total; i++) { head->push_input_endpoint(0, std::make_shared<BenchMessage>(i)); }
+    sink->wait_all();
+    auto time_used = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+
+    std::cout << std::setw(24) << std::left << title << std::right << " chain: " << std::setw(2) << chain_length
+              << (pooled ? ", pool  " : ", thread") << ", " << std::setw(12) << std::fixed << std::setprecision(0)
+              << total / time_used << " msg/s" << std::endl;
+
+    for (auto &r : runners) { r->post_quit_loop(0); }
+    for (auto &r : runners) { r->join(); }
+}
+
+int main(int argc, char *argv[]) {
+    spdlog::set_level(spdlog::level::err);
+
+    bench_handler_dispatch(10000000);
+
+    std::cout << "# chain throughput" << std::endl;
+    for (auto pooled : {false, true}) {
+        bench_chain<ngraph::Bridge>("Bridge", 8, 200000, pooled);
+        bench_chain<BenchRelay>("node_any_basic relay", 8, 200000, pooled);
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "modules/cvrelate/roi_mask.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace gddi;
+
+static const int kWidth = 1920;
+static const int kHeight = 1080;
+
+struct Box {
+    int x1, y1, x2, y2;
+};
+
+static double seconds_since(const std::chrono::high_resolution_clock::time_point &time_start) {
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_start).count();
+}
+
+/**
+ * @brief 星形多边形 ROI，顶点数 5 ~ 12
+ */
+static std::vector<std::vector<Point2i>> make_regions(std::mt19937 &rng, int count) {
+    std::uniform_real_distribution<float> uniform(0, 1);
+    std::vector<std::vector<Point2i>> regions;
+    for (int i = 0; i < count; i++) {
+        float cx = 200 + uniform(rng) * (kWidth - 400), cy = 150 + uniform(rng) * (kHeight - 300);
+        float radius = 80 + uniform(rng) * 220;
+        int vertices = 5 + rng() % 8;
+
+        std::vector<Point2i> region;
+        for (int v = 0; v < vertices; v++) {
+            float angle = 2 * M_PI * (v + uniform(rng) * 0.5f) / vertices;
+            float r = radius * (0.5f + uniform(rng) * 0.5f);
+            region.emplace_back(cx + r * std::cos(angle), cy + r * std::sin(angle));
+        }
+        regions.push_back(region);
+    }
+    return regions;
+}
+
+static std::vector<Box> make_boxes(std::mt19937 &rng, int count) {
+    std::uniform_real_distribution<float> uniform(0, 1);
+    std::vector<Box> boxes;
+    for (int i = 0; i < count; i++) {
+        int w = 16 + uniform(rng) * 150, h = 16 + uniform(rng) * 300;
+        int x = uniform(rng) * (kWidth - w), y = uniform(rng) * (kHeight - h);
+        boxes.push_back({x, y, x + w, y + h});
+    }
+    return boxes;
+}
+
+/**
+ * @brief 与 RoiFilter_v2 相同的用法: 每个框先查候选 ROI，再计算覆盖率；结果按 box x ROI 展开
+ */
+static double run_index(const geometry::RoiMaskIndex &index, const std::vector<Box> &boxes, int rounds,
+                        std::vector<float> &rates) {
+    std::vector<size_t> candidates;
+    auto time_start = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        std::fill(rates.begin(), rates.end(), 0);
+        for (size_t i = 0; i < boxes.size(); i++) {
+            const auto &box = boxes[i];
+            index.query(box.x1, box.y1, box.x2, box.y2, candidates);
+            for (auto roi : candidates) {
+                rates[i * index.size() + roi] = index.cover_rate(roi, box.x1, box.y1, box.x2, box.y2);
+            }
+        }
+    }
+    return seconds_since(time_start) / rounds;
+}
+
+static void bench(int num_boxes, int num_regions, int rounds, float threshold) {
+    std::mt19937 rng(num_boxes * 131 + num_regions);
+    auto regions = make_regions(rng, num_regions);
+    auto boxes = make_boxes(rng, num_boxes);
+    const size_t total = boxes.size() * regions.size();
+
+    // 原实现: 每次调用都构造多边形
+    std::vector<float> legacy(total);
+    auto time_start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < boxes.size(); i++) {
+        const auto &box = boxes[i];
+        std::vector<Point2i> box_points{{box.x1, box.y1}, {box.x1, box.y2}, {box.x2, box.y2}, {box.x2, box.y1}};
+        for (size_t roi = 0; roi < regions.size(); roi++) {
+            legacy[i * regions.size() + roi] = geometry::area_cover_rate(box_points, regions[roi]);
+        }
+    }
+    double legacy_time = seconds_since(time_start);
+
+    geometry::RoiMaskIndex exact, raster;
+    time_start = std::chrono::high_resolution_clock::now();
+    exact.compile(regions, geometry::CoverMode::kExact);
+    double exact_compile = seconds_since(time_start);
+    time_start = std::chrono::high_resolution_clock::now();
+    raster.compile(regions, geometry::CoverMode::kRaster);
+    double raster_compile = seconds_since(time_start);
+
+    std::vector<float> exact_rates(total), raster_rates(total);
+    double exact_time = run_index(exact, boxes, std::max(1, rounds / 10), exact_rates);
+    double raster_time = run_index(raster, boxes, rounds, raster_rates);
+
+    double max_error = 0, sum_error = 0;
+    size_t exact_diff = 0, flipped = 0;
+    for (size_t i = 0; i < total; i++) {
+        if (exact_rates[i] != legacy[i]) { ++exact_diff; }
+        double error = std::abs(raster_rates[i] - legacy[i]);
+        max_error = std::max(max_error, error);
+        sum_error += error;
+        if ((raster_rates[i] >= threshold) != (legacy[i] >= threshold)) { ++flipped; }
+    }
+
+    std::cout << "# " << num_boxes << " boxes x " << num_regions << " ROIs, " << kWidth << "x" << kHeight << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(16) << std::left << "legacy" << std::right << std::setw(10) << legacy_time * 1e3
+              << " ms/frame" << std::endl;
+    std::cout << std::setw(16) << std::left << "exact + rtree" << std::right << std::setw(10) << exact_time * 1e3
+              << " ms/frame, compile " << exact_compile * 1e3 << " ms, " << exact_diff << " differ from legacy"
+              << std::endl;
+    std::cout << std::setw(16) << std::left << "raster + rtree" << std::right << std::setw(10) << raster_time * 1e3
+              << " ms/frame, compile " << raster_compile * 1e3 << " ms" << std::endl;
+    std::cout << "raster error: max " << std::setprecision(4) << max_error << ", mean " << sum_error / total << ", "
+              << flipped << " / " << total << " decisions flipped at threshold " << threshold << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 100;
+    float threshold = argc > 2 ? std::atof(argv[2]) : 0.5f;
+
+    bench(500, 16, rounds, threshold);
+    return 0;
+}
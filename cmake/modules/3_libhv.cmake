@@ -39,6 +39,9 @@ endif()
 file(GLOB CodeFiles
     src/inference_server/*.c??
     src/modules/network/downloader.cpp
+    src/modules/network/event_socket.cpp
+    src/modules/network/event_spool.cpp
+    src/modules/network/upload_parser.cpp
 )
 
 set(LibFiles "${LibFiles};${CodeFiles}")
@@ -14,7 +14,7 @@ set(LibFiles "${LibFiles};${codeFile}")
 
 file(GLOB ModuleLibFiles src/modules/codec/*.cpp)
 add_library(gddi_codec SHARED ${ModuleLibFiles})
-set_target_properties(gddi_codec PROPERTIES PUBLIC_HEADER "src/modules/codec/demux_stream_v3.h;src/modules/codec/decode_video_v3.h")
+set_target_properties(gddi_codec PROPERTIES PUBLIC_HEADER "src/modules/codec/demux_stream_v3.h;src/modules/codec/decode_video_v3.h;src/modules/codec/ingest_loop.h")
 set_target_properties(gddi_codec PROPERTIES VERSION ${PROJECT_VERSION} SOVERSION ${PROJECT_VERSION_MAJOR})
 target_link_libraries(gddi_codec PRIVATE ${FFMPEG_LIBRARIES} spdlog::spdlog Boost::filesystem)
 
@@ -1,5 +1,17 @@
-file(GLOB ModuleFiles src/modules/algorithm/tsing_*.cpp)
-set(LinkLibraries "${LinkLibraries};gddeploy_app;gddeploy_api;gddeploy_core;gddeploy_register;gddeploy_common;mpi")
+file(GLOB ModuleFiles src/modules/algorithm/batch_*.cpp src/modules/algorithm/model_*.cpp
+                      src/modules/algorithm/algo_*.cpp src/modules/algorithm/replay_*.cpp)
+
+# 加速卡推理后端，依赖 gddeploy SDK，没有加速卡的环境使用 -DWITH_TSING_INFERENCE=OFF
+option(WITH_TSING_INFERENCE "Build the tsing inference backend" ON)
+if(WITH_TSING_INFERENCE)
+    message(STATUS "Inference backend \"tsing\" enabled")
+    add_compile_definitions(WITH_TSING_INFERENCE)
+    file(GLOB TsingFiles src/modules/algorithm/tsing_*.cpp)
+    list(APPEND ModuleFiles ${TsingFiles})
+    set(LinkLibraries "${LinkLibraries};gddeploy_app;gddeploy_api;gddeploy_core;gddeploy_register;gddeploy_common;mpi")
+else()
+    message(STATUS "Inference backend \"tsing\" will closed!")
+endif()
 # set(SDK_DOWNLOAD_URL "http://cacher.devops.io/api/cacher/files/86709875d83868e48ba415719d4b17d9cc1f15cf537b8f229a67432967ddad0e")
 # set(SDK_URL_HASH "86709875d83868e48ba415719d4b17d9cc1f15cf537b8f229a67432967ddad0e")
 
@@ -0,0 +1,8 @@
+# CPU 推理后端，依赖 OpenCV dnn 模块，需在 6_opencv 之后加载
+if(OpenCV_FOUND AND "opencv_dnn" IN_LIST OpenCV_LIBS)
+    message(STATUS "Found OpenCV dnn, inference backend \"cpu\" enabled")
+    add_compile_definitions(WITH_CPU_INFERENCE)
+    set(LibFiles "${LibFiles};src/modules/algorithm/cpu_inference.cpp")
+else()
+    message(STATUS "OpenCV dnn not Found, inference backend \"cpu\" will closed!")
+endif()
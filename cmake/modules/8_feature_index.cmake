@@ -0,0 +1,3 @@
+# 特征库近似最近邻索引，内积在运行时按 CPU 选择 AVX2 / NEON 实现
+set(LibFiles "${LibFiles};src/modules/algorithm/feature_index.cpp")
+set(LibFiles "${LibFiles};src/modules/algorithm/feature_manifest.cpp")
@@ -0,0 +1,23 @@
+# CPU JPEG 编解码，依赖 libjpeg-turbo，未找到时编码只使用硬件编码通道，解码使用 OpenCV
+pkg_check_modules(TURBOJPEG QUIET IMPORTED_TARGET libturbojpeg)
+
+if(TURBOJPEG_FOUND)
+    message(STATUS "Found libjpeg-turbo: ${TURBOJPEG_VERSION}, cpu jpeg codec enabled")
+    add_compile_definitions(WITH_TURBOJPEG)
+    set(LinkLibraries "${LinkLibraries};PkgConfig::TURBOJPEG")
+else()
+    message(STATUS "libjpeg-turbo not Found, cpu jpeg encoder will closed!")
+endif()
+
+# PNG 解码，未找到时使用 OpenCV
+pkg_check_modules(LIBPNG QUIET IMPORTED_TARGET libpng)
+
+if(LIBPNG_FOUND)
+    message(STATUS "Found libpng: ${LIBPNG_VERSION}")
+    add_compile_definitions(WITH_LIBPNG)
+    set(LinkLibraries "${LinkLibraries};PkgConfig::LIBPNG")
+else()
+    message(STATUS "libpng not Found, png decoder will use opencv")
+endif()
+
+set(LibFiles "${LibFiles};src/modules/wrapper/jpeg_encoder.cpp;src/modules/wrapper/image_decoder.cpp")
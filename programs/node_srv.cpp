@@ -3,6 +3,8 @@
 //
 #include "basic_logs.hpp"
 #include "inference_server/inference_server_v0.hpp"
+#include "modules/algorithm/algo_factory.h"
+#include "modules/codec/decode_video_v3.h"
 #include "version.h"
 #include <boost/program_options.hpp>
 #include <fstream>
@@ -22,6 +24,8 @@ int main(int argc, char *argv[]) {
             "svr-addr", value<std::string>()->default_value("0.0.0.0"), "http server address")(
             "svr-port", value<uint32_t>()->default_value(8780), "http server port")(
             "cfg-file", value<std::string>()->default_value(""), "local config file")(
+            "algo-backend", value<std::string>()->default_value(""), "default inference backend: tsing, replay, cpu")(
+            "decode-threads", value<int>()->default_value(0), "software decode threads, 0: cpu cores")(
             "log-level", value<int>()->default_value(2), "0: trace; 1: debug; 2: info");
 
         store(parse_command_line(argc, argv, desc), vm);
@@ -39,6 +43,12 @@ int main(int argc, char *argv[]) {
         gddi::logs::setup_spdlog(
             static_cast<spdlog::level::level_enum>(vm["log-level"].as<int>()));
 
+        auto algo_backend = vm["algo-backend"].as<std::string>();
+        if (!algo_backend.empty()) {
+            gddi::algo::AlgoBackendRegistry::get_instance().set_default_backend(algo_backend);
+        }
+        av_wrapper::DecodeThreadBudget::get_instance().set_total_threads(vm["decode-threads"].as<int>());
+
         auto cfg_file = vm["cfg-file"].as<std::string>();
         if (cfg_file.size() > 0) {
             std::fstream file(cfg_file);
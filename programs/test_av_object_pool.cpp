@@ -0,0 +1,150 @@
+/**
+ * @file test_av_object_pool.cpp
+ * @brief AVPacket / AVFrame 对象池的复用、归还时 unref 和句柄晚于对象池释放
+ */
+
+#include "modules/codec/av_object_pool.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace av_wrapper;
+
+namespace {
+
+struct FakeObject {
+    int data{0};
+};
+
+// 统计分配、释放和 unref 次数，不依赖 FFmpeg
+struct FakeTraits {
+    static FakeObject *alloc() {
+        ++allocs;
+        return new FakeObject;
+    }
+    static void unref(FakeObject *object) {
+        ++unrefs;
+        object->data = 0;
+    }
+    static void free(FakeObject *object) {
+        ++frees;
+        delete object;
+    }
+
+    static void reset() { allocs = unrefs = frees = 0; }
+
+    static inline std::atomic_int allocs{0};
+    static inline std::atomic_int unrefs{0};
+    static inline std::atomic_int frees{0};
+};
+
+using FakePool = AvObjectPool<FakeObject, FakeTraits>;
+
+}// namespace
+
+TEST(AvObjectPoolTest, ReuseAfterRelease) {
+    FakeTraits::reset();
+    {
+        FakePool pool(4);
+        auto first = pool.acquire();
+        auto first_ptr = first.get();
+        first->data = 42;
+        first.reset();
+        EXPECT_EQ(FakeTraits::unrefs, 1);
+
+        auto second = pool.acquire();
+        EXPECT_EQ(second.get(), first_ptr);
+        EXPECT_EQ(second->data, 0);
+        EXPECT_EQ(FakeTraits::allocs, 1);
+        EXPECT_EQ(pool.stats().reuses, 1u);
+    }
+    EXPECT_EQ(FakeTraits::frees, FakeTraits::allocs);
+}
+
+TEST(AvObjectPoolTest, SteadyStateNoAllocation) {
+    FakeTraits::reset();
+    FakePool pool(8);
+    {
+        auto a = pool.acquire();
+        auto b = pool.acquire();
+    }
+    auto warm = pool.stats().allocations;
+    EXPECT_EQ(warm, 4u);
+
+    for (int i = 0; i < 1000; i++) {
+        auto a = pool.acquire();
+        auto b = pool.acquire();
+        auto copy = a;
+    }
+    // 对象和 shared_ptr 控制块都从空闲链表取出
+    EXPECT_EQ(pool.stats().allocations, warm);
+    EXPECT_EQ(FakeTraits::allocs, 2);
+}
+
+TEST(AvObjectPoolTest, MaxIdle) {
+    FakeTraits::reset();
+    {
+        FakePool pool(2);
+        std::vector<std::shared_ptr<FakeObject>> objects;
+        for (int i = 0; i < 5; i++) { objects.push_back(pool.acquire()); }
+        objects.clear();
+        // 超过 max_idle 的对象直接释放
+        EXPECT_EQ(FakeTraits::frees, 3);
+    }
+    EXPECT_EQ(FakeTraits::frees, 5);
+}
+
+TEST(AvObjectPoolTest, HandleOutlivesPool) {
+    FakeTraits::reset();
+    std::shared_ptr<FakeObject> object;
+    {
+        FakePool pool;
+        object = pool.acquire();
+        object->data = 1;
+    }
+    EXPECT_EQ(FakeTraits::frees, 0);
+    EXPECT_EQ(object->data, 1);
+    object.reset();
+    EXPECT_EQ(FakeTraits::frees, 1);
+}
+
+TEST(AvObjectPoolTest, ReleaseOnOtherThread) {
+    FakeTraits::reset();
+    {
+        FakePool pool(16);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&pool]() {
+                for (int i = 0; i < 1000; i++) {
+                    auto object = pool.acquire();
+                    std::thread([object = std::move(object)]() mutable { object.reset(); }).join();
+                }
+            });
+        }
+        for (auto &thread : threads) { thread.join(); }
+        EXPECT_LE(FakeTraits::allocs, 16);
+    }
+    EXPECT_EQ(FakeTraits::frees, FakeTraits::allocs);
+}
+
+TEST(AvObjectPoolTest, PacketUnref) {
+    PacketPool pool;
+    auto packet = pool.acquire();
+    ASSERT_EQ(av_new_packet(packet.get(), 1024), 0);
+    auto buf = packet->buf;
+    auto ref = std::shared_ptr<AVPacket>(av_packet_clone(packet.get()), [](AVPacket *ptr) { av_packet_free(&ptr); });
+    EXPECT_EQ(av_buffer_get_ref_count(buf), 2);
+
+    // 归还时释放对数据的引用
+    packet.reset();
+    EXPECT_EQ(av_buffer_get_ref_count(ref->buf), 1);
+
+    packet = pool.acquire();
+    EXPECT_EQ(packet->size, 0);
+    EXPECT_EQ(packet->buf, nullptr);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+/**
+ * @file test_bounded_queue.cpp
+ * @brief Runner 有界队列在容量已满时的阻塞、丢弃最旧、丢弃最新策略，以及任务配置中不支持的 executor
+ */
+
+#include "json.hpp"
+#include "inference_server/_inference_task_json.hpp"
+#include "runnable_node.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace gddi;
+using namespace gddi::ngraph;
+using namespace std::chrono_literals;
+
+namespace {
+
+template<typename Pred>
+bool wait_until(Pred pred, std::chrono::milliseconds timeout = 5000ms) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) { return false; }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+class SeqMessage : public Message {
+public:
+    explicit SeqMessage(int seq) : seq(seq) {}
+
+    std::string to_string() const override { return std::to_string(seq); }
+    std::string name() const override { return "SeqMessage"; }
+
+    int seq;
+};
+
+// 按处理顺序记录收到的消息序号
+class CollectingNode : public NodeAny {
+public:
+    explicit CollectingNode(std::string name) : NodeAny(std::move(name)) {}
+
+    std::vector<int> received() const {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        return received_;
+    }
+
+protected:
+    void on_input_message(int endpoint, const MessagePtr &message) override {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        received_.push_back(std::dynamic_pointer_cast<SeqMessage>(message)->seq);
+    }
+
+    result_for<endpoint::DataFeatures> on_query_endpoint(endpoint::Type type, int endpoint) const override {
+        return {endpoint == 0, {"SeqMessage"}};
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<int> received_;
+};
+
+class BoundedQueueTest : public testing::Test {
+protected:
+    // Runner 启动前不消费消息，投递的消息都留在有界队列中
+    void SetUp() override {
+        runner_ = std::make_shared<Runner>("runner");
+        node_ = std::make_shared<CollectingNode>("node");
+        node_->bind_runner(runner_);
+    }
+
+    void TearDown() override { runner_->stop(); }
+
+    void push(int begin, int end) {
+        for (int seq = begin; seq < end; seq++) { node_->push_input_endpoint(0, std::make_shared<SeqMessage>(seq)); }
+    }
+
+    queue::Stats stats() const { return runner_->get_queue_stats().at(0); }
+
+    std::vector<int> start_and_receive(size_t count) {
+        runner_->start();
+        EXPECT_TRUE(wait_until([&]() { return node_->received().size() >= count; }));
+        return node_->received();
+    }
+
+    std::shared_ptr<Runner> runner_;
+    std::shared_ptr<CollectingNode> node_;
+};
+
+}// namespace
+
+TEST_F(BoundedQueueTest, DropOldest) {
+    runner_->set_queue_options({4, queue::OverflowPolicy::kDropOldest});
+    push(0, 10);
+    EXPECT_EQ(stats().queued, 4);
+    EXPECT_EQ(stats().dropped, 6);
+    EXPECT_EQ(stats().policy, "drop_oldest");
+
+    EXPECT_EQ(start_and_receive(4), std::vector<int>({6, 7, 8, 9}));
+}
+
+TEST_F(BoundedQueueTest, DropNewest) {
+    runner_->set_queue_options({4, queue::OverflowPolicy::kDropNewest});
+    push(0, 10);
+    EXPECT_EQ(stats().queued, 4);
+    EXPECT_EQ(stats().dropped, 6);
+    EXPECT_EQ(stats().policy, "drop_newest");
+
+    EXPECT_EQ(start_and_receive(4), std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST_F(BoundedQueueTest, Block) {
+    runner_->set_queue_options({4, queue::OverflowPolicy::kBlock, 5000});
+
+    // 队列满后生产者阻塞，Runner 开始消费后继续投递，不丢弃消息
+    std::atomic_int pushed{0};
+    std::thread producer([&]() {
+        for (int seq = 0; seq < 10; seq++, pushed++) { push(seq, seq + 1); }
+    });
+    ASSERT_TRUE(wait_until([&]() { return pushed == 4; }));
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(pushed, 4);
+    EXPECT_EQ(stats().queued, 4);
+
+    auto received = start_and_receive(10);
+    producer.join();
+    EXPECT_EQ(received, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(stats().dropped, 0);
+}
+
+TEST_F(BoundedQueueTest, BlockTimeout) {
+    runner_->set_queue_options({4, queue::OverflowPolicy::kBlock, 50});
+    push(0, 4);
+
+    // 等待超时后丢弃新消息
+    auto begin = std::chrono::steady_clock::now();
+    push(4, 5);
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, 50ms);
+    EXPECT_EQ(stats().dropped, 1);
+
+    EXPECT_EQ(start_and_receive(4), std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST_F(BoundedQueueTest, InputQueueOverridesRunner) {
+    runner_->set_queue_options({2, queue::OverflowPolicy::kDropOldest});
+    runner_->set_input_queue_options(node_, 0, {4, queue::OverflowPolicy::kDropNewest});
+    push(0, 10);
+
+    auto queue_stats = runner_->get_queue_stats();
+    ASSERT_EQ(queue_stats.size(), 2);
+    EXPECT_EQ(queue_stats[0].dropped, 0);
+    EXPECT_EQ(queue_stats[1].name, "node:0");
+    EXPECT_EQ(queue_stats[1].dropped, 6);
+
+    EXPECT_EQ(start_and_receive(4), std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST(InferenceSliceConfigTest, UnknownExecutor) {
+    const std::string text = R"({"version": "v1", "executor": "%s", "nodes": [], "pipe": []})";
+    auto config_text = [&text](const std::string &executor) {
+        auto result = text;
+        return result.replace(result.find("%s"), 2, executor);
+    };
+
+    InferenceSliceConfig config;
+    auto parsed = InferenceSliceConfig::parse(config_text("pool"), config);
+    EXPECT_TRUE(parsed.success) << parsed.result;
+    EXPECT_EQ(config.executor, "pool");
+
+    InferenceSliceConfig unknown;
+    parsed = InferenceSliceConfig::parse(config_text("fiber"), unknown);
+    EXPECT_FALSE(parsed.success);
+    EXPECT_NE(parsed.result.find("executor: < fiber > not supported"), std::string::npos) << parsed.result;
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
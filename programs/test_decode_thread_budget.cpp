@@ -0,0 +1,80 @@
+/**
+ * @file test_decode_thread_budget.cpp
+ * @brief 软件解码线程预算按分辨率在各路流之间分配，流加入和退出后重新分配
+ */
+
+#include "modules/codec/decode_video_v3.h"
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+using namespace av_wrapper;
+
+namespace {
+
+constexpr int64_t k4K = 3840 * 2160;
+constexpr int64_t k1080P = 1920 * 1080;
+constexpr int64_t k360P = 640 * 360;
+
+int used_threads(const DecodeThreadBudget &budget, const std::vector<int> &ids) {
+    return std::accumulate(ids.begin(), ids.end(), 0, [&](int sum, int id) { return sum + budget.threads(id); });
+}
+
+}// namespace
+
+TEST(DecodeThreadBudgetTest, SingleStreamCapped) {
+    DecodeThreadBudget budget(64, 16);
+    auto id = budget.add_stream(k4K);
+    EXPECT_EQ(budget.threads(id), 16);
+}
+
+TEST(DecodeThreadBudgetTest, FewHighResolutionStreams) {
+    DecodeThreadBudget budget(32);
+    std::vector<int> ids;
+    for (int i = 0; i < 4; i++) { ids.push_back(budget.add_stream(k4K)); }
+    for (auto id : ids) { EXPECT_EQ(budget.threads(id), 8); }
+}
+
+TEST(DecodeThreadBudgetTest, ManyLowResolutionStreams) {
+    DecodeThreadBudget budget(32);
+    std::vector<int> ids;
+    for (int i = 0; i < 64; i++) { ids.push_back(budget.add_stream(k360P)); }
+    for (auto id : ids) { EXPECT_EQ(budget.threads(id), 1); }
+}
+
+TEST(DecodeThreadBudgetTest, WeightedByPixels) {
+    DecodeThreadBudget budget(16);
+    auto high = budget.add_stream(k4K);
+    auto low = budget.add_stream(k1080P);
+    // 多出的 14 个线程按 4:1 分配
+    EXPECT_EQ(budget.threads(high), 1 + 14 * 4 / 5);
+    EXPECT_EQ(budget.threads(low), 1 + 14 / 5);
+    EXPECT_LE(used_threads(budget, {high, low}), 16);
+}
+
+TEST(DecodeThreadBudgetTest, RebalanceOnRemove) {
+    DecodeThreadBudget budget(16);
+    std::vector<int> ids;
+    for (int i = 0; i < 8; i++) { ids.push_back(budget.add_stream(k1080P)); }
+    EXPECT_EQ(budget.threads(ids[0]), 2);
+
+    for (int i = 1; i < 8; i++) { budget.remove_stream(ids[i]); }
+    EXPECT_EQ(budget.threads(ids[0]), 16);
+
+    budget.remove_stream(ids[0]);
+    EXPECT_EQ(budget.threads(ids[0]), 1);
+}
+
+TEST(DecodeThreadBudgetTest, SetTotalThreads) {
+    DecodeThreadBudget budget(4);
+    auto id = budget.add_stream(k1080P);
+    EXPECT_EQ(budget.threads(id), 4);
+    budget.set_total_threads(8);
+    EXPECT_EQ(budget.total_threads(), 8);
+    EXPECT_EQ(budget.threads(id), 8);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
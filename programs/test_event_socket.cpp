@@ -0,0 +1,377 @@
+/**
+ * @file test_event_socket.cpp
+ * @brief 事件磁盘队列的重放与截断恢复，以及向注入延迟和故障的本地 HTTP 服务投递，
+ *        一个接收端不可用或响应慢时不影响其他接收端
+ */
+
+#include "json.hpp"
+#include "modules/network/event_socket.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <hv/HttpServer.h>
+#include <set>
+#include <thread>
+
+using namespace gddi::network;
+
+static const int kPort = 18931;
+
+static std::string make_directory(const std::string &name) {
+    auto path = testing::TempDir() + name;
+    boost::filesystem::remove_all(path);
+    return path;
+}
+
+static EventObject make_event(int index, const std::string &url = "http://127.0.0.1/event") {
+    return EventObject{"task", std::to_string(index), url, "{\"event_id\":\"" + std::to_string(index) + "\"}"};
+}
+
+static size_t count_segments(const std::string &path) {
+    size_t count = 0;
+    for (boost::filesystem::directory_iterator iter(path), end; iter != end; ++iter) {
+        if (iter->path().extension() == ".spool") { ++count; }
+    }
+    return count;
+}
+
+/**
+ * @brief 依次出队并检查 event_id 连续
+ */
+static void expect_sequence(EventSpool &spool, int first, int last, size_t batch) {
+    std::vector<EventObject> events;
+    std::vector<uint64_t> ids;
+    int expected = first;
+    while (spool.front(events, ids, batch, 1 << 20) > 0) {
+        for (const auto &event : events) { ASSERT_EQ(event.event_id, std::to_string(expected++)); }
+        spool.ack(ids);
+    }
+    EXPECT_EQ(expected, last);
+    EXPECT_EQ(spool.size(), 0u);
+}
+
+TEST(EventSpoolTest, Replay) {
+    auto path = make_directory("event_spool_replay");
+    {
+        EventSpool spool({path, 1024, 16});
+        ASSERT_TRUE(spool.persistent());
+        for (int i = 0; i < 100; i++) { ASSERT_TRUE(spool.append(make_event(i))); }
+
+        std::vector<EventObject> events;
+        std::vector<uint64_t> ids;
+        ASSERT_EQ(spool.front(events, ids, 40, 1 << 20), 16);
+        spool.ack(ids);
+        ASSERT_EQ(spool.front(events, ids, 24, 1 << 20), 16);
+        spool.ack(ids);
+        ASSERT_EQ(spool.front(events, ids, 8, 1 << 20), 8);
+        spool.ack(ids);
+        EXPECT_EQ(spool.size(), 60);
+        EXPECT_GT(count_segments(path), 1);
+    }
+
+    // 重启后从第 40 条开始，全部确认后只剩当前写入段
+    EventSpool spool({path, 1024, 16});
+    EXPECT_EQ(spool.size(), 60);
+    expect_sequence(spool, 40, 100, 7);
+    EXPECT_EQ(count_segments(path), 1);
+}
+
+TEST(EventSpoolTest, TornTail) {
+    auto path = make_directory("event_spool_torn");
+    std::string last_segment;
+    {
+        EventSpool spool({path});
+        for (int i = 0; i < 10; i++) { spool.append(make_event(i)); }
+    }
+    for (boost::filesystem::directory_iterator iter(path), end; iter != end; ++iter) {
+        if (iter->path().extension() == ".spool" && boost::filesystem::file_size(iter->path()) > 0) {
+            last_segment = iter->path().string();
+        }
+    }
+    ASSERT_FALSE(last_segment.empty());
+
+    // 模拟写入一半时崩溃
+    auto record = make_event(10);
+    std::ofstream(last_segment, std::ios::binary | std::ios::app) << "GEVT" << std::string(20, '\x7f');
+
+    {
+        EventSpool spool({path});
+        EXPECT_EQ(spool.size(), 10);
+        spool.append(record);
+    }
+
+    // ack 损坏时从头重放
+    std::ofstream(path + "/ack", std::ios::binary | std::ios::trunc) << "broken";
+    EventSpool spool({path});
+    expect_sequence(spool, 0, 11, 4);
+}
+
+TEST(EventSpoolTest, Batch) {
+    auto path = make_directory("event_spool_batch");
+    EventSpool spool({path, 4 << 20, 64});
+    for (int i = 0; i < 10; i++) { spool.append(make_event(i, i < 6 ? "http://a/event" : "http://b/event")); }
+
+    // 只取同一 url 的事件，超过字节上限时截断，至少返回一条
+    std::vector<EventObject> events;
+    std::vector<uint64_t> ids;
+    EXPECT_EQ(spool.front(events, ids, 32, 1 << 20), 6);
+    EXPECT_EQ(spool.front(events, ids, 4, 1 << 20), 4);
+    EXPECT_EQ(spool.front(events, ids, 32, 1), 1);
+    spool.front(events, ids, 32, 1 << 20);
+    spool.ack(ids);
+    EXPECT_EQ(spool.front(events, ids, 32, 1 << 20), 4);
+    EXPECT_EQ(events.front().url, "http://b/event");
+}
+
+TEST(EventSpoolTest, SkipUrl) {
+    auto path = make_directory("event_spool_skip");
+    {
+        EventSpool spool({path, 4 << 20, 64});
+        for (int i = 0; i < 10; i++) { spool.append(make_event(i, i % 2 ? "http://b/event" : "http://a/event")); }
+
+        // a 在退避中时先投递 b，b 内部保持顺序
+        std::vector<EventObject> events;
+        std::vector<uint64_t> ids;
+        ASSERT_EQ(spool.front(events, ids, 32, 1 << 20, {"http://a/event"}), 5);
+        for (int i = 0; i < 5; i++) { EXPECT_EQ(events[i].event_id, std::to_string(i * 2 + 1)); }
+        spool.ack(ids);
+        EXPECT_EQ(spool.size(), 5);
+        EXPECT_EQ(spool.front(events, ids, 32, 1 << 20, {"http://a/event"}), 0);
+
+        ASSERT_EQ(spool.front(events, ids, 2, 1 << 20), 2);
+        EXPECT_EQ(events[0].event_id, "0");
+        EXPECT_EQ(events[1].event_id, "2");
+        spool.ack(ids);
+    }
+
+    // ack 文件只推进到连续确认的位置，重启后从 4 开始重放，其中已确认的 b 事件重发
+    EventSpool spool({path, 4 << 20, 64});
+    EXPECT_EQ(spool.size(), 6);
+    EXPECT_EQ(spool.ack_url("http://b/event"), 3);
+    std::vector<EventObject> events;
+    std::vector<uint64_t> ids;
+    ASSERT_EQ(spool.front(events, ids, 32, 1 << 20), 3);
+    for (int i = 0; i < 3; i++) { EXPECT_EQ(events[i].event_id, std::to_string(i * 2 + 4)); }
+    spool.ack(ids);
+    EXPECT_EQ(spool.size(), 0);
+}
+
+TEST(EventSpoolTest, DeadHead) {
+    auto path = make_directory("event_spool_dead_head");
+    EventSpool spool({path, 4 << 20, 16});
+    for (int i = 0; i < 40; i++) { spool.append(make_event(i, "http://a/event")); }
+    for (int i = 40; i < 140; i++) { spool.append(make_event(i, "http://b/event")); }
+
+    // a 的事件占满窗口且在退避中，继续向后读取 b 的事件，a 只记录位置
+    std::vector<EventObject> events;
+    std::vector<uint64_t> ids;
+    int expected = 40;
+    while (spool.front(events, ids, 8, 1 << 20, {"http://a/event"}) > 0) {
+        for (const auto &event : events) {
+            ASSERT_EQ(event.url, "http://b/event");
+            ASSERT_EQ(event.event_id, std::to_string(expected++));
+        }
+        spool.ack(ids);
+    }
+    EXPECT_EQ(expected, 140);
+    EXPECT_EQ(spool.size(), 40);
+
+    // a 恢复后从磁盘读回只记录位置的事件
+    expect_sequence(spool, 0, 40, 16);
+    EXPECT_EQ(count_segments(path), 1);
+}
+
+TEST(EventSpoolTest, MemoryOnly) {
+    EventSpool spool({"", 0, 4});
+    EXPECT_FALSE(spool.persistent());
+    for (int i = 0; i < 10; i++) { spool.append(make_event(i)); }
+    EXPECT_EQ(spool.size(), 4);
+    expect_sequence(spool, 6, 10, 3);
+}
+
+/**
+ * @brief 本地事件接收服务，可注入延迟和 503
+ */
+class StandInServer {
+public:
+    explicit StandInServer(int port = kPort) {
+        router_.POST("/event", [this](HttpRequest *req, HttpResponse *resp) { return on_event(req, resp); });
+        server_.service = &router_;
+        server_.port = port;
+        server_.worker_threads = 2;
+        http_server_run(&server_, 0);
+    }
+    ~StandInServer() { http_server_stop(&server_); }
+
+    size_t received() {
+        std::lock_guard<std::mutex> glk(mutex_);
+        return event_ids_.size();
+    }
+
+    std::atomic_int latency_ms{0};
+    std::atomic_int fail_every{0};
+    std::atomic_int requests{0};
+
+private:
+    int on_event(HttpRequest *req, HttpResponse *resp) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(latency_ms));
+        if (fail_every > 0 && ++requests % fail_every == 0) { return HTTP_STATUS_SERVICE_UNAVAILABLE; }
+
+        auto body = nlohmann::json::parse(req->body);
+        if (!body.is_array()) { body = nlohmann::json::array({body}); }
+        if (req->GetHeader("X-Event-Count", "1") != std::to_string(body.size())) { return HTTP_STATUS_BAD_REQUEST; }
+
+        std::lock_guard<std::mutex> glk(mutex_);
+        for (const auto &event : body) { event_ids_.insert(event["event_id"].get<std::string>()); }
+        return HTTP_STATUS_OK;
+    }
+
+    HttpService router_;
+    http_server_t server_;
+    std::mutex mutex_;
+    std::set<std::string> event_ids_;
+};
+
+static EventSocket::Options socket_options(const std::string &path) {
+    EventSocket::Options options;
+    options.spool_directory = path;
+    options.window = 256;
+    options.max_batch = 64;
+    options.min_backoff = std::chrono::milliseconds(20);
+    options.max_backoff = std::chrono::milliseconds(500);
+    return options;
+}
+
+static bool wait_received(StandInServer &server, size_t count, std::chrono::seconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (server.received() < count) {
+        if (std::chrono::steady_clock::now() > deadline) { return false; }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+TEST(EventSocketTest, Throughput) {
+    const int count = 20000;
+    const std::string url = "http://127.0.0.1:" + std::to_string(kPort) + "/event";
+    StandInServer server;
+    server.latency_ms = 2;
+    server.fail_every = 7;
+
+    EventSocket socket(socket_options(make_directory("event_socket_throughput")));
+    auto time_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) { socket.post_sync("task", std::to_string(i), url, make_event(i).buffer); }
+    auto post_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+
+    ASSERT_TRUE(wait_received(server, count, std::chrono::seconds(120)));
+    auto time_used = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+
+    auto stats = socket.stats();
+    printf("post %.0f events/s, delivered %.0f events/s, %llu requests, %llu failures\n", count / post_time,
+           count / time_used, (unsigned long long)stats.requests, (unsigned long long)stats.failures);
+    EXPECT_GT(stats.failures, 0u);
+    EXPECT_LT(stats.requests, count / 4u);
+}
+
+TEST(EventSocketTest, Recovery) {
+    const int count = 2000;
+    const std::string url = "http://127.0.0.1:" + std::to_string(kPort) + "/event";
+    auto path = make_directory("event_socket_recovery");
+
+    // 接收端不可用时进程重启，事件留在磁盘上
+    {
+        EventSocket socket(socket_options(path));
+        for (int i = 0; i < count; i++) { socket.post_sync("task", std::to_string(i), url, make_event(i).buffer); }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        EXPECT_EQ(socket.pending(), (size_t)count);
+        EXPECT_GT(socket.stats().failures, 0u);
+    }
+
+    StandInServer server;
+    server.latency_ms = 5;
+    auto time_start = std::chrono::steady_clock::now();
+    EventSocket socket(socket_options(path));
+    ASSERT_TRUE(wait_received(server, count, std::chrono::seconds(60)));
+    auto time_used = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+    printf("replayed %d events in %.3f s after restart\n", count, time_used);
+
+    for (int i = 0; i < 100 && socket.pending() > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(socket.pending(), 0u);
+}
+
+TEST(EventSocketTest, BatchOptIn) {
+    const int count = 200;
+    const std::string url = "http://127.0.0.1:" + std::to_string(kPort) + "/event";
+    StandInServer server;
+    server.latency_ms = 2;
+
+    // 默认每个事件一个请求
+    auto options = socket_options(make_directory("event_socket_batch"));
+    options.max_batch = 1;
+    EventSocket socket(options);
+    for (int i = 0; i < count; i++) { socket.post_sync("task", std::to_string(i), url, make_event(i).buffer); }
+    ASSERT_TRUE(wait_received(server, count, std::chrono::seconds(10)));
+    EXPECT_EQ(socket.stats().requests, (uint64_t)count);
+
+    // 按 url 开启合并
+    socket.set_max_batch(url, 64);
+    for (int i = count; i < count * 2; i++) {
+        socket.post_sync("task", std::to_string(i), url, make_event(i).buffer);
+    }
+    ASSERT_TRUE(wait_received(server, count * 2, std::chrono::seconds(10)));
+    EXPECT_LT(socket.stats().requests, count * 3 / 2u);
+}
+
+TEST(EventSocketTest, DeadReceiver) {
+    const std::string live_url = "http://127.0.0.1:" + std::to_string(kPort) + "/event";
+    const std::string dead_url = "http://127.0.0.1:" + std::to_string(kPort + 1) + "/event";
+    StandInServer server;
+
+    // 不可用的接收端在退避中，其事件超过窗口大小时也不阻塞其后发往其他 url 的事件
+    auto options = socket_options(make_directory("event_socket_dead"));
+    options.max_retry_age = std::chrono::seconds(2);
+    EventSocket socket(options);
+    const int dead_count = options.window + 44;
+    const int live_count = options.window * 4;
+    for (int i = 0; i < dead_count; i++) {
+        socket.post_sync("task", std::to_string(i), dead_url, make_event(i).buffer);
+    }
+    for (int i = dead_count; i < dead_count + live_count; i++) {
+        socket.post_sync("task", std::to_string(i), live_url, make_event(i).buffer);
+    }
+    ASSERT_TRUE(wait_received(server, live_count, std::chrono::seconds(1)));
+    for (int i = 0; i < 100 && socket.pending() > (size_t)dead_count; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(socket.pending(), (size_t)dead_count);
+
+    // 持续失败超过 max_retry_age 后丢弃
+    for (int i = 0; i < 500 && socket.stats().dropped < (uint64_t)dead_count; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(socket.stats().dropped, (uint64_t)dead_count);
+    EXPECT_EQ(socket.pending(), 0u);
+}
+
+TEST(EventSocketTest, SlowReceiver) {
+    const std::string live_url = "http://127.0.0.1:" + std::to_string(kPort) + "/event";
+    const std::string slow_url = "http://127.0.0.1:" + std::to_string(kPort + 2) + "/event";
+    StandInServer server;
+    StandInServer slow_server(kPort + 2);
+    slow_server.latency_ms = 2000;
+
+    // 慢的接收端只占用一个发送线程，其他 url 的事件照常投递
+    EventSocket socket(socket_options(make_directory("event_socket_slow")));
+    socket.post_sync("task", "0", slow_url, make_event(0).buffer);
+    for (int i = 1; i <= 100; i++) { socket.post_sync("task", std::to_string(i), live_url, make_event(i).buffer); }
+    ASSERT_TRUE(wait_received(server, 100, std::chrono::seconds(1)));
+    EXPECT_EQ(slow_server.received(), 0u);
+    ASSERT_TRUE(wait_received(slow_server, 1, std::chrono::seconds(5)));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,175 @@
+/**
+ * @file test_feature_index.cpp
+ * @brief 特征库 HNSW 索引的检索、增删和文件读写
+ */
+
+#include "modules/algorithm/feature_index.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace gddi::algo;
+
+static const uint32_t kDim = 512;
+
+static std::vector<float> make_features(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> normal;
+    std::vector<float> features(count * kDim);
+    for (auto &value : features) { value = normal(rng); }
+    return features;
+}
+
+static float scalar_cosine(const float *a, const float *b) {
+    double dot = 0, norm_a = 0, norm_b = 0;
+    for (uint32_t i = 0; i < kDim; i++) {
+        dot += a[i] * b[i];
+        norm_a += a[i] * a[i];
+        norm_b += b[i] * b[i];
+    }
+    return dot / std::sqrt(norm_a * norm_b);
+}
+
+TEST(FeatureIndexTest, Dot) {
+    auto features = make_features(2, 1);
+    for (size_t dim : {1, 7, 8, 15, 16, 100, 512}) {
+        float expected = 0;
+        for (size_t i = 0; i < dim; i++) { expected += features[i] * features[kDim + i]; }
+        EXPECT_NEAR(feature_dot(features.data(), features.data() + kDim, dim), expected, 1e-3);
+    }
+}
+
+TEST(FeatureIndexTest, Search) {
+    const size_t count = 2000;
+    auto features = make_features(count, 2);
+
+    FeatureIndex index(kDim);
+    for (size_t i = 0; i < count; i++) { index.add(i, features.data() + i * kDim); }
+    EXPECT_EQ(index.size(), count);
+
+    // 库内特征加少量噪声后应找回自身
+    auto noise = make_features(100, 3);
+    size_t hits = 0;
+    for (size_t i = 0; i < 100; i++) {
+        std::vector<float> query(features.begin() + i * 17 * kDim, features.begin() + (i * 17 + 1) * kDim);
+        for (uint32_t j = 0; j < kDim; j++) { query[j] += noise[i * kDim + j] * 0.3f; }
+
+        auto results = index.search(query.data(), 5);
+        ASSERT_EQ(results.size(), 5);
+        EXPECT_GE(results[0].similarity, results[4].similarity);
+        if (results[0].label == i * 17) {
+            ++hits;
+            EXPECT_NEAR(results[0].similarity, scalar_cosine(query.data(), features.data() + i * 17 * kDim), 1e-4);
+        }
+    }
+    EXPECT_GE(hits, 98);
+}
+
+TEST(FeatureIndexTest, Update) {
+    const size_t count = 500;
+    auto features = make_features(count, 4);
+
+    FeatureIndex index(kDim);
+    for (size_t i = 0; i < count; i++) { index.add(i, features.data() + i * kDim); }
+
+    EXPECT_TRUE(index.remove(10));
+    EXPECT_FALSE(index.remove(10));
+    EXPECT_FALSE(index.contains(10));
+    EXPECT_NE(index.search(features.data() + 10 * kDim, 1)[0].label, 10);
+
+    // 替换已有 label 的特征
+    index.add(20, features.data() + 30 * kDim);
+    EXPECT_EQ(index.size(), count - 1);
+    auto results = index.search(features.data() + 30 * kDim, 2);
+    EXPECT_NEAR(results[0].similarity, 1, 1e-4);
+    EXPECT_NEAR(results[1].similarity, 1, 1e-4);
+
+    // 删除超过 1/4 后重建，剩余特征仍可检索
+    for (size_t i = 100; i < 300; i++) { index.remove(i); }
+    EXPECT_EQ(index.size(), count - 201);
+    EXPECT_EQ(index.search(features.data() + 400 * kDim, 1)[0].label, 400);
+
+    // label 整体前移一位，0 删除
+    std::vector<uint32_t> labels(count, FeatureIndex::kInvalidLabel);
+    for (size_t i = 1; i < count; i++) { labels[i] = i - 1; }
+    index.relabel(labels);
+    EXPECT_FALSE(index.contains(499));
+    EXPECT_EQ(index.search(features.data() + 400 * kDim, 1)[0].label, 399);
+}
+
+TEST(FeatureIndexTest, SaveLoad) {
+    const size_t count = 300;
+    auto features = make_features(count, 5);
+    auto path = testing::TempDir() + "test_feature_index.idx";
+
+    {
+        FeatureIndex index(kDim);
+        for (size_t i = 0; i < count; i++) { index.add(i * 2, features.data() + i * kDim); }
+        index.remove(0);
+        ASSERT_TRUE(index.save(path));
+    }
+
+    FeatureIndex index(kDim);
+    ASSERT_TRUE(index.load(path));
+    EXPECT_EQ(index.size(), count - 1);
+    EXPECT_EQ(index.search(features.data() + 100 * kDim, 1)[0].label, 200);
+
+    // 修改 mmap 的索引不影响文件
+    index.add(1, features.data());
+    EXPECT_EQ(index.search(features.data(), 1)[0].label, 1);
+
+    FeatureIndex reload(kDim);
+    ASSERT_TRUE(reload.load(path));
+    EXPECT_FALSE(reload.contains(1));
+
+    FeatureIndex other_dim(128);
+    EXPECT_FALSE(other_dim.load(path));
+    EXPECT_FALSE(other_dim.load(path + ".missing"));
+
+    std::remove(path.c_str());
+}
+
+TEST(FeatureIndexTest, LoadCorrupted) {
+    const size_t count = 50;
+    const uint32_t m = 16;
+    auto features = make_features(count, 6);
+    auto path = testing::TempDir() + "test_feature_index_corrupted.idx";
+
+    FeatureIndex index(kDim, m);
+    for (size_t i = 0; i < count; i++) { index.add(i, features.data() + i * kDim); }
+    ASSERT_TRUE(index.save(path));
+
+    // 文件头之后依次为 vectors、labels、levels、links0、upper_offsets、upper
+    const size_t links0_pos = 64 + count * kDim * sizeof(float) + count * 2 * sizeof(uint32_t);
+    const size_t upper_offsets_pos = links0_pos + count * (1 + m * 2) * sizeof(uint32_t);
+    auto load_patched = [&](size_t pos, uint32_t value) {
+        auto patched = path + ".patched";
+        {
+            std::ifstream src(path, std::ios::binary);
+            std::ofstream dst(patched, std::ios::binary | std::ios::trunc);
+            dst << src.rdbuf();
+            dst.seekp(pos);
+            dst.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+        FeatureIndex loaded(kDim, m);
+        bool ok = loaded.load(patched);
+        if (!ok) { EXPECT_EQ(loaded.size(), 0); }
+        std::remove(patched.c_str());
+        return ok;
+    };
+
+    EXPECT_TRUE(load_patched(links0_pos + sizeof(uint32_t), 1));
+    // 邻居编号越界、邻居数超过上限、上层链接偏移超出文件
+    EXPECT_FALSE(load_patched(links0_pos + sizeof(uint32_t), count));
+    EXPECT_FALSE(load_patched(links0_pos, m * 2 + 1));
+    EXPECT_FALSE(load_patched(upper_offsets_pos, UINT32_MAX - 4));
+
+    std::remove(path.c_str());
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
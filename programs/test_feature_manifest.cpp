@@ -0,0 +1,145 @@
+/**
+ * @file test_feature_manifest.cpp
+ * @brief 特征库图片清单的读写、未变化文件的判断，以及截断、损坏的清单整体作废
+ */
+
+#include "modules/algorithm/feature_manifest.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <unistd.h>
+#include <vector>
+
+using namespace gddi::algo;
+
+namespace {
+
+class FeatureManifestTest : public testing::Test {
+protected:
+    void SetUp() override {
+        path_ = testing::TempDir() + "features.manifest." + std::to_string(getpid());
+        for (int i = 0; i < 3; i++) {
+            FeatureManifest::Entry entry;
+            entry.size = 1000 + i;
+            entry.mtime = 1700000000 + i;
+            for (int j = 0; j < 32; j++) { entry.sha256[j] = i * 32 + j; }
+            manifest_.entries()["person" + std::to_string(i) + "/face.jpg"] = entry;
+        }
+    }
+
+    void TearDown() override { remove(path_.c_str()); }
+
+    std::vector<char> read_file() {
+        std::ifstream ifs(path_, std::ios::binary);
+        return {std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    }
+
+    void write_file(const std::vector<char> &data) {
+        std::ofstream ofs(path_, std::ios::binary | std::ios::trunc);
+        ofs.write(data.data(), data.size());
+    }
+
+    std::string path_;
+    FeatureManifest manifest_;
+};
+
+}// namespace
+
+TEST_F(FeatureManifestTest, RoundTrip) {
+    ASSERT_TRUE(manifest_.save(path_));
+
+    FeatureManifest loaded;
+    ASSERT_TRUE(loaded.load(path_));
+    ASSERT_EQ(loaded.entries().size(), manifest_.entries().size());
+    for (const auto &[path, entry] : manifest_.entries()) {
+        auto iter = loaded.entries().find(path);
+        ASSERT_NE(iter, loaded.entries().end());
+        EXPECT_EQ(memcmp(&iter->second, &entry, sizeof(entry)), 0);
+    }
+}
+
+TEST_F(FeatureManifestTest, FindUnchanged) {
+    ASSERT_TRUE(manifest_.save(path_));
+    FeatureManifest loaded;
+    ASSERT_TRUE(loaded.load(path_));
+
+    auto unchanged = loaded.find_unchanged("person1/face.jpg", 1001, 1700000001);
+    ASSERT_NE(unchanged, nullptr);
+    EXPECT_EQ(unchanged->sha256[0], 32);
+
+    EXPECT_EQ(loaded.find_unchanged("person1/face.jpg", 1002, 1700000001), nullptr);
+    EXPECT_EQ(loaded.find_unchanged("person1/face.jpg", 1001, 1700000002), nullptr);
+    EXPECT_EQ(loaded.find_unchanged("person3/face.jpg", 1001, 1700000001), nullptr);
+}
+
+TEST_F(FeatureManifestTest, MissingFile) {
+    FeatureManifest loaded;
+    loaded.entries() = manifest_.entries();
+    EXPECT_FALSE(loaded.load(path_));
+    EXPECT_TRUE(loaded.entries().empty());
+}
+
+TEST_F(FeatureManifestTest, TruncatedFile) {
+    ASSERT_TRUE(manifest_.save(path_));
+    auto data = read_file();
+
+    // 任意位置截断都整体作废，不保留前面完整的记录
+    for (size_t size : {size_t(0), size_t(3), size_t(20), data.size() / 2, data.size() - 1}) {
+        write_file({data.begin(), data.begin() + size});
+        FeatureManifest loaded;
+        EXPECT_FALSE(loaded.load(path_)) << size;
+        EXPECT_TRUE(loaded.entries().empty()) << size;
+    }
+}
+
+TEST_F(FeatureManifestTest, CorruptFile) {
+    ASSERT_TRUE(manifest_.save(path_));
+    auto data = read_file();
+    data[data.size() / 2] ^= 0x5a;
+    write_file(data);
+
+    FeatureManifest loaded;
+    EXPECT_FALSE(loaded.load(path_));
+    EXPECT_TRUE(loaded.entries().empty());
+}
+
+TEST_F(FeatureManifestTest, HugePathSize) {
+    FeatureManifest single;
+    single.entries()["a.jpg"] = manifest_.entries().begin()->second;
+    ASSERT_TRUE(single.save(path_));
+    auto data = read_file();
+
+    // 路径长度改为 4G 并重算校验和，读取时不能按该长度分配内存
+    const size_t path_size_offset = 4 + 8 + sizeof(FeatureManifest::Entry);
+    uint32_t path_size = 0xffffffff;
+    memcpy(data.data() + path_size_offset, &path_size, sizeof(path_size));
+    uint64_t checksum = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < data.size() - sizeof(checksum); i++) {
+        checksum ^= static_cast<uint8_t>(data[i]);
+        checksum *= 0x100000001b3ULL;
+    }
+    memcpy(data.data() + data.size() - sizeof(checksum), &checksum, sizeof(checksum));
+    write_file(data);
+
+    FeatureManifest loaded;
+    EXPECT_FALSE(loaded.load(path_));
+    EXPECT_TRUE(loaded.entries().empty());
+}
+
+TEST_F(FeatureManifestTest, VersionMismatch) {
+    ASSERT_TRUE(manifest_.save(path_));
+    auto data = read_file();
+    data[0] = 1;
+    write_file(data);
+
+    FeatureManifest loaded;
+    EXPECT_FALSE(loaded.load(path_));
+    EXPECT_TRUE(loaded.entries().empty());
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
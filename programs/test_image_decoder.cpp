@@ -0,0 +1,151 @@
+/**
+ * @file test_image_decoder.cpp
+ * @brief JPEG/PNG 解码为池化 NV12，JPEG 在 DCT 域缩小
+ */
+
+#include "modules/wrapper/image_decoder.h"
+#include "modules/wrapper/jpeg_encoder.h"
+#include <cstdlib>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#if defined(WITH_LIBPNG)
+#include <png.h>
+#endif
+
+using namespace gddi;
+
+// 水平渐变，缩小后仍能比较像素
+static std::shared_ptr<AVFrame> make_frame(AVPixelFormat format, int width, int height) {
+    auto frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    frame->format = format;
+    frame->width = width;
+    frame->height = height;
+    av_frame_get_buffer(frame.get(), 32);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) { frame->data[0][y * frame->linesize[0] + x] = 16 + x * 200 / width; }
+    }
+    int planes = format == AV_PIX_FMT_NV12 ? 2 : 3;
+    for (int i = 1; i < planes; i++) {
+        for (int y = 0; y < (height + 1) / 2; y++) {
+            memset(frame->data[i] + y * frame->linesize[i], 128, frame->linesize[i]);
+        }
+    }
+    return frame;
+}
+
+static std::vector<uint8_t> make_jpeg(AVPixelFormat format, int width, int height) {
+    return codec::JpegEncodePool::get_instance().encode(make_frame(format, width, height), 95).get();
+}
+
+class ImageDecoderTest : public testing::Test {
+protected:
+    void SetUp() override {
+        if (!image_wrapper::image_jpeg_dec_available() || !codec::JpegEncodePool::available()) {
+            GTEST_SKIP() << "built without libjpeg-turbo";
+        }
+    }
+
+    ImagePool mem_pool_;
+};
+
+TEST_F(ImageDecoderTest, JpegFullSize) {
+    auto jpeg = make_jpeg(AV_PIX_FMT_NV12, 1920, 1080);
+
+    int src_width = 0, src_height = 0;
+    auto mem_obj = image_wrapper::image_jpeg_dec(mem_pool_, jpeg.data(), jpeg.size(), 0, 0, &src_width, &src_height);
+    const auto &frame = mem_obj->data;
+    ASSERT_EQ(frame->format, AV_PIX_FMT_NV12);
+    EXPECT_EQ(frame->width, 1920);
+    EXPECT_EQ(frame->height, 1080);
+    EXPECT_EQ(src_width, 1920);
+    EXPECT_EQ(src_height, 1080);
+
+    for (int x : {0, 480, 960, 1440, 1900}) {
+        EXPECT_NEAR(frame->data[0][540 * frame->linesize[0] + x], 16 + x * 200 / 1920, 3);
+    }
+    EXPECT_NEAR(frame->data[1][270 * frame->linesize[1] + 480], 128, 3);
+}
+
+TEST_F(ImageDecoderTest, JpegDctScaling) {
+    auto jpeg = make_jpeg(AV_PIX_FMT_NV12, 1920, 1080);
+
+    // 取按比例缩放到目标尺寸时不需要放大的最小系数
+    const int expected[][3] = {{1280, 1920, 1080}, {640, 960, 540}, {320, 480, 270}, {100, 240, 135}};
+    for (const auto &item : expected) {
+        int src_width = 0, src_height = 0;
+        auto mem_obj = image_wrapper::image_jpeg_dec(mem_pool_, jpeg.data(), jpeg.size(), item[0], item[0],
+                                                     &src_width, &src_height);
+        EXPECT_EQ(mem_obj->data->width, item[1]) << "fit " << item[0];
+        EXPECT_EQ(mem_obj->data->height, item[2]) << "fit " << item[0];
+        EXPECT_EQ(src_width, 1920);
+        EXPECT_EQ(src_height, 1080);
+    }
+
+    auto mem_obj = image_wrapper::image_jpeg_dec(mem_pool_, jpeg.data(), jpeg.size(), 640, 640);
+    const auto &frame = mem_obj->data;
+    for (int x : {0, 240, 480, 720, 950}) {
+        EXPECT_NEAR(frame->data[0][270 * frame->linesize[0] + x], 16 + x * 2 * 200 / 1920, 4);
+    }
+}
+
+TEST_F(ImageDecoderTest, JpegOddSize) {
+    auto jpeg = make_jpeg(AV_PIX_FMT_YUV420P, 641, 359);
+
+    auto mem_obj = image_wrapper::image_jpeg_dec(mem_pool_, jpeg.data(), jpeg.size());
+    EXPECT_EQ(mem_obj->data->format, AV_PIX_FMT_NV12);
+    EXPECT_EQ(mem_obj->data->width, 641);
+    EXPECT_EQ(mem_obj->data->height, 359);
+}
+
+TEST_F(ImageDecoderTest, PoolReuse) {
+    auto jpeg = make_jpeg(AV_PIX_FMT_NV12, 1280, 720);
+
+    auto mem_obj = image_wrapper::image_jpeg_dec(mem_pool_, jpeg.data(), jpeg.size(), 640, 640);
+    auto buffer = mem_obj->data->data[0];
+    mem_obj.reset();
+
+    // 同尺寸再次解码复用释放的帧
+    mem_obj = image_wrapper::image_jpeg_dec(mem_pool_, jpeg.data(), jpeg.size(), 640, 640);
+    EXPECT_EQ(mem_obj->data->data[0], buffer);
+}
+
+TEST_F(ImageDecoderTest, InvalidData) {
+    std::vector<uint8_t> data{0xFF, 0xD8, 0x00, 0x01, 0x02};
+    EXPECT_THROW(image_wrapper::image_jpeg_dec(mem_pool_, data.data(), data.size()), std::runtime_error);
+}
+
+#if defined(WITH_LIBPNG)
+TEST(ImagePngDecoderTest, DecodeRgb) {
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    image.width = 320;
+    image.height = 240;
+    image.format = PNG_FORMAT_RGB;
+    std::vector<uint8_t> rgb(320 * 240 * 3, 128);
+
+    png_alloc_size_t png_size = 0;
+    ASSERT_TRUE(png_image_write_to_memory(&image, nullptr, &png_size, 0, rgb.data(), 0, nullptr));
+    std::vector<uint8_t> png(png_size);
+    ASSERT_TRUE(png_image_write_to_memory(&image, png.data(), &png_size, 0, rgb.data(), 0, nullptr));
+
+    ImagePool mem_pool;
+    auto mem_obj = image_wrapper::image_png_dec(mem_pool, png.data(), png.size());
+    const auto &frame = mem_obj->data;
+    ASSERT_EQ(frame->format, AV_PIX_FMT_NV12);
+    EXPECT_EQ(frame->width, 320);
+    EXPECT_EQ(frame->height, 240);
+    EXPECT_NEAR(frame->data[1][60 * frame->linesize[1] + 160], 128, 2);
+
+    std::vector<uint8_t> data{0x89, 0x50, 0x4E, 0x47};
+    EXPECT_THROW(image_wrapper::image_png_dec(mem_pool, data.data(), data.size()), std::runtime_error);
+}
+#endif
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
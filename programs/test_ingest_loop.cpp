@@ -0,0 +1,303 @@
+/**
+ * @file test_ingest_loop.cpp
+ * @brief 共享读取线程的调度、移除、阻塞补偿 (大量阻塞任务同时启动) 和阻塞任务的线程上限，以及重连退避的增长、重置和随机错开
+ */
+
+#include "modules/codec/ingest_loop.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+
+using namespace av_wrapper;
+using namespace std::chrono_literals;
+
+namespace {
+
+template<typename Pred>
+bool wait_until(Pred pred, std::chrono::milliseconds timeout = 5000ms) {
+    auto deadline = IngestClock::now() + timeout;
+    while (!pred()) {
+        if (IngestClock::now() > deadline) { return false; }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+// 每步读取一个"包"，间隔 interval，读完 count 个后结束
+class CountingTask : public IngestTask {
+public:
+    CountingTask(int count, std::chrono::milliseconds interval) : count_(count), interval_(interval) {}
+
+    bool step(IngestClock::time_point &next) override {
+        if (running_.exchange(true)) { concurrent_ = true; }
+        next += interval_;
+        auto keep = ++steps_ < count_;
+        running_ = false;
+        return keep;
+    }
+
+    std::atomic_int steps_{0};
+    std::atomic_bool concurrent_{false};
+
+private:
+    int count_;
+    std::chrono::milliseconds interval_;
+    std::atomic_bool running_{false};
+};
+
+class BlockingTask : public IngestTask {
+public:
+    explicit BlockingTask(std::chrono::milliseconds duration) : duration_(duration) {}
+
+    bool step(IngestClock::time_point &next) override {
+        entered_ = true;
+        std::this_thread::sleep_for(duration_);
+        ++steps_;
+        next += 1ms;
+        return true;
+    }
+
+    std::atomic_bool entered_{false};
+    std::atomic_int steps_{0};
+
+private:
+    std::chrono::milliseconds duration_;
+};
+
+// 模拟摄像头: 所有流在同一时刻断开，之后按退避时间重连
+class FlakyStream : public IngestTask {
+public:
+    FlakyStream(const BackoffOptions &options, uint32_t seed, const std::atomic_bool &network_down)
+        : backoff_(options, seed), network_down_(network_down) {}
+
+    bool step(IngestClock::time_point &next) override {
+        if (!connected_) {
+            if (network_down_) {
+                next += backoff_.next_delay(next);
+                return true;
+            }
+            connected_ = true;
+            backoff_.on_connected(next);
+            if (dropped_) { reconnect_time_ = next; }
+            return true;
+        }
+        if (network_down_) {
+            connected_ = false;
+            dropped_ = true;
+            next += backoff_.next_delay(next);
+            return true;
+        }
+        next += 5ms;
+        return true;
+    }
+
+    std::atomic_bool connected_{false};
+    bool dropped_{false};
+    IngestClock::time_point reconnect_time_;
+
+private:
+    ReconnectBackoff backoff_;
+    const std::atomic_bool &network_down_;
+};
+
+}// namespace
+
+TEST(IngestLoopTest, BackoffGrowth) {
+    BackoffOptions options;
+    options.base = 100ms;
+    options.max = 1000ms;
+    options.jitter = 0.5;
+    options.reset_after = 10000ms;
+    ReconnectBackoff backoff(options, 1);
+
+    auto now = IngestClock::now();
+    std::vector<int64_t> expected{100, 200, 400, 800, 1000, 1000};
+    for (auto value : expected) {
+        auto delay = backoff.next_delay(now).count();
+        EXPECT_GE(delay, value / 2);
+        EXPECT_LE(delay, value * 3 / 2);
+    }
+    EXPECT_EQ(backoff.attempts(), 6);
+
+    // 连接保持时间不足时继续增长，足够长后从 base 重新开始
+    backoff.on_connected(now);
+    backoff.next_delay(now + 1000ms);
+    EXPECT_EQ(backoff.attempts(), 7);
+    backoff.on_connected(now);
+    auto delay = backoff.next_delay(now + 10000ms).count();
+    EXPECT_EQ(backoff.attempts(), 1);
+    EXPECT_LE(delay, 150);
+}
+
+TEST(IngestLoopTest, BackoffJitter) {
+    // 同时断开的各路流重连时间被错开
+    std::vector<int64_t> delays;
+    for (uint32_t seed = 1; seed <= 64; seed++) {
+        ReconnectBackoff backoff(BackoffOptions{}, seed);
+        delays.push_back(backoff.next_delay(IngestClock::now()).count());
+    }
+    auto [min, max] = std::minmax_element(delays.begin(), delays.end());
+    EXPECT_GE(*min, 250);
+    EXPECT_LT(*max, 750);
+    EXPECT_GT(*max - *min, 200);
+}
+
+TEST(IngestLoopTest, ManyTasksFewThreads) {
+    IngestLoopOptions options;
+    options.threads = 2;
+    IngestLoop loop("test", options);
+
+    std::vector<std::unique_ptr<CountingTask>> tasks;
+    for (int i = 0; i < 64; i++) {
+        tasks.emplace_back(std::make_unique<CountingTask>(20, 1ms));
+        loop.add(tasks.back().get());
+    }
+    ASSERT_TRUE(wait_until([&]() { return loop.stats().tasks == 0; }));
+
+    for (const auto &task : tasks) {
+        EXPECT_EQ(task->steps_, 20);
+        EXPECT_FALSE(task->concurrent_);
+    }
+    EXPECT_EQ(loop.stats().threads, 2u);
+    EXPECT_EQ(loop.stats().steps, 64u * 20);
+}
+
+TEST(IngestLoopTest, RemoveWaitsForStep) {
+    IngestLoopOptions options;
+    options.threads = 1;
+    IngestLoop loop("test", options);
+
+    BlockingTask task(100ms);
+    auto id = loop.add(&task);
+    ASSERT_TRUE(wait_until([&]() { return task.entered_.load(); }));
+    loop.remove(id);
+
+    // 移除返回时这一步已经结束，之后不再调度
+    auto steps = task.steps_.load();
+    EXPECT_GE(steps, 1);
+    std::this_thread::sleep_for(150ms);
+    EXPECT_EQ(task.steps_, steps);
+    EXPECT_EQ(loop.stats().tasks, 0u);
+}
+
+TEST(IngestLoopTest, BlockingCompensation) {
+    IngestLoopOptions options;
+    options.threads = 1;
+    options.max_threads = 2;
+    options.blocking_threshold = 50ms;
+    options.idle_timeout = 100ms;
+    IngestLoop loop("test", options);
+
+    // 一路流卡住时其它流仍能读取
+    BlockingTask blocked(1000ms);
+    CountingTask counting(1000000, 1ms);
+    auto blocked_id = loop.add(&blocked);
+    ASSERT_TRUE(wait_until([&]() { return blocked.entered_.load(); }));
+    auto counting_id = loop.add(&counting);
+
+    EXPECT_TRUE(wait_until([&]() { return counting.steps_ >= 10; }, 500ms));
+    EXPECT_GE(loop.stats().compensations, 1u);
+    EXPECT_LE(loop.stats().threads, 2u);
+
+    loop.remove(blocked_id);
+    loop.remove(counting_id);
+
+    // 临时线程空闲超时后退出
+    EXPECT_TRUE(wait_until([&]() { return loop.stats().threads == 1; }));
+}
+
+TEST(IngestLoopTest, BlockingTasksRaiseThreadCap) {
+    IngestLoopOptions options;
+    options.threads = 1;
+    options.max_threads = 1;
+    options.blocking_threshold = 50ms;
+    options.idle_timeout = 100ms;
+    IngestLoop loop("test", options);
+
+    // 阻塞任务超过线程上限时，每个阻塞任务仍能有一个线程，其它任务还有一个
+    std::vector<std::unique_ptr<BlockingTask>> blocked;
+    std::vector<int> ids;
+    for (int i = 0; i < 3; i++) {
+        blocked.emplace_back(std::make_unique<BlockingTask>(300ms));
+        ids.push_back(loop.add(blocked.back().get(), true));
+    }
+    CountingTask counting(1000000, 1ms);
+    ids.push_back(loop.add(&counting));
+    EXPECT_EQ(loop.stats().blocking_tasks, 3u);
+
+    EXPECT_TRUE(wait_until([&]() {
+        return std::all_of(blocked.begin(), blocked.end(), [](const auto &task) { return task->entered_.load(); });
+    }, 1000ms));
+    EXPECT_TRUE(wait_until([&]() { return counting.steps_ >= 10; }, 1000ms));
+    EXPECT_LE(loop.stats().threads, 4u);
+
+    loop.set_blocking(ids[0], false);
+    EXPECT_EQ(loop.stats().blocking_tasks, 2u);
+    for (auto id : ids) { loop.remove(id); }
+    EXPECT_EQ(loop.stats().blocking_tasks, 0u);
+}
+
+TEST(IngestLoopTest, BlockingTasksStartTogether) {
+    IngestLoopOptions options;
+    options.threads = 1;
+    options.max_threads = 1;
+    options.blocking_threshold = 50ms;
+    options.idle_timeout = 100ms;
+    // 任务在 loop 之后析构，loop 析构时各线程并行结束当前一步
+    std::vector<std::unique_ptr<BlockingTask>> blocked;
+    IngestLoop loop("test", options);
+
+    // 大量阻塞任务同时加入时，一轮补偿就为所有到期的任务加线程，不是每个周期只加一个
+    auto time_start = IngestClock::now();
+    for (int i = 0; i < 32; i++) {
+        blocked.emplace_back(std::make_unique<BlockingTask>(300ms));
+        loop.add(blocked.back().get(), true);
+    }
+    EXPECT_TRUE(wait_until([&]() {
+        return std::all_of(blocked.begin(), blocked.end(), [](const auto &task) { return task->entered_.load(); });
+    }, 500ms));
+    EXPECT_LT(IngestClock::now() - time_start, 500ms);
+    EXPECT_LE(loop.stats().threads, 33u);
+    EXPECT_GE(loop.stats().compensations, 31u);
+}
+
+TEST(IngestLoopTest, FlakyStreamsReconnectSpread) {
+    IngestLoopOptions options;
+    options.threads = 2;
+    IngestLoop loop("test", options);
+
+    BackoffOptions backoff;
+    backoff.base = 200ms;
+    std::atomic_bool network_down{false};
+    std::vector<std::unique_ptr<FlakyStream>> streams;
+    std::vector<int> ids;
+    for (uint32_t i = 0; i < 32; i++) {
+        streams.emplace_back(std::make_unique<FlakyStream>(backoff, i + 1, network_down));
+        ids.push_back(loop.add(streams.back().get()));
+    }
+    ASSERT_TRUE(wait_until([&]() {
+        return std::all_of(streams.begin(), streams.end(), [](const auto &s) { return s->connected_.load(); });
+    }));
+
+    // 网络中断 50ms 后恢复
+    network_down = true;
+    ASSERT_TRUE(wait_until([&]() {
+        return std::none_of(streams.begin(), streams.end(), [](const auto &s) { return s->connected_.load(); });
+    }));
+    std::this_thread::sleep_for(50ms);
+    network_down = false;
+    ASSERT_TRUE(wait_until([&]() {
+        return std::all_of(streams.begin(), streams.end(), [](const auto &s) { return s->connected_.load(); });
+    }));
+
+    for (auto id : ids) { loop.remove(id); }
+
+    std::vector<IngestClock::time_point> reconnects;
+    for (const auto &stream : streams) { reconnects.push_back(stream->reconnect_time_); }
+    auto [first, last] = std::minmax_element(reconnects.begin(), reconnects.end());
+    EXPECT_GT(*last - *first, 50ms);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,95 @@
+/**
+ * @file test_jpeg_encoder.cpp
+ * @brief CPU JPEG 编码线程池，不依赖加速卡
+ */
+
+#include "modules/wrapper/jpeg_encoder.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+using namespace codec;
+
+static std::shared_ptr<AVFrame> make_frame(AVPixelFormat format, int width, int height) {
+    auto frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    frame->format = format;
+    frame->width = width;
+    frame->height = height;
+    av_frame_get_buffer(frame.get(), 32);
+
+    int planes = format == AV_PIX_FMT_NV12 ? 2 : 3;
+    for (int i = 0; i < planes; i++) {
+        int rows = i == 0 ? height : (height + 1) / 2;
+        for (int y = 0; y < rows; y++) {
+            memset(frame->data[i] + y * frame->linesize[i], (y * 3 + i * 64) & 0xff, frame->linesize[i]);
+        }
+    }
+    return frame;
+}
+
+static bool is_jpeg(const std::vector<uint8_t> &data) {
+    return data.size() > 4 && data[0] == 0xFF && data[1] == 0xD8 && data[data.size() - 2] == 0xFF
+        && data[data.size() - 1] == 0xD9;
+}
+
+class JpegEncoderTest : public testing::Test {
+protected:
+    void SetUp() override {
+        if (!JpegEncodePool::available()) { GTEST_SKIP() << "built without libjpeg-turbo"; }
+    }
+};
+
+TEST_F(JpegEncoderTest, EncodeNV12) {
+    JpegEncoder encoder("cpu");
+    ASSERT_TRUE(encoder.init_codecer(1920, 1080));
+
+    std::vector<uint8_t> jpeg_data;
+    auto jpeg_size = encoder.codec_image(make_frame(AV_PIX_FMT_NV12, 1920, 1080), jpeg_data, 85);
+    EXPECT_GT(jpeg_size, 0);
+    EXPECT_EQ(jpeg_size, jpeg_data.size());
+    EXPECT_TRUE(is_jpeg(jpeg_data));
+}
+
+TEST_F(JpegEncoderTest, EncodeI420OddSize) {
+    JpegEncoder encoder("cpu");
+    ASSERT_TRUE(encoder.init_codecer(641, 359));
+
+    std::vector<uint8_t> jpeg_data;
+    EXPECT_GT(encoder.codec_image(make_frame(AV_PIX_FMT_YUV420P, 641, 359), jpeg_data, 85), 0);
+    EXPECT_TRUE(is_jpeg(jpeg_data));
+}
+
+TEST_F(JpegEncoderTest, UnsupportedFormat) {
+    JpegEncoder encoder("cpu");
+    ASSERT_TRUE(encoder.init_codecer(64, 64));
+
+    std::vector<uint8_t> jpeg_data;
+    EXPECT_EQ(encoder.codec_image(make_frame(AV_PIX_FMT_YUV444P, 64, 64), jpeg_data, 85), 0);
+}
+
+TEST_F(JpegEncoderTest, ReuseBuffer) {
+    auto frame = make_frame(AV_PIX_FMT_NV12, 1280, 720);
+    JpegEncoder encoder("cpu");
+    ASSERT_TRUE(encoder.init_codecer(1280, 720));
+
+    std::vector<uint8_t> jpeg_data;
+    encoder.codec_image(frame, jpeg_data, 85);
+    auto first = jpeg_data;
+    auto buffer_ptr = jpeg_data.data();
+
+    // 同一帧再次编码，结果相同且不重新分配
+    encoder.codec_image(frame, jpeg_data, 85);
+    EXPECT_EQ(jpeg_data, first);
+    EXPECT_EQ(jpeg_data.data(), buffer_ptr);
+}
+
+TEST_F(JpegEncoderTest, Concurrent) {
+    auto frame = make_frame(AV_PIX_FMT_NV12, 1280, 720);
+    std::vector<std::future<std::vector<uint8_t>>> results;
+    for (int i = 0; i < 32; i++) { results.emplace_back(JpegEncodePool::get_instance().encode(frame, 50 + i)); }
+    for (auto &result : results) { EXPECT_TRUE(is_jpeg(result.get())); }
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,105 @@
+/**
+ * @file test_model_registry.cpp
+ * @brief 模型注册表的共享加载，预热在每次加载后只执行一次，预热帧的结果不会分发给使用者，加载完成后可查询输入尺寸
+ */
+
+#include "modules/algorithm/model_registry.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace gddi;
+
+class ModelRegistryTest : public testing::Test {
+protected:
+    void SetUp() override {
+        // 每个用例使用不同的模型路径，避免共用注册表中的模型
+        replay_path_ = testing::TempDir() + "test_model_registry_"
+            + testing::UnitTest::GetInstance()->current_test_info()->name() + ".json";
+        std::ofstream file(replay_path_);
+        file << R"({
+            "model_type": "detection",
+            "labels": ["person"],
+            "input_size": [320, 192],
+            "frames": [[{"class_id": 0, "prob": 0.9, "box": [1, 2, 3, 4]}]]
+        })";
+        file.close();
+
+        parms_.backend = "replay";
+        parms_.mod_path = replay_path_;
+    }
+
+    void TearDown() override {
+        algo::ModelRegistry::get_instance().set_warmup_hook(&algo::SharedModel::dummy_inference);
+        std::remove(replay_path_.c_str());
+    }
+
+    std::string replay_path_;
+    algo::ModParms parms_;
+};
+
+TEST_F(ModelRegistryTest, WarmupOncePerLoad) {
+    std::atomic_int warmup_count{0};
+    algo::ModelRegistry::get_instance().set_warmup_hook([&warmup_count](algo::SharedModel &model) {
+        model.dummy_inference();
+        ++warmup_count;
+    });
+
+    auto first = algo::ModelRegistry::get_instance().acquire(parms_);
+    ASSERT_TRUE(first->init(parms_));
+    EXPECT_EQ(warmup_count, 1);
+
+    // 模型已加载，直接复用，不再预热
+    auto second = algo::ModelRegistry::get_instance().acquire(parms_);
+    ASSERT_TRUE(second->init(parms_));
+    EXPECT_EQ(warmup_count, 1);
+
+    // 所有使用者释放后模型卸载，再次获取时重新加载并预热
+    first.reset();
+    second.reset();
+    auto third = algo::ModelRegistry::get_instance().acquire(parms_);
+    ASSERT_TRUE(third->init(parms_));
+    EXPECT_EQ(warmup_count, 2);
+}
+
+TEST_F(ModelRegistryTest, DefaultWarmupUsesInputSize) {
+    std::pair<int, int> warmup_size;
+    algo::ModelRegistry::get_instance().set_warmup_hook([&warmup_size](algo::SharedModel &model) {
+        warmup_size = model.input_size();
+        model.dummy_inference();
+    });
+
+    std::atomic_int result_count{0};
+    auto algo = algo::ModelRegistry::get_instance().acquire(parms_);
+    algo->register_infer_callback(
+        [&result_count](const int64_t, const AlgoType, const std::vector<algo::AlgoOutput> &) { ++result_count; });
+    ASSERT_TRUE(algo->init(parms_));
+    EXPECT_EQ(warmup_size, std::make_pair(320, 192));
+
+    // dummy_inference 等到预热帧的结果返回，之后不会再有回调
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(result_count, 0);
+}
+
+TEST_F(ModelRegistryTest, InputSizeAfterLoad) {
+    auto algo = algo::ModelRegistry::get_instance().acquire(parms_);
+    EXPECT_EQ(algo::ModelRegistry::get_instance().input_size(replay_path_), std::make_pair(0, 0));
+
+    ASSERT_TRUE(algo->init(parms_));
+    EXPECT_EQ(algo::ModelRegistry::get_instance().input_size(replay_path_), std::make_pair(320, 192));
+    EXPECT_EQ(algo::ModelRegistry::get_instance().input_size("unknown"), std::make_pair(0, 0));
+}
+
+TEST_F(ModelRegistryTest, WarmupDisabled) {
+    algo::ModelRegistry::get_instance().set_warmup_hook(nullptr);
+
+    auto algo = algo::ModelRegistry::get_instance().acquire(parms_);
+    EXPECT_TRUE(algo->init(parms_));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file test_packet_ring_buffer.cpp
+ * @brief 事件预录压缩包缓存，按关键帧对齐裁剪
+ */
+
+#include "modules/codec/packet_ring_buffer.h"
+#include <gtest/gtest.h>
+
+using namespace av_wrapper;
+
+class PacketRingBufferTest : public testing::Test {
+protected:
+    void SetUp() override {
+        auto codecpar = std::shared_ptr<AVCodecParameters>(
+            avcodec_parameters_alloc(), [](AVCodecParameters *ptr) { avcodec_parameters_free(&ptr); });
+        ring_.open(codecpar, AVRational{1, 25}, AVRational{25, 1});
+    }
+
+    // 25 fps，每 gop_size 帧一个关键帧，时间基为 1/25
+    void push(int64_t pts, int gop_size = 25, int size = 1000) {
+        auto packet = std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *ptr) { av_packet_free(&ptr); });
+        av_new_packet(packet.get(), size);
+        packet->pts = pts;
+        packet->dts = pts;
+        if (pts % gop_size == 0) { packet->flags |= AV_PKT_FLAG_KEY; }
+        ring_.push_packet(packet);
+    }
+
+    PacketRingBuffer ring_;
+};
+
+TEST_F(PacketRingBufferTest, DisabledByDefault) {
+    for (int64_t i = 0; i < 100; i++) { push(i); }
+    EXPECT_EQ(ring_.packet_count(), 0);
+}
+
+TEST_F(PacketRingBufferTest, StartsAtKeyFrame) {
+    ring_.set_duration(2);
+    for (int64_t i = 10; i < 30; i++) { push(i); }
+
+    auto packets = ring_.snapshot();
+    ASSERT_EQ(packets.size(), 5);
+    EXPECT_EQ(packets.front()->pts, 25);
+    EXPECT_TRUE(packets.front()->flags & AV_PKT_FLAG_KEY);
+}
+
+TEST_F(PacketRingBufferTest, TrimByGop) {
+    ring_.set_duration(2);
+    for (int64_t i = 0; i < 25 * 10; i++) { push(i); }
+
+    // 最新包 pts = 249 (9.96 s)，第 8 s 的关键帧之前已不需要，保留 [7 s, 9.96 s]
+    auto packets = ring_.snapshot();
+    ASSERT_EQ(packets.size(), 75);
+    EXPECT_EQ(packets.front()->pts, 175);
+    EXPECT_EQ(packets.back()->pts, 249);
+    EXPECT_EQ(ring_.bytes(), 75 * 1000);
+}
+
+TEST_F(PacketRingBufferTest, MaxBytes) {
+    ring_.set_duration(10);
+    ring_.set_max_bytes(30 * 1000);
+    for (int64_t i = 0; i < 25 * 4; i++) { push(i); }
+
+    // 超出上限时至少保留最后一个 GOP
+    auto packets = ring_.snapshot();
+    ASSERT_EQ(packets.size(), 25);
+    EXPECT_EQ(packets.front()->pts, 75);
+}
+
+TEST_F(PacketRingBufferTest, TimestampRollback) {
+    ring_.set_duration(10);
+    for (int64_t i = 1000; i < 1100; i++) { push(i); }
+    for (int64_t i = 0; i < 30; i++) { push(i); }
+
+    auto packets = ring_.snapshot();
+    ASSERT_EQ(packets.size(), 30);
+    EXPECT_EQ(packets.front()->pts, 0);
+}
+
+TEST(PacketRingRegistryTest, SharedByStream) {
+    auto ring1 = PacketRingRegistry::get_instance().acquire("task_1");
+    auto ring2 = PacketRingRegistry::get_instance().acquire("task_1");
+    auto ring3 = PacketRingRegistry::get_instance().acquire("task_2");
+    EXPECT_EQ(ring1, ring2);
+    EXPECT_NE(ring1, ring3);
+
+    std::weak_ptr<PacketRingBuffer> weak_ring = ring1;
+    ring1.reset();
+    ring2.reset();
+    EXPECT_TRUE(weak_ring.expired());
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,123 @@
+/**
+ * @file test_replay_backend.cpp
+ * @brief 回放推理后端，异步、批量与多阶段推理路径
+ */
+
+#include "modules/algorithm/algo_factory.h"
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <mutex>
+
+using namespace gddi;
+
+class ReplayBackendTest : public testing::Test {
+protected:
+    void SetUp() override {
+        replay_path_ = testing::TempDir() + "test_replay_backend.json";
+        std::ofstream file(replay_path_);
+        file << R"({
+            "model_type": "detection",
+            "labels": ["person", "car"],
+            "latency_ms": 5,
+            "frames": [
+                [{"class_id": 0, "prob": 0.9, "box": [10, 20, 30, 40]}],
+                [],
+                [{"class_id": 1, "prob": 0.6, "box": [1, 2, 3, 4]}, {"class_id": 0, "prob": 0.7, "box": [5, 6, 7, 8]}]
+            ]
+        })";
+        file.close();
+
+        algo_ = algo::make_algo_impl("replay");
+        algo_->register_init_callback([this](const std::vector<std::string> &labels) { labels_ = labels; });
+        algo_->register_infer_callback(
+            [this](const int64_t frame_idx, const AlgoType type, const std::vector<algo::AlgoOutput> &outputs) {
+                std::lock_guard<std::mutex> lock_guard(mutex_);
+                results_.emplace_back(frame_idx, outputs);
+                cv_.notify_all();
+            });
+
+        algo::ModParms parms;
+        parms.mod_path = replay_path_;
+        ASSERT_TRUE(algo_->init(parms));
+    }
+
+    void TearDown() override {
+        algo_.reset();
+        std::remove(replay_path_.c_str());
+    }
+
+    static std::shared_ptr<nodes::FrameInfo> make_frame(int64_t video_frame_idx) {
+        return std::make_shared<nodes::FrameInfo>(video_frame_idx, nullptr);
+    }
+
+    void wait_results(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ASSERT_TRUE(cv_.wait_for(lock, std::chrono::seconds(1), [this, count] { return results_.size() >= count; }));
+    }
+
+    std::string replay_path_;
+    std::unique_ptr<algo::AbstractAlgo> algo_;
+    std::vector<std::string> labels_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::pair<int64_t, std::vector<algo::AlgoOutput>>> results_;
+};
+
+TEST(AlgoBackendRegistryTest, UnknownBackend) {
+    EXPECT_THROW(algo::make_algo_impl("undefined"), std::runtime_error);
+    EXPECT_THROW(algo::AlgoBackendRegistry::get_instance().set_default_backend("undefined"), std::runtime_error);
+}
+
+TEST_F(ReplayBackendTest, Labels) { EXPECT_EQ(labels_, std::vector<std::string>({"person", "car"})); }
+
+TEST_F(ReplayBackendTest, AsyncInference) {
+    for (int64_t i = 0; i < 4; i++) {
+        auto frame = make_frame(i);
+        frame->infer_frame_idx = 100 + i;
+        algo_->inference("task", frame, algo::InferType::kAsync);
+    }
+    wait_results(4);
+
+    // 帧序号超出录制范围后循环回放
+    ASSERT_EQ(results_.size(), 4);
+    EXPECT_EQ(results_[0].first, 100);
+    EXPECT_EQ(results_[0].second.size(), 1);
+    EXPECT_EQ(results_[0].second[0].label, "person");
+    EXPECT_EQ(results_[1].second.size(), 0);
+    EXPECT_EQ(results_[2].second.size(), 2);
+    EXPECT_EQ(results_[3].first, 103);
+    EXPECT_EQ(results_[3].second.size(), 1);
+}
+
+TEST_F(ReplayBackendTest, BatchInference) {
+    std::vector<algo::BatchItem> batch;
+    for (int64_t i = 0; i < 3; i++) { batch.push_back({i * 10, "task", make_frame(2 - i)}); }
+    algo_->inference(batch);
+    wait_results(3);
+
+    ASSERT_EQ(results_.size(), 3);
+    EXPECT_EQ(results_[0].first, 0);
+    EXPECT_EQ(results_[0].second.size(), 2);
+    EXPECT_EQ(results_[2].first, 20);
+    EXPECT_EQ(results_[2].second.size(), 1);
+}
+
+TEST_F(ReplayBackendTest, MultiStageInference) {
+    auto frame = make_frame(0);
+    frame->ext_info.emplace_back(AlgoType::kDetection, "", "", 0);
+    frame->ext_info.mutable_back().crop_rects[3] = {100, 200, 50, 50};
+
+    std::map<int, std::vector<algo::AlgoOutput>> outputs;
+    EXPECT_EQ(algo_->inference("task", frame, outputs), AlgoType::kDetection);
+    ASSERT_EQ(outputs[3].size(), 1);
+    EXPECT_FLOAT_EQ(outputs[3][0].box.x, 110);
+    EXPECT_FLOAT_EQ(outputs[3][0].box.y, 220);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,85 @@
+/**
+ * @file test_roi_mask.cpp
+ * @brief ROI 栅格积分图与精确多边形覆盖率的一致性
+ */
+
+#include "modules/cvrelate/roi_mask.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace gddi;
+
+static std::vector<Point2i> rect_points(int x1, int y1, int x2, int y2) {
+    return {{x1, y1}, {x1, y2}, {x2, y2}, {x2, y1}};
+}
+
+static const std::vector<std::vector<Point2i>> kRegions{
+    {{100, 100}, {700, 120}, {650, 500}, {400, 300}, {120, 480}},// 凹多边形
+    {{900, 200}, {1400, 200}, {1400, 700}, {900, 700}},
+    {{300, 700}, {600, 650}, {500, 1000}},
+};
+
+TEST(RoiMaskTest, Exact) {
+    geometry::RoiMaskIndex index;
+    index.compile(kRegions, geometry::CoverMode::kExact);
+    ASSERT_EQ(index.size(), kRegions.size());
+
+    std::mt19937 rng(1);
+    for (int i = 0; i < 200; i++) {
+        int x1 = rng() % 1400, y1 = rng() % 900, x2 = x1 + 10 + rng() % 300, y2 = y1 + 10 + rng() % 300;
+        for (size_t roi = 0; roi < kRegions.size(); roi++) {
+            float expected = geometry::area_cover_rate(rect_points(x1, y1, x2, y2), kRegions[roi]);
+            EXPECT_EQ(index.cover_rate(roi, x1, y1, x2, y2), expected);
+        }
+    }
+}
+
+TEST(RoiMaskTest, Raster) {
+    geometry::RoiMaskIndex index;
+    index.compile(kRegions, geometry::CoverMode::kRaster, 128);
+
+    std::mt19937 rng(2);
+    for (int i = 0; i < 500; i++) {
+        int x1 = rng() % 1400, y1 = rng() % 900, x2 = x1 + 10 + rng() % 300, y2 = y1 + 10 + rng() % 300;
+        for (size_t roi = 0; roi < kRegions.size(); roi++) {
+            float expected = geometry::area_cover_rate(rect_points(x1, y1, x2, y2), kRegions[roi]);
+            EXPECT_NEAR(index.cover_rate(roi, x1, y1, x2, y2), expected, 0.02);
+        }
+    }
+
+    // 完全包含与完全不相交
+    EXPECT_NEAR(index.cover_rate(1, 1000, 300, 1100, 400), 1, 1e-5);
+    EXPECT_NEAR(index.cover_rate(1, 0, 0, 50, 50), 0, 1e-5);
+}
+
+TEST(RoiMaskTest, Query) {
+    geometry::RoiMaskIndex index;
+    index.compile(kRegions);
+
+    std::vector<size_t> indices;
+    index.query(0, 0, 50, 50, indices);
+    EXPECT_TRUE(indices.empty());
+
+    index.query(550, 450, 950, 750, indices);
+    EXPECT_EQ(indices, (std::vector<size_t>{0, 1, 2}));
+
+    EXPECT_TRUE(index.within(1, {1000, 300}));
+    EXPECT_FALSE(index.within(0, {400, 400}));
+}
+
+TEST(RoiMaskTest, RectCoverRate) {
+    std::mt19937 rng(3);
+    for (int i = 0; i < 200; i++) {
+        Rect rect1{int(rng() % 500), int(rng() % 500), int(1 + rng() % 200), int(1 + rng() % 200)};
+        Rect rect2{int(rng() % 500), int(rng() % 500), int(1 + rng() % 200), int(1 + rng() % 200)};
+        float expected =
+            geometry::area_cover_rate(rect_points(rect1.x, rect1.y, rect1.x + rect1.width, rect1.y + rect1.height),
+                                      rect_points(rect2.x, rect2.y, rect2.x + rect2.width, rect2.y + rect2.height));
+        EXPECT_FLOAT_EQ(geometry::rect_cover_rate(rect1, rect2), expected);
+    }
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_runner_executor.cpp
+ * @brief 共享线程池上 Runner 的串行切片、启动前消息的占位计数，以及切片运行中释放 Runner
+ */
+
+#include "runnable_node.hpp"
+#include <future>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace gddi;
+using namespace gddi::ngraph;
+using namespace std::chrono_literals;
+
+namespace {
+
+template<typename Pred>
+bool wait_until(Pred pred, std::chrono::milliseconds timeout = 5000ms) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) { return false; }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+class SeqMessage : public Message {
+public:
+    SeqMessage(int producer, int seq) : producer(producer), seq(seq) {}
+
+    std::string to_string() const override { return std::to_string(producer) + ":" + std::to_string(seq); }
+    std::string name() const override { return "SeqMessage"; }
+
+    int producer;
+    int seq;
+};
+
+// 记录每个生产者的消息顺序，并检查同一节点的消息是否被并发处理
+class RecordingNode : public NodeAny {
+public:
+    RecordingNode(std::string name, int producers) : NodeAny(std::move(name)), last_seq_(producers, -1) {}
+
+    std::atomic_int handled{0};
+    std::atomic_bool concurrent{false};
+    std::atomic_bool out_of_order{false};
+    std::atomic_bool setup_before_message{true};
+    std::shared_future<void> gate;// 有效时处理第一条消息前等待
+
+protected:
+    void on_setup() override { setup_ = true; }
+
+    void on_input_message(int endpoint, const MessagePtr &message) override {
+        if (active_.exchange(true)) { concurrent = true; }
+        if (!setup_) { setup_before_message = false; }
+        if (gate.valid() && handled == 0) { gate.wait(); }
+
+        auto seq_message = std::dynamic_pointer_cast<SeqMessage>(message);
+        if (seq_message->seq <= last_seq_[seq_message->producer]) { out_of_order = true; }
+        last_seq_[seq_message->producer] = seq_message->seq;
+
+        active_ = false;
+        ++handled;
+    }
+
+    result_for<endpoint::DataFeatures> on_query_endpoint(endpoint::Type type, int endpoint) const override {
+        return {endpoint == 0, {"SeqMessage"}};
+    }
+
+private:
+    std::atomic_bool active_{false};
+    bool setup_{false};
+    std::vector<int> last_seq_;// 仅在 on_input_message 中访问
+};
+
+}// namespace
+
+TEST(RunnerExecutorTest, SerialSlicesPerRunner) {
+    const int runner_num = 8, producer_num = 4, message_num = 500;
+    auto executor = std::make_shared<RunnerExecutor>("test", 4);
+
+    std::vector<std::shared_ptr<Runner>> runners;
+    std::vector<std::shared_ptr<RecordingNode>> nodes;
+    for (int i = 0; i < runner_num; i++) {
+        runners.emplace_back(std::make_shared<Runner>("runner" + std::to_string(i), executor));
+        nodes.emplace_back(std::make_shared<RecordingNode>("node" + std::to_string(i), producer_num));
+        nodes.back()->bind_runner(runners.back());
+        runners.back()->start();
+    }
+
+    // 多个外部线程同时向所有节点投递，每个节点的消息跨越多个切片
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producer_num; p++) {
+        producers.emplace_back([&nodes, p]() {
+            for (int seq = 0; seq < message_num; seq++) {
+                for (auto &node : nodes) { node->push_input_endpoint(0, std::make_shared<SeqMessage>(p, seq)); }
+            }
+        });
+    }
+    for (auto &producer : producers) { producer.join(); }
+
+    ASSERT_TRUE(wait_until([&]() {
+        return std::all_of(nodes.begin(), nodes.end(),
+                           [](const auto &node) { return node->handled == producer_num * message_num; });
+    }));
+    for (const auto &node : nodes) {
+        EXPECT_FALSE(node->concurrent);
+        EXPECT_FALSE(node->out_of_order);
+        EXPECT_TRUE(node->setup_before_message);
+    }
+    for (auto &runner : runners) { runner->stop(); }
+}
+
+TEST(RunnerExecutorTest, MessagesBeforeStart) {
+    auto executor = std::make_shared<RunnerExecutor>("test", 2);
+    auto runner = std::make_shared<Runner>("runner", executor);
+    auto node = std::make_shared<RecordingNode>("node", 1);
+    node->bind_runner(runner);
+
+    // 启动前的消息和初始化消息一起留在队列中，由占位保证启动前不会被调度
+    for (int seq = 0; seq < 100; seq++) { node->push_input_endpoint(0, std::make_shared<SeqMessage>(0, seq)); }
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(node->handled, 0);
+
+    runner->start();
+    ASSERT_TRUE(wait_until([&]() { return node->handled == 100; }));
+    EXPECT_TRUE(node->setup_before_message);
+
+    // 计数归零后，下一条消息仍由投递者重新调度
+    for (int round = 0; round < 10; round++) {
+        std::this_thread::sleep_for(2ms);
+        node->push_input_endpoint(0, std::make_shared<SeqMessage>(0, 100 + round));
+        ASSERT_TRUE(wait_until([&]() { return node->handled == 101 + round; }));
+    }
+    EXPECT_FALSE(node->out_of_order);
+
+    std::promise<int> quit;
+    runner->set_quit_listener([&quit](int code) { quit.set_value(code); });
+    runner->post_quit_loop(7);
+    runner->join();
+    ASSERT_EQ(quit.get_future().wait_for(1s), std::future_status::ready);
+}
+
+TEST(RunnerExecutorTest, DestroyWithSliceInFlight) {
+    auto executor = std::make_shared<RunnerExecutor>("test", 2);
+    auto runner = std::make_shared<Runner>("runner", executor);
+    auto node = std::make_shared<RecordingNode>("node", 1);
+    std::promise<void> gate;
+    node->gate = gate.get_future().share();
+    node->bind_runner(runner);
+
+    std::promise<int> quit;
+    runner->set_quit_listener([&quit](int code) { quit.set_value(code); });
+    runner->start();
+    for (int seq = 0; seq < 5; seq++) { node->push_input_endpoint(0, std::make_shared<SeqMessage>(0, seq)); }
+
+    // 切片持有 Runner，外部释放后在工作线程上析构
+    std::weak_ptr<Runner> weak_runner = runner;
+    runner.reset();
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(weak_runner.expired());
+
+    gate.set_value();
+    ASSERT_TRUE(wait_until([&]() { return weak_runner.expired(); }));
+    EXPECT_EQ(node->handled, 5);
+    ASSERT_EQ(quit.get_future().wait_for(1s), std::future_status::ready);
+
+    // Runner 已释放，投递直接忽略
+    node->push_input_endpoint(0, std::make_shared<SeqMessage>(0, 5));
+    EXPECT_EQ(node->handled, 5);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
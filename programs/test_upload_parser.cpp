@@ -0,0 +1,88 @@
+/**
+ * @file test_upload_parser.cpp
+ * @brief 图片上传的 multipart 拆分和 JSON SAX 解析
+ */
+
+#include "modules/network/upload_parser.h"
+#include <gtest/gtest.h>
+
+using namespace gddi::network;
+
+static const char *kContentType = "multipart/form-data; boundary=\"----gddi0123\"";
+
+static std::string make_part(const std::string &name, const std::string &filename, const std::string &data) {
+    std::string part = "------gddi0123\r\nContent-Disposition: form-data; name=\"" + name + "\"";
+    if (!filename.empty()) { part += "; filename=\"" + filename + "\"\r\nContent-Type: image/jpeg"; }
+    return part + "\r\n\r\n" + data + "\r\n";
+}
+
+TEST(UploadParserTest, Multipart) {
+    // 图片数据中包含 \r\n 和不完整的分隔符
+    const char raw_image[] = "\xFF\xD8\r\n------gddi01\r\n\x00\xFF\xD9";
+    std::string image1(raw_image, sizeof(raw_image) - 1);
+    std::string image2 = "\x89PNG";
+    auto body = "preamble\r\n" + make_part("metadata", "", "{}") + make_part("img0", "a.jpg", image1)
+        + make_part("img1", "b.png", image2) + "------gddi0123--\r\n";
+
+    std::vector<FormPart> parts;
+    ASSERT_TRUE(parse_multipart(kContentType, body, parts));
+    ASSERT_EQ(parts.size(), 3);
+
+    EXPECT_EQ(parts[0].name, "metadata");
+    EXPECT_TRUE(parts[0].filename.empty());
+    EXPECT_EQ(parts[0].data, "{}");
+
+    EXPECT_EQ(parts[1].name, "img0");
+    EXPECT_EQ(parts[1].filename, "a.jpg");
+    EXPECT_EQ(parts[1].content_type, "image/jpeg");
+    EXPECT_EQ(parts[1].data, image1);
+    EXPECT_EQ(parts[1].data.data(), body.data() + body.find(image1));// 不复制
+
+    EXPECT_EQ(parts[2].data, image2);
+}
+
+TEST(UploadParserTest, MultipartMalformed) {
+    std::vector<FormPart> parts;
+    EXPECT_FALSE(parse_multipart("multipart/form-data", "------gddi0123--", parts));
+    EXPECT_FALSE(parse_multipart(kContentType, "no boundary here", parts));
+    EXPECT_FALSE(parse_multipart(kContentType, make_part("img0", "a.jpg", "data"), parts));
+}
+
+TEST(UploadParserTest, LegacyJson) {
+    std::map<std::string, RegionMap> regions;
+    std::string image;
+    ASSERT_TRUE(parse_upload_json(R"({"image": "data:image/jpeg;base64,/9j/",
+                                      "additional": {"regions_with_label": {"door": [[0.1, 0.2], [100, 200], [3, 4]]},
+                                                     "other": [1, 2]}})",
+                                  regions, &image));
+
+    EXPECT_EQ(image, "data:image/jpeg;base64,/9j/");
+    ASSERT_EQ(regions.count("additional"), 1);
+    const auto &points = regions["additional"]["door"];
+    ASSERT_EQ(points.size(), 3);
+    EXPECT_FLOAT_EQ(points[0][0], 0.1);
+    EXPECT_FLOAT_EQ(points[1][1], 200);
+    EXPECT_FLOAT_EQ(points[2][0], 3);
+}
+
+TEST(UploadParserTest, BatchMetadata) {
+    std::map<std::string, RegionMap> regions;
+    ASSERT_TRUE(parse_upload_json(R"({"img0": {"regions_with_label": {"a": [[1, 2]], "b": [[3, 4], [5, 6]]}},
+                                      "img1": {"regions_with_label": {}}, "img2": {"image": "ignored"}})",
+                                  regions));
+
+    EXPECT_EQ(regions.size(), 1);
+    EXPECT_EQ(regions["img0"]["a"].size(), 1);
+    EXPECT_EQ(regions["img0"]["b"].size(), 2);
+    EXPECT_FLOAT_EQ(regions["img0"]["b"][1][1], 6);
+}
+
+TEST(UploadParserTest, JsonMalformed) {
+    std::map<std::string, RegionMap> regions;
+    EXPECT_FALSE(parse_upload_json(R"({"img0": {"regions_with_label": )", regions));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -118,6 +118,8 @@ private:
         router_.GET((api_ + "/task").c_str(), [=](auto &ctx) { return _task_get(ctx); });
         router_.POST((api_ + "/task").c_str(), [=](auto &ctx) { return _task_create(ctx); });
         router_.Delete((api_ + "/task").c_str(), [=](auto &ctx) { return _task_delete(ctx); });
+        router_.GET((api_ + "/task/metrics").c_str(), [=](auto &ctx) { return _task_metrics(ctx); });
+        router_.GET((api_ + "/metrics").c_str(), [=](auto &ctx) { return _metrics_prometheus(ctx); });
         router_.POST((api_ + "/preview").c_str(), [=](auto &ctx) { return _task_preview(ctx); });
         router_.POST((api_ + "/preview_jpeg").c_str(), [=](auto &ctx) { return _task_preview_jpeg(ctx); });
         router_.Delete((api_ + "/preview_jpeg").c_str(), [=](auto &ctx) { return _task_preview_jpeg_close(ctx); });
@@ -202,6 +204,17 @@ private:
         return ctx->send(task_list.dump());
     }
 
+    int _task_metrics(const HttpContextPtr &ctx) {
+        HttpServiceTimeUsed time_used(ctx->response.get());
+
+        auto metrics_list = server_basic_->get_tasks_metrics_json();
+        return ctx->send(metrics_list.dump());
+    }
+
+    int _metrics_prometheus(const HttpContextPtr &ctx) {
+        return ctx->send(server_basic_->get_tasks_metrics_prometheus(), TEXT_PLAIN);
+    }
+
     int _task_preview(const HttpContextPtr &ctx) {
         auto ack_json = nlohmann::json::object();
 
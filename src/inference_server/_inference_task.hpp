@@ -9,6 +9,8 @@
 #include <memory>
 #include <atomic>
 #include <map>
+#include <mutex>
+#include <chrono>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
@@ -35,6 +37,10 @@ private:
     std::shared_ptr<inference_slice> inference_slice_;  // 主要的逻辑推理
     std::shared_ptr<inference_slice> preview_slice_;    // 预览专用片段
 
+    std::mutex metrics_mutex_;                                          // 速率统计访问保护
+    std::chrono::steady_clock::time_point last_metrics_time_{std::chrono::steady_clock::now()};
+    std::map<std::string, uint64_t> last_edge_messages_;                // 上一次查询时各连接的消息数
+
 public:
     InferenceTask() = delete;
     explicit InferenceTask(std::string name) : name_(std::move(name)) {}
@@ -151,6 +157,19 @@ public:
 
             task_json["nodes"].push_back(node_json);
         }
+        task_json["queues"] = nlohmann::json::array();
+        for (const auto &r : runners) {
+            for (const auto &stats : r.second->get_queue_stats()) {
+                auto queue_json = nlohmann::json();
+                queue_json["runner"] = r.first;
+                queue_json["name"] = stats.name;
+                queue_json["policy"] = stats.policy;
+                queue_json["capacity"] = stats.capacity;
+                queue_json["queued"] = stats.queued;
+                queue_json["dropped"] = stats.dropped;
+                task_json["queues"].push_back(queue_json);
+            }
+        }
         task_json["running"] = is_running();
         task_json["quit_code"] = quit_code();
         task_json["runtime_json"] = get_runtime_json();
@@ -159,6 +178,147 @@ public:
         return task_json;
     }
 
+    /**
+     * @brief 节点耗时、Runner 队列深度及连接消息速率，速率按两次查询之间的增量计算
+     */
+    nlohmann::json get_metrics_json() {
+        namespace metrics = gddi::ngraph::metrics;
+        const auto &runners = inference_slice_->runners();
+        const auto &nodes = inference_slice_->nodes();
+
+        auto histogram_json = [](const metrics::Histogram::Snapshot &snapshot) {
+            auto histogram = nlohmann::json();
+            histogram["count"] = snapshot.count;
+            histogram["avg"] = snapshot.average_us();
+            histogram["p50"] = snapshot.percentile_us(0.5);
+            histogram["p90"] = snapshot.percentile_us(0.9);
+            histogram["p99"] = snapshot.percentile_us(0.99);
+            return histogram;
+        };
+
+        auto task_json = nlohmann::json();
+        task_json["name"] = name_;
+        task_json["runners"] = nlohmann::json::array();
+        task_json["nodes"] = nlohmann::json::array();
+        task_json["edges"] = nlohmann::json::array();
+
+        for (const auto &r : runners) {
+            auto runner_json = nlohmann::json();
+            runner_json["name"] = r.first;
+            runner_json["pooled"] = r.second->is_pooled();
+            runner_json["queue_depth"] = r.second->queue_depth();
+            task_json["runners"].push_back(runner_json);
+        }
+
+        std::map<const void *, int> node_ids;
+        for (const auto &n : nodes) { node_ids[n.second.get()] = n.first; }
+
+        std::lock_guard<std::mutex> lock_guard(metrics_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration<double>(now - last_metrics_time_).count();
+        last_metrics_time_ = now;
+        task_json["elapsed"] = elapsed;
+
+        for (const auto &n : nodes) {
+            const auto &node_metrics = n.second->metrics();
+            auto node_json = nlohmann::json();
+            node_json["id"] = n.first;
+            node_json["type"] = n.second->type();
+            node_json["runner"] = n.second->get_runner()->name();
+            node_json["messages_in"] = node_metrics.input.snapshot();
+            node_json["messages_out"] = node_metrics.output.snapshot();
+            node_json["queue_wait_us"] = histogram_json(node_metrics.queue_wait.snapshot());
+            node_json["handle_us"] = histogram_json(node_metrics.handle_time.snapshot());
+            task_json["nodes"].push_back(node_json);
+
+            std::vector<metrics::EdgeStats> edge_stats;
+            n.second->get_edge_stats(edge_stats);
+            for (const auto &edge : edge_stats) {
+                auto iter = node_ids.find(edge.to_);
+                if (iter == node_ids.end()) { continue; }// 预览片段等外部节点
+
+                auto key = std::to_string(n.first) + ":" + std::to_string(edge.from_ep_) + "->"
+                         + std::to_string(iter->second) + ":" + std::to_string(edge.to_ep_);
+                auto &last_messages = last_edge_messages_[key];
+
+                auto edge_json = nlohmann::json();
+                edge_json["from"] = n.first;
+                edge_json["from_ep"] = edge.from_ep_;
+                edge_json["to"] = iter->second;
+                edge_json["to_ep"] = edge.to_ep_;
+                edge_json["messages"] = edge.messages;
+                auto delta = edge.messages >= last_messages ? edge.messages - last_messages : edge.messages;
+                edge_json["rate"] = elapsed > 0 ? (double)delta / elapsed : 0.0;
+                task_json["edges"].push_back(edge_json);
+                last_messages = edge.messages;
+            }
+        }
+        return task_json;
+    }
+
+    /**
+     * @brief 以 Prometheus 文本格式输出，速率由 Prometheus 端根据计数器计算
+     */
+    void get_metrics_prometheus(gddi::ngraph::metrics::PrometheusText &text) const {
+        namespace metrics = gddi::ngraph::metrics;
+        const auto &runners = inference_slice_->runners();
+        const auto &nodes = inference_slice_->nodes();
+
+        for (const auto &r : runners) {
+            metrics::PrometheusText::Labels labels{{"task", name_}, {"runner", r.first}};
+            text.add("gddi_runner_queue_depth", "gauge", "Messages waiting in the runner queue.", labels,
+                     (double)r.second->queue_depth());
+
+            for (const auto &stats : r.second->get_queue_stats()) {
+                auto queue_labels = labels;
+                queue_labels.emplace_back("queue", stats.name);
+                text.add("gddi_bounded_queue_dropped_total", "counter", "Messages dropped by bounded queues.",
+                         queue_labels, (double)stats.dropped);
+            }
+        }
+
+        std::map<const void *, int> node_ids;
+        for (const auto &n : nodes) { node_ids[n.second.get()] = n.first; }
+
+        for (const auto &n : nodes) {
+            const auto &node_metrics = n.second->metrics();
+            metrics::PrometheusText::Labels labels{
+                {"task", name_}, {"node", std::to_string(n.first)}, {"type", n.second->type()}};
+
+            text.add_histogram("gddi_node_queue_wait_seconds", "Time messages wait in the runner queue.", labels,
+                               node_metrics.queue_wait.snapshot());
+            text.add_histogram("gddi_node_handle_seconds", "Time spent in node message handlers.", labels,
+                               node_metrics.handle_time.snapshot());
+
+            auto add_endpoints = [&](const std::string &family, const std::string &help,
+                                     const std::vector<uint64_t> &values) {
+                for (size_t ep = 0; ep < values.size(); ep++) {
+                    auto ep_labels = labels;
+                    ep_labels.emplace_back("endpoint", std::to_string(ep));
+                    text.add(family, "counter", help, ep_labels, (double)values[ep]);
+                }
+            };
+            add_endpoints("gddi_node_messages_in_total", "Messages handled per input endpoint.",
+                          node_metrics.input.snapshot());
+            add_endpoints("gddi_node_messages_out_total", "Messages emitted per output endpoint.",
+                          node_metrics.output.snapshot());
+
+            std::vector<metrics::EdgeStats> edge_stats;
+            n.second->get_edge_stats(edge_stats);
+            for (const auto &edge : edge_stats) {
+                auto iter = node_ids.find(edge.to_);
+                if (iter == node_ids.end()) { continue; }
+                text.add("gddi_edge_messages_total", "counter", "Messages sent along each node connection.",
+                         {{"task", name_},
+                          {"from", std::to_string(n.first)},
+                          {"from_ep", std::to_string(edge.from_ep_)},
+                          {"to", std::to_string(iter->second)},
+                          {"to_ep", std::to_string(edge.to_ep_)}},
+                         (double)edge.messages);
+            }
+        }
+    }
+
     void release_preview() {
         auto node = inference_slice_->find_first_node_by_type("JpegPreviewer_v2");
         if (node) {
@@ -31,6 +31,8 @@ public:
             };
         };
 
+        bool bounded{false};                    // 是否为目标输入端点配置了有界队列
+        gddi::ngraph::queue::Options queue;
     };
 
     static ResultMsg parse(const std::string &text, InferenceSliceConfig &config) {
@@ -39,6 +41,8 @@ public:
         try {
             auto json = nlohmann::json::parse(text);
             config.get_version(json);
+            config.get_executor(json);
+            config.get_runner_queues(json);
             config.get_nodes(json);
             config.get_pipes(json);
             config.raw_json = text;
@@ -55,11 +59,42 @@ public:
     std::map<int, NodeConfig> node_configs;             // id, NodeConfig
     std::map<std::string, NodePipeConfig> node_flows;   // key(generated), NodePipeConfig
     std::set<std::string> named_runners;
+    std::string executor{"thread"};                     // thread: 每个 runner 独占线程, pool: 共享线程池
+    std::map<std::string, gddi::ngraph::queue::Options> runner_queues;  // runner name, 有界队列配置
     std::string version;
     std::string raw_json;
 
 private:
     void get_version(nlohmann::json &json) { version = json["version"].get<std::string>(); }
+    void get_executor(nlohmann::json &json) {
+        if (json.contains("executor")) {
+            executor = json["executor"].get<std::string>();
+            if (executor != "thread" && executor != "pool") {
+                throw std::runtime_error("executor: < " + executor + " > not supported!!!");
+            }
+        }
+    }
+
+    static gddi::ngraph::queue::Options parse_queue_options(const nlohmann::json &json) {
+        gddi::ngraph::queue::Options options;
+        options.capacity = json.value("capacity", options.capacity);
+        options.block_timeout_ms = json.value("block_timeout_ms", options.block_timeout_ms);
+        if (json.contains("policy")) {
+            auto policy = json["policy"].get<std::string>();
+            if (!gddi::ngraph::queue::policy_from_string(policy, options.policy)) {
+                throw std::runtime_error("queue policy: < " + policy + " > not supported!!!");
+            }
+        }
+        return options;
+    }
+
+    void get_runner_queues(nlohmann::json &json) {
+        if (json.contains("runners")) {
+            for (auto &iter : json["runners"].items()) {
+                runner_queues[iter.key()] = parse_queue_options(iter.value());
+            }
+        }
+    }
     void get_nodes(nlohmann::json &json) {
         auto nodes = json["nodes"];
         for (const auto &node : nodes) {
@@ -122,6 +157,12 @@ private:
                 cfg.from_ep = from_ep_;
                 cfg.to = to_;
                 cfg.to_ep = to_ep_;
+
+                // 可选的第 5 个参数，目标输入端点的有界队列配置
+                if (pipe.size() > 4) {
+                    cfg.queue = parse_queue_options(pipe.at(4));
+                    cfg.bounded = true;
+                }
             }
         }
     }
@@ -7,6 +7,7 @@
 #include "inference_helper.hpp"
 #include "runnable_node.hpp"
 #include "utils.hpp"
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <iomanip>
@@ -17,6 +18,7 @@
 #include <sstream>
 #include <string>
 #include <set>
+#include <vector>
 
 static int stream_id{0};
 
@@ -68,6 +70,9 @@ private:
     // 用于标识启动，每个inference_slice在设计上只允许正向跑一次。多次是不允许的。
     int32_t run_times_{0};
 
+    // runner 调度的线程池，为空时每个 runner 独占一个线程
+    std::shared_ptr<gddi::ngraph::RunnerExecutor> executor_;
+
 private:
     inference_slice() = default;
 
@@ -79,7 +84,7 @@ private:
     std::shared_ptr<gddi::ngraph::Runner> get_runner_(const std::string &runner_id) {
         auto iter = named_runners_.find(runner_id);
         if (iter == named_runners_.end()) {
-            named_runners_[runner_id] = std::make_shared<gddi::ngraph::Runner>(runner_id);
+            named_runners_[runner_id] = std::make_shared<gddi::ngraph::Runner>(runner_id, executor_);
         }
         return named_runners_[runner_id];
     }
@@ -171,9 +176,14 @@ public:
     static std::shared_ptr<inference_slice> create_from(const std::string &slice_name,
                                                         const InferenceSliceConfig &task_json) {
         auto slice_ = std::shared_ptr<inference_slice>(new inference_slice);
+        if (task_json.executor == "pool") { slice_->executor_ = gddi::ngraph::RunnerExecutor::shared_instance(); }
 
         // 1. create all runners
-        for (const auto &name : task_json.named_runners) { slice_->get_runner_(name); }
+        for (const auto &name : task_json.named_runners) {
+            auto runner = slice_->get_runner_(name);
+            auto iter = task_json.runner_queues.find(name);
+            if (iter != task_json.runner_queues.end()) { runner->set_queue_options(iter->second); }
+        }
 
         // 2. create all node with runners
         auto &task_all_nodes = slice_->nodes_;// ref the var member
@@ -222,9 +232,59 @@ public:
                 throw std::runtime_error(oss.str());
             }
 
+            if (cfg.bounded) { to_->get_runner()->set_input_queue_options(to_, cfg.to_ep, cfg.queue); }
+
             to_->input_endpoint_increment();
         }
 
+        // 4. 解码输出只送往推理节点时，推理节点之外的帧都会被丢弃，提前在解码端按最高推理帧率抽帧
+        for (const auto &n : task_json.node_configs) {
+            if (n.second.type != "MediaDecoder_v2" || n.second.props.count("frame_rate_limit") > 0) { continue; }
+
+            float frame_rate_limit = 0;
+            for (const auto &line : task_json.node_flows) {
+                if (line.second.from != n.first) { continue; }
+
+                const auto &to_type = task_json.node_configs.at(line.second.to).type;
+                const auto &to_props = task_all_nodes[line.second.to]->properties().items();
+                auto iter = to_props.find("frame_rate");
+                if ((to_type != "Inference_v2" && to_type != "Detection_v2" && to_type != "Classifier_v2")
+                    || iter == to_props.end()) {
+                    frame_rate_limit = 0;
+                    break;
+                }
+                frame_rate_limit = std::max(frame_rate_limit, iter->second.get_runtime_value().get<float>());
+            }
+
+            if (frame_rate_limit > 0) {
+                task_all_nodes[n.first]->properties().try_set_property("frame_rate_limit", frame_rate_limit);
+            }
+        }
+
+        // 5. 图片服务只送往推理节点时，按这些模型的输入尺寸缩小解码，模型加载完成后生效
+        for (const auto &n : task_json.node_configs) {
+            if (n.second.type != "ImageServer_v2" || n.second.props.count("decode_size") > 0) { continue; }
+
+            std::vector<std::string> decode_models;
+            for (const auto &line : task_json.node_flows) {
+                if (line.second.from != n.first) { continue; }
+
+                const auto &to_type = task_json.node_configs.at(line.second.to).type;
+                const auto &to_props = task_all_nodes[line.second.to]->properties().items();
+                auto iter = to_props.find("mod_path");
+                if ((to_type != "Inference_v2" && to_type != "Detection_v2" && to_type != "Classifier_v2")
+                    || iter == to_props.end()) {
+                    decode_models.clear();
+                    break;
+                }
+                decode_models.push_back(iter->second.get_runtime_value().get<std::string>());
+            }
+
+            if (!decode_models.empty()) {
+                task_all_nodes[n.first]->properties().try_set_property("decode_models", decode_models);
+            }
+        }
+
         slice_->running_ctrl_ctx_ = std::make_shared<running_ctrl_ctx>();
         slice_->running_ctrl_ctx_->raw_json = task_json.raw_json;
         slice_->running_ctrl_ctx_->name = slice_name;
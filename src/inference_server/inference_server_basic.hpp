@@ -43,6 +43,18 @@ public:
      */
     virtual nlohmann::json get_tasks_json() = 0;
 
+    /**
+     * @brief get runtime metrics of all tasks, return in JSON object
+     * @return
+     */
+    virtual nlohmann::json get_tasks_metrics_json() = 0;
+
+    /**
+     * @brief get runtime metrics of all tasks, in Prometheus text exposition format
+     * @return
+     */
+    virtual std::string get_tasks_metrics_prometheus() = 0;
+
     /**
      * @brief preview
      * 
@@ -120,6 +120,20 @@ public:
         return task_list;
     }
 
+    nlohmann::json get_tasks_metrics_json() override {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        auto task_list = nlohmann::json::array();
+        for (const auto &task : tasks_) { task_list.push_back(task.second->get_metrics_json()); }
+        return task_list;
+    }
+
+    std::string get_tasks_metrics_prometheus() override {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        gddi::ngraph::metrics::PrometheusText text;
+        for (const auto &task : tasks_) { task.second->get_metrics_prometheus(text); }
+        return text.str();
+    }
+
     ResultMsg preview_task(const std::string &task_name, const std::string &codec, const std::string &stream_url,
                            int node_id) override {
         std::lock_guard<std::mutex> lock_guard(mutex_);
@@ -14,7 +14,8 @@ namespace algo {
 enum class InferType { kAsync, kSync };
 
 struct ModParms {
-    int stream_id;// 对应 bitmain 推理的 m_streamId
+    int stream_id{0};// 对应 bitmain 推理的 m_streamId
+    std::string backend;// 推理后端，为空时使用默认后端
 
     std::string mod_id;
     std::string mod_name;
@@ -24,6 +25,7 @@ struct ModParms {
     float frame_rate{15};
     size_t instances{1};
     uint32_t batch_size{1};
+    uint32_t batch_wait_ms{20};// 凑批最长等待时间
 };
 
 struct AlgoOutput {
@@ -44,6 +46,12 @@ struct AlgoOutput {
 using InitCallback = std::function<void(const std::vector<std::string> &)>;
 using InferCallback = std::function<void(const int64_t, const AlgoType, const std::vector<algo::AlgoOutput> &)>;
 
+struct BatchItem {
+    int64_t id;// 结果回调时的帧序号
+    std::string task_name;
+    std::shared_ptr<nodes::FrameInfo> info;
+};
+
 class AbstractAlgo {
 public:
     AbstractAlgo() {}
@@ -57,6 +65,16 @@ public:
     virtual AlgoType inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
                                std::map<int, std::vector<algo::AlgoOutput>> &outputs) = 0;
 
+    /**
+     * @brief 批量异步推理，每一帧的结果通过 InferCallback 按 BatchItem::id 返回
+     */
+    virtual void inference(const std::vector<BatchItem> &batch) = 0;
+
+    /**
+     * @brief 网络输入宽高，init() 之后有效，后端无法获取时为 {0, 0}
+     */
+    virtual std::pair<int, int> input_size() const { return {0, 0}; }
+
     void register_init_callback(const InitCallback &callback) { init_callback_ = callback; }
     void register_infer_callback(const InferCallback &callback) { infer_callback_ = callback; }
 
@@ -0,0 +1,82 @@
+#include "algo_factory.h"
+#include "replay_inference.h"
+#include <stdexcept>
+
+#ifdef WITH_TSING_INFERENCE
+#include "tsing_inference.h"
+#endif
+
+#ifdef WITH_CPU_INFERENCE
+#include "cpu_inference.h"
+#endif
+
+namespace gddi {
+namespace algo {
+
+AlgoBackendRegistry::AlgoBackendRegistry() {
+    // 静态库中的注册代码可能不会被链接，内置后端在这里显式注册
+    creators_["replay"] = [] { return std::make_unique<ReplayInference>(); };
+#ifdef WITH_CPU_INFERENCE
+    creators_["cpu"] = [] { return std::make_unique<CpuInference>(); };
+#endif
+#ifdef WITH_TSING_INFERENCE
+    creators_["tsing"] = [] { return std::make_unique<TsingInference>(); };
+#endif
+
+    // 优先使用加速卡，没有编译时使用 CPU 后端
+#if defined(WITH_TSING_INFERENCE)
+    default_backend_ = "tsing";
+#elif defined(WITH_CPU_INFERENCE)
+    default_backend_ = "cpu";
+#else
+    default_backend_ = "replay";
+#endif
+}
+
+AlgoBackendRegistry &AlgoBackendRegistry::get_instance() {
+    static AlgoBackendRegistry registry;
+    return registry;
+}
+
+void AlgoBackendRegistry::register_backend(const std::string &name, Creator creator) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    creators_[name] = std::move(creator);
+}
+
+std::unique_ptr<AbstractAlgo> AlgoBackendRegistry::create(const std::string &name) const {
+    Creator creator;
+    {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        auto iter = creators_.find(name.empty() ? default_backend_ : name);
+        if (iter == creators_.end()) {
+            throw std::runtime_error("Undefined inference backend: " + (name.empty() ? default_backend_ : name));
+        }
+        creator = iter->second;
+    }
+    return creator();
+}
+
+std::vector<std::string> AlgoBackendRegistry::backends() const {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    std::vector<std::string> names;
+    for (const auto &item : creators_) { names.push_back(item.first); }
+    return names;
+}
+
+void AlgoBackendRegistry::set_default_backend(const std::string &name) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    if (creators_.count(name) == 0) { throw std::runtime_error("Undefined inference backend: " + name); }
+    default_backend_ = name;
+}
+
+std::string AlgoBackendRegistry::default_backend() const {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    return default_backend_;
+}
+
+std::unique_ptr<AbstractAlgo> make_algo_impl(const std::string &backend) {
+    return AlgoBackendRegistry::get_instance().create(backend);
+}
+
+}// namespace algo
+}// namespace gddi
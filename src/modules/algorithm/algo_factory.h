@@ -1,15 +1,64 @@
 #ifndef __ALGO_FACTORY_H__
 #define __ALGO_FACTORY_H__
 
-#include "tsing_inference.h"
+#include "abstract_algo.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace gddi {
 namespace algo {
 
-static std::unique_ptr<AbstractAlgo> make_algo_impl() {
-    return std::make_unique<TsingInference>();
-}
+/**
+ * @brief 推理后端注册表，按名称创建 AbstractAlgo 实现
+ *
+ *        内置后端:
+ *          tsing  - 加速卡推理 SDK (默认)，WITH_TSING_INFERENCE 时编译
+ *          replay - 按帧序号回放录制好的 AlgoOutput，不依赖任何硬件
+ *          cpu    - OpenCV DNN 加载 ONNX 模型，在 CPU 上推理 (需要 OpenCV dnn 模块)
+ */
+class AlgoBackendRegistry {
+public:
+    using Creator = std::function<std::unique_ptr<AbstractAlgo>()>;
+
+    AlgoBackendRegistry(const AlgoBackendRegistry &) = delete;
+    AlgoBackendRegistry &operator=(const AlgoBackendRegistry &) = delete;
+
+    static AlgoBackendRegistry &get_instance();
+
+    /**
+     * @brief 注册后端，同名后端会被覆盖
+     */
+    void register_backend(const std::string &name, Creator creator);
+
+    /**
+     * @brief 创建后端实例，名称为空时使用默认后端，后端不存在时抛出 std::runtime_error
+     */
+    std::unique_ptr<AbstractAlgo> create(const std::string &name) const;
+
+    std::vector<std::string> backends() const;
+
+    void set_default_backend(const std::string &name);
+    std::string default_backend() const;
+
+private:
+    AlgoBackendRegistry();
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, Creator> creators_;
+    std::string default_backend_;
+};
+
+/**
+ * @brief 创建推理实现，backend 为空时使用默认后端
+ */
+std::unique_ptr<AbstractAlgo> make_algo_impl(const std::string &backend = {});
+
 }// namespace algo
 }// namespace gddi
 
-#endif
\ No newline at end of file
+#endif
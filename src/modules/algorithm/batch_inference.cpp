@@ -0,0 +1,99 @@
+#include "batch_inference.h"
+#include "common_basic/thread_dbg_utils.hpp"
+#include <spdlog/spdlog.h>
+
+namespace gddi {
+namespace algo {
+
+BatchInferenceService::Client::Client(std::shared_ptr<BatchInferenceService> service, InferCallback callback)
+    : service_(std::move(service)), slot_(std::make_shared<InferSlot>()) {
+    slot_->callback = std::move(callback);
+}
+
+void BatchInferenceService::Client::submit(const std::string &task_name,
+                                           const std::shared_ptr<nodes::FrameInfo> &info) {
+    service_->push_({{slot_, {info->infer_frame_idx, task_name, info}}, std::chrono::steady_clock::now()});
+}
+
+BatchInferenceService::BatchInferenceService(const ModParms &parms)
+    : parms_(parms), model_(ModelRegistry::get_instance().acquire_model(parms)) {
+    if (parms_.batch_size == 0) { parms_.batch_size = 1; }
+
+    // 模型在工作线程中按需加载，已被其它任务加载时立即完成
+    std::promise<bool> ready_promise;
+    ready_ = ready_promise.get_future().share();
+    worker_ = std::thread([this, promise = std::move(ready_promise)]() mutable {
+        gddi::thread_utils::set_cur_thread_name(std::string("batch-infer"));
+        auto loaded = model_->load().get();
+        promise.set_value(loaded);
+        if (loaded) { run_(); }
+    });
+}
+
+BatchInferenceService::~BatchInferenceService() {
+    {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) { worker_.join(); }
+    spdlog::debug("destructor: BatchInferenceService: {}", parms_.mod_path);
+}
+
+std::shared_ptr<BatchInferenceService> BatchInferenceService::acquire(const ModParms &parms) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<BatchInferenceService>> services;
+
+    std::lock_guard<std::mutex> lock_guard(mutex);
+    auto key = parms.backend + ":" + parms.mod_path;
+    auto service = services[key].lock();
+    if (service) {
+        if (service->parms_.batch_size != parms.batch_size || service->parms_.batch_wait_ms != parms.batch_wait_ms) {
+            spdlog::warn("BatchInferenceService: {}, using batch_size: {}, batch_wait_ms: {}", parms.mod_path,
+                         service->parms_.batch_size, service->parms_.batch_wait_ms);
+        }
+        return service;
+    }
+
+    service = std::shared_ptr<BatchInferenceService>(new BatchInferenceService(parms));
+    services[key] = service;
+    return service;
+}
+
+void BatchInferenceService::push_(PendingFrame &&frame) {
+    {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        pending_frames_.emplace_back(std::move(frame));
+    }
+    cv_.notify_one();
+}
+
+void BatchInferenceService::run_() {
+    auto max_wait = std::chrono::milliseconds(parms_.batch_wait_ms);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return stop_ || !pending_frames_.empty(); });
+        if (stop_) { break; }
+
+        // 凑批，最早的帧等待超过 batch_wait_ms 后不满一批也提交
+        auto deadline = pending_frames_.front().queued_at + max_wait;
+        cv_.wait_until(lock, deadline, [this] { return stop_ || pending_frames_.size() >= parms_.batch_size; });
+        if (stop_) { break; }
+
+        std::vector<SlotItem> batch;
+        while (!pending_frames_.empty() && batch.size() < parms_.batch_size) {
+            batch.emplace_back(std::move(pending_frames_.front().item));
+            pending_frames_.pop_front();
+        }
+        lock.unlock();
+
+        try {
+            model_->inference(batch);
+        } catch (const std::exception &e) { spdlog::error("BatchInferenceService: {}, {}", parms_.mod_path, e.what()); }
+
+        lock.lock();
+    }
+}
+
+}// namespace algo
+}// namespace gddi
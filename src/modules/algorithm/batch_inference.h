@@ -0,0 +1,97 @@
+#ifndef __BATCH_INFERENCE_H__
+#define __BATCH_INFERENCE_H__
+
+#include "model_registry.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace gddi {
+namespace algo {
+
+/**
+ * @brief 跨任务共享的批量推理服务，按推理后端 + 模型路径区分
+ *
+ *        使用同一个模型的节点把帧提交到同一个服务，工作线程凑满 batch_size 或等待超过 batch_wait_ms 后
+ *        一次性提交给共享模型，结果再按帧通过各自的 InferCallback 返回。
+ *        最后一个 Client 释放后服务随之销毁。
+ */
+class BatchInferenceService {
+public:
+    class Client {
+    public:
+        Client(std::shared_ptr<BatchInferenceService> service, InferCallback callback);
+        ~Client() { close(); }
+
+        /**
+         * @brief 异步提交一帧，结果以 info->infer_frame_idx 回调
+         */
+        void submit(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info);
+
+        /**
+         * @brief 关闭后不再回调，返回时保证没有正在执行的回调
+         */
+        void close() { slot_->close(); }
+
+        const std::shared_ptr<BatchInferenceService> &service() const { return service_; }
+
+    private:
+        std::shared_ptr<BatchInferenceService> service_;
+        std::shared_ptr<InferSlot> slot_;
+    };
+
+    ~BatchInferenceService();
+
+    /**
+     * @brief 获取模型对应的服务，不存在时创建并在后台加载模型
+     *
+     *        批量参数以第一次创建时为准
+     */
+    static std::shared_ptr<BatchInferenceService> acquire(const ModParms &parms);
+
+    /**
+     * @brief 模型加载结果
+     */
+    std::shared_future<bool> ready() const { return ready_; }
+
+    std::vector<std::string> labels() const { return model_->labels(); }
+
+    /**
+     * @brief 多阶段同步推理
+     */
+    AlgoType inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                       std::map<int, std::vector<algo::AlgoOutput>> &outputs) {
+        return model_->inference(task_name, info, outputs);
+    }
+
+private:
+    explicit BatchInferenceService(const ModParms &parms);
+
+    struct PendingFrame {
+        SlotItem item;
+        std::chrono::steady_clock::time_point queued_at;
+    };
+
+    void push_(PendingFrame &&frame);
+    void run_();
+
+private:
+    ModParms parms_;
+    std::shared_ptr<SharedModel> model_;
+    std::shared_future<bool> ready_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<PendingFrame> pending_frames_;// 等待凑批的帧
+    bool stop_{false};
+
+    std::thread worker_;
+};
+
+}// namespace algo
+}// namespace gddi
+
+#endif// __BATCH_INFERENCE_H__
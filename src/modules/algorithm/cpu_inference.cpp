@@ -0,0 +1,282 @@
+#include "cpu_inference.h"
+#include "common_basic/thread_dbg_utils.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <opencv2/dnn.hpp>
+#include <opencv2/imgproc.hpp>
+#include <thread>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libswscale/swscale.h>
+}
+
+namespace gddi {
+namespace algo {
+
+struct CpuInference::Impl {
+    cv::dnn::Net net;
+    std::mutex net_mutex;// cv::dnn::Net 不是线程安全的
+
+    AlgoType algo_type{AlgoType::kUndefined};
+    std::vector<std::string> labels;
+    cv::Size input_size{640, 640};
+    float conf_thres{0.05};
+    float nms_thres{0.45};
+
+    SwsContext *sws_ctx{nullptr};// 只在持有 net_mutex 时使用
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<BatchItem> pending_items;
+    bool stop{false};
+    std::thread worker;
+
+    ~Impl() { sws_freeContext(sws_ctx); }
+
+    cv::Mat to_bgr(const AVFrame *frame) {
+        sws_ctx = sws_getCachedContext(sws_ctx, frame->width, frame->height, (AVPixelFormat)frame->format,
+                                       frame->width, frame->height, AV_PIX_FMT_BGR24, SWS_BILINEAR, nullptr,
+                                       nullptr, nullptr);
+        if (!sws_ctx) { throw std::runtime_error("CpuInference: unsupported frame format"); }
+
+        cv::Mat image(frame->height, frame->width, CV_8UC3);
+        uint8_t *dst_data[1] = {image.data};
+        int dst_linesize[1] = {(int)image.step};
+        sws_scale(sws_ctx, frame->data, frame->linesize, 0, frame->height, dst_data, dst_linesize);
+        return image;
+    }
+
+    cv::Mat forward(const cv::Mat &image) {
+        auto blob = cv::dnn::blobFromImage(image, 1.0 / 255, input_size, cv::Scalar(), true, false);
+        net.setInput(blob);
+        return net.forward().clone();
+    }
+
+    /**
+     * @brief 推理单张 BGR 图像，目标框为图像坐标
+     */
+    std::vector<AlgoOutput> run(const cv::Mat &image) {
+        auto output = forward(image);
+        if (algo_type == AlgoType::kClassification) { return decode_classification(output, image.size()); }
+        return decode_detection(output, image.size());
+    }
+
+    std::vector<AlgoOutput> decode_detection(const cv::Mat &output, const cv::Size &image_size) const {
+        if (output.dims != 3) { throw std::runtime_error("CpuInference: detection output must be 3-D"); }
+
+        // YOLOv5: [1, N, 5 + C]，YOLOv8: [1, 4 + C, N] 无目标置信度
+        bool transposed = output.size[1] < output.size[2];
+        int rows = transposed ? output.size[2] : output.size[1];
+        int cols = transposed ? output.size[1] : output.size[2];
+        cv::Mat preds(output.size[1], output.size[2], CV_32F, (void *)output.ptr<float>());
+        if (transposed) { preds = preds.t(); }
+
+        int class_offset = transposed ? 4 : 5;
+        float scale_x = (float)image_size.width / input_size.width;
+        float scale_y = (float)image_size.height / input_size.height;
+
+        std::vector<cv::Rect> boxes;
+        std::vector<float> scores;
+        std::vector<int> class_ids;
+        for (int i = 0; i < rows; i++) {
+            const float *row = preds.ptr<float>(i);
+            float objectness = transposed ? 1.0f : row[4];
+            if (objectness < conf_thres) { continue; }
+
+            auto max_iter = std::max_element(row + class_offset, row + cols);
+            float score = objectness * (*max_iter);
+            if (score < conf_thres) { continue; }
+
+            float w = row[2] * scale_x;
+            float h = row[3] * scale_y;
+            boxes.emplace_back((int)(row[0] * scale_x - w / 2), (int)(row[1] * scale_y - h / 2), (int)w, (int)h);
+            scores.emplace_back(score);
+            class_ids.emplace_back((int)(max_iter - (row + class_offset)));
+        }
+
+        std::vector<int> indices;
+        cv::dnn::NMSBoxes(boxes, scores, conf_thres, nms_thres, indices);
+
+        std::vector<AlgoOutput> vec_output;
+        for (auto idx : indices) {
+            auto box = boxes[idx] & cv::Rect(0, 0, image_size.width, image_size.height);
+            vec_output.emplace_back(AlgoOutput{.class_id = class_ids[idx],
+                                               .label = label_of(class_ids[idx]),
+                                               .prob = scores[idx],
+                                               .box = {(float)box.x, (float)box.y, (float)box.width,
+                                                       (float)box.height}});
+        }
+        return vec_output;
+    }
+
+    std::vector<AlgoOutput> decode_classification(const cv::Mat &output, const cv::Size &image_size) const {
+        cv::Mat probs = output.reshape(1, 1);
+        double min_value, max_value;
+        cv::minMaxLoc(probs, &min_value, &max_value);
+        if (min_value < 0 || max_value > 1) {
+            // 输出为 logits 时做 softmax
+            cv::exp(probs - max_value, probs);
+            probs /= cv::sum(probs)[0];
+        }
+
+        cv::Point max_loc;
+        cv::minMaxLoc(probs, nullptr, &max_value, nullptr, &max_loc);
+        return {AlgoOutput{.class_id = max_loc.x,
+                           .label = label_of(max_loc.x),
+                           .prob = (float)max_value,
+                           .box = {0, 0, (float)image_size.width, (float)image_size.height}}};
+    }
+
+    std::string label_of(int class_id) const {
+        return class_id < (int)labels.size() ? labels[class_id] : std::to_string(class_id);
+    }
+};
+
+static std::vector<std::string> read_label_file(const std::string &mod_path) {
+    auto stem = mod_path.substr(0, mod_path.rfind('.'));
+    for (const auto &path : {stem + ".names", stem + ".txt"}) {
+        std::ifstream file(path);
+        if (!file.is_open()) { continue; }
+
+        std::vector<std::string> labels;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+            if (!line.empty()) { labels.emplace_back(line); }
+        }
+        return labels;
+    }
+    return {};
+}
+
+CpuInference::CpuInference() : impl_(std::make_unique<CpuInference::Impl>()) {}
+
+CpuInference::~CpuInference() {
+    // 已提交的帧全部推理并回调后才退出
+    {
+        std::lock_guard<std::mutex> lock_guard(impl_->mutex);
+        impl_->stop = true;
+    }
+    impl_->cv.notify_all();
+    if (impl_->worker.joinable()) { impl_->worker.join(); }
+}
+
+bool CpuInference::init(const ModParms &parms) {
+    nlohmann::json config = nlohmann::json::object();
+    std::ifstream config_file(parms.mod_path + ".json");
+    if (config_file.is_open()) { config = nlohmann::json::parse(config_file); }
+
+    if (config.count("input_size")) {
+        auto input_size = config["input_size"].get<std::vector<int>>();
+        if (input_size.size() != 2) { throw std::runtime_error("input_size must be [width, height]"); }
+        impl_->input_size = cv::Size(input_size[0], input_size[1]);
+    }
+    impl_->nms_thres = config.value("nms_thres", impl_->nms_thres);
+    impl_->conf_thres = config.value("conf_thres", impl_->conf_thres);
+
+    impl_->net = cv::dnn::readNet(parms.mod_path);
+    impl_->net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+    impl_->net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+
+    // 空跑一次，既是预热，也用于判断输出格式
+    auto output = impl_->forward(cv::Mat::zeros(impl_->input_size, CV_8UC3));
+    int num_classes = 0;
+    if (config.count("model_type")) {
+        auto model_type = config["model_type"].get<std::string>();
+        if (model_type == "detection") {
+            impl_->algo_type = AlgoType::kDetection;
+        } else if (model_type == "classification") {
+            impl_->algo_type = AlgoType::kClassification;
+        } else {
+            throw std::runtime_error("CpuInference: unsupported model type: " + model_type);
+        }
+    } else {
+        impl_->algo_type = output.dims == 3 ? AlgoType::kDetection : AlgoType::kClassification;
+    }
+    if (impl_->algo_type == AlgoType::kDetection) {
+        if (output.dims != 3) { throw std::runtime_error("CpuInference: detection output must be 3-D"); }
+        num_classes = std::min(output.size[1], output.size[2]) - (output.size[1] < output.size[2] ? 4 : 5);
+    } else {
+        num_classes = (int)output.total();
+    }
+
+    impl_->labels = config.value("labels", std::vector<std::string>());
+    if (impl_->labels.empty()) { impl_->labels = read_label_file(parms.mod_path); }
+    for (int i = (int)impl_->labels.size(); i < num_classes; i++) { impl_->labels.emplace_back(std::to_string(i)); }
+
+    impl_->worker = std::thread([this]() {
+        gddi::thread_utils::set_cur_thread_name(std::string("cpu-infer"));
+        std::unique_lock<std::mutex> lock(impl_->mutex);
+        while (true) {
+            impl_->cv.wait(lock, [this] { return impl_->stop || !impl_->pending_items.empty(); });
+            if (impl_->pending_items.empty()) { break; }
+
+            auto item = std::move(impl_->pending_items.front());
+            impl_->pending_items.pop_front();
+            lock.unlock();
+
+            std::vector<AlgoOutput> vec_output;
+            try {
+                std::lock_guard<std::mutex> net_lock(impl_->net_mutex);
+                vec_output = impl_->run(impl_->to_bgr(item.info->src_frame->data.get()));
+            } catch (const std::exception &e) { spdlog::error("CpuInference: {}", e.what()); }
+            if (infer_callback_) { infer_callback_(item.id, impl_->algo_type, vec_output); }
+
+            lock.lock();
+        }
+    });
+
+    return AbstractAlgo::init(parms, impl_->algo_type, impl_->labels);
+}
+
+void CpuInference::inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                             const InferType type) {
+    inference({BatchItem{info->infer_frame_idx, task_name, info}});
+}
+
+void CpuInference::inference(const std::vector<BatchItem> &batch) {
+    if (batch.empty()) { return; }
+
+    {
+        std::lock_guard<std::mutex> lock_guard(impl_->mutex);
+        impl_->pending_items.insert(impl_->pending_items.end(), batch.begin(), batch.end());
+    }
+    impl_->cv.notify_one();
+}
+
+std::pair<int, int> CpuInference::input_size() const {
+    return {impl_->input_size.width, impl_->input_size.height};
+}
+
+AlgoType CpuInference::inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                                 std::map<int, std::vector<algo::AlgoOutput>> &outputs) {
+    const auto &ext_info = info->ext_info.back();
+    for (const auto &[target_id, image] : ext_info.crop_images) {
+        // 扣图为 NV12，高度为原图的 3/2
+        cv::Mat bgr_image;
+        cv::cvtColor(image, bgr_image, cv::COLOR_YUV2BGR_NV12);
+
+        std::vector<AlgoOutput> vec_output;
+        {
+            std::lock_guard<std::mutex> net_lock(impl_->net_mutex);
+            vec_output = impl_->run(bgr_image);
+        }
+
+        const auto &rect = ext_info.crop_rects.at(target_id);
+        auto &target_outputs = outputs[target_id];
+        for (auto &output : vec_output) {
+            output.box.x += rect.x;
+            output.box.y += rect.y;
+            target_outputs.emplace_back(std::move(output));
+        }
+    }
+
+    return impl_->algo_type;
+}
+
+}// namespace algo
+}// namespace gddi
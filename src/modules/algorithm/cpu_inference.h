@@ -0,0 +1,50 @@
+#ifndef __CPU_INFERENCE_H__
+#define __CPU_INFERENCE_H__
+
+#include "abstract_algo.h"
+#include <memory>
+#include <vector>
+
+namespace gddi {
+namespace algo {
+
+/**
+ * @brief CPU 推理后端，使用 OpenCV DNN 加载 ONNX 模型，要求输入帧为软解的 AVFrame
+ *
+ *        支持的模型输出:
+ *          检测 - [1, N, 5 + C] (YOLOv5) 或 [1, 4 + C, N] (YOLOv8)，框坐标相对于网络输入尺寸
+ *          分类 - [1, C]
+ *        可选的配置文件为 mod_path + ".json":
+ *        {
+ *            "model_type": "detection",  // 缺省时按输出维度判断
+ *            "input_size": [640, 640],   // 网络输入宽高，默认 640x640
+ *            "labels": ["person"],       // 缺省时读取同名 .names/.txt 文件，再缺省时使用类别序号
+ *            "nms_thres": 0.45,
+ *            "conf_thres": 0.05          // 后端的最低置信度
+ *        }
+ *        同一模型由多个阈值不同的任务共享，后端不使用 ModParms::mod_thres，由推理节点按各自的阈值过滤。
+ *        异步推理在内部工作线程中逐帧执行并回调。
+ */
+class CpuInference : public AbstractAlgo {
+public:
+    CpuInference();
+    ~CpuInference();
+
+    bool init(const ModParms &parms) override;
+
+    void inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                   const InferType type) override;
+    AlgoType inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                       std::map<int, std::vector<algo::AlgoOutput>> &outputs) override;
+    void inference(const std::vector<BatchItem> &batch) override;
+    std::pair<int, int> input_size() const override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}// namespace algo
+}// namespace gddi
+
+#endif// __CPU_INFERENCE_H__
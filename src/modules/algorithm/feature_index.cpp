@@ -0,0 +1,517 @@
+#include "feature_index.h"
+#include <algorithm>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <queue>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define FEATURE_DOT_AVX2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FEATURE_DOT_NEON
+#endif
+
+namespace gddi {
+namespace algo {
+
+static float dot_scalar(const float *a, const float *b, size_t dim) {
+    float sum[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= dim; i += 4) {
+        sum[0] += a[i] * b[i];
+        sum[1] += a[i + 1] * b[i + 1];
+        sum[2] += a[i + 2] * b[i + 2];
+        sum[3] += a[i + 3] * b[i + 3];
+    }
+    for (; i < dim; i++) { sum[0] += a[i] * b[i]; }
+    return sum[0] + sum[1] + sum[2] + sum[3];
+}
+
+#if defined(FEATURE_DOT_AVX2)
+__attribute__((target("avx2,fma"))) static float dot_avx2(const float *a, const float *b, size_t dim) {
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+    }
+    for (; i + 8 <= dim; i += 8) { sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0); }
+
+    sum0 = _mm256_add_ps(sum0, sum1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+    sum = _mm_hadd_ps(sum, sum);
+    sum = _mm_hadd_ps(sum, sum);
+
+    float result = _mm_cvtss_f32(sum);
+    for (; i < dim; i++) { result += a[i] * b[i]; }
+    return result;
+}
+#endif
+
+#if defined(FEATURE_DOT_NEON)
+static float dot_neon(const float *a, const float *b, size_t dim) {
+    float32x4_t sum0 = vdupq_n_f32(0);
+    float32x4_t sum1 = vdupq_n_f32(0);
+    size_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        sum0 = vmlaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+        sum1 = vmlaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    sum0 = vaddq_f32(sum0, sum1);
+#if defined(__aarch64__)
+    float result = vaddvq_f32(sum0);
+#else
+    float32x2_t sum = vadd_f32(vget_low_f32(sum0), vget_high_f32(sum0));
+    float result = vget_lane_f32(vpadd_f32(sum, sum), 0);
+#endif
+    for (; i < dim; i++) { result += a[i] * b[i]; }
+    return result;
+}
+#endif
+
+using DotFunc = float (*)(const float *, const float *, size_t);
+
+static DotFunc select_dot() {
+#if defined(FEATURE_DOT_AVX2)
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return dot_avx2; }
+#elif defined(FEATURE_DOT_NEON)
+    return dot_neon;
+#endif
+    return dot_scalar;
+}
+
+float feature_dot(const float *a, const float *b, size_t dim) {
+    static const DotFunc func = select_dot();
+    return func(a, b, dim);
+}
+
+/**
+ * @brief 索引文件头，之后依次为 vectors、labels、levels、links0、upper_offsets、upper
+ */
+struct IndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t dim;
+    uint32_t m;
+    uint32_t count;
+    uint32_t entry;
+    int32_t max_level;
+    uint32_t upper_size;
+    uint32_t reserved[8];
+};
+static_assert(sizeof(IndexHeader) == 64, "IndexHeader must be 64 bytes");
+
+static const char kIndexMagic[4] = {'G', 'F', 'I', 'X'};
+static const uint32_t kIndexVersion = 1;
+static const int kMaxLevel = 16;
+
+struct FeatureIndex::MappedFile {
+    boost::interprocess::file_mapping mapping;
+    boost::interprocess::mapped_region region;
+
+    explicit MappedFile(const std::string &path)
+        : mapping(path.c_str(), boost::interprocess::read_only), region(mapping, boost::interprocess::read_only) {}
+};
+
+FeatureIndex::FeatureIndex(uint32_t dim, uint32_t m, uint32_t ef_construction)
+    : dim_(dim), m_(m), max_m0_(m * 2), ef_construction_(ef_construction), level_mult_(1 / std::log((double)m)) {}
+
+FeatureIndex::~FeatureIndex() {}
+
+bool FeatureIndex::load(const std::string &path) {
+    clear();
+
+    std::unique_ptr<MappedFile> mapped;
+    try {
+        mapped = std::make_unique<MappedFile>(path);
+    } catch (const boost::interprocess::interprocess_exception &) { return false; }
+
+    auto size = mapped->region.get_size();
+    auto data = static_cast<const uint8_t *>(mapped->region.get_address());
+    if (size < sizeof(IndexHeader)) { return false; }
+
+    IndexHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, kIndexMagic, sizeof(kIndexMagic)) != 0 || header.version != kIndexVersion
+        || header.dim != dim_ || header.m == 0) {
+        return false;
+    }
+
+    size_t count = header.count;
+    size_t links0_stride = 1 + header.m * 2;
+    size_t expected = sizeof(header) + count * dim_ * sizeof(float)
+        + (count * 3 + count * links0_stride + header.upper_size) * sizeof(uint32_t);
+    if (size != expected || (count > 0 && header.entry >= count)) { return false; }
+
+    m_ = header.m;
+    max_m0_ = m_ * 2;
+    level_mult_ = 1 / std::log((double)m_);
+    count_ = header.count;
+    entry_ = header.entry;
+    max_level_ = header.max_level;
+
+    vectors_ = reinterpret_cast<const float *>(data + sizeof(header));
+    labels_ = reinterpret_cast<const uint32_t *>(vectors_ + count * dim_);
+    levels_ = labels_ + count;
+    links0_ = levels_ + count;
+    upper_offsets_ = links0_ + count * links0_stride;
+    upper_ = upper_offsets_ + count;
+    mapped_ = std::move(mapped);
+
+    // 文件内容不可信，检索时不再做边界检查，这里一次性校验
+    if (!check_graph(header.upper_size)) {
+        clear();
+        return false;
+    }
+
+    for (uint32_t id = 0; id < count_; id++) {
+        if (labels_[id] == kInvalidLabel) {
+            ++deleted_;
+        } else {
+            label_map_[labels_[id]] = id;
+        }
+    }
+    return true;
+}
+
+bool FeatureIndex::save(const std::string &path) const {
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) { return false; }
+
+    size_t upper_size = 0;
+    for (uint32_t id = 0; id < count_; id++) { upper_size += levels_[id] * (1 + m_); }
+
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+    header.version = kIndexVersion;
+    header.dim = dim_;
+    header.m = m_;
+    header.count = count_;
+    header.entry = entry_;
+    header.max_level = max_level_;
+    header.upper_size = upper_size;
+
+    auto write = [&ofs](const void *data, size_t size) { ofs.write(reinterpret_cast<const char *>(data), size); };
+    write(&header, sizeof(header));
+    write(vectors_, (size_t)count_ * dim_ * sizeof(float));
+    write(labels_, count_ * sizeof(uint32_t));
+    write(levels_, count_ * sizeof(uint32_t));
+    write(links0_, (size_t)count_ * (1 + max_m0_) * sizeof(uint32_t));
+    write(upper_offsets_, count_ * sizeof(uint32_t));
+    write(upper_, upper_size * sizeof(uint32_t));
+    return ofs.good();
+}
+
+void FeatureIndex::clear() {
+    mapped_.reset();
+    owned_vectors_.clear();
+    owned_labels_.clear();
+    owned_levels_.clear();
+    owned_links0_.clear();
+    owned_upper_offsets_.clear();
+    owned_upper_.clear();
+    label_map_.clear();
+
+    count_ = 0;
+    entry_ = 0;
+    max_level_ = -1;
+    deleted_ = 0;
+    update_view();
+}
+
+void FeatureIndex::add(uint32_t label, const float *feature) {
+    std::vector<float> normalized(feature, feature + dim_);
+    float norm = std::sqrt(feature_dot(feature, feature, dim_));
+    if (norm > 0) {
+        for (auto &value : normalized) { value /= norm; }
+    }
+
+    remove(label);
+    detach();
+    insert(label, normalized.data());
+}
+
+bool FeatureIndex::remove(uint32_t label) {
+    auto iter = label_map_.find(label);
+    if (iter == label_map_.end()) { return false; }
+
+    detach();
+    owned_labels_[iter->second] = kInvalidLabel;
+    label_map_.erase(iter);
+    if (++deleted_ * 4 > count_) { compact(); }
+    return true;
+}
+
+void FeatureIndex::relabel(const std::vector<uint32_t> &labels) {
+    detach();
+    label_map_.clear();
+    for (uint32_t id = 0; id < count_; id++) {
+        auto &label = owned_labels_[id];
+        if (label == kInvalidLabel) { continue; }
+
+        label = label < labels.size() ? labels[label] : kInvalidLabel;
+        if (label == kInvalidLabel) {
+            ++deleted_;
+        } else {
+            label_map_[label] = id;
+        }
+    }
+    if (deleted_ * 4 > count_) { compact(); }
+}
+
+std::vector<FeatureIndex::Result> FeatureIndex::search(const float *feature, size_t k, uint32_t ef) const {
+    std::vector<Result> results;
+    if (label_map_.empty() || k == 0) { return results; }
+
+    std::vector<float> query(feature, feature + dim_);
+    float norm = std::sqrt(feature_dot(feature, feature, dim_));
+    if (norm > 0) {
+        for (auto &value : query) { value /= norm; }
+    }
+
+    auto entry = greedy_search(query.data(), entry_, max_level_, 1);
+    auto candidates = search_layer(query.data(), entry, std::max<uint32_t>(ef, k), 0, true);
+    for (size_t i = 0; i < candidates.size() && i < k; i++) {
+        results.push_back({labels_[candidates[i].id], 1.0f - candidates[i].distance});
+    }
+    return results;
+}
+
+const uint32_t *FeatureIndex::links(uint32_t id, int level) const {
+    if (level == 0) { return links0_ + (size_t)id * (1 + max_m0_); }
+    return upper_ + upper_offsets_[id] + (level - 1) * (1 + m_);
+}
+
+uint32_t *FeatureIndex::mutable_links(uint32_t id, int level) {
+    if (level == 0) { return owned_links0_.data() + (size_t)id * (1 + max_m0_); }
+    return owned_upper_.data() + owned_upper_offsets_[id] + (level - 1) * (1 + m_);
+}
+
+uint32_t FeatureIndex::greedy_search(const float *query, uint32_t entry, int from_level, int to_level) const {
+    auto current = entry;
+    auto current_distance = distance(query, current);
+    for (int level = from_level; level >= to_level; level--) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            auto list = links(current, level);
+            for (uint32_t i = 1; i <= list[0]; i++) {
+                auto d = distance(query, list[i]);
+                if (d < current_distance) {
+                    current = list[i];
+                    current_distance = d;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return current;
+}
+
+std::vector<FeatureIndex::Candidate> FeatureIndex::search_layer(const float *query, uint32_t entry, uint32_t ef,
+                                                                int level, bool skip_deleted) const {
+    // 线程私有的访问标记，每次查询只递增 tag，不清空数组
+    thread_local std::vector<uint32_t> visited;
+    thread_local uint32_t tag = 0;
+    if (visited.size() < count_) { visited.resize(count_, 0); }
+    if (++tag == 0) {
+        std::fill(visited.begin(), visited.end(), 0);
+        tag = 1;
+    }
+
+    auto closer = [](const Candidate &a, const Candidate &b) { return a.distance > b.distance; };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(closer)> candidates(closer);
+    std::priority_queue<Candidate> results;// 堆顶为当前最远的结果
+
+    Candidate first{distance(query, entry), entry};
+    candidates.push(first);
+    if (!skip_deleted || labels_[entry] != kInvalidLabel) { results.push(first); }
+    visited[entry] = tag;
+
+    auto bound = [&results]() {
+        return results.empty() ? std::numeric_limits<float>::max() : results.top().distance;
+    };
+
+    while (!candidates.empty()) {
+        auto current = candidates.top();
+        if (current.distance > bound() && results.size() >= ef) { break; }
+        candidates.pop();
+
+        auto list = links(current.id, level);
+#if defined(__GNUC__)
+        for (uint32_t i = 1; i <= list[0]; i++) { __builtin_prefetch(vector(list[i])); }
+#endif
+        for (uint32_t i = 1; i <= list[0]; i++) {
+            auto id = list[i];
+            if (visited[id] == tag) { continue; }
+            visited[id] = tag;
+
+            auto d = distance(query, id);
+            if (results.size() < ef || d < bound()) {
+                candidates.push({d, id});
+                if (!skip_deleted || labels_[id] != kInvalidLabel) {
+                    results.push({d, id});
+                    if (results.size() > ef) { results.pop(); }
+                }
+            }
+        }
+    }
+
+    std::vector<Candidate> sorted(results.size());
+    for (auto iter = sorted.rbegin(); iter != sorted.rend(); ++iter) {
+        *iter = results.top();
+        results.pop();
+    }
+    return sorted;
+}
+
+std::vector<uint32_t> FeatureIndex::select_neighbors(std::vector<Candidate> candidates, uint32_t max_count) const {
+    // 启发式选择: 候选点离已选点比离目标点更近时跳过，保留不同方向的邻居
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<uint32_t> selected;
+    for (const auto &candidate : candidates) {
+        if (selected.size() >= max_count) { break; }
+
+        bool good = true;
+        for (auto id : selected) {
+            if (distance(vector(candidate.id), id) < candidate.distance) {
+                good = false;
+                break;
+            }
+        }
+        if (good) { selected.push_back(candidate.id); }
+    }
+    return selected;
+}
+
+void FeatureIndex::connect(uint32_t id, uint32_t neighbor, int level) {
+    auto list = mutable_links(id, level);
+    auto max_count = level == 0 ? max_m0_ : m_;
+    if (list[0] < max_count) {
+        list[++list[0]] = neighbor;
+        return;
+    }
+
+    std::vector<Candidate> candidates{{distance(vector(id), neighbor), neighbor}};
+    for (uint32_t i = 1; i <= list[0]; i++) { candidates.push_back({distance(vector(id), list[i]), list[i]}); }
+
+    auto selected = select_neighbors(std::move(candidates), max_count);
+    list[0] = selected.size();
+    std::copy(selected.begin(), selected.end(), list + 1);
+}
+
+void FeatureIndex::insert(uint32_t label, const float *normalized) {
+    std::uniform_real_distribution<double> uniform(std::numeric_limits<double>::min(), 1.0);
+    int level = std::min((int)(-std::log(uniform(level_rng_)) * level_mult_), kMaxLevel);
+
+    auto id = count_++;
+    owned_vectors_.insert(owned_vectors_.end(), normalized, normalized + dim_);
+    owned_labels_.push_back(label);
+    owned_levels_.push_back(level);
+    owned_links0_.resize(owned_links0_.size() + 1 + max_m0_, 0);
+    owned_upper_offsets_.push_back(owned_upper_.size());
+    owned_upper_.resize(owned_upper_.size() + level * (1 + m_), 0);
+    update_view();
+    label_map_[label] = id;
+
+    if (max_level_ < 0) {
+        entry_ = id;
+        max_level_ = level;
+        return;
+    }
+
+    auto current = greedy_search(normalized, entry_, max_level_, level + 1);
+    for (int l = std::min(level, max_level_); l >= 0; l--) {
+        auto candidates = search_layer(normalized, current, ef_construction_, l, false);
+        current = candidates.front().id;
+
+        auto neighbors = select_neighbors(std::move(candidates), m_);
+        auto list = mutable_links(id, l);
+        list[0] = neighbors.size();
+        std::copy(neighbors.begin(), neighbors.end(), list + 1);
+        for (auto neighbor : neighbors) { connect(neighbor, id, l); }
+    }
+
+    if (level > max_level_) {
+        entry_ = id;
+        max_level_ = level;
+    }
+}
+
+void FeatureIndex::detach() {
+    if (!mapped_) { return; }
+
+    size_t upper_size = 0;
+    for (uint32_t id = 0; id < count_; id++) { upper_size += levels_[id] * (1 + m_); }
+
+    owned_vectors_.assign(vectors_, vectors_ + (size_t)count_ * dim_);
+    owned_labels_.assign(labels_, labels_ + count_);
+    owned_levels_.assign(levels_, levels_ + count_);
+    owned_links0_.assign(links0_, links0_ + (size_t)count_ * (1 + max_m0_));
+    owned_upper_offsets_.assign(upper_offsets_, upper_offsets_ + count_);
+    owned_upper_.assign(upper_, upper_ + upper_size);
+    mapped_.reset();
+    update_view();
+}
+
+void FeatureIndex::compact() {
+    std::vector<uint32_t> labels;
+    std::vector<float> vectors;
+    for (uint32_t id = 0; id < count_; id++) {
+        if (labels_[id] == kInvalidLabel) { continue; }
+        labels.push_back(labels_[id]);
+        vectors.insert(vectors.end(), vector(id), vector(id) + dim_);
+    }
+
+    clear();
+    for (size_t i = 0; i < labels.size(); i++) { insert(labels[i], vectors.data() + i * dim_); }
+}
+
+bool FeatureIndex::check_graph(size_t upper_size) const {
+    if (max_level_ < (count_ > 0 ? 0 : -1) || max_level_ > kMaxLevel) { return false; }
+    if (count_ > 0 && levels_[entry_] < (uint32_t)max_level_) { return false; }
+
+    // 上层邻居也必须存在于该层，否则 greedy_search 会读到邻居不存在的层
+    auto valid_list = [this](const uint32_t *list, uint32_t max_count, uint32_t level) {
+        if (list[0] > max_count) { return false; }
+        for (uint32_t i = 1; i <= list[0]; i++) {
+            if (list[i] >= count_ || levels_[list[i]] < level) { return false; }
+        }
+        return true;
+    };
+
+    size_t total_upper = 0;
+    for (uint32_t id = 0; id < count_; id++) {
+        if (levels_[id] > (uint32_t)kMaxLevel) { return false; }
+        if (!valid_list(links(id, 0), max_m0_, 0)) { return false; }
+
+        size_t level_size = (size_t)levels_[id] * (1 + m_);
+        total_upper += level_size;
+        if ((size_t)upper_offsets_[id] + level_size > upper_size) { return false; }
+        for (uint32_t level = 1; level <= levels_[id]; level++) {
+            if (!valid_list(links(id, level), m_, level)) { return false; }
+        }
+    }
+    // save() / detach() 按层数连续读取上层链接
+    return total_upper <= upper_size;
+}
+
+void FeatureIndex::update_view() {
+    if (mapped_) { return; }
+    vectors_ = owned_vectors_.data();
+    labels_ = owned_labels_.data();
+    levels_ = owned_levels_.data();
+    links0_ = owned_links0_.data();
+    upper_offsets_ = owned_upper_offsets_.data();
+    upper_ = owned_upper_.data();
+}
+
+}// namespace algo
+}// namespace gddi
@@ -0,0 +1,132 @@
+#ifndef __FEATURE_INDEX_H__
+#define __FEATURE_INDEX_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gddi {
+namespace algo {
+
+/**
+ * @brief 内积，按 CPU 支持选择 AVX2 / NEON 实现
+ */
+float feature_dot(const float *a, const float *b, size_t dim);
+
+/**
+ * @brief 特征向量的 HNSW 近似最近邻索引，相似度为余弦相似度
+ *
+ *        向量归一化后连续存放，检索时直接计算内积。索引文件包含向量矩阵和图结构，
+ *        load() 以只读方式 mmap，add() / remove() 前自动复制到内存。
+ *        label 由调用者指定，内部节点编号对外不可见；删除只做标记，标记过多时重建。
+ *        search() 可以多线程并发调用，修改接口不可与其它接口并发
+ */
+class FeatureIndex {
+public:
+    static constexpr uint32_t kInvalidLabel = UINT32_MAX;
+
+    struct Result {
+        uint32_t label;
+        float similarity;
+    };
+
+    explicit FeatureIndex(uint32_t dim = 512, uint32_t m = 16, uint32_t ef_construction = 200);
+    ~FeatureIndex();
+
+    FeatureIndex(const FeatureIndex &) = delete;
+    FeatureIndex &operator=(const FeatureIndex &) = delete;
+
+    /**
+     * @brief 加载索引文件，文件不存在或格式、维度不符、图结构越界时返回 false，索引保持为空
+     */
+    bool load(const std::string &path);
+    bool save(const std::string &path) const;
+    void clear();
+
+    /**
+     * @brief 添加特征，label 已存在时替换原特征
+     */
+    void add(uint32_t label, const float *feature);
+    bool remove(uint32_t label);
+
+    /**
+     * @brief 批量修改 label，labels[old] 为新 label，kInvalidLabel 或越界表示删除
+     */
+    void relabel(const std::vector<uint32_t> &labels);
+
+    /**
+     * @brief 按相似度从高到低返回 k 个结果，ef 越大召回率越高
+     */
+    std::vector<Result> search(const float *feature, size_t k, uint32_t ef = 64) const;
+
+    bool contains(uint32_t label) const { return label_map_.count(label) > 0; }
+    size_t size() const { return label_map_.size(); }
+    uint32_t dim() const { return dim_; }
+
+private:
+    struct Candidate {
+        float distance;
+        uint32_t id;
+        bool operator<(const Candidate &other) const { return distance < other.distance; }
+    };
+
+    const float *vector(uint32_t id) const { return vectors_ + (size_t)id * dim_; }
+    const uint32_t *links(uint32_t id, int level) const;
+    uint32_t *mutable_links(uint32_t id, int level);
+    float distance(const float *query, uint32_t id) const { return 1.0f - feature_dot(query, vector(id), dim_); }
+
+    uint32_t greedy_search(const float *query, uint32_t entry, int from_level, int to_level) const;
+    std::vector<Candidate> search_layer(const float *query, uint32_t entry, uint32_t ef, int level,
+                                        bool skip_deleted) const;
+    std::vector<uint32_t> select_neighbors(std::vector<Candidate> candidates, uint32_t max_count) const;
+    void connect(uint32_t id, uint32_t neighbor, int level);
+
+    void insert(uint32_t label, const float *normalized);
+    void detach();
+    void compact();
+    void update_view();
+    bool check_graph(size_t upper_size) const;
+
+private:
+    uint32_t dim_;
+    uint32_t m_;
+    uint32_t max_m0_;
+    uint32_t ef_construction_;
+    double level_mult_;
+    std::mt19937 level_rng_{100};
+
+    uint32_t count_{0};
+    uint32_t entry_{0};
+    int max_level_{-1};
+    size_t deleted_{0};
+
+    // 只读视图，指向 mmap 的文件或下面的内存数据
+    const float *vectors_{nullptr};
+    const uint32_t *labels_{nullptr};
+    const uint32_t *levels_{nullptr};
+    const uint32_t *links0_{nullptr};
+    const uint32_t *upper_offsets_{nullptr};
+    const uint32_t *upper_{nullptr};
+
+    struct MappedFile;
+    std::unique_ptr<MappedFile> mapped_;
+
+    std::vector<float> owned_vectors_;
+    std::vector<uint32_t> owned_labels_;
+    std::vector<uint32_t> owned_levels_;
+    std::vector<uint32_t> owned_links0_;
+    std::vector<uint32_t> owned_upper_offsets_;
+    std::vector<uint32_t> owned_upper_;
+
+    std::unordered_map<uint32_t, uint32_t> label_map_;// label -> 节点编号
+};
+
+}// namespace algo
+}// namespace gddi
+
+#endif//__FEATURE_INDEX_H__
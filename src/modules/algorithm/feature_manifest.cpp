@@ -0,0 +1,112 @@
+#include "feature_manifest.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+namespace gddi {
+namespace algo {
+
+static const uint32_t kManifestVersion = 2;
+static const uint32_t kMaxPathSize = 4096;
+
+static uint64_t fnv1a(const uint8_t *data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool FeatureManifest::load(const std::string &path) {
+    entries_.clear();
+
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) { return false; }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    uint32_t version = 0;
+    uint64_t count = 0;
+    uint64_t checksum = 0;
+    const size_t header_size = sizeof(version) + sizeof(count);
+    if (data.size() < header_size + sizeof(checksum)) {
+        spdlog::warn("Discard truncated manifest: {}", path);
+        return false;
+    }
+
+    auto body_size = data.size() - sizeof(checksum);
+    memcpy(&version, data.data(), sizeof(version));
+    memcpy(&count, data.data() + sizeof(version), sizeof(count));
+    memcpy(&checksum, data.data() + body_size, sizeof(checksum));
+    if (version != kManifestVersion) { return false; }
+    if (checksum != fnv1a(data.data(), body_size)) {
+        spdlog::warn("Discard corrupt manifest: {}", path);
+        return false;
+    }
+
+    // 校验和只防止意外损坏，解析时仍然检查每个长度
+    size_t offset = header_size;
+    for (uint64_t i = 0; i < count; i++) {
+        Entry entry;
+        uint32_t path_size = 0;
+        if (body_size - offset < sizeof(entry) + sizeof(path_size)) { break; }
+        memcpy(&entry, data.data() + offset, sizeof(entry));
+        memcpy(&path_size, data.data() + offset + sizeof(entry), sizeof(path_size));
+        offset += sizeof(entry) + sizeof(path_size);
+
+        if (path_size > kMaxPathSize || body_size - offset < path_size) { break; }
+        entries_.emplace(std::string(reinterpret_cast<const char *>(data.data() + offset), path_size), entry);
+        offset += path_size;
+    }
+
+    if (offset != body_size || entries_.size() != count) {
+        spdlog::warn("Discard inconsistent manifest: {}", path);
+        entries_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool FeatureManifest::save(const std::string &path) const {
+    std::vector<uint8_t> data;
+    auto append = [&data](const void *value, size_t size) {
+        auto bytes = static_cast<const uint8_t *>(value);
+        data.insert(data.end(), bytes, bytes + size);
+    };
+
+    uint64_t count = entries_.size();
+    append(&kManifestVersion, sizeof(kManifestVersion));
+    append(&count, sizeof(count));
+    for (const auto &[relative_path, entry] : entries_) {
+        uint32_t path_size = relative_path.size();
+        append(&entry, sizeof(entry));
+        append(&path_size, sizeof(path_size));
+        append(relative_path.data(), path_size);
+    }
+    auto checksum = fnv1a(data.data(), data.size());
+    append(&checksum, sizeof(checksum));
+
+    auto tmp_path = path + ".tmp";
+    std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open()) { return false; }
+    ofs.write(reinterpret_cast<const char *>(data.data()), data.size());
+    ofs.close();
+    if (!ofs) {
+        remove(tmp_path.c_str());
+        return false;
+    }
+    return rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+const FeatureManifest::Entry *FeatureManifest::find_unchanged(const std::string &relative_path, uint64_t size,
+                                                              int64_t mtime) const {
+    auto iter = entries_.find(relative_path);
+    if (iter == entries_.end() || iter->second.size != size || iter->second.mtime != mtime) { return nullptr; }
+    return &iter->second;
+}
+
+}// namespace algo
+}// namespace gddi
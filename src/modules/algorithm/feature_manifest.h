@@ -0,0 +1,51 @@
+#ifndef __FEATURE_MANIFEST_H__
+#define __FEATURE_MANIFEST_H__
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace gddi {
+namespace algo {
+
+/**
+ * @brief 特征库的图片清单 features.manifest，记录每个图片的大小、修改时间和 sha256
+ *
+ *        大小和修改时间都未变化的图片沿用上次的 sha256，不再重新读取。
+ *        文件格式: 版本 | 记录数 | 记录(size, mtime, sha256, 路径长度, 路径)... | 校验和，
+ *        校验和为之前所有字节的 FNV-1a 64，截断、损坏或版本不符时整个清单作废。
+ */
+class FeatureManifest {
+public:
+    struct Entry {
+        uint64_t size;
+        int64_t mtime;
+        uint8_t sha256[32];
+    };
+
+    /**
+     * @brief 读取清单，文件不存在或不完整时清空并返回 false
+     */
+    bool load(const std::string &path);
+
+    /**
+     * @brief 先写入临时文件再改名，写入中断时不影响原有的清单
+     */
+    bool save(const std::string &path) const;
+
+    /**
+     * @brief 大小和修改时间都未变化时返回上次的记录，否则返回 nullptr
+     */
+    const Entry *find_unchanged(const std::string &relative_path, uint64_t size, int64_t mtime) const;
+
+    std::map<std::string, Entry> &entries() { return entries_; }
+    const std::map<std::string, Entry> &entries() const { return entries_; }
+
+private:
+    std::map<std::string, Entry> entries_;// 相对特征库目录的路径 -> 文件信息
+};
+
+}// namespace algo
+}// namespace gddi
+
+#endif// __FEATURE_MANIFEST_H__
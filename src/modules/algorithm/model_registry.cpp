@@ -0,0 +1,252 @@
+#include "model_registry.h"
+#include "algo_factory.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+namespace gddi {
+namespace algo {
+
+/**
+ * @brief SharedModel 的 AbstractAlgo 视图，每个使用者一个，回调互不干扰
+ */
+class SharedAlgo : public AbstractAlgo {
+public:
+    explicit SharedAlgo(std::shared_ptr<SharedModel> model)
+        : model_(std::move(model)), slot_(std::make_shared<InferSlot>()) {
+        slot_->callback = [this](const int64_t frame_idx, const AlgoType type,
+                                 const std::vector<algo::AlgoOutput> &outputs) {
+            if (infer_callback_) { infer_callback_(frame_idx, type, outputs); }
+        };
+    }
+
+    ~SharedAlgo() override { slot_->close(); }
+
+    bool init(const ModParms &parms) override {
+        if (!model_->load().get()) { return false; }
+        if (init_callback_) { init_callback_(model_->labels()); }
+        return true;
+    }
+
+    void inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                   const InferType type) override {
+        model_->inference({SlotItem{slot_, {info->infer_frame_idx, task_name, info}}});
+    }
+
+    AlgoType inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                       std::map<int, std::vector<algo::AlgoOutput>> &outputs) override {
+        return model_->inference(task_name, info, outputs);
+    }
+
+    void inference(const std::vector<BatchItem> &batch) override {
+        std::vector<SlotItem> items;
+        items.reserve(batch.size());
+        for (const auto &item : batch) { items.push_back({slot_, item}); }
+        model_->inference(items);
+    }
+
+private:
+    std::shared_ptr<SharedModel> model_;
+    std::shared_ptr<InferSlot> slot_;
+};
+
+SharedModel::SharedModel(ModParms parms, WarmupHook warmup_hook)
+    : parms_(std::move(parms)), warmup_hook_(std::move(warmup_hook)), algo_impl_(make_algo_impl(parms_.backend)),
+      loaded_(loaded_promise_.get_future().share()) {
+    algo_impl_->register_init_callback([this](const std::vector<std::string> &vec_labels) {
+        std::lock_guard<std::mutex> lock_guard(labels_mutex_);
+        labels_ = vec_labels;
+    });
+    algo_impl_->register_infer_callback(
+        [this](const int64_t id, const AlgoType type, const std::vector<AlgoOutput> &outputs) {
+            on_result_(id, type, outputs);
+        });
+}
+
+SharedModel::~SharedModel() {
+    // 等待已提交的推理全部返回
+    algo_impl_.reset();
+    spdlog::info("SharedModel unloaded: {}", parms_.mod_path);
+}
+
+std::shared_future<bool> SharedModel::load() {
+    {
+        std::lock_guard<std::mutex> lock_guard(load_mutex_);
+        if (loading_) { return loaded_; }
+        loading_ = true;
+    }
+
+    bool loaded = false;
+    try {
+        auto time_start = std::chrono::steady_clock::now();
+        loaded = algo_impl_->init(parms_);
+        if (loaded && warmup_hook_) { warmup_hook_(*this); }
+        spdlog::info("SharedModel loaded: {}, {} ms", parms_.mod_path,
+                     std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()
+                                                                           - time_start)
+                         .count());
+    } catch (const std::exception &e) { spdlog::error("SharedModel: {}, {}", parms_.mod_path, e.what()); }
+
+    loaded_promise_.set_value(loaded);
+    return loaded_;
+}
+
+void SharedModel::dummy_inference() {
+    auto [width, height] = input_size();
+    if (width <= 0 || height <= 0) { width = height = 640; }
+
+    // 对齐为 1，Y 和 UV 平面在同一块连续内存中，与解码输出的 NV12 布局一致
+    auto frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    frame->format = AV_PIX_FMT_NV12;
+    frame->width = width;
+    frame->height = height;
+    if (av_frame_get_buffer(frame.get(), 1) < 0) { throw std::runtime_error("Failed to allocate warmup frame"); }
+    memset(frame->data[0], 16, frame->linesize[0] * height);
+    memset(frame->data[1], 128, frame->linesize[1] * (height / 2));
+
+    auto done = std::make_shared<std::promise<void>>();
+    auto result = done->get_future();
+    auto slot = std::make_shared<InferSlot>();
+    slot->callback = [done](const int64_t, const AlgoType, const std::vector<AlgoOutput> &) { done->set_value(); };
+
+    auto info = std::make_shared<nodes::FrameInfo>(-1, std::make_shared<MemObject<AVFrame>>(frame));
+    inference({SlotItem{slot, {-1, "warmup", info}}});
+    if (result.wait_for(std::chrono::seconds(30)) != std::future_status::ready) {
+        spdlog::warn("SharedModel warmup timeout: {}", parms_.mod_path);
+    }
+    slot->close();
+}
+
+std::vector<std::string> SharedModel::labels() const {
+    std::lock_guard<std::mutex> lock_guard(labels_mutex_);
+    return labels_;
+}
+
+bool SharedModel::ready() const {
+    return loaded_.wait_for(std::chrono::seconds(0)) == std::future_status::ready && loaded_.get();
+}
+
+void SharedModel::inference(const std::vector<SlotItem> &items) {
+    if (items.empty()) { return; }
+
+    std::vector<BatchItem> batch;
+    batch.reserve(items.size());
+    {
+        std::lock_guard<std::mutex> lock_guard(inflight_mutex_);
+        for (const auto &item : items) {
+            auto id = next_id_++;
+            inflight_frames_[id] = {item.slot, item.item.id};
+            batch.push_back({id, item.item.task_name, item.item.info});
+        }
+    }
+
+    try {
+        std::lock_guard<std::mutex> lock_guard(algo_mutex_);
+        algo_impl_->inference(batch);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock_guard(inflight_mutex_);
+        for (const auto &item : batch) { inflight_frames_.erase(item.id); }
+        throw;
+    }
+}
+
+AlgoType SharedModel::inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                                std::map<int, std::vector<algo::AlgoOutput>> &outputs) {
+    std::lock_guard<std::mutex> lock_guard(algo_mutex_);
+    return algo_impl_->inference(task_name, info, outputs);
+}
+
+void SharedModel::on_result_(int64_t id, AlgoType type, const std::vector<AlgoOutput> &outputs) {
+    InflightFrame frame;
+    {
+        std::lock_guard<std::mutex> lock_guard(inflight_mutex_);
+        auto iter = inflight_frames_.find(id);
+        if (iter == inflight_frames_.end()) { return; }// 不经过 inference() 提交的帧
+        frame = std::move(iter->second);
+        inflight_frames_.erase(iter);
+    }
+
+    std::lock_guard<std::mutex> lock_guard(frame.slot->mutex);
+    if (frame.slot->callback) { frame.slot->callback(frame.frame_idx, type, outputs); }
+}
+
+ModelRegistry &ModelRegistry::get_instance() {
+    static std::mutex mutex;
+    static std::shared_ptr<ModelRegistry> model_registry = nullptr;
+    std::lock_guard<std::mutex> lock_guard(mutex);
+    if (model_registry == nullptr) { model_registry = std::shared_ptr<ModelRegistry>(new ModelRegistry()); }
+    return *model_registry;
+}
+
+std::string ModelRegistry::make_key_(const ModParms &parms, size_t instance) {
+    return parms.backend + ":" + parms.mod_path + "#" + std::to_string(parms.stream_id) + "#" + std::to_string(instance);
+}
+
+std::shared_ptr<SharedModel> ModelRegistry::acquire_model(const ModParms &parms, size_t instance) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+
+    auto key = make_key_(parms, instance);
+    auto model = models_[key].lock();
+    if (model == nullptr) {
+        model = std::make_shared<SharedModel>(parms, warmup_hook_);
+        models_[key] = model;
+    }
+
+    // 顺便清理已经卸载的模型
+    for (auto iter = models_.begin(); iter != models_.end();) {
+        if (iter->second.expired()) {
+            iter = models_.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+    return model;
+}
+
+std::unique_ptr<AbstractAlgo> ModelRegistry::acquire(const ModParms &parms, size_t instance) {
+    return std::make_unique<SharedAlgo>(acquire_model(parms, instance));
+}
+
+void ModelRegistry::set_warmup_hook(SharedModel::WarmupHook hook) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    warmup_hook_ = std::move(hook);
+}
+
+std::pair<int, int> ModelRegistry::input_size(const std::string &mod_path) const {
+    // 最后一个引用可能在这里释放，模型在锁外卸载
+    std::vector<std::shared_ptr<SharedModel>> models;
+    {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        for (const auto &item : models_) {
+            auto model = item.second.lock();
+            if (model && model->parms().mod_path == mod_path) { models.emplace_back(std::move(model)); }
+        }
+    }
+
+    std::pair<int, int> size{0, 0};
+    for (const auto &model : models) {
+        if (!model->ready()) { continue; }
+        auto input_size = model->input_size();
+        size.first = std::max(size.first, input_size.first);
+        size.second = std::max(size.second, input_size.second);
+    }
+    return size;
+}
+
+std::vector<std::string> ModelRegistry::models() const {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+
+    std::vector<std::string> keys;
+    for (const auto &item : models_) {
+        if (!item.second.expired()) { keys.push_back(item.first); }
+    }
+    return keys;
+}
+
+}// namespace algo
+}// namespace gddi
@@ -0,0 +1,165 @@
+#ifndef __MODEL_REGISTRY_H__
+#define __MODEL_REGISTRY_H__
+
+#include "abstract_algo.h"
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace gddi {
+namespace algo {
+
+/**
+ * @brief 推理结果回调入口，等待结果的帧只持有它，不持有模型或调用者
+ */
+struct InferSlot {
+    std::mutex mutex;
+    InferCallback callback;// 为空表示调用者已释放
+
+    void close() {
+        std::lock_guard<std::mutex> lock_guard(mutex);
+        callback = nullptr;
+    }
+};
+
+struct SlotItem {
+    std::shared_ptr<InferSlot> slot;
+    BatchItem item;// item.id 为回调给 slot 的帧序号
+};
+
+/**
+ * @brief 多个任务共享的已加载模型
+ *
+ *        第一次 load() 时才真正加载并预热，之后的调用直接返回同一个结果。
+ *        提交的帧使用内部序号，结果按帧分发到各自的 InferSlot，不同调用者的帧序号互不影响。
+ */
+class SharedModel {
+public:
+    using WarmupHook = std::function<void(SharedModel &)>;
+
+    SharedModel(ModParms parms, WarmupHook warmup_hook);
+    ~SharedModel();
+
+    SharedModel(const SharedModel &) = delete;
+    SharedModel &operator=(const SharedModel &) = delete;
+
+    /**
+     * @brief thread-safe, 按需加载模型，加载及预热完成后返回 true
+     */
+    std::shared_future<bool> load();
+
+    std::vector<std::string> labels() const;
+    const ModParms &parms() const { return parms_; }
+
+    /**
+     * @brief 加载及预热已成功完成，不等待
+     */
+    bool ready() const;
+
+    std::pair<int, int> input_size() const { return algo_impl_->input_size(); }
+
+    /**
+     * @brief 默认的预热: 按网络输入尺寸提交一帧黑色 NV12 图像，等待结果返回
+     *
+     *        首次推理的显存分配、算子选择等开销由加载过程承担，不落在第一帧真实数据上。
+     *        后端不提供输入尺寸时使用 640x640。
+     */
+    void dummy_inference();
+
+    /**
+     * @brief 异步推理，每一帧的结果回调到各自的 slot
+     */
+    void inference(const std::vector<SlotItem> &items);
+
+    /**
+     * @brief 多阶段同步推理
+     */
+    AlgoType inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                       std::map<int, std::vector<algo::AlgoOutput>> &outputs);
+
+private:
+    struct InflightFrame {
+        std::shared_ptr<InferSlot> slot;
+        int64_t frame_idx;
+    };
+
+    void on_result_(int64_t id, AlgoType type, const std::vector<AlgoOutput> &outputs);
+
+private:
+    ModParms parms_;
+    WarmupHook warmup_hook_;
+    std::unique_ptr<AbstractAlgo> algo_impl_;
+    std::mutex algo_mutex_;// AbstractAlgo 调用保护
+
+    std::mutex load_mutex_;
+    bool loading_{false};
+    std::promise<bool> loaded_promise_;
+    std::shared_future<bool> loaded_;
+
+    mutable std::mutex labels_mutex_;
+    std::vector<std::string> labels_;
+
+    std::mutex inflight_mutex_;
+    std::unordered_map<int64_t, InflightFrame> inflight_frames_;
+    int64_t next_id_{0};
+};
+
+/**
+ * @brief 进程内的模型注册表，以 推理后端 + 模型路径 + 实例配置 为键，引用计数共享 SharedModel
+ *
+ *        最后一个使用者释放后模型随之卸载。
+ */
+class ModelRegistry {
+public:
+    ModelRegistry(const ModelRegistry &) = delete;
+    ModelRegistry &operator=(const ModelRegistry &) = delete;
+
+    static ModelRegistry &get_instance();
+
+    /**
+     * @brief 获取共享模型，尚未加载时不会立即加载
+     * @param instance 同一任务内的实例序号，不同序号对应不同的模型实例
+     */
+    std::shared_ptr<SharedModel> acquire_model(const ModParms &parms, size_t instance = 0);
+
+    /**
+     * @brief 获取共享模型的 AbstractAlgo 视图，用法与 make_algo_impl() 相同
+     *
+     *        init() 触发按需加载，模型已加载时立即返回；回调只属于当前对象。
+     */
+    std::unique_ptr<AbstractAlgo> acquire(const ModParms &parms, size_t instance = 0);
+
+    /**
+     * @brief 模型加载成功后、交给使用者之前调用一次，只对之后创建的模型生效
+     *
+     *        默认为 SharedModel::dummy_inference，传入空函数则不预热
+     */
+    void set_warmup_hook(SharedModel::WarmupHook hook);
+
+    /**
+     * @brief 已加载完成的 mod_path 模型的网络输入宽高，多个实例取最大值，尚未加载完成时为 {0, 0}
+     */
+    std::pair<int, int> input_size(const std::string &mod_path) const;
+
+    /**
+     * @brief 当前已创建的模型键
+     */
+    std::vector<std::string> models() const;
+
+private:
+    ModelRegistry() = default;
+
+    static std::string make_key_(const ModParms &parms, size_t instance);
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<SharedModel>> models_;
+    SharedModel::WarmupHook warmup_hook_{&SharedModel::dummy_inference};
+};
+
+}// namespace algo
+}// namespace gddi
+
+#endif// __MODEL_REGISTRY_H__
@@ -0,0 +1,190 @@
+#include "replay_inference.h"
+#include "common_basic/thread_dbg_utils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace gddi {
+namespace algo {
+
+static AlgoType parse_model_type(const std::string &model_type) {
+    static const std::map<std::string, AlgoType> types{{"detection", AlgoType::kDetection},
+                                                       {"classification", AlgoType::kClassification},
+                                                       {"pose", AlgoType::kPose},
+                                                       {"segmentation", AlgoType::kSegmentation},
+                                                       {"action", AlgoType::kAction},
+                                                       {"ocr_det", AlgoType::kOCR_DET},
+                                                       {"ocr_rec", AlgoType::kOCR_REC}};
+    auto iter = types.find(model_type);
+    if (iter == types.end()) { throw std::runtime_error("Undefined model type: " + model_type); }
+    return iter->second;
+}
+
+static AlgoOutput parse_output(const nlohmann::json &object, const std::vector<std::string> &labels) {
+    AlgoOutput output{};
+    output.class_id = object.value("class_id", 0);
+    output.prob = object.value("prob", 1.0f);
+    if (object.count("label")) {
+        output.label = object["label"].get<std::string>();
+    } else if (output.class_id >= 0 && output.class_id < (int)labels.size()) {
+        output.label = labels[output.class_id];
+    }
+    if (object.count("box")) {
+        auto box = object["box"].get<std::vector<float>>();
+        if (box.size() != 4) { throw std::runtime_error("box must be [x, y, w, h]"); }
+        output.box = {box[0], box[1], box[2], box[3]};
+    }
+    if (object.count("key_points")) {
+        for (const auto &point : object["key_points"]) {
+            output.vec_key_points.emplace_back(point.at(0).get<int>(), point.at(1).get<float>(),
+                                               point.at(2).get<float>(), point.at(3).get<float>());
+        }
+    }
+    if (object.count("feature")) { output.feature = object["feature"].get<std::vector<float>>(); }
+    if (object.count("ocr_str")) { output.ocr_str = object["ocr_str"].get<std::string>(); }
+    return output;
+}
+
+struct ReplayInference::Impl {
+    AlgoType algo_type{AlgoType::kUndefined};
+    std::vector<std::string> labels;
+    std::map<int64_t, std::vector<AlgoOutput>> frames;// 帧序号 - 录制结果
+    int64_t frame_count{0};
+    bool loop{true};
+    std::chrono::milliseconds latency{0};
+    std::pair<int, int> input_size{0, 0};
+
+    struct PendingResult {
+        std::chrono::steady_clock::time_point due;
+        int64_t id;
+        std::vector<AlgoOutput> outputs;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<PendingResult> pending_results;// 按提交顺序排列，due 单调递增
+    bool stop{false};
+    std::thread worker;
+
+    const std::vector<AlgoOutput> &lookup(int64_t frame_idx) const {
+        static const std::vector<AlgoOutput> empty;
+        if (frame_count <= 0 || frame_idx < 0) { return empty; }
+        if (loop) { frame_idx %= frame_count; }
+        auto iter = frames.find(frame_idx);
+        return iter == frames.end() ? empty : iter->second;
+    }
+};
+
+ReplayInference::ReplayInference() : impl_(std::make_unique<ReplayInference::Impl>()) {}
+
+ReplayInference::~ReplayInference() {
+    // 已提交的帧全部回调后才退出，与加速卡后端的 WaitTaskDone 一致
+    {
+        std::lock_guard<std::mutex> lock_guard(impl_->mutex);
+        impl_->stop = true;
+    }
+    impl_->cv.notify_all();
+    if (impl_->worker.joinable()) { impl_->worker.join(); }
+}
+
+bool ReplayInference::init(const ModParms &parms) {
+    std::ifstream file(parms.mod_path);
+    if (!file.is_open()) { throw std::runtime_error("Failed to open replay file: " + parms.mod_path); }
+
+    auto record = nlohmann::json::parse(file);
+    impl_->algo_type = parse_model_type(record.value("model_type", std::string("detection")));
+    impl_->labels = record.value("labels", std::vector<std::string>());
+    impl_->loop = record.value("loop", true);
+    impl_->latency = std::chrono::milliseconds(record.value("latency_ms", 0));
+    if (record.count("input_size")) {
+        auto input_size = record["input_size"].get<std::vector<int>>();
+        if (input_size.size() != 2) { throw std::runtime_error("input_size must be [width, height]"); }
+        impl_->input_size = {input_size[0], input_size[1]};
+    }
+
+    const auto &frames = record.at("frames");
+    if (frames.is_array()) {
+        for (size_t i = 0; i < frames.size(); i++) {
+            for (const auto &object : frames[i]) {
+                impl_->frames[i].emplace_back(parse_output(object, impl_->labels));
+            }
+        }
+        impl_->frame_count = frames.size();
+    } else {
+        for (const auto &[key, objects] : frames.items()) {
+            int64_t frame_idx = std::stoll(key);
+            auto &outputs = impl_->frames[frame_idx];
+            for (const auto &object : objects) { outputs.emplace_back(parse_output(object, impl_->labels)); }
+            impl_->frame_count = std::max(impl_->frame_count, frame_idx + 1);
+        }
+    }
+
+    impl_->worker = std::thread([this]() {
+        gddi::thread_utils::set_cur_thread_name(std::string("replay-infer"));
+        std::unique_lock<std::mutex> lock(impl_->mutex);
+        while (true) {
+            impl_->cv.wait(lock, [this] { return impl_->stop || !impl_->pending_results.empty(); });
+            if (impl_->pending_results.empty()) { break; }
+
+            if (!impl_->stop) {
+                auto due = impl_->pending_results.front().due;
+                impl_->cv.wait_until(lock, due, [this] { return impl_->stop; });
+            }
+
+            auto result = std::move(impl_->pending_results.front());
+            impl_->pending_results.pop_front();
+            lock.unlock();
+            if (infer_callback_) { infer_callback_(result.id, impl_->algo_type, result.outputs); }
+            lock.lock();
+        }
+    });
+
+    return AbstractAlgo::init(parms, impl_->algo_type, impl_->labels);
+}
+
+void ReplayInference::inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                                const InferType type) {
+    inference({BatchItem{info->infer_frame_idx, task_name, info}});
+}
+
+void ReplayInference::inference(const std::vector<BatchItem> &batch) {
+    if (batch.empty()) { return; }
+
+    {
+        std::lock_guard<std::mutex> lock_guard(impl_->mutex);
+        // 同一批的结果一起返回，耗时从上一批完成时算起，模拟单个设备串行推理
+        auto due = std::chrono::steady_clock::now();
+        if (!impl_->pending_results.empty()) { due = std::max(due, impl_->pending_results.back().due); }
+        due += impl_->latency;
+        for (const auto &item : batch) {
+            impl_->pending_results.push_back({due, item.id, impl_->lookup(item.info->video_frame_idx)});
+        }
+    }
+    impl_->cv.notify_one();
+}
+
+std::pair<int, int> ReplayInference::input_size() const { return impl_->input_size; }
+
+AlgoType ReplayInference::inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                                    std::map<int, std::vector<algo::AlgoOutput>> &outputs) {
+    if (impl_->latency.count() > 0) { std::this_thread::sleep_for(impl_->latency); }
+
+    const auto &records = impl_->lookup(info->video_frame_idx);
+    for (const auto &[target_id, rect] : info->ext_info.back().crop_rects) {
+        auto &target_outputs = outputs[target_id];
+        for (auto output : records) {
+            output.box.x += rect.x;
+            output.box.y += rect.y;
+            target_outputs.emplace_back(std::move(output));
+        }
+    }
+
+    return impl_->algo_type;
+}
+
+}// namespace algo
+}// namespace gddi
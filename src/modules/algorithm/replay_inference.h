@@ -0,0 +1,51 @@
+#ifndef __REPLAY_INFERENCE_H__
+#define __REPLAY_INFERENCE_H__
+
+#include "abstract_algo.h"
+#include <memory>
+#include <vector>
+
+namespace gddi {
+namespace algo {
+
+/**
+ * @brief 回放后端，按解码帧序号 (video_frame_idx) 返回录制好的推理结果
+ *
+ *        mod_path 指向录制文件 (JSON):
+ *        {
+ *            "model_type": "detection",  // 同 SDK 的模型类型
+ *            "labels": ["person", "car"],
+ *            "latency_ms": 10,           // 每次提交的模拟推理耗时，默认 0
+ *            "loop": true,               // 帧序号超出录制范围后循环回放，默认 true
+ *            "input_size": [640, 640],   // 模拟的网络输入宽高，可选
+ *            "frames": [                 // 下标为帧序号；也可以是 {"帧序号": [...]} 形式的稀疏记录
+ *                [{"class_id": 0, "prob": 0.9, "box": [x, y, w, h]}],
+ *                []
+ *            ]
+ *        }
+ *        结果在内部工作线程中回调，与加速卡后端一样是异步的；多阶段推理时每个扣图目标返回该帧的记录，
+ *        目标框按扣图位置偏移。
+ */
+class ReplayInference : public AbstractAlgo {
+public:
+    ReplayInference();
+    ~ReplayInference();
+
+    bool init(const ModParms &parms) override;
+
+    void inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                   const InferType type) override;
+    AlgoType inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
+                       std::map<int, std::vector<algo::AlgoOutput>> &outputs) override;
+    void inference(const std::vector<BatchItem> &batch) override;
+    std::pair<int, int> input_size() const override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}// namespace algo
+}// namespace gddi
+
+#endif// __REPLAY_INFERENCE_H__
@@ -16,6 +16,25 @@ struct TsingInference::Impl {
     AlgoType algo_type{AlgoType::kUndefined};
 };
 
+/**
+ * @brief 不拷贝帧数据，直接引用原始帧
+ */
+static std::shared_ptr<gddeploy::BufSurfaceWrapper> wrap_frame_surface(const std::shared_ptr<nodes::FrameInfo> &info) {
+    auto buf_surf = std::shared_ptr<gddeploy::BufSurfaceWrapper>(new gddeploy::BufSurfaceWrapper(new BufSurface, false),
+                                                                 [](gddeploy::BufSurfaceWrapper *ptr) {
+                                                                     delete ptr->GetBufSurface()->surface_list;
+                                                                     delete ptr->GetBufSurface();
+                                                                     delete ptr;
+                                                                 });
+    buf_surf->GetBufSurface()->surface_list = new BufSurfaceParams;
+    buf_surf->GetBufSurface()->surface_list[0].width = info->src_frame->data->width;
+    buf_surf->GetBufSurface()->surface_list[0].height = info->src_frame->data->height;
+    buf_surf->GetBufSurface()->surface_list[0].color_format = GDDEPLOY_BUF_COLOR_FORMAT_NV12;
+    buf_surf->GetBufSurface()->surface_list[0].pitch = 1;
+    buf_surf->GetBufSurface()->surface_list[0].data_ptr = info->src_frame->data->buf[0]->data;
+    return buf_surf;
+}
+
 TsingInference::TsingInference() : impl_(std::make_unique<TsingInference::Impl>()) {}
 
 TsingInference::~TsingInference() {
@@ -135,28 +154,27 @@ void TsingInference::inference(const std::string &task_name, const std::shared_p
     /*******************************************************************************************/
 
     // 正常情况：不拷贝帧数据（推理使用原始帧数据）一路25帧异常
-    auto buf_surf = std::shared_ptr<gddeploy::BufSurfaceWrapper>(new gddeploy::BufSurfaceWrapper(new BufSurface, false),
-                                                                 [](gddeploy::BufSurfaceWrapper *ptr) {
-                                                                     delete ptr->GetBufSurface()->surface_list;
-                                                                     delete ptr->GetBufSurface();
-                                                                     delete ptr;
-                                                                 });
-    buf_surf->GetBufSurface()->surface_list = new BufSurfaceParams;
-    buf_surf->GetBufSurface()->surface_list[0].width = info->src_frame->data->width;
-    buf_surf->GetBufSurface()->surface_list[0].height = info->src_frame->data->height;
-    buf_surf->GetBufSurface()->surface_list[0].color_format = GDDEPLOY_BUF_COLOR_FORMAT_NV12;
-    buf_surf->GetBufSurface()->surface_list[0].pitch = 1;
-    buf_surf->GetBufSurface()->surface_list[0].data_ptr = info->src_frame->data->buf[0]->data;
+    inference({BatchItem{info->infer_frame_idx, task_name, info}});
 
-    gddeploy::PackagePtr in = gddeploy::Package::Create(1);
-    in->data[0]->Set(buf_surf);
-    in->data[0]->SetUserData(info->infer_frame_idx);
+    // infer_callback_(info->infer_frame_idx, impl_->algo_type, {});
+}
+
+void TsingInference::inference(const std::vector<BatchItem> &batch) {
+    if (batch.empty()) { return; }
+
+    gddeploy::PackagePtr in = gddeploy::Package::Create(batch.size());
+    for (size_t i = 0; i < batch.size(); i++) {
+        in->data[i]->Set(wrap_frame_surface(batch[i].info));
+        in->data[i]->SetUserData(batch[i].id);
+    }
 
     impl_->alg_impl->InferAsync(
         in, [this](gddeploy::Status status, gddeploy::PackagePtr data, gddeploy::any user_data) {
-            std::vector<algo::AlgoOutput> vec_output;
-            if (data->data[0]->HasMetaValue()) {
-                auto result = data->data[0]->GetMetaData<gddeploy::InferResult>();
+            for (auto &item : data->data) {
+                if (!item->HasMetaValue()) { continue; }
+
+                std::vector<algo::AlgoOutput> vec_output;
+                auto result = item->GetMetaData<gddeploy::InferResult>();
                 for (auto result_type : result.result_type) {
                     if (result_type == gddeploy::GDD_RESULT_TYPE_DETECT) {
                         for (uint32_t i = 0; i < result.detect_result.detect_imgs.size(); i++) {
@@ -170,13 +188,9 @@ void TsingInference::inference(const std::string &task_name, const std::shared_p
                     }
                 }
 
-                if (infer_callback_) {
-                    infer_callback_(data->data[0]->GetUserData<int64_t>(), impl_->algo_type, vec_output);
-                }
+                if (infer_callback_) { infer_callback_(item->GetUserData<int64_t>(), impl_->algo_type, vec_output); }
             }
         });
-
-    // infer_callback_(info->infer_frame_idx, impl_->algo_type, {});
 }
 
 AlgoType TsingInference::inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
@@ -19,6 +19,7 @@ public:
                    const InferType type) override;
     AlgoType inference(const std::string &task_name, const std::shared_ptr<nodes::FrameInfo> &info,
                        std::map<int, std::vector<algo::AlgoOutput>> &outputs) override;
+    void inference(const std::vector<BatchItem> &batch) override;
 
 private:
     struct Impl;
@@ -1,4 +1,5 @@
 #include "BYTETracker.h"
+#include <algorithm>
 #include <fstream>
 
 BYTETracker::BYTETracker(const float track_thres, const float high_thresh, const float match_thresh,
@@ -15,227 +16,234 @@ BYTETracker::~BYTETracker()
 {
 }
 
-vector<STrack> BYTETracker::update(const vector<Object>& objects)
+static void gather(const vector<STrack> &pool, const vector<int> &slots, vector<const STrack *> &out)
+{
+	out.clear();
+	for (int slot : slots)
+	{
+		out.push_back(&pool[slot]);
+	}
+}
+
+static void gather(const vector<STrack> &pool, vector<const STrack *> &out)
+{
+	out.clear();
+	for (const auto &track : pool)
+	{
+		out.push_back(&track);
+	}
+}
+
+const vector<const STrack *> &BYTETracker::update(const vector<Object>& objects)
 {
 
 	////////////////// Step 1: Get detections //////////////////
 	this->frame_id++;
-	vector<STrack> activated_stracks;
-	vector<STrack> refind_stracks;
-	vector<STrack> removed_stracks;
-	vector<STrack> lost_stracks;
-	vector<STrack> detections;
-	vector<STrack> detections_low;
-
-	vector<STrack> detections_cp;
-	vector<STrack> tracked_stracks_swap;
-	vector<STrack> resa, resb;
-	vector<STrack> output_stracks;
-
-	vector<STrack*> unconfirmed;
-	vector<STrack*> tracked_stracks;
-	vector<STrack*> strack_pool;
-	vector<STrack*> r_tracked_stracks;
-
-	if (objects.size() > 0)
-	{
-		for (int i = 0; i < objects.size(); i++)
+	detections.clear();
+	detections_low.clear();
+
+	for (const auto &object : objects)
+	{
+		float tlbr_[4] = {object.rect.x, object.rect.y, object.rect.x + object.rect.width,
+			object.rect.y + object.rect.height};
+		float tlwh_[4] = {tlbr_[0], tlbr_[1], tlbr_[2] - tlbr_[0], tlbr_[3] - tlbr_[1]};
+
+		STrack strack(tlwh_, object.prob, object.label, object.target_id);
+		if (object.prob >= track_thresh)
 		{
-			vector<float> tlbr_;
-			tlbr_.resize(4);
-			tlbr_[0] = objects[i].rect.x;
-			tlbr_[1] = objects[i].rect.y;
-			tlbr_[2] = objects[i].rect.x + objects[i].rect.width;
-			tlbr_[3] = objects[i].rect.y + objects[i].rect.height;
-
-			float score = objects[i].prob;
-			int label = objects[i].label;
-			int target_id = objects[i].target_id;
-
-			STrack strack(STrack::tlbr_to_tlwh(tlbr_), score, label, target_id);
-			if (score >= track_thresh)
-			{
-				detections.push_back(strack);
-			}
-			else
-			{
-				detections_low.push_back(strack);
-			}
-			
+			detections.push_back(strack);
+		}
+		else
+		{
+			detections_low.push_back(strack);
 		}
 	}
 
 	// Add newly detected tracklets to tracked_stracks
-	for (int i = 0; i < this->tracked_stracks.size(); i++)
+	unconfirmed.clear();
+	strack_pool.clear();
+	for (int slot : this->tracked_stracks)
 	{
-		if (!this->tracked_stracks[i].is_activated)
-			unconfirmed.push_back(&this->tracked_stracks[i]);
+		if (!tracks[slot].is_activated)
+			unconfirmed.push_back(slot);
 		else
-			tracked_stracks.push_back(&this->tracked_stracks[i]);
+			strack_pool.push_back(slot);
 	}
 
 	////////////////// Step 2: First association, with IoU //////////////////
-	strack_pool = joint_stracks(tracked_stracks, this->lost_stracks);
-	STrack::multi_predict(strack_pool, this->kalman_filter);
-
-	vector<vector<float> > dists;
-	int dist_size = 0, dist_size_size = 0;
-	dists = iou_distance(strack_pool, detections, dist_size, dist_size_size);
+	// tracked and lost never share a track, joining them needs no de-duplication
+	strack_pool.insert(strack_pool.end(), this->lost_stracks.begin(), this->lost_stracks.end());
+	for (int slot : strack_pool)
+	{
+		tracks[slot].predict(this->kalman_filter);
+	}
 
-	vector<vector<int> > matches;
-	vector<int> u_track, u_detection;
-	linear_assignment(dists, dist_size, dist_size_size, match_thresh, matches, u_track, u_detection);
+	gather(tracks, strack_pool, rows);
+	gather(detections, cols);
+	iou_distance(rows, cols);
+	linear_assignment(rows.size(), cols.size(), match_thresh);
 
-	for (int i = 0; i < matches.size(); i++)
+	activated_stracks.clear();
+	refind_stracks.clear();
+	for (const auto &match : matches)
 	{
-		STrack *track = strack_pool[matches[i][0]];
-		STrack *det = &detections[matches[i][1]];
-		if (track->state == TrackState::Tracked)
+		int slot = strack_pool[match.first];
+		STrack &track = tracks[slot];
+		if (track.state == TrackState::Tracked)
 		{
-			track->update(*det, this->frame_id);
-			activated_stracks.push_back(*track);
+			track.update(detections[match.second], this->kalman_filter, this->frame_id);
+			activated_stracks.push_back(slot);
 		}
 		else
 		{
-			track->re_activate(*det, this->frame_id, false);
-			refind_stracks.push_back(*track);
+			track.re_activate(detections[match.second], this->kalman_filter, this->frame_id, false);
+			refind_stracks.push_back(slot);
 		}
 	}
 
 	////////////////// Step 3: Second association, using low score dets //////////////////
-	for (int i = 0; i < u_detection.size(); i++)
-	{
-		detections_cp.push_back(detections[u_detection[i]]);
-	}
-	detections.clear();
-	detections.assign(detections_low.begin(), detections_low.end());
-	
-	for (int i = 0; i < u_track.size(); i++)
+	detections_remain.assign(unmatched_b.begin(), unmatched_b.end());
+
+	r_tracked_stracks.clear();
+	for (int u : unmatched_a)
 	{
-		if (strack_pool[u_track[i]]->state == TrackState::Tracked)
+		if (tracks[strack_pool[u]].state == TrackState::Tracked)
 		{
-			r_tracked_stracks.push_back(strack_pool[u_track[i]]);
+			r_tracked_stracks.push_back(strack_pool[u]);
 		}
 	}
 
-	dists.clear();
-	dists = iou_distance(r_tracked_stracks, detections, dist_size, dist_size_size);
-
-	matches.clear();
-	u_track.clear();
-	u_detection.clear();
-	linear_assignment(dists, dist_size, dist_size_size, 0.5, matches, u_track, u_detection);
+	gather(tracks, r_tracked_stracks, rows);
+	gather(detections_low, cols);
+	iou_distance(rows, cols);
+	linear_assignment(rows.size(), cols.size(), 0.5);
 
-	for (int i = 0; i < matches.size(); i++)
+	for (const auto &match : matches)
 	{
-		STrack *track = r_tracked_stracks[matches[i][0]];
-		STrack *det = &detections[matches[i][1]];
-		if (track->state == TrackState::Tracked)
+		int slot = r_tracked_stracks[match.first];
+		STrack &track = tracks[slot];
+		if (track.state == TrackState::Tracked)
 		{
-			track->update(*det, this->frame_id);
-			activated_stracks.push_back(*track);
+			track.update(detections_low[match.second], this->kalman_filter, this->frame_id);
+			activated_stracks.push_back(slot);
 		}
 		else
 		{
-			track->re_activate(*det, this->frame_id, false);
-			refind_stracks.push_back(*track);
+			track.re_activate(detections_low[match.second], this->kalman_filter, this->frame_id, false);
+			refind_stracks.push_back(slot);
 		}
 	}
 
-	for (int i = 0; i < u_track.size(); i++)
+	new_lost_stracks.clear();
+	for (int u : unmatched_a)
 	{
-		STrack *track = r_tracked_stracks[u_track[i]];
-		if (track->state != TrackState::Lost)
+		STrack &track = tracks[r_tracked_stracks[u]];
+		if (track.state != TrackState::Lost)
 		{
-			track->mark_lost();
-			lost_stracks.push_back(*track);
+			track.mark_lost();
+			new_lost_stracks.push_back(r_tracked_stracks[u]);
 		}
 	}
 
 	// Deal with unconfirmed tracks, usually tracks with only one beginning frame
-	detections.clear();
-	detections.assign(detections_cp.begin(), detections_cp.end());
+	gather(tracks, unconfirmed, rows);
+	gather(detections, detections_remain, cols);
+	iou_distance(rows, cols);
+	linear_assignment(rows.size(), cols.size(), 0.7);
 
-	dists.clear();
-	dists = iou_distance(unconfirmed, detections, dist_size, dist_size_size);
-
-	matches.clear();
-	vector<int> u_unconfirmed;
-	u_detection.clear();
-	linear_assignment(dists, dist_size, dist_size_size, 0.7, matches, u_unconfirmed, u_detection);
-
-	for (int i = 0; i < matches.size(); i++)
+	for (const auto &match : matches)
 	{
-		unconfirmed[matches[i][0]]->update(detections[matches[i][1]], this->frame_id);
-		activated_stracks.push_back(*unconfirmed[matches[i][0]]);
+		tracks[unconfirmed[match.first]].update(detections[detections_remain[match.second]], this->kalman_filter,
+			this->frame_id);
+		activated_stracks.push_back(unconfirmed[match.first]);
 	}
 
-	for (int i = 0; i < u_unconfirmed.size(); i++)
+	removed_stracks.clear();
+	for (int u : unmatched_a)
 	{
-		STrack *track = unconfirmed[u_unconfirmed[i]];
-		track->mark_removed();
-		removed_stracks.push_back(*track);
+		tracks[unconfirmed[u]].mark_removed();
+		removed_stracks.push_back(unconfirmed[u]);
 	}
 
 	////////////////// Step 4: Init new stracks //////////////////
-	for (int i = 0; i < u_detection.size(); i++)
+	for (int u : unmatched_b)
 	{
-		STrack *track = &detections[u_detection[i]];
-		if (track->score < this->high_thresh)
+		const STrack &detection = detections[detections_remain[u]];
+		if (detection.score < this->high_thresh)
 			continue;
-		track->activate(this->kalman_filter, this->frame_id);
-		activated_stracks.push_back(*track);
+		int slot = alloc_track(detection);
+		tracks[slot].activate(this->kalman_filter, this->frame_id);
+		activated_stracks.push_back(slot);
 	}
 
 	////////////////// Step 5: Update state //////////////////
-	for (int i = 0; i < this->lost_stracks.size(); i++)
+	for (int slot : this->lost_stracks)
 	{
-		if (this->frame_id - this->lost_stracks[i].end_frame() > this->max_time_lost)
+		if (this->frame_id - tracks[slot].end_frame() > this->max_time_lost)
 		{
-			this->lost_stracks[i].mark_removed();
-			removed_stracks.push_back(this->lost_stracks[i]);
+			tracks[slot].mark_removed();
+			removed_stracks.push_back(slot);
 		}
 	}
-	
-	for (int i = 0; i < this->tracked_stracks.size(); i++)
+
+	slot_mark.assign(tracks.size(), 0);
+	int tracked_size = 0;
+	for (int slot : this->tracked_stracks)
 	{
-		if (this->tracked_stracks[i].state == TrackState::Tracked)
+		if (tracks[slot].state == TrackState::Tracked)
 		{
-			tracked_stracks_swap.push_back(this->tracked_stracks[i]);
+			this->tracked_stracks[tracked_size++] = slot;
+			slot_mark[slot] = 1;
 		}
 	}
-	this->tracked_stracks.clear();
-	this->tracked_stracks.assign(tracked_stracks_swap.begin(), tracked_stracks_swap.end());
+	this->tracked_stracks.resize(tracked_size);
 
-	this->tracked_stracks = joint_stracks(this->tracked_stracks, activated_stracks);
-	this->tracked_stracks = joint_stracks(this->tracked_stracks, refind_stracks);
-
-	//std::cout << activated_stracks.size() << std::endl;
-
-	this->lost_stracks = sub_stracks(this->lost_stracks, this->tracked_stracks);
-	for (int i = 0; i < lost_stracks.size(); i++)
+	for (const auto *joint : {&activated_stracks, &refind_stracks})
 	{
-		this->lost_stracks.push_back(lost_stracks[i]);
+		for (int slot : *joint)
+		{
+			if (slot_mark[slot] != 1)
+			{
+				slot_mark[slot] = 1;
+				this->tracked_stracks.push_back(slot);
+			}
+		}
 	}
 
-	this->lost_stracks = sub_stracks(this->lost_stracks, this->removed_stracks);
-	for (int i = 0; i < removed_stracks.size(); i++)
+	// lost = lost - tracked + new lost - tracks removed in earlier frames, ordered by track_id.
+	// Tracks removed in this frame stay in lost until the next update, as the original list version does.
+	int lost_size = 0;
+	for (int slot : this->lost_stracks)
+	{
+		if (!slot_mark[slot] && !slot_removed[slot])
+		{
+			this->lost_stracks[lost_size++] = slot;
+		}
+	}
+	this->lost_stracks.resize(lost_size);
+	for (int slot : new_lost_stracks)
+	{
+		if (!slot_removed[slot])
+		{
+			this->lost_stracks.push_back(slot);
+		}
+	}
+	for (int slot : removed_stracks)
 	{
-		this->removed_stracks.push_back(removed_stracks[i]);
+		slot_removed[slot] = 1;
 	}
-	
-	remove_duplicate_stracks(resa, resb, this->tracked_stracks, this->lost_stracks);
+	std::sort(this->lost_stracks.begin(), this->lost_stracks.end(),
+		[this](int a, int b) { return tracks[a].track_id < tracks[b].track_id; });
+
+	remove_duplicate_stracks(this->tracked_stracks, this->lost_stracks);
+	release_unused_tracks();
 
-	this->tracked_stracks.clear();
-	this->tracked_stracks.assign(resa.begin(), resa.end());
-	this->lost_stracks.clear();
-	this->lost_stracks.assign(resb.begin(), resb.end());
-	
-	for (int i = 0; i < this->tracked_stracks.size(); i++)
+	output_stracks.clear();
+	for (int slot : this->tracked_stracks)
 	{
-		if (this->tracked_stracks[i].is_activated)
+		if (tracks[slot].is_activated)
 		{
-			output_stracks.push_back(this->tracked_stracks[i]);
+			output_stracks.push_back(&tracks[slot]);
 		}
 	}
 	return output_stracks;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "STrack.h"
+#include "lapjv.h"
 
 struct Object {
     int target_id;
@@ -9,30 +10,31 @@ struct Object {
     cv::Rect_<float> rect;
 };
 
+/**
+ * Tracks live in a slot pool and the tracked / lost lists only hold slot indices, so a track is never copied
+ * between lists. IoU and cost matrices are flat row-major buffers, all scratch buffers are members reused by
+ * every update(), nothing is allocated once they have grown to the largest frame seen.
+ */
 class BYTETracker {
 public:
     BYTETracker(const float track_thres = 0.5, const float high_thresh = 0.6, const float match_thresh = 0.8,
                 const int track_buffer = 30);
 	~BYTETracker();
 
-	vector<STrack> update(const vector<Object>& objects);
+	/**
+	 * Returned tracks point into the tracker and stay valid until the next update().
+	 */
+	const vector<const STrack *> &update(const vector<Object>& objects);
 	Scalar get_color(int idx);
 
 private:
-	vector<STrack*> joint_stracks(vector<STrack*> &tlista, vector<STrack> &tlistb);
-	vector<STrack> joint_stracks(vector<STrack> &tlista, vector<STrack> &tlistb);
+	int alloc_track(const STrack &track);
+	void release_unused_tracks();
 
-	vector<STrack> sub_stracks(vector<STrack> &tlista, vector<STrack> &tlistb);
-	void remove_duplicate_stracks(vector<STrack> &resa, vector<STrack> &resb, vector<STrack> &stracksa, vector<STrack> &stracksb);
+	void remove_duplicate_stracks(vector<int> &stracksa, vector<int> &stracksb);
 
-	void linear_assignment(vector<vector<float> > &cost_matrix, int cost_matrix_size, int cost_matrix_size_size, float thresh,
-		vector<vector<int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b);
-	vector<vector<float> > iou_distance(vector<STrack*> &atracks, vector<STrack> &btracks, int &dist_size, int &dist_size_size);
-	vector<vector<float> > iou_distance(vector<STrack> &atracks, vector<STrack> &btracks);
-	vector<vector<float> > ious(vector<vector<float> > &atlbrs, vector<vector<float> > &btlbrs);
-
-	double lapjv(const vector<vector<float> > &cost, vector<int> &rowsol, vector<int> &colsol, 
-		bool extend_cost = false, float cost_limit = LONG_MAX, bool return_cost = true);
+	void linear_assignment(int cost_matrix_size, int cost_matrix_size_size, float thresh);
+	void iou_distance(const vector<const STrack *> &atracks, const vector<const STrack *> &btracks);
 
 private:
 
@@ -42,8 +44,37 @@ private:
     int frame_id;
     int max_time_lost;
 
-    vector<STrack> tracked_stracks;
-    vector<STrack> lost_stracks;
-    vector<STrack> removed_stracks;
+    vector<STrack> tracks;              // track pool, addressed by slot
+    vector<char> slot_used;
+    vector<char> slot_removed;          // track has been removed, it never returns to lost
+    vector<int> free_slots;
+    vector<int> tracked_stracks;        // slots of tracked tracks
+    vector<int> lost_stracks;           // slots of lost tracks, sorted by track_id
     byte_kalman::KalmanFilter kalman_filter;
+
+    // per-frame scratch
+    vector<STrack> detections;
+    vector<STrack> detections_low;
+    vector<int> detections_remain;
+    vector<int> unconfirmed;
+    vector<int> strack_pool;
+    vector<int> r_tracked_stracks;
+    vector<int> activated_stracks;
+    vector<int> refind_stracks;
+    vector<int> new_lost_stracks;
+    vector<int> removed_stracks;
+    vector<char> slot_mark;
+    vector<const STrack *> rows;
+    vector<const STrack *> cols;
+    vector<const STrack *> output_stracks;
+
+    vector<float> box_cols;             // x1, y1, x2, y2, area planes, padded to 4 columns
+    vector<float> iou_row;              // one row of 1 - IoU, padded to 4 columns
+    vector<float> cost_matrix;          // 1 - IoU, rows x cols
+    vector<double> lap_cost;
+    vector<int_t> lap_x, lap_y;
+    LapjvWorkspace lap_workspace;
+    vector<pair<int, int> > matches;
+    vector<int> unmatched_a, unmatched_b;
+    vector<char> dup_a, dup_b;
 };
\ No newline at end of file
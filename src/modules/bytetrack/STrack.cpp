@@ -1,17 +1,16 @@
 #include "STrack.h"
 #include <thread>
 
-STrack::STrack(vector<float> tlwh_, float score, int label, int target_id)
+STrack::STrack(const float *tlwh_, float score, int label, int target_id)
 {
-	_tlwh.resize(4);
-	_tlwh.assign(tlwh_.begin(), tlwh_.end());
+	_tlwh[0] = tlwh_[0];
+	_tlwh[1] = tlwh_[1];
+	_tlwh[2] = tlwh_[2];
+	_tlwh[3] = tlwh_[3];
 
 	is_activated = false;
 	track_id = 0;
 	state = TrackState::New;
-	
-	tlwh.resize(4);
-	tlbr.resize(4);
 
 	static_tlwh();
 	static_tlbr();
@@ -29,21 +28,9 @@ STrack::~STrack()
 
 void STrack::activate(byte_kalman::KalmanFilter &kalman_filter, int frame_id)
 {
-	this->kalman_filter = kalman_filter;
 	this->track_id = this->next_id();
 
-	vector<float> _tlwh_tmp(4);
-	_tlwh_tmp[0] = this->_tlwh[0];
-	_tlwh_tmp[1] = this->_tlwh[1];
-	_tlwh_tmp[2] = this->_tlwh[2];
-	_tlwh_tmp[3] = this->_tlwh[3];
-	vector<float> xyah = tlwh_to_xyah(_tlwh_tmp);
-	DETECTBOX xyah_box;
-	xyah_box[0] = xyah[0];
-	xyah_box[1] = xyah[1];
-	xyah_box[2] = xyah[2];
-	xyah_box[3] = xyah[3];
-	auto mc = this->kalman_filter.initiate(xyah_box);
+	auto mc = kalman_filter.initiate(tlwh_to_xyah(this->_tlwh));
 	this->mean = mc.first;
 	this->covariance = mc.second;
 
@@ -61,15 +48,9 @@ void STrack::activate(byte_kalman::KalmanFilter &kalman_filter, int frame_id)
 	this->start_frame = frame_id;
 }
 
-void STrack::re_activate(STrack &new_track, int frame_id, bool new_id)
+void STrack::re_activate(const STrack &new_track, byte_kalman::KalmanFilter &kalman_filter, int frame_id, bool new_id)
 {
-	vector<float> xyah = tlwh_to_xyah(new_track.tlwh);
-	DETECTBOX xyah_box;
-	xyah_box[0] = xyah[0];
-	xyah_box[1] = xyah[1];
-	xyah_box[2] = xyah[2];
-	xyah_box[3] = xyah[3];
-	auto mc = this->kalman_filter.update(this->mean, this->covariance, xyah_box);
+	auto mc = kalman_filter.update(this->mean, this->covariance, tlwh_to_xyah(new_track.tlwh));
 	this->mean = mc.first;
 	this->covariance = mc.second;
 
@@ -87,19 +68,12 @@ void STrack::re_activate(STrack &new_track, int frame_id, bool new_id)
 		this->track_id = next_id();
 }
 
-void STrack::update(STrack &new_track, int frame_id)
+void STrack::update(const STrack &new_track, byte_kalman::KalmanFilter &kalman_filter, int frame_id)
 {
 	this->frame_id = frame_id;
 	this->tracklet_len++;
 
-	vector<float> xyah = tlwh_to_xyah(new_track.tlwh);
-	DETECTBOX xyah_box;
-	xyah_box[0] = xyah[0];
-	xyah_box[1] = xyah[1];
-	xyah_box[2] = xyah[2];
-	xyah_box[3] = xyah[3];
-
-	auto mc = this->kalman_filter.update(this->mean, this->covariance, xyah_box);
+	auto mc = kalman_filter.update(this->mean, this->covariance, tlwh_to_xyah(new_track.tlwh));
 	this->mean = mc.first;
 	this->covariance = mc.second;
 
@@ -137,33 +111,27 @@ void STrack::static_tlwh()
 
 void STrack::static_tlbr()
 {
-	tlbr.clear();
-	tlbr.assign(tlwh.begin(), tlwh.end());
-	tlbr[2] += tlbr[0];
-	tlbr[3] += tlbr[1];
+	tlbr[0] = tlwh[0];
+	tlbr[1] = tlwh[1];
+	tlbr[2] = tlwh[2] + tlwh[0];
+	tlbr[3] = tlwh[3] + tlwh[1];
 }
 
-vector<float> STrack::tlwh_to_xyah(vector<float> tlwh_tmp)
+DETECTBOX STrack::tlwh_to_xyah(const float *tlwh_tmp) const
 {
-	vector<float> tlwh_output = tlwh_tmp;
-	tlwh_output[0] += tlwh_output[2] / 2;
-	tlwh_output[1] += tlwh_output[3] / 2;
-	tlwh_output[2] /= tlwh_output[3];
-	return tlwh_output;
+	DETECTBOX xyah;
+	xyah[0] = tlwh_tmp[0] + tlwh_tmp[2] / 2;
+	xyah[1] = tlwh_tmp[1] + tlwh_tmp[3] / 2;
+	xyah[2] = tlwh_tmp[2] / tlwh_tmp[3];
+	xyah[3] = tlwh_tmp[3];
+	return xyah;
 }
 
-vector<float> STrack::to_xyah()
+DETECTBOX STrack::to_xyah() const
 {
 	return tlwh_to_xyah(tlwh);
 }
 
-vector<float> STrack::tlbr_to_tlwh(vector<float> &tlbr)
-{
-	tlbr[2] -= tlbr[0];
-	tlbr[3] -= tlbr[1];
-	return tlbr;
-}
-
 void STrack::mark_lost()
 {
 	state = TrackState::Lost;
@@ -181,21 +149,18 @@ int STrack::next_id()
 	return _count;
 }
 
-int STrack::end_frame()
+int STrack::end_frame() const
 {
 	return this->frame_id;
 }
 
-void STrack::multi_predict(vector<STrack*> &stracks, byte_kalman::KalmanFilter &kalman_filter)
+void STrack::predict(byte_kalman::KalmanFilter &kalman_filter)
 {
-	for (int i = 0; i < stracks.size(); i++)
+	if (this->state != TrackState::Tracked)
 	{
-		if (stracks[i]->state != TrackState::Tracked)
-		{
-			stracks[i]->mean[7] = 0;
-		}
-		kalman_filter.predict(stracks[i]->mean, stracks[i]->covariance);
-		stracks[i]->static_tlwh();
-		stracks[i]->static_tlbr();
+		this->mean[7] = 0;
 	}
+	kalman_filter.predict(this->mean, this->covariance);
+	static_tlwh();
+	static_tlbr();
 }
\ No newline at end of file
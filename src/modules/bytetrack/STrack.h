@@ -8,26 +8,30 @@ using namespace std;
 
 enum TrackState { New = 0, Tracked, Lost, Removed };
 
+/**
+ * Plain value type without heap members, tracks are kept in BYTETracker's pool and copied by slot.
+ * All tracks share the tracker's Kalman filter.
+ */
 class STrack
 {
 public:
-	STrack(vector<float> tlwh_, float score, int label, int target_id);
+	STrack(const float *tlwh_, float score, int label, int target_id);
 	~STrack();
 
-	vector<float> static tlbr_to_tlwh(vector<float> &tlbr);
-	void static multi_predict(vector<STrack*> &stracks, byte_kalman::KalmanFilter &kalman_filter);
+	void predict(byte_kalman::KalmanFilter &kalman_filter);
 	void static_tlwh();
 	void static_tlbr();
-	vector<float> tlwh_to_xyah(vector<float> tlwh_tmp);
-	vector<float> to_xyah();
+	DETECTBOX tlwh_to_xyah(const float *tlwh_tmp) const;
+	DETECTBOX to_xyah() const;
 	void mark_lost();
 	void mark_removed();
 	int next_id();
-	int end_frame();
+	int end_frame() const;
 	
 	void activate(byte_kalman::KalmanFilter &kalman_filter, int frame_id);
-	void re_activate(STrack &new_track, int frame_id, bool new_id = false);
-	void update(STrack &new_track, int frame_id);
+	void re_activate(const STrack &new_track, byte_kalman::KalmanFilter &kalman_filter, int frame_id,
+		bool new_id = false);
+	void update(const STrack &new_track, byte_kalman::KalmanFilter &kalman_filter, int frame_id);
 
 public:
 	bool is_activated;
@@ -36,9 +40,9 @@ public:
 	int label;
 	int state;
 
-	vector<float> _tlwh;
-	vector<float> tlwh;
-	vector<float> tlbr;
+	float _tlwh[4];
+	float tlwh[4];
+	float tlbr[4];
 	int frame_id;
 	int tracklet_len;
 	int start_frame;
@@ -46,7 +50,4 @@ public:
 	KAL_MEAN mean;
 	KAL_COVA covariance;
 	float score;
-
-private:
-	byte_kalman::KalmanFilter kalman_filter;
 };
\ No newline at end of file
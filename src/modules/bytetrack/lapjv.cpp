@@ -6,11 +6,10 @@
 
 /** Column-reduction and reduction transfer for a dense cost matrix.
  */
-int_t _ccrrt_dense(const uint_t n, cost_t *cost[],
-	int_t *free_rows, int_t *x, int_t *y, cost_t *v)
+int_t _ccrrt_dense(const uint_t n, const cost_t *cost,
+	int_t *free_rows, int_t *x, int_t *y, cost_t *v, boolean *unique)
 {
 	int_t n_free_rows;
-	boolean *unique;
 
 	for (uint_t i = 0; i < n; i++) {
 		x[i] = -1;
@@ -19,7 +18,7 @@ int_t _ccrrt_dense(const uint_t n, cost_t *cost[],
 	}
 	for (uint_t i = 0; i < n; i++) {
 		for (uint_t j = 0; j < n; j++) {
-			const cost_t c = cost[i][j];
+			const cost_t c = cost[(size_t)i * n + j];
 			if (c < v[j]) {
 				v[j] = c;
 				y[j] = i;
@@ -29,7 +28,6 @@ int_t _ccrrt_dense(const uint_t n, cost_t *cost[],
 	}
 	PRINT_COST_ARRAY(v, n);
 	PRINT_INDEX_ARRAY(y, n);
-	NEW(unique, boolean, n);
 	memset(unique, TRUE, n);
 	{
 		int_t j = n;
@@ -57,7 +55,7 @@ int_t _ccrrt_dense(const uint_t n, cost_t *cost[],
 				if (j2 == (uint_t)j) {
 					continue;
 				}
-				const cost_t c = cost[i][j2] - v[j2];
+				const cost_t c = cost[(size_t)i * n + j2] - v[j2];
 				if (c < min) {
 					min = c;
 				}
@@ -66,7 +64,6 @@ int_t _ccrrt_dense(const uint_t n, cost_t *cost[],
 			v[j] -= min;
 		}
 	}
-	FREE(unique);
 	return n_free_rows;
 }
 
@@ -74,7 +71,7 @@ int_t _ccrrt_dense(const uint_t n, cost_t *cost[],
 /** Augmenting row reduction for a dense cost matrix.
  */
 int_t _carr_dense(
-	const uint_t n, cost_t *cost[],
+	const uint_t n, const cost_t *cost,
 	const uint_t n_free_rows,
 	int_t *free_rows, int_t *x, int_t *y, cost_t *v)
 {
@@ -95,12 +92,12 @@ int_t _carr_dense(
 		PRINTF("current = %d rr_cnt = %d\n", current, rr_cnt);
 		const int_t free_i = free_rows[current++];
 		j1 = 0;
-		v1 = cost[free_i][0] - v[0];
+		v1 = cost[(size_t)free_i * n + 0] - v[0];
 		j2 = -1;
 		v2 = LARGE;
 		for (uint_t j = 1; j < n; j++) {
 			PRINTF("%d = %f %d = %f\n", j1, v1, j2, v2);
-			const cost_t c = cost[free_i][j] - v[j];
+			const cost_t c = cost[(size_t)free_i * n + j] - v[j];
 			if (c < v2) {
 				if (c >= v1) {
 					v2 = c;
@@ -171,7 +168,7 @@ uint_t _find_dense(const uint_t n, uint_t lo, cost_t *d, int_t *cols, int_t *y)
 
 // Scan all columns in TODO starting from arbitrary column in SCAN
 // and try to decrease d of the TODO columns using the SCAN column.
-int_t _scan_dense(const uint_t n, cost_t *cost[],
+int_t _scan_dense(const uint_t n, const cost_t *cost,
 	uint_t *plo, uint_t*phi,
 	cost_t *d, int_t *cols, int_t *pred,
 	int_t *y, cost_t *v)
@@ -184,12 +181,12 @@ int_t _scan_dense(const uint_t n, cost_t *cost[],
 		int_t j = cols[lo++];
 		const int_t i = y[j];
 		const cost_t mind = d[j];
-		h = cost[i][j] - v[j] - mind;
+		h = cost[(size_t)i * n + j] - v[j] - mind;
 		PRINTF("i=%d j=%d h=%f\n", i, j, h);
 		// For all columns in TODO
 		for (uint_t k = hi; k < n; k++) {
 			j = cols[k];
-			cred_ij = cost[i][j] - v[j] - h;
+			cred_ij = cost[(size_t)i * n + j] - v[j] - h;
 			if (cred_ij < d[j]) {
 				d[j] = cred_ij;
 				pred[j] = i;
@@ -216,24 +213,19 @@ int_t _scan_dense(const uint_t n, cost_t *cost[],
  * \return The closest free column index.
  */
 int_t find_path_dense(
-	const uint_t n, cost_t *cost[],
+	const uint_t n, const cost_t *cost,
 	const int_t start_i,
 	int_t *y, cost_t *v,
-	int_t *pred)
+	int_t *pred, int_t *cols, cost_t *d)
 {
 	uint_t lo = 0, hi = 0;
 	int_t final_j = -1;
 	uint_t n_ready = 0;
-	int_t *cols;
-	cost_t *d;
-
-	NEW(cols, int_t, n);
-	NEW(d, cost_t, n);
 
 	for (uint_t i = 0; i < n; i++) {
 		cols[i] = i;
 		pred[i] = start_i;
-		d[i] = cost[start_i][i] - v[i];
+		d[i] = cost[(size_t)start_i * n + i] - v[i];
 	}
 	PRINT_COST_ARRAY(d, n);
 	while (final_j == -1) {
@@ -271,9 +263,6 @@ int_t find_path_dense(
 		}
 	}
 
-	FREE(cols);
-	FREE(d);
-
 	return final_j;
 }
 
@@ -281,20 +270,17 @@ int_t find_path_dense(
 /** Augment for a dense cost matrix.
  */
 int_t _ca_dense(
-	const uint_t n, cost_t *cost[],
+	const uint_t n, const cost_t *cost,
 	const uint_t n_free_rows,
-	int_t *free_rows, int_t *x, int_t *y, cost_t *v)
+	int_t *free_rows, int_t *x, int_t *y, cost_t *v,
+	int_t *pred, int_t *cols, cost_t *d)
 {
-	int_t *pred;
-
-	NEW(pred, int_t, n);
-
 	for (int_t *pfree_i = free_rows; pfree_i < free_rows + n_free_rows; pfree_i++) {
 		int_t i = -1, j;
 		uint_t k = 0;
 
 		PRINTF("looking at free_i=%d\n", *pfree_i);
-		j = find_path_dense(n, cost, *pfree_i, y, v, pred);
+		j = find_path_dense(n, cost, *pfree_i, y, v, pred, cols, d);
 		ASSERT(j >= 0);
 		ASSERT(j < n);
 		while (i != *pfree_i) {
@@ -311,33 +297,50 @@ int_t _ca_dense(
 			}
 		}
 	}
-	FREE(pred);
 	return 0;
 }
 
 
-/** Solve dense sparse LAP.
+/** Solve dense LAP, cost is a row-major n x n matrix.
+ *
+ * Buffers come from the workspace and are only reallocated when n grows.
  */
-int lapjv_internal(
-	const uint_t n, cost_t *cost[],
-	int_t *x, int_t *y)
+int_t lapjv_dense(const uint_t n, const cost_t *cost, int_t *x, int_t *y, LapjvWorkspace &workspace)
 {
 	int ret;
-	int_t *free_rows;
-	cost_t *v;
+	workspace.free_rows.resize(n);
+	workspace.cols.resize(n);
+	workspace.pred.resize(n);
+	workspace.v.resize(n);
+	workspace.d.resize(n);
+	workspace.unique.resize(n);
 
-	NEW(free_rows, int_t, n);
-	NEW(v, cost_t, n);
-	ret = _ccrrt_dense(n, cost, free_rows, x, y, v);
+	int_t *free_rows = workspace.free_rows.data();
+	cost_t *v = workspace.v.data();
+	ret = _ccrrt_dense(n, cost, free_rows, x, y, v, workspace.unique.data());
 	int i = 0;
 	while (ret > 0 && i < 2) {
 		ret = _carr_dense(n, cost, ret, free_rows, x, y, v);
 		i++;
 	}
 	if (ret > 0) {
-		ret = _ca_dense(n, cost, ret, free_rows, x, y, v);
+		ret = _ca_dense(n, cost, ret, free_rows, x, y, v, workspace.pred.data(), workspace.cols.data(),
+			workspace.d.data());
 	}
-	FREE(v);
-	FREE(free_rows);
 	return ret;
+}
+
+
+/** Solve dense sparse LAP.
+ */
+int lapjv_internal(
+	const uint_t n, cost_t *cost[],
+	int_t *x, int_t *y)
+{
+	std::vector<cost_t> flat((size_t)n * n);
+	for (uint_t i = 0; i < n; i++) {
+		memcpy(flat.data() + (size_t)i * n, cost[i], sizeof(cost_t) * n);
+	}
+	LapjvWorkspace workspace;
+	return lapjv_dense(n, flat.data(), x, y, workspace);
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef LAPJV_H
 #define LAPJV_H
 
+#include <vector>
+
 #define LARGE 1000000
 
 #if !defined TRUE
@@ -56,6 +58,19 @@ typedef double cost_t;
 typedef char boolean;
 typedef enum fp_t { FP_1 = 1, FP_2 = 2, FP_DYNAMIC = 3 } fp_t;
 
+/** Scratch buffers reused across lapjv_dense() calls.
+ */
+struct LapjvWorkspace {
+	std::vector<int_t> free_rows;
+	std::vector<int_t> cols;
+	std::vector<int_t> pred;
+	std::vector<cost_t> v;
+	std::vector<cost_t> d;
+	std::vector<boolean> unique;
+};
+
+extern int_t lapjv_dense(const uint_t n, const cost_t *cost, int_t *x, int_t *y, LapjvWorkspace &workspace);
+
 extern int_t lapjv_internal(
 	const uint_t n, cost_t *cost[],
 	int_t *x, int_t *y);
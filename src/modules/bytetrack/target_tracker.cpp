@@ -13,21 +13,22 @@ public:
 
     std::map<int, TrackObject> update_object(const std::vector<TrackObject> &objects) {
 
-        auto vec_objects = std::vector<Object>();
+        vec_objects_.clear();
         for (const auto &item : objects) {
-            vec_objects.push_back(Object{.target_id = item.target_id,
-                                         .label = item.class_id,
-                                         .prob = item.prob,
-                                         .rect = {item.rect.x, item.rect.y, item.rect.width, item.rect.height}});
+            vec_objects_.push_back(Object{.target_id = item.target_id,
+                                          .label = item.class_id,
+                                          .prob = item.prob,
+                                          .rect = {item.rect.x, item.rect.y, item.rect.width, item.rect.height}});
         }
 
         std::map<int, TrackObject> result;
-        auto tracked_target = tracker_->update(vec_objects);
-        for (auto &item : tracked_target) {
-            result[item.track_id] = TrackObject{.target_id = item.target_id,
-                                                .class_id = item.label,
-                                                .prob = item.score,
-                                                .rect = Rect2f{item.tlwh[0], item.tlwh[1], item.tlwh[2], item.tlwh[3]}};
+        const auto &tracked_target = tracker_->update(vec_objects_);
+        for (const auto *item : tracked_target) {
+            const auto *tlwh = item->tlwh;
+            result[item->track_id] = TrackObject{.target_id = item->target_id,
+                                                 .class_id = item->label,
+                                                 .prob = item->score,
+                                                 .rect = Rect2f{tlwh[0], tlwh[1], tlwh[2], tlwh[3]}};
         }
 
         return result;
@@ -37,6 +38,7 @@ public:
 
 private:
     std::unique_ptr<BYTETracker> tracker_;
+    std::vector<Object> vec_objects_;
 };
 
 TargetTracker::TargetTracker(const TrackOption &option) {
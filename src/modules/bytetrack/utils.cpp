@@ -1,421 +1,270 @@
 #include "BYTETracker.h"
 #include "lapjv.h"
 
-vector<STrack*> BYTETracker::joint_stracks(vector<STrack*> &tlista, vector<STrack> &tlistb)
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IOU_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IOU_NEON
+#endif
+
+int BYTETracker::alloc_track(const STrack &track)
 {
-	map<int, int> exists;
-	vector<STrack*> res;
-	for (int i = 0; i < tlista.size(); i++)
+	int slot;
+	if (!free_slots.empty())
 	{
-		exists.insert(pair<int, int>(tlista[i]->track_id, 1));
-		res.push_back(tlista[i]);
+		slot = free_slots.back();
+		free_slots.pop_back();
+		tracks[slot] = track;
 	}
-	for (int i = 0; i < tlistb.size(); i++)
+	else
 	{
-		int tid = tlistb[i].track_id;
-		if (!exists[tid] || exists.count(tid) == 0)
-		{
-			exists[tid] = 1;
-			res.push_back(&tlistb[i]);
-		}
+		slot = tracks.size();
+		tracks.push_back(track);
+		slot_used.push_back(0);
+		slot_removed.push_back(0);
 	}
-	return res;
+	slot_used[slot] = 1;
+	slot_removed[slot] = 0;
+	return slot;
 }
 
-vector<STrack> BYTETracker::joint_stracks(vector<STrack> &tlista, vector<STrack> &tlistb)
+void BYTETracker::release_unused_tracks()
 {
-	map<int, int> exists;
-	vector<STrack> res;
-	for (int i = 0; i < tlista.size(); i++)
+	slot_mark.assign(tracks.size(), 0);
+	for (int slot : tracked_stracks)
 	{
-		exists.insert(pair<int, int>(tlista[i].track_id, 1));
-		res.push_back(tlista[i]);
+		slot_mark[slot] = 1;
 	}
-	for (int i = 0; i < tlistb.size(); i++)
+	for (int slot : lost_stracks)
 	{
-		int tid = tlistb[i].track_id;
-		if (!exists[tid] || exists.count(tid) == 0)
+		slot_mark[slot] = 1;
+	}
+
+	for (int slot = 0; slot < (int)tracks.size(); slot++)
+	{
+		if (slot_used[slot] && !slot_mark[slot])
 		{
-			exists[tid] = 1;
-			res.push_back(tlistb[i]);
+			slot_used[slot] = 0;
+			free_slots.push_back(slot);
 		}
 	}
-	return res;
 }
 
-vector<STrack> BYTETracker::sub_stracks(vector<STrack> &tlista, vector<STrack> &tlistb)
+void BYTETracker::remove_duplicate_stracks(vector<int> &stracksa, vector<int> &stracksb)
 {
-	map<int, STrack> stracks;
-	for (int i = 0; i < tlista.size(); i++)
-	{
-		stracks.insert(pair<int, STrack>(tlista[i].track_id, tlista[i]));
-	}
-	for (int i = 0; i < tlistb.size(); i++)
+	rows.clear();
+	for (int slot : stracksa)
 	{
-		int tid = tlistb[i].track_id;
-		if (stracks.count(tid) != 0)
-		{
-			stracks.erase(tid);
-		}
+		rows.push_back(&tracks[slot]);
 	}
-
-	vector<STrack> res;
-	std::map<int, STrack>::iterator  it;
-	for (it = stracks.begin(); it != stracks.end(); ++it)
+	cols.clear();
+	for (int slot : stracksb)
 	{
-		res.push_back(it->second);
+		cols.push_back(&tracks[slot]);
 	}
+	iou_distance(rows, cols);
 
-	return res;
-}
-
-void BYTETracker::remove_duplicate_stracks(vector<STrack> &resa, vector<STrack> &resb, vector<STrack> &stracksa, vector<STrack> &stracksb)
-{
-	vector<vector<float> > pdist = iou_distance(stracksa, stracksb);
-	vector<pair<int, int> > pairs;
-	for (int i = 0; i < pdist.size(); i++)
+	dup_a.assign(stracksa.size(), 0);
+	dup_b.assign(stracksb.size(), 0);
+	for (size_t i = 0; i < rows.size(); i++)
 	{
-		for (int j = 0; j < pdist[i].size(); j++)
+		const float *pdist = cost_matrix.data() + i * cols.size();
+		for (size_t j = 0; j < cols.size(); j++)
 		{
-			if (pdist[i][j] < 0.15)
+			if (pdist[j] < 0.15)
 			{
-				pairs.push_back(pair<int, int>(i, j));
+				int timep = rows[i]->frame_id - rows[i]->start_frame;
+				int timeq = cols[j]->frame_id - cols[j]->start_frame;
+				if (timep > timeq)
+					dup_b[j] = 1;
+				else
+					dup_a[i] = 1;
 			}
 		}
 	}
 
-	vector<int> dupa, dupb;
-	for (int i = 0; i < pairs.size(); i++)
-	{
-		int timep = stracksa[pairs[i].first].frame_id - stracksa[pairs[i].first].start_frame;
-		int timeq = stracksb[pairs[i].second].frame_id - stracksb[pairs[i].second].start_frame;
-		if (timep > timeq)
-			dupb.push_back(pairs[i].second);
-		else
-			dupa.push_back(pairs[i].first);
-	}
-
-	for (int i = 0; i < stracksa.size(); i++)
+	int size = 0;
+	for (size_t i = 0; i < stracksa.size(); i++)
 	{
-		vector<int>::iterator iter = find(dupa.begin(), dupa.end(), i);
-		if (iter == dupa.end())
+		if (!dup_a[i])
 		{
-			resa.push_back(stracksa[i]);
+			stracksa[size++] = stracksa[i];
 		}
 	}
+	stracksa.resize(size);
 
-	for (int i = 0; i < stracksb.size(); i++)
+	size = 0;
+	for (size_t i = 0; i < stracksb.size(); i++)
 	{
-		vector<int>::iterator iter = find(dupb.begin(), dupb.end(), i);
-		if (iter == dupb.end())
+		if (!dup_b[i])
 		{
-			resb.push_back(stracksb[i]);
+			stracksb[size++] = stracksb[i];
 		}
 	}
+	stracksb.resize(size);
 }
 
-void BYTETracker::linear_assignment(vector<vector<float> > &cost_matrix, int cost_matrix_size, int cost_matrix_size_size, float thresh,
-	vector<vector<int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b)
+void BYTETracker::linear_assignment(int cost_matrix_size, int cost_matrix_size_size, float thresh)
 {
-	if (cost_matrix.size() == 0)
+	matches.clear();
+	unmatched_a.clear();
+	unmatched_b.clear();
+
+	int n_rows = cost_matrix_size;
+	int n_cols = cost_matrix_size_size;
+	if (n_rows == 0 || n_cols == 0)
 	{
-		for (int i = 0; i < cost_matrix_size; i++)
+		for (int i = 0; i < n_rows; i++)
 		{
 			unmatched_a.push_back(i);
 		}
-		for (int i = 0; i < cost_matrix_size_size; i++)
+		for (int i = 0; i < n_cols; i++)
 		{
 			unmatched_b.push_back(i);
 		}
 		return;
 	}
 
-	vector<int> rowsol; vector<int> colsol;
-	float c = lapjv(cost_matrix, rowsol, colsol, true, thresh);
-	for (int i = 0; i < rowsol.size(); i++)
+	// Extend to (rows + cols) square: unmatched rows / cols cost thresh / 2, dummy block costs 0
+	int n = n_rows + n_cols;
+	const double fill = (float)(thresh / 2.0);
+	lap_cost.resize((size_t)n * n);
+	for (int i = 0; i < n; i++)
 	{
-		if (rowsol[i] >= 0)
+		double *row = lap_cost.data() + (size_t)i * n;
+		if (i < n_rows)
 		{
-			vector<int> match;
-			match.push_back(i);
-			match.push_back(rowsol[i]);
-			matches.push_back(match);
+			const float *cost = cost_matrix.data() + (size_t)i * n_cols;
+			for (int j = 0; j < n_cols; j++)
+				row[j] = cost[j];
+			std::fill(row + n_cols, row + n, fill);
 		}
 		else
 		{
-			unmatched_a.push_back(i);
-		}
-	}
-
-	for (int i = 0; i < colsol.size(); i++)
-	{
-		if (colsol[i] < 0)
-		{
-			unmatched_b.push_back(i);
+			std::fill(row, row + n_cols, fill);
+			std::fill(row + n_cols, row + n, 0.0);
 		}
 	}
-}
 
-vector<vector<float> > BYTETracker::ious(vector<vector<float> > &atlbrs, vector<vector<float> > &btlbrs)
-{
-	vector<vector<float> > ious;
-	if (atlbrs.size()*btlbrs.size() == 0)
-		return ious;
-
-	ious.resize(atlbrs.size());
-	for (int i = 0; i < ious.size(); i++)
+	lap_x.resize(n);
+	lap_y.resize(n);
+	int ret = lapjv_dense(n, lap_cost.data(), lap_x.data(), lap_y.data(), lap_workspace);
+	if (ret != 0)
 	{
-		ious[i].resize(btlbrs.size());
+		printf("Calculate Wrong!\n");
 	}
 
-	//bbox_ious
-	for (int k = 0; k < btlbrs.size(); k++)
+	for (int i = 0; i < n_rows; i++)
 	{
-		vector<float> ious_tmp;
-		float box_area = (btlbrs[k][2] - btlbrs[k][0] + 1)*(btlbrs[k][3] - btlbrs[k][1] + 1);
-		for (int n = 0; n < atlbrs.size(); n++)
+		if (lap_x[i] >= 0 && lap_x[i] < n_cols)
 		{
-			float iw = min(atlbrs[n][2], btlbrs[k][2]) - max(atlbrs[n][0], btlbrs[k][0]) + 1;
-			if (iw > 0)
-			{
-				float ih = min(atlbrs[n][3], btlbrs[k][3]) - max(atlbrs[n][1], btlbrs[k][1]) + 1;
-				if(ih > 0)
-				{
-					float ua = (atlbrs[n][2] - atlbrs[n][0] + 1)*(atlbrs[n][3] - atlbrs[n][1] + 1) + box_area - iw * ih;
-					ious[n][k] = iw * ih / ua;
-				}
-				else
-				{
-					ious[n][k] = 0.0;
-				}
-			}
-			else
-			{
-				ious[n][k] = 0.0;
-			}
+			matches.emplace_back(i, lap_x[i]);
 		}
-	}
-
-	return ious;
-}
-
-vector<vector<float> > BYTETracker::iou_distance(vector<STrack*> &atracks, vector<STrack> &btracks, int &dist_size, int &dist_size_size)
-{
-	vector<vector<float> > cost_matrix;
-	if (atracks.size() * btracks.size() == 0)
-	{
-		dist_size = atracks.size();
-		dist_size_size = btracks.size();
-		return cost_matrix;
-	}
-	vector<vector<float> > atlbrs, btlbrs;
-	for (int i = 0; i < atracks.size(); i++)
-	{
-		atlbrs.push_back(atracks[i]->tlbr);
-	}
-	for (int i = 0; i < btracks.size(); i++)
-	{
-		btlbrs.push_back(btracks[i].tlbr);
-	}
-
-	dist_size = atracks.size();
-	dist_size_size = btracks.size();
-
-	vector<vector<float> > _ious = ious(atlbrs, btlbrs);
-	
-	for (int i = 0; i < _ious.size();i++)
-	{
-		vector<float> _iou;
-		for (int j = 0; j < _ious[i].size(); j++)
+		else
 		{
-			_iou.push_back(1 - _ious[i][j]);
+			unmatched_a.push_back(i);
 		}
-		cost_matrix.push_back(_iou);
 	}
 
-	return cost_matrix;
-}
-
-vector<vector<float> > BYTETracker::iou_distance(vector<STrack> &atracks, vector<STrack> &btracks)
-{
-	vector<vector<float> > atlbrs, btlbrs;
-	for (int i = 0; i < atracks.size(); i++)
-	{
-		atlbrs.push_back(atracks[i].tlbr);
-	}
-	for (int i = 0; i < btracks.size(); i++)
+	for (int i = 0; i < n_cols; i++)
 	{
-		btlbrs.push_back(btracks[i].tlbr);
-	}
-
-	vector<vector<float> > _ious = ious(atlbrs, btlbrs);
-	vector<vector<float> > cost_matrix;
-	for (int i = 0; i < _ious.size(); i++)
-	{
-		vector<float> _iou;
-		for (int j = 0; j < _ious[i].size(); j++)
+		if (lap_y[i] < 0 || lap_y[i] >= n_rows)
 		{
-			_iou.push_back(1 - _ious[i][j]);
+			unmatched_b.push_back(i);
 		}
-		cost_matrix.push_back(_iou);
 	}
-
-	return cost_matrix;
 }
 
-double BYTETracker::lapjv(const vector<vector<float> > &cost, vector<int> &rowsol, vector<int> &colsol,
-	bool extend_cost, float cost_limit, bool return_cost)
+/**
+ * cost = 1 - IoU, boxes are inclusive pixel coordinates (+1 on width and height).
+ * Columns are stored as planes so 4 columns are computed at once, operation order matches the scalar form.
+ */
+void BYTETracker::iou_distance(const vector<const STrack *> &atracks, const vector<const STrack *> &btracks)
 {
-	vector<vector<float> > cost_c;
-	cost_c.assign(cost.begin(), cost.end());
-
-	vector<vector<float> > cost_c_extended;
-
-	int n_rows = cost.size();
-	int n_cols = cost[0].size();
-	rowsol.resize(n_rows);
-	colsol.resize(n_cols);
-
-	int n = 0;
-	if (n_rows == n_cols)
-	{
-		n = n_rows;
-	}
-	else
-	{
-		if (!extend_cost)
-		{
-			printf("set extend_cost=True\n");
-		}
-	}
-		
-	if (extend_cost || cost_limit < LONG_MAX)
-	{
-		n = n_rows + n_cols;
-		cost_c_extended.resize(n);
-		for (int i = 0; i < cost_c_extended.size(); i++)
-			cost_c_extended[i].resize(n);
-
-		if (cost_limit < LONG_MAX)
-		{
-			for (int i = 0; i < cost_c_extended.size(); i++)
-			{
-				for (int j = 0; j < cost_c_extended[i].size(); j++)
-				{
-					cost_c_extended[i][j] = cost_limit / 2.0;
-				}
-			}
-		}
-		else
-		{
-			float cost_max = -1;
-			for (int i = 0; i < cost_c.size(); i++)
-			{
-				for (int j = 0; j < cost_c[i].size(); j++)
-				{
-					if (cost_c[i][j] > cost_max)
-						cost_max = cost_c[i][j];
-				}
-			}
-			for (int i = 0; i < cost_c_extended.size(); i++)
-			{
-				for (int j = 0; j < cost_c_extended[i].size(); j++)
-				{
-					cost_c_extended[i][j] = cost_max + 1;
-				}
-			}
-		}
-
-		for (int i = n_rows; i < cost_c_extended.size(); i++)
-		{
-			for (int j = n_cols; j < cost_c_extended[i].size(); j++)
-			{
-				cost_c_extended[i][j] = 0;
-			}
-		}
-		for (int i = 0; i < n_rows; i++)
-		{
-			for (int j = 0; j < n_cols; j++)
-			{
-				cost_c_extended[i][j] = cost_c[i][j];
-			}
-		}
-
-		cost_c.clear();
-		cost_c.assign(cost_c_extended.begin(), cost_c_extended.end());
-	}
-
-	double **cost_ptr;
-	cost_ptr = new double *[sizeof(double *) * n];
-	for (int i = 0; i < n; i++)
-		cost_ptr[i] = new double[sizeof(double) * n];
+	const size_t n_rows = atracks.size();
+	const size_t n_cols = btracks.size();
+	const size_t stride = (n_cols + 3) & ~(size_t)3;
+	cost_matrix.resize(n_rows * n_cols);
+	if (n_rows == 0 || n_cols == 0)
+		return;
 
-	for (int i = 0; i < n; i++)
+	box_cols.assign(stride * 5, 0);
+	float *bx1 = box_cols.data();
+	float *by1 = bx1 + stride;
+	float *bx2 = by1 + stride;
+	float *by2 = bx2 + stride;
+	float *barea = by2 + stride;
+	for (size_t k = 0; k < n_cols; k++)
 	{
-		for (int j = 0; j < n; j++)
-		{
-			cost_ptr[i][j] = cost_c[i][j];
-		}
+		const float *tlbr = btracks[k]->tlbr;
+		bx1[k] = tlbr[0];
+		by1[k] = tlbr[1];
+		bx2[k] = tlbr[2];
+		by2[k] = tlbr[3];
+		barea[k] = (tlbr[2] - tlbr[0] + 1) * (tlbr[3] - tlbr[1] + 1);
 	}
 
-	int* x_c = new int[sizeof(int) * n];
-	int *y_c = new int[sizeof(int) * n];
-
-	int ret = lapjv_internal(n, cost_ptr, x_c, y_c);
-	if (ret != 0)
+	iou_row.resize(stride);
+	for (size_t n = 0; n < n_rows; n++)
 	{
-		printf("Calculate Wrong!\n");
-	}
-
-	double opt = 0.0;
-
-	if (n != n_rows)
-	{
-		for (int i = 0; i < n; i++)
+		const float *a = atracks[n]->tlbr;
+		const float aarea = (a[2] - a[0] + 1) * (a[3] - a[1] + 1);
+		float *ious = iou_row.data();
+		size_t k = 0;
+
+#if defined(IOU_SSE2)
+		const __m128 ax1 = _mm_set1_ps(a[0]), ay1 = _mm_set1_ps(a[1]);
+		const __m128 ax2 = _mm_set1_ps(a[2]), ay2 = _mm_set1_ps(a[3]);
+		const __m128 area = _mm_set1_ps(aarea), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+		for (; k < stride; k += 4)
 		{
-			if (x_c[i] >= n_cols)
-				x_c[i] = -1;
-			if (y_c[i] >= n_rows)
-				y_c[i] = -1;
+			__m128 iw = _mm_add_ps(_mm_sub_ps(_mm_min_ps(ax2, _mm_loadu_ps(bx2 + k)),
+				_mm_max_ps(ax1, _mm_loadu_ps(bx1 + k))), one);
+			__m128 ih = _mm_add_ps(_mm_sub_ps(_mm_min_ps(ay2, _mm_loadu_ps(by2 + k)),
+				_mm_max_ps(ay1, _mm_loadu_ps(by1 + k))), one);
+			__m128 inter = _mm_mul_ps(iw, ih);
+			__m128 ua = _mm_sub_ps(_mm_add_ps(area, _mm_loadu_ps(barea + k)), inter);
+			__m128 valid = _mm_and_ps(_mm_cmpgt_ps(iw, zero), _mm_cmpgt_ps(ih, zero));
+			__m128 iou = _mm_and_ps(valid, _mm_div_ps(inter, ua));
+			_mm_storeu_ps(ious + k, _mm_sub_ps(one, iou));
 		}
-		for (int i = 0; i < n_rows; i++)
+#elif defined(IOU_NEON)
+		const float32x4_t ax1 = vdupq_n_f32(a[0]), ay1 = vdupq_n_f32(a[1]);
+		const float32x4_t ax2 = vdupq_n_f32(a[2]), ay2 = vdupq_n_f32(a[3]);
+		const float32x4_t area = vdupq_n_f32(aarea), one = vdupq_n_f32(1.0f), zero = vdupq_n_f32(0);
+		for (; k < stride; k += 4)
 		{
-			rowsol[i] = x_c[i];
+			float32x4_t iw = vaddq_f32(vsubq_f32(vminq_f32(ax2, vld1q_f32(bx2 + k)),
+				vmaxq_f32(ax1, vld1q_f32(bx1 + k))), one);
+			float32x4_t ih = vaddq_f32(vsubq_f32(vminq_f32(ay2, vld1q_f32(by2 + k)),
+				vmaxq_f32(ay1, vld1q_f32(by1 + k))), one);
+			float32x4_t inter = vmulq_f32(iw, ih);
+			float32x4_t ua = vsubq_f32(vaddq_f32(area, vld1q_f32(barea + k)), inter);
+			uint32x4_t valid = vandq_u32(vcgtq_f32(iw, zero), vcgtq_f32(ih, zero));
+			float32x4_t iou = vreinterpretq_f32_u32(vandq_u32(valid, vreinterpretq_u32_f32(vdivq_f32(inter, ua))));
+			vst1q_f32(ious + k, vsubq_f32(one, iou));
 		}
-		for (int i = 0; i < n_cols; i++)
+#endif
+		for (; k < n_cols; k++)
 		{
-			colsol[i] = y_c[i];
-		}
-
-		if (return_cost)
-		{
-			for (int i = 0; i < rowsol.size(); i++)
+			float iou = 0;
+			float iw = min(a[2], bx2[k]) - max(a[0], bx1[k]) + 1;
+			if (iw > 0)
 			{
-				if (rowsol[i] != -1)
+				float ih = min(a[3], by2[k]) - max(a[1], by1[k]) + 1;
+				if (ih > 0)
 				{
-					//cout << i << "\t" << rowsol[i] << "\t" << cost_ptr[i][rowsol[i]] << endl;
-					opt += cost_ptr[i][rowsol[i]];
+					float ua = aarea + barea[k] - iw * ih;
+					iou = iw * ih / ua;
 				}
 			}
+			ious[k] = 1 - iou;
 		}
-	}
-	else if (return_cost)
-	{
-		for (int i = 0; i < rowsol.size(); i++)
-		{
-			opt += cost_ptr[i][rowsol[i]];
-		}
-	}
 
-	for (int i = 0; i < n; i++)
-	{
-		delete[]cost_ptr[i];
+		std::copy(ious, ious + n_cols, cost_matrix.data() + n * n_cols);
 	}
-	delete[]cost_ptr;
-	delete[]x_c;
-	delete[]y_c;
-
-	return opt;
 }
 
 Scalar BYTETracker::get_color(int idx)
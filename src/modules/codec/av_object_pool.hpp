@@ -0,0 +1,176 @@
+#ifndef __AV_OBJECT_POOL_HPP__
+#define __AV_OBJECT_POOL_HPP__
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/frame.h>
+}
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace av_wrapper {
+
+template<typename T>
+struct AvObjectTraits;
+
+template<>
+struct AvObjectTraits<AVPacket> {
+    static AVPacket *alloc() { return av_packet_alloc(); }
+    static void unref(AVPacket *packet) { av_packet_unref(packet); }
+    static void free(AVPacket *packet) { av_packet_free(&packet); }
+};
+
+template<>
+struct AvObjectTraits<AVFrame> {
+    static AVFrame *alloc() { return av_frame_alloc(); }
+    static void unref(AVFrame *frame) { av_frame_unref(frame); }
+    static void free(AVFrame *frame) { av_frame_free(&frame); }
+};
+
+/**
+ * @brief AVPacket / AVFrame 对象池，每路流一个
+ *
+ *        acquire() 返回空的 shared_ptr 句柄，最后一个引用释放时 unref 数据，对象回到空闲链表；
+ *        shared_ptr 的控制块也从池中分配，稳定运行时取出和归还都不再调用 malloc。
+ *        句柄可以比对象池活得久(例如被预录缓存持有)，空闲对象超过 max_idle 时直接释放。
+ *        thread-safe, 取出和归还可以在不同线程
+ */
+template<typename T, typename Traits = AvObjectTraits<T>>
+class AvObjectPool {
+public:
+    struct Stats {
+        uint64_t allocations;// 新分配的对象和控制块
+        uint64_t reuses;     // 从空闲链表取出的次数
+    };
+
+    explicit AvObjectPool(size_t max_idle = 64) : state_(std::make_shared<State>(max_idle)) {}
+
+    AvObjectPool(const AvObjectPool &) = delete;
+    AvObjectPool &operator=(const AvObjectPool &) = delete;
+
+    std::shared_ptr<T> acquire() {
+        auto object = state_->take_object();
+        if (!object) { return nullptr; }
+        return std::shared_ptr<T>(object, Recycler{state_.get()}, BlockAllocator<T>(state_));
+    }
+
+    Stats stats() const { return {state_->allocations.load(), state_->reuses.load()}; }
+
+private:
+    struct State {
+        explicit State(size_t max_idle) : max_idle(max_idle) {
+            objects.reserve(max_idle);
+            blocks.reserve(max_idle);
+        }
+
+        ~State() {
+            for (auto object : objects) { Traits::free(object); }
+            for (auto block : blocks) { ::operator delete(block); }
+        }
+
+        T *take_object() {
+            {
+                std::lock_guard<std::mutex> glk(mutex);
+                if (!objects.empty()) {
+                    auto object = objects.back();
+                    objects.pop_back();
+                    reuses.fetch_add(1, std::memory_order_relaxed);
+                    return object;
+                }
+            }
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            return Traits::alloc();
+        }
+
+        void give_object(T *object) {
+            Traits::unref(object);
+            {
+                std::lock_guard<std::mutex> glk(mutex);
+                if (objects.size() < max_idle) {
+                    objects.push_back(object);
+                    return;
+                }
+            }
+            Traits::free(object);
+        }
+
+        // 控制块大小由 shared_ptr 的实现决定，同一个池内总是相同，大小不同的请求不入池
+        void *take_block(size_t size) {
+            {
+                std::lock_guard<std::mutex> glk(mutex);
+                if (size == block_size && !blocks.empty()) {
+                    auto block = blocks.back();
+                    blocks.pop_back();
+                    return block;
+                }
+                if (block_size == 0) { block_size = size; }
+            }
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+
+        void give_block(void *block, size_t size) {
+            {
+                std::lock_guard<std::mutex> glk(mutex);
+                if (size == block_size && blocks.size() < max_idle) {
+                    blocks.push_back(block);
+                    return;
+                }
+            }
+            ::operator delete(block);
+        }
+
+        const size_t max_idle;
+        std::mutex mutex;
+        std::vector<T *> objects;
+        std::vector<void *> blocks;
+        size_t block_size{0};
+
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> reuses{0};
+    };
+
+    // 控制块析构时先销毁删除器再释放内存，由分配器持有 State，删除器只需要裸指针
+    struct Recycler {
+        State *state;
+        void operator()(T *object) const { state->give_object(object); }
+    };
+
+    template<typename U>
+    struct BlockAllocator {
+        using value_type = U;
+
+        explicit BlockAllocator(std::shared_ptr<State> state) : state(std::move(state)) {}
+        template<typename V>
+        BlockAllocator(const BlockAllocator<V> &other) : state(other.state) {}
+
+        U *allocate(size_t n) { return static_cast<U *>(state->take_block(n * sizeof(U))); }
+        void deallocate(U *ptr, size_t n) { state->give_block(ptr, n * sizeof(U)); }
+
+        template<typename V>
+        bool operator==(const BlockAllocator<V> &other) const {
+            return state == other.state;
+        }
+        template<typename V>
+        bool operator!=(const BlockAllocator<V> &other) const {
+            return state != other.state;
+        }
+
+        std::shared_ptr<State> state;
+    };
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+using PacketPool = AvObjectPool<AVPacket>;
+using FramePool = AvObjectPool<AVFrame>;
+
+}// namespace av_wrapper
+
+#endif//__AV_OBJECT_POOL_HPP__
@@ -9,6 +9,7 @@ extern "C" {
 #endif
 }
 
+#include "av_object_pool.hpp"
 #include <memory>
 #include <string.h>
 
@@ -49,14 +50,11 @@ public:
                 throw std::runtime_error("Error during decoding filter");
             }
 
-            // 2. read packet from filter
-            auto receive_packet =
-                std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *ptr) { av_packet_free(&ptr); });
-            while (av_bsf_receive_packet(avbsf_ctx_, receive_packet.get()) == 0) {
-                // packet ready
+            // 2. read packet from filter, 释放时自动 unref 并回到 packet_pool_
+            while (true) {
+                auto receive_packet = packet_pool_.acquire();
+                if (av_bsf_receive_packet(avbsf_ctx_, receive_packet.get()) != 0) { break; }
                 if (packet_cb_) { packet_cb_(receive_packet); }
-                // unref the
-                av_packet_unref(receive_packet.get());
             }
         } else {
             if (packet_cb_) { packet_cb_(packet); }
@@ -78,6 +76,7 @@ protected:
 protected:
     const AVBitStreamFilter *av_bit_stream_filter_{nullptr};
     AVBSFContext *avbsf_ctx_{nullptr};
+    PacketPool packet_pool_{8};
 
     AvPacketCallback packet_cb_;
 };
@@ -1,7 +1,11 @@
 #include "decode_video_v3.h"
+#include "av_object_pool.hpp"
 #include "basic_logs.hpp"
 #include "bitstream_filter_v3.hpp"
+#include <algorithm>
 #include <atomic>
+#include <deque>
+#include <thread>
 
 namespace av_wrapper {
 
@@ -27,6 +31,70 @@ static AVPixelFormat find_decoder_hw_config(AVCodec *decoder, AVHWDeviceType typ
     }
 }
 
+static AVDiscard discard_of(const FrameSkip skip) {
+    switch (skip) {
+        case FrameSkip::kNonRef: return AVDISCARD_NONREF;
+        case FrameSkip::kNonKey: return AVDISCARD_NONKEY;
+        default: return AVDISCARD_DEFAULT;
+    }
+}
+
+//############################## DecodeThreadBudget Begin ##############################
+
+DecodeThreadBudget::DecodeThreadBudget(int total_threads, int max_threads_per_stream)
+    : total_threads_(total_threads > 0 ? total_threads : std::max(1u, std::thread::hardware_concurrency())),
+      max_threads_per_stream_(std::max(1, max_threads_per_stream)) {}
+
+DecodeThreadBudget &DecodeThreadBudget::get_instance() {
+    static DecodeThreadBudget instance;
+    return instance;
+}
+
+void DecodeThreadBudget::set_total_threads(int total_threads) {
+    std::lock_guard<std::mutex> glk(mutex_);
+    total_threads_ = total_threads > 0 ? total_threads : std::max(1u, std::thread::hardware_concurrency());
+    rebalance_();
+}
+
+int DecodeThreadBudget::total_threads() const {
+    std::lock_guard<std::mutex> glk(mutex_);
+    return total_threads_;
+}
+
+int DecodeThreadBudget::add_stream(int64_t pixels) {
+    std::lock_guard<std::mutex> glk(mutex_);
+    auto id = next_id_++;
+    streams_[id] = {std::max<int64_t>(pixels, 1), 1};
+    rebalance_();
+    return id;
+}
+
+void DecodeThreadBudget::remove_stream(int id) {
+    std::lock_guard<std::mutex> glk(mutex_);
+    streams_.erase(id);
+    rebalance_();
+}
+
+int DecodeThreadBudget::threads(int id) const {
+    std::lock_guard<std::mutex> glk(mutex_);
+    auto iter = streams_.find(id);
+    return iter != streams_.end() ? iter->second.second : 1;
+}
+
+void DecodeThreadBudget::rebalance_() {
+    int64_t total_pixels = 0;
+    for (const auto &[id, stream] : streams_) { total_pixels += stream.first; }
+
+    // 每路先分 1 个线程，剩余的按像素数比例分配
+    auto extra = std::max<int64_t>(0, total_threads_ - (int64_t)streams_.size());
+    for (auto &[id, stream] : streams_) {
+        auto threads = 1 + extra * stream.first / total_pixels;
+        stream.second = (int)std::min<int64_t>(threads, max_threads_per_stream_);
+    }
+}
+
+//############################### DecodeThreadBudget End ###############################
+
 class DecoderPrivate {
 public:
     DecoderPrivate(const Decoder_v3::OpenCallback &open_cb, const Decoder_v3::DecodeCallback &decode_cb)
@@ -36,11 +104,20 @@ public:
         open_cb_ = nullptr;
         decode_cb_ = nullptr;
         av_dict_free(&dicts_);
+        if (budget_id_ >= 0) { DecodeThreadBudget::get_instance().remove_stream(budget_id_); }
     }
 
-    bool open_decoder_impl(const std::shared_ptr<AVCodecParameters> &codecpar, const AVHWDeviceType type);
+    bool open_decoder_impl(const std::shared_ptr<AVCodecParameters> &codecpar, const AVHWDeviceType type,
+                           const DecodeMode mode);
+
+    bool filter_packet(const std::shared_ptr<AVPacket> &packet, const FrameSkip skip);
 
-    bool filter_packet(const std::shared_ptr<AVPacket> &packet);
+private:
+    bool open_codec_context(const AVCodec *decoder, int thread_count);
+    void receive_frames();
+    void update_thread_count();
+    void apply_frame_skip(const FrameSkip skip);
+    int64_t next_frame_idx(const AVFrame *avframe);
 
 private:
     Decoder_v3::OpenCallback open_cb_;
@@ -48,8 +125,19 @@ private:
 
     int64_t frame_idx = 1;
 
+    FrameSkip frame_skip{FrameSkip::kNone};
+    bool wait_key_frame{false};                        // 离开 kNonKey 后等待关键帧
+    int64_t packet_idx = 0;                            // 码流中的帧序号
+    std::deque<std::pair<int64_t, int64_t>> packet_pts;// pts - 码流帧序号，跳帧时还原帧序号
+
     AVPixelFormat hw_pixfmt{AV_PIX_FMT_NONE};
+    AVHWDeviceType hw_type_{AV_HWDEVICE_TYPE_NONE};
+    const AVCodec *decoder_{nullptr};
+    std::shared_ptr<AVCodecParameters> codecpar_;
+    int budget_id_{-1};  // 软件解码时在 DecodeThreadBudget 中的 ID
+    int thread_count_{0};// 软件解码线程数，硬件解码为 0
     std::unique_ptr<BitStreamFilter_v3> bs_filter{nullptr};
+    FramePool frame_pool_;// 解码输出帧，下游释放后 unref 复用，帧数据仍由解码器的缓冲池管理
 
     AVDictionary *dicts_ = nullptr;
     std::unique_ptr<AVCodecContext, void (*)(AVCodecContext *)> codec_ctx{nullptr, nullptr};
@@ -67,17 +155,43 @@ private:
     }
 };
 
-bool DecoderPrivate::open_decoder_impl(const std::shared_ptr<AVCodecParameters> &codecpar, const AVHWDeviceType type) {
+bool DecoderPrivate::open_decoder_impl(const std::shared_ptr<AVCodecParameters> &codecpar, const AVHWDeviceType type,
+                                       const DecodeMode mode) {
     codec_ctx.reset();
     av_dict_free(&dicts_);
+    codecpar_ = codecpar;
+    hw_type_ = type;
 
     const AVCodec *decoder = nullptr;
-    switch (codecpar->codec_id) {
-        case AV_CODEC_ID_H264: decoder = avcodec_find_decoder_by_name("h264_tsmpp"); break;
-        case AV_CODEC_ID_HEVC: decoder = avcodec_find_decoder_by_name("hevc_tsmpp"); break;
-        case AV_CODEC_ID_VP8: decoder = avcodec_find_decoder_by_name("vp8_tsmpp"); break;
-        case AV_CODEC_ID_VP9: decoder = avcodec_find_decoder_by_name("vp9_tsmpp"); break;
-        default: decoder = avcodec_find_decoder(codecpar->codec_id); break;
+    if (mode != DecodeMode::kSoftware) {
+        switch (codecpar->codec_id) {
+            case AV_CODEC_ID_H264: decoder = avcodec_find_decoder_by_name("h264_tsmpp"); break;
+            case AV_CODEC_ID_HEVC: decoder = avcodec_find_decoder_by_name("hevc_tsmpp"); break;
+            case AV_CODEC_ID_VP8: decoder = avcodec_find_decoder_by_name("vp8_tsmpp"); break;
+            case AV_CODEC_ID_VP9: decoder = avcodec_find_decoder_by_name("vp9_tsmpp"); break;
+            default:
+                // 指定了硬件设备时仍按原方式打开，由 hw_device_ctx 加速
+                if (mode == DecodeMode::kHardware || type != AV_HWDEVICE_TYPE_NONE) {
+                    decoder = avcodec_find_decoder(codecpar->codec_id);
+                }
+                break;
+        }
+    }
+
+    if (decoder && !open_codec_context(decoder, 0)) {
+        if (mode == DecodeMode::kHardware) { return false; }
+        spdlog::warn("Failed to open decoder {}, fallback to software decoder", decoder->name);
+        decoder = nullptr;
+    }
+
+    // 软件解码，线程数由 DecodeThreadBudget 按当前所有软件解码流的分辨率分配
+    if (decoder == nullptr && mode != DecodeMode::kHardware) {
+        decoder = avcodec_find_decoder(codecpar->codec_id);
+        if (decoder) {
+            auto &budget = DecodeThreadBudget::get_instance();
+            budget_id_ = budget.add_stream((int64_t)codecpar->width * codecpar->height);
+            if (!open_codec_context(decoder, budget.threads(budget_id_))) { return false; }
+        }
     }
 
     if (decoder == nullptr) {
@@ -89,76 +203,150 @@ bool DecoderPrivate::open_decoder_impl(const std::shared_ptr<AVCodecParameters>
         if (avcodec_send_packet(codec_ctx.get(), packet.get()) < 0) {
             throw std::runtime_error("Error during decoding");
         }
-
-        while (true) {
-            auto avframe = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) {
-                av_frame_free(&ptr);
-                delete ptr;
-            });
-
-            int ret = avcodec_receive_frame(codec_ctx.get(), avframe.get());
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-                break;
-            } else if (ret < 0) {
-                throw std::runtime_error("Error during receive frame, error code: " + std::to_string(ret));
-            }
-            if (decode_cb_) { decode_cb_(frame_idx++, avframe); }
-        }
+        receive_frames();
     });
 
     bs_filter->init_filter_by_codec_name(decoder->name, codecpar);
 
-    codec_ctx = std::unique_ptr<AVCodecContext, void (*)(AVCodecContext *)>(avcodec_alloc_context3(decoder),
-                                                                            [](AVCodecContext *ptr) {
-                                                                                avcodec_free_context(&ptr);
-                                                                                delete ptr;
-                                                                            });
-    if (codec_ctx.get() == nullptr) {
+    if (open_cb_) {
+        auto codec_parameters = std::shared_ptr<AVCodecParameters>(
+            avcodec_parameters_alloc(), [](AVCodecParameters *ptr) { avcodec_parameters_free(&ptr); });
+        avcodec_parameters_from_context(codec_parameters.get(), codec_ctx.get());
+        open_cb_(codec_parameters);
+    }
+
+    dump_codec_info(decoder);
+    if (thread_count_ > 0) { spdlog::info("Software decoder threads: {}", thread_count_); }
+
+    return true;
+}
+
+bool DecoderPrivate::open_codec_context(const AVCodec *decoder, int thread_count) {
+    auto ctx = std::unique_ptr<AVCodecContext, void (*)(AVCodecContext *)>(avcodec_alloc_context3(decoder),
+                                                                           [](AVCodecContext *ptr) {
+                                                                               avcodec_free_context(&ptr);
+                                                                               delete ptr;
+                                                                           });
+    if (ctx.get() == nullptr) {
         spdlog::error("Failed to alloc context of avcodec");
         return false;
     }
 
-    if (avcodec_parameters_to_context(codec_ctx.get(), codecpar.get()) < 0) {
+    if (avcodec_parameters_to_context(ctx.get(), codecpar_.get()) < 0) {
         spdlog::error("Failed in init_decoder_context");
         return false;
     }
 
-    hw_pixfmt = find_decoder_hw_config(const_cast<AVCodec *>(decoder), type);
-    if (hw_pixfmt != AV_PIX_FMT_NONE) {
-        if (av_hwdevice_ctx_create(&codec_ctx->hw_device_ctx, type, 0, NULL, 0) < 0) {
-            spdlog::error("Failed to create specified HW device: {}", type);
-            return false;
-        }
-        codec_ctx->opaque = this;
-        codec_ctx->get_format = DecoderPrivate::get_hw_format;
-    }
-
     AVDictionary *opts = nullptr;
+    if (thread_count > 0) {
+        // 帧级多线程吞吐最高，但输出延迟 thread_count - 1 帧；码流不支持时由 FFmpeg 退回片级多线程
+        ctx->thread_count = thread_count;
+        ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    } else {
+        hw_pixfmt = hw_type_ != AV_HWDEVICE_TYPE_NONE ? find_decoder_hw_config(const_cast<AVCodec *>(decoder), hw_type_)
+                                                      : AV_PIX_FMT_NONE;
+        if (hw_pixfmt != AV_PIX_FMT_NONE) {
+            if (av_hwdevice_ctx_create(&ctx->hw_device_ctx, hw_type_, 0, NULL, 0) < 0) {
+                spdlog::error("Failed to create specified HW device: {}", hw_type_);
+                return false;
+            }
+            ctx->opaque = this;
+            ctx->get_format = DecoderPrivate::get_hw_format;
+        }
 
-    av_dict_set_int(&opts, "height", codecpar->height, 0);
-    av_dict_set_int(&opts, "width", codecpar->width, 0);
-    av_dict_set_int(&opts, "framebuf_cnt", 25, 0);
-    av_dict_set_int(&opts, "refframebuf_num", 25, 0);
+        av_dict_set_int(&opts, "height", codecpar_->height, 0);
+        av_dict_set_int(&opts, "width", codecpar_->width, 0);
+        av_dict_set_int(&opts, "framebuf_cnt", 25, 0);
+        av_dict_set_int(&opts, "refframebuf_num", 25, 0);
+    }
+    ctx->skip_frame = discard_of(frame_skip);
 
-    if (avcodec_open2(codec_ctx.get(), decoder, &opts) < 0) {
+    auto ret = avcodec_open2(ctx.get(), decoder, &opts);
+    av_dict_free(&opts);
+    if (ret < 0) {
         spdlog::error("Failed to open codec for stream");
         return false;
     }
 
-    if (open_cb_) {
-        auto codec_parameters = std::shared_ptr<AVCodecParameters>(
-            avcodec_parameters_alloc(), [](AVCodecParameters *ptr) { avcodec_parameters_free(&ptr); });
-        avcodec_parameters_from_context(codec_parameters.get(), codec_ctx.get());
-        open_cb_(codec_parameters);
+    codec_ctx = std::move(ctx);
+    decoder_ = decoder;
+    thread_count_ = thread_count;
+    return true;
+}
+
+void DecoderPrivate::receive_frames() {
+    while (true) {
+        auto avframe = frame_pool_.acquire();
+        int ret = avcodec_receive_frame(codec_ctx.get(), avframe.get());
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+            break;
+        } else if (ret < 0) {
+            throw std::runtime_error("Error during receive frame, error code: " + std::to_string(ret));
+        }
+        if (decode_cb_) { decode_cb_(next_frame_idx(avframe.get()), avframe); }
     }
+}
 
-    dump_codec_info(decoder);
+void DecoderPrivate::update_thread_count() {
+    auto target = DecodeThreadBudget::get_instance().threads(budget_id_);
+    // 变化不到一倍时不重建，避免流频繁加入退出时反复打开解码器
+    if (target < thread_count_ * 2 && thread_count_ < target * 2) { return; }
+
+    // 在关键帧处取出旧解码器中缓存的帧，再按新线程数重新打开，新解码器从该关键帧开始解码
+    avcodec_send_packet(codec_ctx.get(), nullptr);
+    receive_frames();
+
+    auto previous = thread_count_;
+    if (!open_codec_context(decoder_, target)) {
+        // 打开失败时保留原解码器，清除 EOF 状态后继续使用
+        spdlog::error("Failed to reopen decoder {} with {} threads", decoder_->name, target);
+        avcodec_flush_buffers(codec_ctx.get());
+        return;
+    }
+    spdlog::info("Decoder {} threads: {} -> {}", decoder_->name, previous, target);
+}
 
-    return true;
+void DecoderPrivate::apply_frame_skip(const FrameSkip skip) {
+    if (skip == frame_skip || !codec_ctx) { return; }
+
+    codec_ctx->skip_frame = discard_of(skip);
+    if (frame_skip == FrameSkip::kNonKey) { wait_key_frame = true; }
+    if (skip == FrameSkip::kNone) { packet_pts.clear(); }
+
+    spdlog::debug("Decoder frame skip: {} -> {}", (int)frame_skip, (int)skip);
+    frame_skip = skip;
+}
+
+int64_t DecoderPrivate::next_frame_idx(const AVFrame *avframe) {
+    if (frame_skip != FrameSkip::kNone && avframe->pts != AV_NOPTS_VALUE) {
+        auto pts = avframe->pts;
+        auto iter = std::find_if(packet_pts.begin(), packet_pts.end(),
+                                 [pts](const std::pair<int64_t, int64_t> &item) { return item.first == pts; });
+        if (iter != packet_pts.end()) {
+            frame_idx = std::max(frame_idx, iter->second);
+            packet_pts.erase(iter);
+        }
+    }
+    return frame_idx++;
 }
 
-bool DecoderPrivate::filter_packet(const std::shared_ptr<AVPacket> &packet) {
+bool DecoderPrivate::filter_packet(const std::shared_ptr<AVPacket> &packet, const FrameSkip skip) {
+    packet_idx++;
+    apply_frame_skip(skip);
+
+    bool key_frame = packet->flags & AV_PKT_FLAG_KEY;
+    if (key_frame) { wait_key_frame = false; }
+    if (!key_frame && (frame_skip == FrameSkip::kNonKey || wait_key_frame)) {
+        return true;// 丢弃，不送入解码器
+    }
+
+    if (frame_skip != FrameSkip::kNone && packet->pts != AV_NOPTS_VALUE) {
+        packet_pts.emplace_back(packet->pts, packet_idx);
+        if (packet_pts.size() > 64) { packet_pts.pop_front(); }
+    }
+
     try {
+        if (key_frame && budget_id_ >= 0) { update_thread_count(); }
         bs_filter->send_packet(packet);
     } catch (const std::exception &e) {
         spdlog::error("{}, stream_index: {}, pts: {}", e.what(), packet->stream_index, packet->pts);
@@ -172,11 +360,11 @@ Decoder_v3::~Decoder_v3() {}
 
 bool Decoder_v3::open_decoder(const std::shared_ptr<AVCodecParameters> &codecpar, const AVHWDeviceType type) {
     impl_ = std::make_unique<DecoderPrivate>(open_cb_, decode_cb_);
-    return impl_->open_decoder_impl(codecpar, type);
+    return impl_->open_decoder_impl(codecpar, type, decode_mode_);
 }
 
 bool Decoder_v3::decode_packet(const std::shared_ptr<AVPacket> &packet) {
-    if (impl_) { return impl_->filter_packet(packet); }
+    if (impl_) { return impl_->filter_packet(packet, frame_skip_.load(std::memory_order_relaxed)); }
     return false;
 }
 
@@ -184,4 +372,8 @@ void Decoder_v3::register_open_callback(const OpenCallback &open_cb) { open_cb_
 
 void Decoder_v3::register_deocde_callback(const DecodeCallback &decode_cb) { decode_cb_ = decode_cb; }
 
+void Decoder_v3::set_frame_skip(const FrameSkip skip) { frame_skip_.store(skip, std::memory_order_relaxed); }
+
+void Decoder_v3::set_decode_mode(const DecodeMode mode) { decode_mode_ = mode; }
+
 }// namespace av_wrapper
\ No newline at end of file
@@ -4,13 +4,77 @@
 extern "C" {
 #include <libavcodec/avcodec.h>
 }
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <functional>
 
 namespace av_wrapper {
 
 class DecoderPrivate;
 
+/**
+ * @brief 解码端跳帧方式
+ */
+enum class FrameSkip {
+    kNone,  // 解码全部帧
+    kNonRef,// 跳过非参考帧 (AVDISCARD_NONREF)，解码器不支持时不生效
+    kNonKey,// 只解码关键帧，非关键帧在送入解码器之前丢弃
+};
+
+/**
+ * @brief 解码方式
+ */
+enum class DecodeMode {
+    kAuto,    // 优先使用硬件解码器，找不到或打开失败时使用软件解码
+    kHardware,// 只使用硬件解码器
+    kSoftware,// FFmpeg 软件解码，帧级和片级多线程，线程数由 DecodeThreadBudget 分配
+};
+
+/**
+ * @brief 进程内软件解码的线程预算，在所有软件解码的流之间按分辨率分配
+ *
+ *        每路流至少 1 个线程，预算多于流数时，多出的线程按像素数比例分给各路流，每路不超过
+ *        max_threads_per_stream。高分辨率流较少时每路分到多个线程，低分辨率流很多时每路 1 个线程。
+ *        流加入或退出后重新分配，解码器在下一个关键帧按新的线程数重新打开。thread-safe
+ */
+class DecodeThreadBudget {
+public:
+    /**
+     * @param total_threads 0 表示 CPU 核心数
+     */
+    explicit DecodeThreadBudget(int total_threads = 0, int max_threads_per_stream = 16);
+
+    static DecodeThreadBudget &get_instance();
+
+    void set_total_threads(int total_threads);
+    int total_threads() const;
+
+    /**
+     * @brief 加入一路流，返回 ID
+     *
+     * @param pixels 每帧像素数，作为分配权重
+     */
+    int add_stream(int64_t pixels);
+    void remove_stream(int id);
+
+    /**
+     * @brief 当前分配给该流的线程数
+     */
+    int threads(int id) const;
+
+private:
+    void rebalance_();
+
+private:
+    mutable std::mutex mutex_;
+    int total_threads_;
+    int max_threads_per_stream_;
+    std::map<int, std::pair<int64_t, int>> streams_;// ID - 像素数, 线程数
+    int next_id_{0};
+};
+
 class Decoder_v3 {
 public:
     using OpenCallback = std::function<void(const std::shared_ptr<AVCodecParameters> &)>;
@@ -53,8 +117,27 @@ public:
      */
     void register_deocde_callback(const DecodeCallback &decode_cb);
 
+    /**
+     * @brief 设置跳帧方式，thread-safe, 从下一个压缩帧开始生效
+     *
+     *        跳帧时回调的帧序号仍为该帧在码流中的序号，被跳过的帧序号不会出现；
+     *        从 kNonKey 切换到其它方式时，会一直丢弃到下一个关键帧，避免参考帧缺失导致花屏。
+     * 
+     * @param skip 
+     */
+    void set_frame_skip(const FrameSkip skip);
+
+    /**
+     * @brief 设置解码方式，在 open_decoder 之前调用，默认 kAuto
+     * 
+     * @param mode 
+     */
+    void set_decode_mode(const DecodeMode mode);
+
 private:
     std::unique_ptr<DecoderPrivate> impl_;
+    std::atomic<FrameSkip> frame_skip_{FrameSkip::kNone};
+    DecodeMode decode_mode_{DecodeMode::kAuto};
 
     OpenCallback open_cb_;
     DecodeCallback decode_cb_;
@@ -1,7 +1,10 @@
 #include "demux_stream_v3.h"
+#include "av_object_pool.hpp"
 #include "basic_logs.hpp"
+#include "ingest_loop.h"
 #include "thread.hpp"
 #include <algorithm>
+#include <cmath>
 #include <mutex>
 
 extern "C" {
@@ -26,24 +29,46 @@ static inline bool is_video_file(const std::string &stream_url) {
     return false;
 }
 
-class DemuxerPrivate {
+class DemuxerPrivate : public IngestTask {
 public:
     DemuxerPrivate(const Demuxer_v3::OpenCallback &open, const Demuxer_v3::PacketCallback &read,
                    const Demuxer_v3::CloseCallback &exit)
         : opaque({true}), open_cb(open), packet_cb(read), exit_cb(exit) {}
     ~DemuxerPrivate() {
         opaque.demux_on = false;
+        // 中断正在进行的读取，等待当前这一步返回
+        if (ingest_loop_) { ingest_loop_->remove(ingest_id_); }
         if (thread_handle.joinable()) { thread_handle.join(); }
+        finish_stream(true);
         av_dict_free(&dicts);
     }
 
     void open_stream(const std::string stream_url, const DemuxerOptions &options);
 
+    bool step(IngestClock::time_point &next) override;
+
+    DemuxerStats get_stats() {
+        std::lock_guard<std::mutex> glk(stats_mutex_);
+        return stats_;
+    }
+
     friend class Demuxer_v3;
 
 protected:
+    enum class ReadResult {
+        kContinue,// 继续读取下一个包
+        kWait,    // 文件限速或暂无数据，到 next 再读
+        kEnd,     // 读取结束或出错
+    };
+
     void open_stream_impl();
-    void read_stream_packet(const Demuxer_v3::PacketCallback &packet_cb);
+    bool step_open(IngestClock::time_point &next);
+    bool step_read(IngestClock::time_point &next);
+    bool step_reconnect(IngestClock::time_point &next, const std::string &reason);
+    bool finish_stream(bool normal_exit);
+    ReadResult read_stream_packet(IngestClock::time_point &next);
+    void seek_segment();
+    bool accept_segment_packet(const AVPacket *packet);
     void dump_demuxer_stat();
 
     const AVInputFormat *get_input_format() {
@@ -56,6 +81,11 @@ protected:
         return 0;
     }
 
+    AVRational get_video_time_base() {
+        if (fmt_ctx_ && video_stream_index >= 0) return fmt_ctx_->streams[video_stream_index]->time_base;
+        return AVRational{1, AV_TIME_BASE};
+    }
+
 private:
     std::shared_ptr<AVFormatContext> fmt_ctx_{nullptr};
     std::thread thread_handle;
@@ -75,36 +105,117 @@ private:
     int64_t pkt_count{0};              // 读取包计数
     int64_t pkt_video_count{0};        // 视频帧统计
     int64_t pkt_video_i_frame_count{0};// 视频I-Frame帧统计
+
+    int64_t segment_start_pts{AV_NOPTS_VALUE};// 分段读取，从不早于该时间的第一个关键帧开始
+    int64_t segment_end_pts{AV_NOPTS_VALUE};  // 分段读取，遇到不早于该时间的关键帧结束，即下一段的起点
+    bool segment_started{false};
+    bool segment_finished{false};
+
+    PacketPool packet_pool_;// 读取的包，下游释放后复用
+
+    bool opened_{false};
+    int64_t last_pts{AV_NOPTS_VALUE};
+    ReconnectBackoff backoff_;
+    std::shared_ptr<IngestLoop> ingest_loop_;// 实时流共享读取线程，视频文件和离线模式使用独立线程
+    int ingest_id_{-1};
+    bool nonblocking_{false};// 读取返回过 EAGAIN，格式支持 AVFMT_FLAG_NONBLOCK
+
+    std::mutex stats_mutex_;
+    DemuxerStats stats_;
 };
 
 void DemuxerPrivate::open_stream(const std::string stream_url, const DemuxerOptions &options) {
     stream_url_ = stream_url;
     options_ = options;
+    backoff_ = ReconnectBackoff(options.reconnect_backoff);
+
+    // 离线模式的包回调会等待下游，文件限速时大部分时间在等待，这两种情况各用一个线程
+    if (options_.offline || is_video_file(stream_url_)) {
+        thread_handle = std::thread([this]() {
+            auto next = IngestClock::now();
+            while (step(next)) {
+                std::this_thread::sleep_until(next);
+                next = IngestClock::now();
+            }
+        });
+    } else {
+        // RTSP 等格式忽略 AVFMT_FLAG_NONBLOCK，读取返回 EAGAIN 之前按阻塞任务计算线程上限
+        ingest_loop_ = IngestLoop::shared_instance();
+        ingest_id_ = ingest_loop_->add(this, true);
+    }
+}
 
-    thread_handle = std::thread([this]() {
-        while (opaque.demux_on) {
-            try {
-                open_stream_impl();
-                if (open_cb) {
-                    auto codecpar = std::shared_ptr<AVCodecParameters>(
-                        avcodec_parameters_alloc(), [](AVCodecParameters *ptr) { avcodec_parameters_free(&ptr); });
-                    avcodec_parameters_copy(codecpar.get(), fmt_ctx_->streams[video_stream_index]->codecpar);
-                    open_cb(codecpar);
-                }
-                read_stream_packet(packet_cb);
+bool DemuxerPrivate::step(IngestClock::time_point &next) {
+    if (!opaque.demux_on) { return finish_stream(true); }
+    return opened_ ? step_read(next) : step_open(next);
+}
+
+bool DemuxerPrivate::step_open(IngestClock::time_point &next) {
+    try {
+        open_stream_impl();
+        if (open_cb) {
+            auto codecpar = std::shared_ptr<AVCodecParameters>(
+                avcodec_parameters_alloc(), [](AVCodecParameters *ptr) { avcodec_parameters_free(&ptr); });
+            avcodec_parameters_copy(codecpar.get(), fmt_ctx_->streams[video_stream_index]->codecpar);
+            open_cb(codecpar);
+        }
+    } catch (const std::exception &e) {
+        spdlog::error(e.what());
+        if (!opaque.demux_on) { return finish_stream(false); }
+        return step_reconnect(next, e.what());
+    }
+
+    opened_ = true;
+    last_pts = AV_NOPTS_VALUE;
+    backoff_.on_connected(next);
+
+    std::lock_guard<std::mutex> glk(stats_mutex_);
+    stats_.connected = true;
+    ++stats_.connects;
+    stats_.reconnect_delay_ms = 0;
+    return true;
+}
+
+bool DemuxerPrivate::step_read(IngestClock::time_point &next) {
+    // 每步最多读取一批包，同一线程上的其它输入源轮流读取；
+    // 阻塞的格式每步只读一个包，否则一步要等到整批包都到达，期间占住线程
+    const int max_packets = ingest_loop_ && !nonblocking_ ? 1 : 16;
+    for (int i = 0; i < max_packets && opaque.demux_on; i++) {
+        switch (read_stream_packet(next)) {
+            case ReadResult::kContinue: break;
+            case ReadResult::kWait: return true;
+            case ReadResult::kEnd:
                 spdlog::info("Stream exit: {}, packeds: {}", stream_url_, pkt_count);
-            } catch (const std::exception &e) {
-                spdlog::error(e.what());
-                std::this_thread::sleep_for(std::chrono::seconds(3));
-                if (!opaque.demux_on && exit_cb) {
-                    exit_cb(false);
-                    exit_cb = nullptr;
-                }
-            }
-            if (is_video_file(stream_url_)) break;
+                return step_reconnect(next, "stream exit");
         }
-        if (exit_cb) { exit_cb(true); }
-    });
+    }
+    return true;
+}
+
+bool DemuxerPrivate::step_reconnect(IngestClock::time_point &next, const std::string &reason) {
+    opened_ = false;
+    fmt_ctx_.reset();
+    if (is_video_file(stream_url_) || options_.offline) { return finish_stream(true); }
+
+    // 指数退避加随机抖动，网络恢复后各路流错开重连
+    auto delay = backoff_.next_delay(next);
+    next += delay;
+    spdlog::warn("Stream: {}, reconnect in {} ms, attempt: {}", stream_url_, delay.count(), backoff_.attempts());
+
+    std::lock_guard<std::mutex> glk(stats_mutex_);
+    stats_.connected = false;
+    ++stats_.failures;
+    stats_.reconnect_delay_ms = delay.count();
+    stats_.last_error = reason;
+    return true;
+}
+
+bool DemuxerPrivate::finish_stream(bool normal_exit) {
+    if (exit_cb) {
+        exit_cb(normal_exit);
+        exit_cb = nullptr;
+    }
+    return false;
 }
 
 void DemuxerPrivate::open_stream_impl() {
@@ -166,46 +277,118 @@ void DemuxerPrivate::open_stream_impl() {
 
     // dump stream info
     av_dump_format(fmt_ctx_.get(), video_stream_index, stream_url_.c_str(), 0);
+
+    if (options_.segment_count > 1) { seek_segment(); }
+
+    // 共享读取线程上支持非阻塞的格式暂无数据时返回 EAGAIN，不阻塞其它流
+    if (ingest_loop_) { fmt_ctx_->flags |= AVFMT_FLAG_NONBLOCK; }
+}
+
+void DemuxerPrivate::seek_segment() {
+    if (options_.segment_index < 0 || options_.segment_index >= options_.segment_count) {
+        throw std::runtime_error("Invalid segment index " + std::to_string(options_.segment_index) + ": "
+                                 + stream_url_);
+    }
+    if (fmt_ctx_->duration <= 0) { throw std::runtime_error("Couldn't split stream without duration: " + stream_url_); }
+
+    // 按时长均分，相邻两段使用同一个边界，起止都对齐到边界之后的第一个关键帧，不重叠也不遗漏
+    auto stream = fmt_ctx_->streams[video_stream_index];
+    auto start_time = fmt_ctx_->start_time != AV_NOPTS_VALUE ? fmt_ctx_->start_time : 0;
+    auto boundary = [&](int index) {
+        return av_rescale_q(start_time + fmt_ctx_->duration * index / options_.segment_count,
+                            AVRational{1, AV_TIME_BASE}, stream->time_base);
+    };
+    if (options_.segment_index > 0) { segment_start_pts = boundary(options_.segment_index); }
+    if (options_.segment_index < options_.segment_count - 1) { segment_end_pts = boundary(options_.segment_index + 1); }
+    segment_started = false;
+    segment_finished = false;
+
+    if (segment_start_pts != AV_NOPTS_VALUE
+        && av_seek_frame(fmt_ctx_.get(), video_stream_index, segment_start_pts, AVSEEK_FLAG_BACKWARD) < 0) {
+        throw std::runtime_error("Couldn't seek to segment " + std::to_string(options_.segment_index) + ": "
+                                 + stream_url_);
+    }
+    spdlog::info("Stream: {}, segment {}/{}, pts: [{}, {})", stream_url_, options_.segment_index,
+                 options_.segment_count, segment_start_pts, segment_end_pts);
+}
+
+bool DemuxerPrivate::accept_segment_packet(const AVPacket *packet) {
+    auto stream = fmt_ctx_->streams[video_stream_index];
+    auto pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+    bool key_frame = packet->flags & AV_PKT_FLAG_KEY;
+
+    if (!segment_started) {
+        if (!key_frame || (segment_start_pts != AV_NOPTS_VALUE && pts < segment_start_pts)) { return false; }
+        segment_started = true;
+
+        // 包序号按时间戳换算为整个文件中的帧序号，各段的输出可以按序号合并
+        auto stream_start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        auto position = (pts - stream_start) * av_q2d(stream->time_base);
+        pkt_video_count = std::max<int64_t>(0, std::llround(position * get_video_frame_rate()));
+        return true;
+    }
+
+    if (key_frame && segment_end_pts != AV_NOPTS_VALUE && pts >= segment_end_pts) { segment_finished = true; }
+    return !segment_finished;
 }
 
-void DemuxerPrivate::read_stream_packet(const Demuxer_v3::PacketCallback &packet_cb) {
-    int64_t last_pts = AV_NOPTS_VALUE;
+DemuxerPrivate::ReadResult DemuxerPrivate::read_stream_packet(IngestClock::time_point &next) {
+    // 从读取前开始计算超时，离线模式下包回调可能因下游积压阻塞较长时间
+    opaque.time_point = std::chrono::steady_clock::now();
+    auto packet = packet_pool_.acquire();
+    auto ret = av_read_frame(fmt_ctx_.get(), packet.get());
+    if (ret == AVERROR(EAGAIN)) {
+        // 非阻塞读取暂无数据
+        if (!nonblocking_ && ingest_loop_) {
+            nonblocking_ = true;
+            ingest_loop_->set_blocking(ingest_id_, false);
+        }
+        next += std::chrono::milliseconds(10);
+        return ReadResult::kWait;
+    } else if (ret < 0) {
+        // < 0 on error or end of file
+        return ReadResult::kEnd;
+    }
 
-    while (opaque.demux_on) {
-        auto packet = std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *ptr) { av_packet_free(&ptr); });
-        if (av_read_frame(fmt_ctx_.get(), packet.get()) == 0) {
-            opaque.time_point = std::chrono::steady_clock::now();
+    ++pkt_count;
+    {
+        std::lock_guard<std::mutex> glk(stats_mutex_);
+        ++stats_.packets;
+        stats_.bytes += packet->size;
+        stats_.last_packet_time = opaque.time_point;
+    }
 
-            ++pkt_count;
+    // is video stream
+    if (packet->stream_index != video_stream_index) { return ReadResult::kContinue; }
 
-            // is video stream
-            if (packet->stream_index == video_stream_index) {
-                if (packet->flags & AV_PKT_FLAG_KEY) { ++pkt_video_i_frame_count; }
+    if (options_.segment_count > 1 && !accept_segment_packet(packet.get())) {
+        return segment_finished ? ReadResult::kEnd : ReadResult::kContinue;
+    }
+    if (packet->flags & AV_PKT_FLAG_KEY) { ++pkt_video_i_frame_count; }
 
-                // Jump first I-Frame & follow P-frame
-                if (options_.jump_first_video_i_frame && pkt_video_i_frame_count < 1) { continue; }
+    // Jump first I-Frame & follow P-frame
+    if (options_.jump_first_video_i_frame && pkt_video_i_frame_count < 1) { return ReadResult::kContinue; }
 
-                if (packet_cb) {
-                    if (!packet_cb(++pkt_video_count, packet)) { break; }
-                }
+    if (packet_cb) {
+        if (!packet_cb(++pkt_video_count, packet)) { return ReadResult::kEnd; }
+    }
 
-                if (is_video_file(stream_url_)) {
-                    if (packet->pts < 0) {
-                        av_usleep(AV_TIME_BASE / av_q2d(fmt_ctx_->streams[video_stream_index]->r_frame_rate) - 1000);
-                    } else if (last_pts != AV_NOPTS_VALUE) {
-                        int64_t delay =
-                            av_rescale_q(packet->pts - last_pts, fmt_ctx_->streams[video_stream_index]->time_base,
-                                         {1, AV_TIME_BASE});
-                        av_usleep(delay);
-                    }
-                    last_pts = packet->pts;
-                }
-            }
-        } else {
-            // < 0 on error or end of file
-            break;
+    if (!options_.offline && is_video_file(stream_url_)) {
+        // 按时间戳限速，等待期间不占用线程
+        int64_t delay = 0;
+        if (packet->pts < 0) {
+            delay = AV_TIME_BASE / av_q2d(fmt_ctx_->streams[video_stream_index]->r_frame_rate) - 1000;
+        } else if (last_pts != AV_NOPTS_VALUE) {
+            delay = av_rescale_q(packet->pts - last_pts, fmt_ctx_->streams[video_stream_index]->time_base,
+                                 {1, AV_TIME_BASE});
+        }
+        last_pts = packet->pts;
+        if (delay > 0) {
+            next += std::chrono::microseconds(delay);
+            return ReadResult::kWait;
         }
     }
+    return ReadResult::kContinue;
 }
 
 void DemuxerPrivate::dump_demuxer_stat() {
@@ -238,10 +421,20 @@ void Demuxer_v3::register_video_callback(const PacketCallback &packet_cb) { vide
 void Demuxer_v3::register_audio_callback(const PacketCallback &packet_cb) {}
 void Demuxer_v3::register_close_callback(const CloseCallback &close_cb) { close_cb_ = close_cb; }
 
+DemuxerStats Demuxer_v3::get_stats() {
+    if (impl_) return impl_->get_stats();
+    return DemuxerStats{};
+}
+
 double Demuxer_v3::get_video_frame_rate() {
     if (impl_) return impl_->get_video_frame_rate();
     return 0;
 }
+
+AVRational Demuxer_v3::get_video_time_base() {
+    if (impl_) return impl_->get_video_time_base();
+    return AVRational{1, AV_TIME_BASE};
+}
 //################################### Demuxer_v3 End ###################################
 
 }// namespace av_wrapper
\ No newline at end of file
@@ -4,6 +4,7 @@
 extern "C" {
 #include <libavformat/avformat.h>
 }
+#include "ingest_loop.h"
 #include <boost/noncopyable.hpp>
 #include <chrono>
 #include <functional>
@@ -19,6 +20,27 @@ struct DemuxerOptions {
     bool tcp_transport{true};// 使用 tcp 协议，默认 true
     // 是否跳过第一个I-Frame，默认 true, 第一个I-Frame貌似会pts错误
     bool jump_first_video_i_frame{true};
+    // 离线模式，视频文件不按时间戳限速，由包回调阻塞控制读取速度
+    bool offline{false};
+    // 按时长把视频文件切成 segment_count 段，只读取第 segment_index 段，段的起止都在关键帧
+    int segment_count{1};
+    int segment_index{0};
+    // 实时流断开后的重连退避
+    BackoffOptions reconnect_backoff;
+};
+
+/**
+ * @brief 输入流健康状态
+ */
+struct DemuxerStats {
+    bool connected{false};
+    uint64_t connects{0};         // 打开成功次数
+    uint64_t failures{0};         // 打开失败或读取中断次数
+    uint64_t packets{0};          // 读取的包数
+    uint64_t bytes{0};            // 读取的字节数
+    int64_t reconnect_delay_ms{0};// 当前的重连等待时间
+    std::chrono::steady_clock::time_point last_packet_time;
+    std::string last_error;
 };
 
 class Demuxer_v3 : public boost::noncopyable {
@@ -68,6 +90,20 @@ public:
      */
     double get_video_frame_rate();
 
+    /**
+     * @brief 获取视频流时间基
+     * 
+     * @return AVRational 
+     */
+    AVRational get_video_time_base();
+
+    /**
+     * @brief 获取输入流健康状态
+     * 
+     * @return DemuxerStats 
+     */
+    DemuxerStats get_stats();
+
     /**
      * @brief 注册打开回调
      * 
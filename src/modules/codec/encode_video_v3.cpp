@@ -3,6 +3,7 @@
 //
 
 #include "encode_video_v3.h"
+#include "av_object_pool.hpp"
 #include <memory>
 #include <spdlog/spdlog.h>
 
@@ -48,13 +49,24 @@ class EncoderPrivate {
 public:
     EncoderPrivate(Encoder_v3::OpenCallback open_cb, Encoder_v3::PacketCallback packet_cb)
         : open_cb_(std::move(open_cb)), packet_cb_(std::move(packet_cb)) {}
-    ~EncoderPrivate() {}
+    ~EncoderPrivate() {
+        sws_freeContext(sws_ctx_);
+        av_buffer_pool_uninit(&buffer_pool_);
+    }
 
     bool open_encoder(const EncodeOptions &opts, const AVHWDeviceType type);
     bool encode_frame(const std::shared_ptr<AVFrame> &frame);
     bool encode_frame(const uint8_t *data, int width, int height);
     void flush_encoder();
 
+private:
+    /**
+     * @brief 缩放到编码尺寸，帧和帧数据都从池中取
+     */
+    std::shared_ptr<AVFrame> scale_frame(const std::shared_ptr<AVFrame> &frame);
+
+    void receive_packets();
+
 private:
     const AVCodec *encoder = nullptr;
     std::unique_ptr<AVCodecContext, void (*)(AVCodecContext *)> codec_ctx_{nullptr, nullptr};
@@ -66,6 +78,12 @@ private:
     uint64_t frame_index = 0;
     std::shared_ptr<AVFrame> last_frame_;
 
+    FramePool frame_pool_{8};
+    PacketPool packet_pool_;
+    AVBufferPool *buffer_pool_{nullptr};// 缩放后的帧数据
+    int buffer_size_{0};
+    SwsContext *sws_ctx_{nullptr};
+
     Encoder_v3::OpenCallback open_cb_;
     Encoder_v3::PacketCallback packet_cb_;
 };
@@ -151,70 +169,35 @@ bool EncoderPrivate::open_encoder(const EncodeOptions &opts, const AVHWDeviceTyp
 bool EncoderPrivate::encode_frame(const std::shared_ptr<AVFrame> &frame) {
     try {
         auto enc_frame = frame;
-
-        std::shared_ptr<uint8_t> buffer;
         if (enc_frame->width != codec_ctx_->width || enc_frame->height != codec_ctx_->height) {
-            enc_frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
-
-            enc_frame->width = codec_ctx_->width;
-            enc_frame->height = codec_ctx_->height;
-            enc_frame->format = _convert_deprecated_format((AVPixelFormat)enc_frame->format);
-            buffer = std::shared_ptr<uint8_t>(
-                (uint8_t *)av_malloc(av_image_get_buffer_size((AVPixelFormat)enc_frame->format, codec_ctx_->width,
-                                                              codec_ctx_->height, 1)),
-                [](uint8_t *buf) { av_free(buf); });
-            av_image_fill_arrays(enc_frame->data, enc_frame->linesize, buffer.get(), (AVPixelFormat)enc_frame->format,
-                                 enc_frame->width, enc_frame->height, 1);
-
-            SwsContext *conversion = sws_getContext(
-                enc_frame->width, enc_frame->height, (AVPixelFormat)enc_frame->format, enc_frame->width,
-                enc_frame->height, (AVPixelFormat)enc_frame->format, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-            sws_scale(conversion, enc_frame->data, enc_frame->linesize, 0, enc_frame->height, enc_frame->data,
-                      enc_frame->linesize);
-            sws_freeContext(conversion);
+            enc_frame = scale_frame(frame);
         }
 
         if (hw_device_ctx) {
-            enc_frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
-            if (!enc_frame.get()) { throw std::runtime_error("Can not alloc frame"); }
+            auto hw_frame = frame_pool_.acquire();
+            if (!hw_frame.get()) { throw std::runtime_error("Can not alloc frame"); }
 
-            if (av_hwframe_get_buffer(codec_ctx_->hw_frames_ctx, enc_frame.get(), 0) < 0) {
+            if (av_hwframe_get_buffer(codec_ctx_->hw_frames_ctx, hw_frame.get(), 0) < 0) {
                 throw std::runtime_error("Failed to convert hwframe");
             }
 
-            if (!enc_frame->hw_frames_ctx) { throw std::runtime_error("Frame is not hwaccel pixel format"); }
+            if (!hw_frame->hw_frames_ctx) { throw std::runtime_error("Frame is not hwaccel pixel format"); }
 
-            if (av_hwframe_transfer_data(enc_frame.get(), frame.get(), 0) < 0) {
+            if (av_hwframe_transfer_data(hw_frame.get(), enc_frame.get(), 0) < 0) {
                 throw std::runtime_error("Error while transferring frame data to surface");
             }
 
-            av_frame_copy_props(enc_frame.get(), frame.get());
+            av_frame_copy_props(hw_frame.get(), enc_frame.get());
+            enc_frame = hw_frame;
+        }
 
-            enc_frame->pts = frame_index++;
-            if (avcodec_send_frame(codec_ctx_.get(), enc_frame.get()) < 0) {
-                throw std::runtime_error("Error sending a frame for encoding");
-            }
-        } else {
-            enc_frame->pts = frame_index++;
-            if (avcodec_send_frame(codec_ctx_.get(), frame.get()) < 0) {
-                throw std::runtime_error("Error sending a frame for encoding");
-            }
+        enc_frame->pts = frame_index++;
+        if (avcodec_send_frame(codec_ctx_.get(), enc_frame.get()) < 0) {
+            throw std::runtime_error("Error sending a frame for encoding");
         }
 
         last_frame_ = enc_frame;
-
-        while (true) {
-            auto packet = std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *pkt) { av_packet_free(&pkt); });
-            int ret = avcodec_receive_packet(codec_ctx_.get(), packet.get());
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) break;
-#if !defined(WITH_MLU220)
-            // TODO: MLU220 暂时忽略这个报错
-            else if (ret < 0)
-                throw std::runtime_error("Error during encoding");
-#endif
-            packet->stream_index = 0;
-            if (packet_cb_) packet_cb_(packet);
-        }
+        receive_packets();
     } catch (const std::exception &e) {
         spdlog::error(e.what());
         return false;
@@ -223,6 +206,50 @@ bool EncoderPrivate::encode_frame(const std::shared_ptr<AVFrame> &frame) {
     return true;
 }
 
+std::shared_ptr<AVFrame> EncoderPrivate::scale_frame(const std::shared_ptr<AVFrame> &frame) {
+    auto format = _convert_deprecated_format((AVPixelFormat)frame->format);
+    auto size = av_image_get_buffer_size(format, codec_ctx_->width, codec_ctx_->height, 1);
+    if (size < 0) { throw std::runtime_error("Unsupported frame format for scaling"); }
+
+    // 帧数据从 AVBufferPool 中取，编码器释放后回到池中，分辨率和格式不变时不再分配
+    if (!buffer_pool_ || buffer_size_ != size) {
+        av_buffer_pool_uninit(&buffer_pool_);
+        buffer_pool_ = av_buffer_pool_init(size, nullptr);
+        buffer_size_ = size;
+    }
+
+    auto scaled_frame = frame_pool_.acquire();
+    scaled_frame->buf[0] = av_buffer_pool_get(buffer_pool_);
+    if (!scaled_frame->buf[0]) { throw std::runtime_error("Can not alloc frame buffer"); }
+    scaled_frame->format = format;
+    scaled_frame->width = codec_ctx_->width;
+    scaled_frame->height = codec_ctx_->height;
+    av_image_fill_arrays(scaled_frame->data, scaled_frame->linesize, scaled_frame->buf[0]->data, format,
+                         scaled_frame->width, scaled_frame->height, 1);
+
+    sws_ctx_ = sws_getCachedContext(sws_ctx_, frame->width, frame->height, format, scaled_frame->width,
+                                    scaled_frame->height, format, SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+    if (!sws_ctx_) { throw std::runtime_error("Failed to get SwsContext"); }
+    sws_scale(sws_ctx_, frame->data, frame->linesize, 0, frame->height, scaled_frame->data, scaled_frame->linesize);
+    av_frame_copy_props(scaled_frame.get(), frame.get());
+    return scaled_frame;
+}
+
+void EncoderPrivate::receive_packets() {
+    while (true) {
+        auto packet = packet_pool_.acquire();
+        int ret = avcodec_receive_packet(codec_ctx_.get(), packet.get());
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) break;
+#if !defined(WITH_MLU220)
+        // TODO: MLU220 暂时忽略这个报错
+        else if (ret < 0)
+            throw std::runtime_error("Error during encoding");
+#endif
+        packet->stream_index = 0;
+        if (packet_cb_) packet_cb_(packet);
+    }
+}
+
 bool EncoderPrivate::encode_frame(const uint8_t *data, int width, int height) {
     int step = (width + STEP_ALIGNMENT - 1) & ~(STEP_ALIGNMENT - 1);
 
@@ -241,7 +268,7 @@ bool EncoderPrivate::encode_frame(const uint8_t *data, int width, int height) {
         }
 
         while (true) {
-            auto packet = std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *pkt) { av_packet_free(&pkt); });
+            auto packet = packet_pool_.acquire();
             if (avcodec_receive_packet(codec_ctx_.get(), packet.get()) < 0) break;
 
             if (packet_cb_) packet_cb_(packet);
@@ -264,7 +291,7 @@ void EncoderPrivate::flush_encoder() {
         }
 
         while (true) {
-            auto packet = std::shared_ptr<AVPacket>(av_packet_alloc(), [](AVPacket *pkt) { av_packet_free(&pkt); });
+            auto packet = packet_pool_.acquire();
             if (avcodec_receive_packet(codec_ctx_.get(), packet.get()) < 0) break;
             if (packet_cb_) packet_cb_(packet);
         }
@@ -1,4 +1,5 @@
 #include "filter_video_v3.h"
+#include "av_object_pool.hpp"
 #include <stdexcept>
 
 namespace av_wrapper {
@@ -11,6 +12,7 @@ public:
     AVFilterGraph *filter_graph = nullptr;
     AVFilterContext *buffer_ctx = nullptr;
     AVFilterContext *buffersink_ctx = nullptr;
+    FramePool frame_pool;
 };
 
 Filter_v3::Filter_v3() { impl_ = std::make_unique<FilterPrivate>(); }
@@ -82,8 +84,7 @@ bool Filter_v3::filter_frame(const int64_t frame_idx, const std::shared_ptr<AVFr
         throw std::runtime_error("Error submitting the frame to the filtergraph");
     }
 
-    auto sink_frame =
-        std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    auto sink_frame = impl_->frame_pool.acquire();
     if (av_buffersink_get_frame(impl_->buffersink_ctx, sink_frame.get()) >= 0) {
         if (filter_cb_) { filter_cb_(frame_idx, sink_frame); }
         return true;
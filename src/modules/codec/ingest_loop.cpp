@@ -0,0 +1,213 @@
+#include "ingest_loop.h"
+#include <algorithm>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace av_wrapper {
+
+ReconnectBackoff::ReconnectBackoff(const BackoffOptions &options, uint32_t seed) : options_(options), rng_(seed) {}
+
+void ReconnectBackoff::on_connected(IngestClock::time_point now) {
+    connected_ = true;
+    connected_at_ = now;
+}
+
+std::chrono::milliseconds ReconnectBackoff::next_delay(IngestClock::time_point now) {
+    if (connected_ && now - connected_at_ >= options_.reset_after) { attempts_ = 0; }
+    connected_ = false;
+
+    auto delay = options_.base.count() * std::pow(2.0, std::min(attempts_, 30));
+    delay = std::min(delay, (double)options_.max.count());
+    std::uniform_real_distribution<double> jitter(1 - options_.jitter, 1 + options_.jitter);
+    ++attempts_;
+    return std::chrono::milliseconds(std::llround(delay * jitter(rng_)));
+}
+
+IngestLoop::IngestLoop(std::string name, const IngestLoopOptions &options) : name_(std::move(name)), options_(options) {
+    if (options_.threads == 0) { options_.threads = std::max(1u, std::thread::hardware_concurrency()); }
+    if (options_.max_threads == 0) { options_.max_threads = options_.threads * 4; }
+    options_.max_threads = std::max(options_.max_threads, options_.threads);
+
+    std::lock_guard<std::mutex> glk(mutex_);
+    for (size_t i = 0; i < options_.threads; i++) { spawn_worker_(false); }
+    monitor_ = std::thread([this]() { run_monitor_(); });
+    spdlog::info("IngestLoop: {}, threads: {}, max threads: {}", name_, options_.threads, options_.max_threads);
+}
+
+IngestLoop::~IngestLoop() {
+    {
+        std::lock_guard<std::mutex> glk(mutex_);
+        stop_ = true;
+    }
+    queue_cv_.notify_all();
+    monitor_cv_.notify_all();
+    if (monitor_.joinable()) { monitor_.join(); }
+    for (auto &worker : workers_) {
+        if (worker->thread.joinable()) { worker->thread.join(); }
+    }
+}
+
+int IngestLoop::add(IngestTask *task, bool blocking) {
+    std::lock_guard<std::mutex> glk(mutex_);
+    auto id = next_id_++;
+    entries_[id] = Entry{task, IngestClock::now()};
+    entries_[id].blocking = blocking;
+    blocking_tasks_ += blocking;
+    schedule_(id, entries_[id].next);
+    return id;
+}
+
+void IngestLoop::set_blocking(int id, bool blocking) {
+    std::lock_guard<std::mutex> glk(mutex_);
+    auto iter = entries_.find(id);
+    if (iter == entries_.end() || iter->second.blocking == blocking) { return; }
+    iter->second.blocking = blocking;
+    blocking ? ++blocking_tasks_ : --blocking_tasks_;
+}
+
+void IngestLoop::remove(int id) {
+    std::unique_lock<std::mutex> lk(mutex_);
+    auto iter = entries_.find(id);
+    if (iter == entries_.end()) { return; }
+
+    if (iter->second.running) {
+        iter->second.removed = true;
+        removed_cv_.wait(lk, [this, id]() { return entries_.find(id) == entries_.end(); });
+    } else {
+        queue_.erase({iter->second.next, id});
+        erase_(iter);
+    }
+}
+
+IngestLoop::Stats IngestLoop::stats() {
+    std::lock_guard<std::mutex> glk(mutex_);
+    return Stats{entries_.size(), workers_.size(), busy_threads_, steps_, compensations_, blocking_tasks_};
+}
+
+void IngestLoop::erase_(std::map<int, Entry>::iterator iter) {
+    blocking_tasks_ -= iter->second.blocking;
+    entries_.erase(iter);
+}
+
+void IngestLoop::schedule_(int id, IngestClock::time_point next) {
+    entries_[id].next = next;
+    queue_.emplace(next, id);
+    if (queue_.begin()->second == id) { queue_cv_.notify_one(); }
+}
+
+void IngestLoop::spawn_worker_(bool temporary) {
+    workers_.emplace_back(std::make_unique<Worker>());
+    auto worker = workers_.back().get();
+    worker->thread = std::thread([this, worker, temporary]() { run_worker_(worker, temporary); });
+}
+
+void IngestLoop::run_worker_(Worker *worker, bool temporary) {
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), name_.substr(0, 15).c_str());
+#endif
+
+    std::unique_lock<std::mutex> lk(mutex_);
+    auto idle_since = IngestClock::now();
+    while (!stop_) {
+        auto now = IngestClock::now();
+        if (queue_.empty() || queue_.begin()->first > now) {
+            // 临时线程空闲超时后退出，由监控线程回收
+            if (temporary && now - idle_since >= options_.idle_timeout) { break; }
+            auto deadline = queue_.empty() ? now + options_.idle_timeout : queue_.begin()->first;
+            if (temporary) { deadline = std::min(deadline, idle_since + options_.idle_timeout); }
+            queue_cv_.wait_until(lk, deadline);
+            continue;
+        }
+
+        auto id = queue_.begin()->second;
+        queue_.erase(queue_.begin());
+        auto &entry = entries_.at(id);
+        auto task = entry.task;
+        entry.running = true;
+        worker->busy = true;
+        worker->step_start = now;
+        ++busy_threads_;
+        ++steps_;
+        lk.unlock();
+
+        auto next = now;
+        bool keep = false;
+        try {
+            keep = task->step(next);
+        } catch (const std::exception &e) { spdlog::error("IngestLoop: {}, {}", name_, e.what()); }
+
+        lk.lock();
+        worker->busy = false;
+        --busy_threads_;
+        idle_since = IngestClock::now();
+
+        auto iter = entries_.find(id);
+        iter->second.running = false;
+        if (!keep || iter->second.removed) {
+            erase_(iter);
+            removed_cv_.notify_all();
+        } else {
+            schedule_(id, next);
+        }
+    }
+
+    worker->exited = true;
+    monitor_cv_.notify_one();
+}
+
+void IngestLoop::run_monitor_() {
+    auto period = std::max(options_.blocking_threshold / 2, std::chrono::milliseconds(10));
+
+    std::unique_lock<std::mutex> lk(mutex_);
+    while (!stop_) {
+        monitor_cv_.wait_for(lk, period);
+        if (stop_) { break; }
+
+        // 退出的线程已释放锁，join 不会等待
+        for (auto iter = workers_.begin(); iter != workers_.end();) {
+            if ((*iter)->exited) {
+                (*iter)->thread.join();
+                iter = workers_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+
+        // 有任务到期但所有线程都卡在同一步里超过阈值，按到期的任务数临时增加线程，阻塞任务最多各占一个线程，
+        // 大量摄像头同时启动时一轮补齐，不必每个周期只加一个
+        auto now = IngestClock::now();
+        auto max_threads = std::max(options_.max_threads, blocking_tasks_ + 1);
+        if (queue_.empty() || queue_.begin()->first > now) { continue; }
+        if (busy_threads_ < workers_.size() || workers_.size() >= max_threads) { continue; }
+        bool blocked = std::all_of(workers_.begin(), workers_.end(), [&](const std::unique_ptr<Worker> &worker) {
+            return worker->busy && now - worker->step_start >= options_.blocking_threshold;
+        });
+        if (!blocked) { continue; }
+
+        size_t due = 0;
+        for (auto iter = queue_.begin(); iter != queue_.end() && iter->first <= now; ++iter) { ++due; }
+        auto count = std::min(due, max_threads - workers_.size());
+        for (size_t i = 0; i < count; i++) { spawn_worker_(true); }
+        // 每新增 100 个临时线程记录一次
+        if ((compensations_ + 99) / 100 != (compensations_ + count + 99) / 100) {
+            spdlog::warn("IngestLoop: {}, all {} threads blocked, add {} temporary threads", name_,
+                         workers_.size() - count, count);
+        }
+        compensations_ += count;
+    }
+}
+
+std::shared_ptr<IngestLoop> IngestLoop::shared_instance() {
+    static std::mutex mutex;
+    static std::shared_ptr<IngestLoop> instance{nullptr};
+
+    std::lock_guard<std::mutex> glk(mutex);
+    if (instance == nullptr) { instance = std::make_shared<IngestLoop>("ingest"); }
+    return instance;
+}
+
+}// namespace av_wrapper
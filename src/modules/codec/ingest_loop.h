@@ -0,0 +1,174 @@
+#ifndef __INGEST_LOOP_H__
+#define __INGEST_LOOP_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace av_wrapper {
+
+using IngestClock = std::chrono::steady_clock;
+
+struct BackoffOptions {
+    std::chrono::milliseconds base{500};         // 第一次重连前的等待
+    std::chrono::milliseconds max{30000};        // 等待上限
+    double jitter{0.5};                          // 随机系数范围 [1 - jitter, 1 + jitter)
+    std::chrono::milliseconds reset_after{30000};// 连接保持超过该时间后再断开，从 base 重新开始
+};
+
+/**
+ * @brief 重连退避，第 n 次失败后等待 base * 2^n，不超过 max，并乘以随机系数
+ *
+ *        网络抖动后各路摄像头的重连时间被随机错开，不会同时重连。
+ */
+class ReconnectBackoff {
+public:
+    explicit ReconnectBackoff(const BackoffOptions &options = {}, uint32_t seed = std::random_device{}());
+
+    /**
+     * @brief 连接成功
+     */
+    void on_connected(IngestClock::time_point now);
+
+    /**
+     * @brief 连接失败或断开，返回下次重连前的等待时间
+     */
+    std::chrono::milliseconds next_delay(IngestClock::time_point now);
+
+    int attempts() const { return attempts_; }
+
+private:
+    BackoffOptions options_;
+    std::minstd_rand rng_;
+    int attempts_{0};
+    bool connected_{false};
+    IngestClock::time_point connected_at_;
+};
+
+/**
+ * @brief 在 IngestLoop 上调度的输入源
+ */
+class IngestTask {
+public:
+    virtual ~IngestTask() = default;
+
+    /**
+     * @brief 执行一步(打开、读取一批包或重连)，同一任务不会被并发调用
+     *
+     * @param next 下次调度的时间，调用前为当前时间
+     * @return false 时结束，不再调度
+     */
+    virtual bool step(IngestClock::time_point &next) = 0;
+};
+
+struct IngestLoopOptions {
+    size_t threads{0};                                  // 常驻工作线程，0 表示 CPU 核心数
+    size_t max_threads{0};                              // 阻塞补偿的线程上限，0 表示常驻线程的 4 倍，至少比阻塞任务多一个
+    std::chrono::milliseconds blocking_threshold{200};  // 所有线程都阻塞超过该时间且有任务等待时按等待的任务数临时加线程
+    std::chrono::milliseconds idle_timeout{10000};      // 临时线程空闲超过该时间后退出
+};
+
+/**
+ * @brief 多路实时流共享的读取线程池，代替每路流一个线程
+ *
+ *        任务按下次调度时间排序，到期后由空闲的工作线程执行一步，执行完再按返回的时间重新排队，
+ *        重连等待和文件限速都不占用线程。libavformat 的读取接口是阻塞的，一路流卡住时会占住一个线程，
+ *        所有线程都卡住超过 blocking_threshold 时按到期的任务数临时增加线程，保证其它流仍能按时读取。
+ *        读取会阻塞的任务 (如忽略 AVFMT_FLAG_NONBLOCK 的 RTSP) 最坏情况下各占一个线程，线程上限至少比这类任务多一个。
+ */
+class IngestLoop {
+public:
+    struct Stats {
+        size_t tasks;
+        size_t threads;
+        size_t busy_threads;
+        uint64_t steps;
+        uint64_t compensations;// 因阻塞临时增加的线程数
+        size_t blocking_tasks;
+    };
+
+    explicit IngestLoop(std::string name, const IngestLoopOptions &options = {});
+    ~IngestLoop();
+
+    IngestLoop(const IngestLoop &) = delete;
+    IngestLoop &operator=(const IngestLoop &) = delete;
+
+    /**
+     * @brief thread-safe, 加入任务并立即调度，task 在 remove 返回前必须有效
+     *
+     * @param blocking 任务的 step 可能阻塞等待数据
+     */
+    int add(IngestTask *task, bool blocking = false);
+
+    /**
+     * @brief thread-safe, 更新任务是否阻塞，可以在该任务的 step 中调用
+     */
+    void set_blocking(int id, bool blocking);
+
+    /**
+     * @brief thread-safe, 移除任务，任务正在执行时等待这一步返回，不能在该任务的 step 中调用
+     */
+    void remove(int id);
+
+    Stats stats();
+
+    /**
+     * @brief 进程内共享的默认实例，按需创建
+     */
+    static std::shared_ptr<IngestLoop> shared_instance();
+
+private:
+    struct Entry {
+        IngestTask *task;
+        IngestClock::time_point next;
+        bool running{false};
+        bool removed{false};
+        bool blocking{false};
+    };
+
+    struct Worker {
+        std::thread thread;
+        bool busy{false};
+        bool exited{false};
+        IngestClock::time_point step_start;
+    };
+
+    void run_worker_(Worker *worker, bool temporary);
+    void run_monitor_();
+    void spawn_worker_(bool temporary);
+    void schedule_(int id, IngestClock::time_point next);
+    void erase_(std::map<int, Entry>::iterator iter);
+
+private:
+    std::string name_;
+    IngestLoopOptions options_;
+
+    std::mutex mutex_;
+    std::condition_variable queue_cv_;  // 有任务到期或排队时间提前
+    std::condition_variable removed_cv_;// 正在执行的任务返回
+    std::condition_variable monitor_cv_;
+    std::map<int, Entry> entries_;
+    std::set<std::pair<IngestClock::time_point, int>> queue_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    int next_id_{0};
+    size_t busy_threads_{0};
+    size_t blocking_tasks_{0};
+    uint64_t steps_{0};
+    uint64_t compensations_{0};
+    bool stop_{false};
+
+    std::thread monitor_;
+};
+
+}// namespace av_wrapper
+
+#endif//__INGEST_LOOP_H__
@@ -0,0 +1,156 @@
+#include "packet_ring_buffer.h"
+#include "remux_stream_v3.h"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace av_wrapper {
+
+void PacketRingBuffer::open(const std::shared_ptr<AVCodecParameters> &codecpar, const AVRational &timebase,
+                            const AVRational &framerate) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    codecpar_ = codecpar;
+    timebase_ = timebase;
+    if (framerate.num > 0 && framerate.den > 0) { framerate_ = framerate; }
+
+    gops_.clear();
+    total_bytes_ = 0;
+    total_packets_ = 0;
+    latest_time_ = 0;
+    pushed_packets_ = 0;
+}
+
+void PacketRingBuffer::set_duration(double seconds) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    duration_ = std::max(duration_, seconds);
+}
+
+void PacketRingBuffer::set_max_bytes(size_t max_bytes) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    max_bytes_ = max_bytes;
+}
+
+double PacketRingBuffer::packet_time_(const AVPacket *packet) {
+    if (packet->pts != AV_NOPTS_VALUE) { return packet->pts * av_q2d(timebase_); }
+    if (packet->dts != AV_NOPTS_VALUE) { return packet->dts * av_q2d(timebase_); }
+    return pushed_packets_ / av_q2d(framerate_);
+}
+
+void PacketRingBuffer::push_packet(const std::shared_ptr<AVPacket> &packet) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    if (duration_ <= 0) { return; }
+
+    auto time = packet_time_(packet.get());
+    ++pushed_packets_;
+
+    if (packet->flags & AV_PKT_FLAG_KEY) {
+        if (!gops_.empty() && time < latest_time_ - 1.0) {
+            // 时间戳回退(重连或回绕)，旧数据与之后的包无法拼接
+            gops_.clear();
+            total_bytes_ = 0;
+            total_packets_ = 0;
+            latest_time_ = time;
+        }
+        gops_.push_back(Gop{time});
+    } else if (gops_.empty()) {
+        // 等待第一个关键帧
+        return;
+    }
+
+    auto &gop = gops_.back();
+    gop.packets.push_back(packet);
+    gop.bytes += packet->size;
+    total_bytes_ += packet->size;
+    ++total_packets_;
+    latest_time_ = std::max(latest_time_, time);
+
+    // 第二个 GOP 已覆盖预录时长时，第一个 GOP 不再需要
+    while (gops_.size() > 1 && (gops_[1].start_time <= latest_time_ - duration_ || total_bytes_ > max_bytes_)) {
+        total_bytes_ -= gops_.front().bytes;
+        total_packets_ -= gops_.front().packets.size();
+        gops_.pop_front();
+    }
+}
+
+std::vector<std::shared_ptr<const AVPacket>> PacketRingBuffer::snapshot() const {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    std::vector<std::shared_ptr<const AVPacket>> packets;
+    packets.reserve(total_packets_);
+    for (const auto &gop : gops_) { packets.insert(packets.end(), gop.packets.begin(), gop.packets.end()); }
+    return packets;
+}
+
+bool PacketRingBuffer::export_clip(const std::string &output_url) const {
+    std::shared_ptr<AVCodecParameters> codecpar;
+    AVRational timebase;
+    AVRational framerate;
+    {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        codecpar = codecpar_;
+        timebase = timebase_;
+        framerate = framerate_;
+    }
+    auto packets = snapshot();
+    if (!codecpar || packets.empty()) { return false; }
+
+    Remuxer_v3 remuxer;
+    if (!remuxer.open_stream(output_url, codecpar, timebase, framerate)) { return false; }
+
+    auto start_time = packets.front()->dts != AV_NOPTS_VALUE ? packets.front()->dts : packets.front()->pts;
+    if (start_time == AV_NOPTS_VALUE) { start_time = 0; }
+    auto frame_duration = av_rescale_q(1, av_inv_q(framerate), timebase);
+
+    for (size_t i = 0; i < packets.size(); i++) {
+        // 只引用数据，Remuxer_v3 会改写时间戳和流序号
+        auto packet =
+            std::shared_ptr<AVPacket>(av_packet_clone(packets[i].get()), [](AVPacket *ptr) { av_packet_free(&ptr); });
+        if (!packet) { return false; }
+
+        if (packet->dts == AV_NOPTS_VALUE) {
+            packet->dts = packet->pts != AV_NOPTS_VALUE ? packet->pts : start_time + (int64_t)i * frame_duration;
+        }
+        if (packet->pts == AV_NOPTS_VALUE) { packet->pts = packet->dts; }
+        packet->pts -= start_time;
+        packet->dts -= start_time;
+
+        if (!remuxer.write_packet(packet)) {
+            spdlog::error("Failed to write packet: {}", output_url);
+            return false;
+        }
+    }
+    remuxer.close_stream();
+
+    return true;
+}
+
+size_t PacketRingBuffer::packet_count() const {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    return total_packets_;
+}
+
+size_t PacketRingBuffer::bytes() const {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    return total_bytes_;
+}
+
+PacketRingRegistry &PacketRingRegistry::get_instance() {
+    static PacketRingRegistry instance;
+    return instance;
+}
+
+std::shared_ptr<PacketRingBuffer> PacketRingRegistry::acquire(const std::string &stream_name) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
+    auto &weak_buffer = buffers_[stream_name];
+    auto buffer = weak_buffer.lock();
+    if (!buffer) {
+        buffer = std::make_shared<PacketRingBuffer>();
+        weak_buffer = buffer;
+    }
+
+    // 清理已释放的缓存
+    for (auto iter = buffers_.begin(); iter != buffers_.end();) {
+        iter = iter->second.expired() ? buffers_.erase(iter) : ++iter;
+    }
+    return buffer;
+}
+
+}// namespace av_wrapper
@@ -0,0 +1,113 @@
+#ifndef __PACKET_RING_BUFFER_H__
+#define __PACKET_RING_BUFFER_H__
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace av_wrapper {
+
+/**
+ * @brief 按关键帧对齐的视频压缩包环形缓存，用于事件预录
+ *
+ *        以 GOP 为单位保存，首包始终是关键帧，超出时长后整个 GOP 一起丢弃，
+ *        内存占用与码率成正比，与分辨率无关。导出时直接封装，不重新编码。
+ */
+class PacketRingBuffer {
+public:
+    PacketRingBuffer() = default;
+
+    PacketRingBuffer(const PacketRingBuffer &) = delete;
+    PacketRingBuffer &operator=(const PacketRingBuffer &) = delete;
+
+    /**
+     * @brief 解封装打开(或重连)时调用，清空已缓存的包
+     */
+    void open(const std::shared_ptr<AVCodecParameters> &codecpar, const AVRational &timebase,
+              const AVRational &framerate);
+
+    /**
+     * @brief 预录时长(秒)，多个使用者时取最大值，为 0 时不缓存
+     */
+    void set_duration(double seconds);
+
+    /**
+     * @brief 内存上限(字节)，码率异常时按 GOP 丢弃，至少保留一个 GOP
+     */
+    void set_max_bytes(size_t max_bytes);
+
+    /**
+     * @brief thread-safe, 缓存一个视频包，只增加引用不拷贝数据
+     */
+    void push_packet(const std::shared_ptr<AVPacket> &packet);
+
+    /**
+     * @brief thread-safe, 当前缓存的包，调用者不能修改包内容
+     */
+    std::vector<std::shared_ptr<const AVPacket>> snapshot() const;
+
+    /**
+     * @brief 将当前缓存封装为视频文件，时间戳从 0 开始
+     */
+    bool export_clip(const std::string &output_url) const;
+
+    size_t packet_count() const;
+    size_t bytes() const;
+
+private:
+    struct Gop {
+        double start_time;// 秒
+        size_t bytes{0};
+        std::vector<std::shared_ptr<AVPacket>> packets;
+    };
+
+    double packet_time_(const AVPacket *packet);
+
+private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<AVCodecParameters> codecpar_;
+    AVRational timebase_{1, 90000};
+    AVRational framerate_{25, 1};
+
+    double duration_{0};
+    size_t max_bytes_{64 * 1024 * 1024};
+
+    std::deque<Gop> gops_;
+    size_t total_bytes_{0};
+    size_t total_packets_{0};
+    double latest_time_{0};
+    int64_t pushed_packets_{0};
+};
+
+/**
+ * @brief 进程内按视频流(任务名)共享 PacketRingBuffer，解码节点写入，上报节点导出
+ *
+ *        最后一个使用者释放后缓存随之释放。
+ */
+class PacketRingRegistry {
+public:
+    PacketRingRegistry(const PacketRingRegistry &) = delete;
+    PacketRingRegistry &operator=(const PacketRingRegistry &) = delete;
+
+    static PacketRingRegistry &get_instance();
+
+    std::shared_ptr<PacketRingBuffer> acquire(const std::string &stream_name);
+
+private:
+    PacketRingRegistry() = default;
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<PacketRingBuffer>> buffers_;
+};
+
+}// namespace av_wrapper
+
+#endif//__PACKET_RING_BUFFER_H__
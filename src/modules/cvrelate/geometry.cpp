@@ -74,6 +74,15 @@ float area_cover_rate(const std::vector<Point2i> &region1, const std::vector<Poi
     return inter_area / std::min(bg::area(poly1), bg::area(poly2));
 }
 
+float rect_cover_rate(const Rect &rect1, const Rect &rect2) {
+    double iw = std::min(rect1.x + rect1.width, rect2.x + rect2.width) - std::max(rect1.x, rect2.x);
+    double ih = std::min(rect1.y + rect1.height, rect2.y + rect2.height) - std::max(rect1.y, rect2.y);
+    double inter = iw > 0 && ih > 0 ? iw * ih : 0;
+    double area1 = std::abs((double)rect1.width * rect1.height);
+    double area2 = std::abs((double)rect2.width * rect2.height);
+    return inter / std::min(area1, area2);
+}
+
 bool point_within_area(const Point2i &point, const std::vector<Point2i> &region) {
     polygon_type poly = convert_polygon(region);
     return boost::geometry::within(point_type(point.x, point.y), poly);
@@ -32,6 +32,11 @@ float polygon_area(const std::vector<Point2i> &region);
 
 float area_cover_rate(const std::vector<Point2i> &region1, const std::vector<Point2i> &region2);
 
+/**
+ * @brief 轴对齐矩形的 area_cover_rate，解析计算，不构造多边形
+ */
+float rect_cover_rate(const Rect &rect1, const Rect &rect2);
+
 bool point_within_area(const Point2i &point, const std::vector<Point2i> &region);
 
 }// namespace geometry
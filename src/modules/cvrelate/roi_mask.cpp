@@ -0,0 +1,144 @@
+#include "roi_mask.h"
+#include <algorithm>
+#include <cmath>
+
+namespace gddi {
+namespace geometry {
+
+// 每个格子每个方向的采样数
+static const int kSamples = 4;
+
+CoverMode cover_mode_from_string(const std::string &mode) {
+    return mode == "exact" ? CoverMode::kExact : CoverMode::kRaster;
+}
+
+void RoiMaskIndex::compile(const std::vector<std::vector<Point2i>> &regions, CoverMode mode, int max_cells) {
+    clear();
+    mode_ = mode;
+    masks_.resize(regions.size());
+
+    std::vector<std::pair<box_type, size_t>> boxes;
+    for (size_t i = 0; i < regions.size(); i++) {
+        auto &mask = masks_[i];
+        mask.polygon = convert_polygon(regions[i]);
+        mask.area = bg::area(mask.polygon);
+        if (mode_ == CoverMode::kRaster) { rasterize(regions[i], mask, max_cells); }
+        if (!regions[i].empty()) { boxes.emplace_back(bg::return_envelope<box_type>(mask.polygon), i); }
+    }
+    rtree_ = rtree_type(boxes);
+}
+
+void RoiMaskIndex::clear() {
+    masks_.clear();
+    rtree_.clear();
+}
+
+void RoiMaskIndex::rasterize(const std::vector<Point2i> &region, Mask &mask, int max_cells) {
+    mask.origin_x = mask.origin_y = 0;
+    mask.cell = 1;
+    mask.cols = mask.rows = 1;
+    mask.integral.assign(4, 0);
+    if (region.size() < 3) { return; }
+
+    int min_x = region[0].x, min_y = region[0].y, max_x = min_x, max_y = min_y;
+    for (const auto &point : region) {
+        min_x = std::min(min_x, point.x);
+        min_y = std::min(min_y, point.y);
+        max_x = std::max(max_x, point.x);
+        max_y = std::max(max_y, point.y);
+    }
+
+    const float width = max_x - min_x, height = max_y - min_y;
+    mask.origin_x = min_x;
+    mask.origin_y = min_y;
+    mask.cell = std::max(1.0f, std::ceil(std::max(width, height) / max_cells));
+    mask.cols = std::max(1, (int)std::ceil(width / mask.cell));
+    mask.rows = std::max(1, (int)std::ceil(height / mask.cell));
+
+    // 逐采样行扫描线填充，奇偶规则
+    const float step = mask.cell / kSamples;
+    const int sample_cols = mask.cols * kSamples;
+    std::vector<uint8_t> counts((size_t)mask.rows * mask.cols, 0);
+    std::vector<float> crossings;
+    for (int sy = 0; sy < mask.rows * kSamples; sy++) {
+        const float y = min_y + (sy + 0.5f) * step;
+        crossings.clear();
+        for (size_t i = 0; i < region.size(); i++) {
+            const auto &a = region[i];
+            const auto &b = region[(i + 1) % region.size()];
+            if ((a.y <= y) != (b.y <= y)) { crossings.push_back(a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)); }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        uint8_t *row = counts.data() + (size_t)(sy / kSamples) * mask.cols;
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+            // 采样点 min_x + (sx + 0.5) * step 落在 [crossings[i], crossings[i + 1]) 内
+            int begin = std::max(0, (int)std::ceil((crossings[i] - min_x) / step - 0.5f));
+            int end = std::min(sample_cols, (int)std::ceil((crossings[i + 1] - min_x) / step - 0.5f));
+            for (int sx = begin; sx < end; sx++) { ++row[sx / kSamples]; }
+        }
+    }
+
+    const int stride = mask.cols + 1;
+    mask.integral.assign((size_t)(mask.rows + 1) * stride, 0);
+    for (int r = 0; r < mask.rows; r++) {
+        double row_sum = 0;
+        for (int c = 0; c < mask.cols; c++) {
+            row_sum += counts[(size_t)r * mask.cols + c] / float(kSamples * kSamples);
+            mask.integral[(size_t)(r + 1) * stride + c + 1] = mask.integral[(size_t)r * stride + c + 1] + row_sum;
+        }
+    }
+}
+
+float RoiMaskIndex::Mask::integral_at(float x, float y) const {
+    float u = std::min(std::max((x - origin_x) / cell, 0.0f), (float)cols);
+    float v = std::min(std::max((y - origin_y) / cell, 0.0f), (float)rows);
+    int i = std::min((int)u, cols - 1);
+    int j = std::min((int)v, rows - 1);
+    float fx = u - i, fy = v - j;
+
+    const float *top = integral.data() + (size_t)j * (cols + 1) + i;
+    const float *bottom = top + cols + 1;
+    return (top[0] * (1 - fx) + top[1] * fx) * (1 - fy) + (bottom[0] * (1 - fx) + bottom[1] * fx) * fy;
+}
+
+void RoiMaskIndex::query(float x1, float y1, float x2, float y2, std::vector<size_t> &indices) const {
+    indices.clear();
+    box_type box(point_type(std::min(x1, x2), std::min(y1, y2)), point_type(std::max(x1, x2), std::max(y1, y2)));
+    for (auto iter = rtree_.qbegin(bg::index::intersects(box)); iter != rtree_.qend(); ++iter) {
+        indices.push_back(iter->second);
+    }
+    std::sort(indices.begin(), indices.end());
+}
+
+float RoiMaskIndex::cover_rate(size_t index, float x1, float y1, float x2, float y2) const {
+    const auto &mask = masks_[index];
+
+    if (mode_ == CoverMode::kExact) {
+        polygon_type box;
+        for (auto &point : {point_type(x1, y1), point_type(x1, y2), point_type(x2, y2), point_type(x2, y1)}) {
+            bg::append(box, point);
+        }
+        bg::correct(box);
+        return intersection(box, mask.polygon) / std::min((float)bg::area(box), mask.area);
+    }
+
+    if (x1 > x2) { std::swap(x1, x2); }
+    if (y1 > y2) { std::swap(y1, y2); }
+    float inter = mask.integral_at(x2, y2) - mask.integral_at(x1, y2) - mask.integral_at(x2, y1)
+        + mask.integral_at(x1, y1);
+    inter = std::max(inter, 0.0f) * mask.cell * mask.cell;
+    return std::min(inter / std::min((x2 - x1) * (y2 - y1), mask.area), 1.0f);
+}
+
+float RoiMaskIndex::cover_rate(size_t index, const std::vector<Point2i> &region) const {
+    polygon_type poly = convert_polygon(region);
+    return intersection(poly, masks_[index].polygon) / std::min((float)bg::area(poly), masks_[index].area);
+}
+
+bool RoiMaskIndex::within(size_t index, const Point2i &point) const {
+    return bg::within(point_type(point.x, point.y), masks_[index].polygon);
+}
+
+}// namespace geometry
+}// namespace gddi
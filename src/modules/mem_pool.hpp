@@ -19,11 +19,15 @@ template<typename T, typename U = int64_t>
 // 实际分配内存对象
 struct MemObject {
     explicit MemObject(std::function<void(T *)> on_free, const U &u) {
-        data = std::shared_ptr<T>(new T, [on_free, u](T *ptr) {
+        data = std::shared_ptr<T>(new T(), [on_free, u](T *ptr) {
             if (on_free) { on_free(ptr); };
             delete ptr;
         });
     }
+
+    // 直接引用已有对象，不分配
+    explicit MemObject(std::shared_ptr<T> d) : data(std::move(d)) {}
+
     std::shared_ptr<T> data;
 };
 
@@ -52,17 +56,21 @@ public:
     }
 
     // 对象内存管理，队列有则取，没有则申请
+    // 释放时 data 指向的对象回到队列，使用者可以替换 data，但不能替换为不属于自己的对象
     std::shared_ptr<MemObject<T>> alloc_mem_attach(Args... args) {
-        auto mem_object = std::shared_ptr<MemObject<T>>(
-            new MemObject<T>(mem_free_, 0), [queue = this->queue_](MemObject<T> *ptr) {
-                queue->enqueue(ptr->data);
-                delete ptr;
-            });
-        if (!queue_->try_dequeue(mem_object->data)) {
-            if (mem_alloc_) { mem_alloc_(mem_object->data.get(), args...); }
+        std::shared_ptr<T> data;
+        MemObject<T> *object = nullptr;
+        if (queue_->try_dequeue(data)) {
+            object = new MemObject<T>(std::move(data));
+        } else {
+            object = new MemObject<T>(mem_free_, 0);
+            if (mem_alloc_) { mem_alloc_(object->data.get(), args...); }
         }
 
-        return mem_object;
+        return std::shared_ptr<MemObject<T>>(object, [queue = this->queue_](MemObject<T> *ptr) {
+            if (ptr->data) { queue->enqueue(std::move(ptr->data)); }
+            delete ptr;
+        });
     }
 
     // 对象内存管理，与 typename U 同生命周期
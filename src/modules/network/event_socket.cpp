@@ -0,0 +1,207 @@
+#include "event_socket.h"
+#include "spdlog/spdlog.h"
+#include <random>
+
+namespace gddi {
+namespace network {
+
+EventSocket::EventSocket(Options options)
+    : options_(std::move(options)), spool_(EventSpool::Options{options_.spool_directory, 4 << 20, options_.window}) {
+    if (options_.senders == 0) { options_.senders = 1; }
+    for (size_t i = 0; i < options_.senders; i++) {
+        sender_handles_.emplace_back(
+            std::make_unique<gddi::Thread>([this]() { run_sender(); }, gddi::Thread::DtorAction::join));
+        sender_handles_.back()->start();
+    }
+    thread_handle_ = std::make_unique<gddi::Thread>([this]() { run(); }, gddi::Thread::DtorAction::join);
+    thread_handle_->start();
+}
+
+EventSocket::~EventSocket() {
+    {
+        std::lock_guard<std::mutex> glk(mtx_wakeup_);
+        running_ = false;
+    }
+    cv_wakeup_.notify_all();
+    cv_jobs_.notify_all();
+    thread_handle_.reset();
+    sender_handles_.clear();
+}
+
+void EventSocket::post_sync(const std::string &task_name, const std::string &event_id, const std::string &url,
+                            const std::string &data) {
+    if (!spool_.append(EventObject{task_name, event_id, url, data})) {
+        spdlog::error("Failed to queue event, task: {}, event: {}", task_name, event_id);
+        return;
+    }
+
+    std::lock_guard<std::mutex> glk(mtx_wakeup_);
+    wakeup_ = true;
+    cv_wakeup_.notify_one();
+}
+
+void EventSocket::set_max_batch(const std::string &url, size_t max_batch) {
+    std::lock_guard<std::mutex> glk(mtx_batch_);
+    url_max_batch_[url] = std::max<size_t>(max_batch, 1);
+}
+
+size_t EventSocket::max_batch(const std::string &url) {
+    std::lock_guard<std::mutex> glk(mtx_batch_);
+    auto iter = url_max_batch_.find(url);
+    return iter != url_max_batch_.end() ? iter->second : options_.max_batch;
+}
+
+void EventSocket::run() {
+    std::vector<EventObject> events;
+    std::vector<uint64_t> ids;
+    std::map<std::string, Receiver> receivers;// 投递失败的 url
+    std::set<std::string> busy_urls;          // 已交给发送线程、结果未返回的 url
+    std::deque<Result> results;
+    std::mt19937 rng(std::random_device{}());
+
+    while (running_) {
+        {
+            std::lock_guard<std::mutex> glk(mtx_wakeup_);
+            results.swap(results_);
+        }
+
+        for (auto &result : results) {
+            busy_urls.erase(result.url);
+            if (result.delivered) {
+                spool_.ack(result.ids);
+                receivers.erase(result.url);
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            const auto &url = result.url;
+            auto iter = receivers.find(url);
+            if (iter == receivers.end()) {
+                iter = receivers.emplace(url, Receiver{now, now, options_.min_backoff}).first;
+            } else {
+                iter->second.backoff = std::min(iter->second.backoff * 2, options_.max_backoff);
+            }
+            auto &receiver = iter->second;
+
+            // 指数退避，随机抖动避免多路同时重连
+            std::uniform_int_distribution<int64_t> jitter(receiver.backoff.count() / 2, receiver.backoff.count());
+            auto delay = std::chrono::milliseconds(jitter(rng));
+            receiver.retry_at = now + delay;
+
+            if (now - receiver.failing_since >= options_.max_retry_age) {
+                auto count = spool_.ack_url(url);
+                dropped_ += count;
+                spdlog::error("Event receiver unavailable for over {} s, drop {} events, url: {}",
+                              options_.max_retry_age.count(), count, url);
+                continue;
+            }
+            spdlog::warn("Event receiver unavailable, {} events pending, retry in {} ms, url: {}", spool_.size(),
+                         delay.count(), url);
+        }
+        results.clear();
+
+        auto now = std::chrono::steady_clock::now();
+        auto retry_at = std::chrono::steady_clock::time_point::max();
+        std::set<std::string> skip_urls = busy_urls;
+        for (const auto &[url, receiver] : receivers) {
+            if (receiver.retry_at > now) {
+                skip_urls.insert(url);
+                retry_at = std::min(retry_at, receiver.retry_at);
+            }
+        }
+
+        if (busy_urls.size() >= options_.senders
+            || spool_.front(events, ids, 1, options_.max_batch_bytes, skip_urls) == 0) {
+            // 发送线程都在忙、没有事件或所有 url 都在退避中，等待新事件、投递结果或最早的重试时间
+            std::unique_lock<std::mutex> ulk(mtx_wakeup_);
+            auto pred = [this] { return !running_ || wakeup_ || !results_.empty(); };
+            if (retry_at == std::chrono::steady_clock::time_point::max()) {
+                cv_wakeup_.wait(ulk, pred);
+            } else {
+                cv_wakeup_.wait_until(ulk, retry_at, pred);
+            }
+            wakeup_ = false;
+            continue;
+        }
+
+        // 跳过的 url 不变，再取一次得到同一个 url 的一批事件
+        const auto url = events.front().url;
+        auto batch = max_batch(url);
+        if (batch > 1) { spool_.front(events, ids, batch, options_.max_batch_bytes, skip_urls); }
+
+        busy_urls.insert(url);
+        {
+            std::lock_guard<std::mutex> glk(mtx_wakeup_);
+            jobs_.push_back(Job{std::move(events), std::move(ids)});
+        }
+        cv_jobs_.notify_one();
+    }
+}
+
+void EventSocket::run_sender() {
+    hv::HttpClient client;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> ulk(mtx_wakeup_);
+            cv_jobs_.wait(ulk, [this] { return !running_ || !jobs_.empty(); });
+            if (!running_) { break; }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        bool delivered = deliver(client, job.events);
+
+        std::lock_guard<std::mutex> glk(mtx_wakeup_);
+        results_.push_back(Result{job.events.front().url, std::move(job.ids), delivered});
+        cv_wakeup_.notify_one();
+    }
+}
+
+bool EventSocket::deliver(hv::HttpClient &client, const std::vector<EventObject> &events) {
+    const auto &front = events.front();
+
+    HttpRequest req;
+    req.method = HTTP_POST;
+    req.url = front.url;
+    req.headers["Content-Type"] = "application/json";
+    req.timeout = options_.timeout;
+
+    if (events.size() == 1) {
+        req.body = front.buffer;
+    } else {
+        size_t size = events.size() + 1;
+        for (const auto &event : events) { size += event.buffer.size(); }
+        req.body.reserve(size);
+        req.body.push_back('[');
+        for (const auto &event : events) {
+            if (req.body.size() > 1) { req.body.push_back(','); }
+            req.body.append(event.buffer);
+        }
+        req.body.push_back(']');
+        req.headers["X-Event-Count"] = std::to_string(events.size());
+    }
+
+    HttpResponse resp;
+    ++requests_;
+    int ret = client.send(&req, &resp);
+    if (ret == 0 && resp.status_code >= 200 && resp.status_code < 300) {
+        delivered_ += events.size();
+        return true;
+    }
+
+    ++failures_;
+    spdlog::error("Post event request failed, task: {}, url: {}, events: {}, resp-code: {}, resp-msg: {}",
+                  front.task_name, front.url, events.size(), ret == 0 ? (int)resp.status_code : -1,
+                  ret == 0 ? resp.status_message() : http_client_strerror(ret));
+
+    if (ret == 0 && resp.status_code >= 400 && resp.status_code < 500 && resp.status_code != 408
+        && resp.status_code != 429) {
+        dropped_ += events.size();
+        return true;
+    }
+    return false;
+}
+
+}// namespace network
+}// namespace gddi
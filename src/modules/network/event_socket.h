@@ -1,88 +1,129 @@
-#include "basic_logs.hpp"
-#include "spdlog/spdlog.h"
+#ifndef __EVENT_SOCKET_H__
+#define __EVENT_SOCKET_H__
+
+#include "event_spool.h"
 #include "thread.hpp"
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <hv/requests.h>
-#include <queue>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace gddi {
 namespace network {
 
-struct EventObject {
-    std::string task_name;
-    std::string event_id;
-    std::string url;
-    std::string buffer;
-    std::size_t num_of_retries{0};
-};
-
+/**
+ * @brief 事件上报，先写入磁盘队列再由分发线程按 url 交给 senders 个发送线程投递
+ *
+ *        默认每个事件一个 POST，body 与原来相同。接收端支持时可以按 url 开启合并 (set_max_batch)，
+ *        同一 url 的多个事件合并为一个 POST，body 为 JSON 数组 [事件1, 事件2, ...]，
+ *        每个元素与单独上报时的 body 相同，请求头 X-Event-Count 为事件数；只有一个事件时仍不加数组。
+ *        连接保持复用，失败按指数退避重试，
+ *        2xx 确认出队，408 / 429 以外的 4xx 重试无意义，记录日志后丢弃。
+ *        每个发送线程使用自己的连接，同一 url 同时只有一个请求，保证顺序，慢的接收端只占用一个发送线程；
+ *        退避按 url 分别计算，一个接收端不可用时其他 url 的事件照常投递；
+ *        持续失败超过 max_retry_age 的 url 丢弃其缓存的事件，避免占满内存窗口。
+ *        进程退出或崩溃后未确认的事件下次启动时补发
+ */
 class EventSocket {
 public:
+    struct Options {
+        std::string spool_directory{"/home/data/event_spool"};
+        size_t window{1024};               // 内存中缓存的未确认事件数
+        size_t senders{4};                 // 发送线程数，即同时投递的 url 数
+        size_t max_batch{1};               // 单个 POST 最多合并的事件数，1 表示不合并
+        size_t max_batch_bytes{4 << 20};   // 单个 POST body 上限
+        int timeout{10};                   // 请求超时，秒
+        std::chrono::milliseconds min_backoff{500};
+        std::chrono::milliseconds max_backoff{60000};
+        std::chrono::seconds max_retry_age{3600};// url 持续失败超过该时间后丢弃其事件
+    };
+
+    struct Stats {
+        uint64_t delivered;
+        uint64_t dropped;
+        uint64_t requests;
+        uint64_t failures;
+    };
+
+    explicit EventSocket(Options options);
+    ~EventSocket();
+
     EventSocket(const EventSocket &) = delete;
     EventSocket &operator=(const EventSocket &) = delete;
 
     static EventSocket &get_instance() {
-        static EventSocket handle;
+        static EventSocket handle(Options{});
         return handle;
     }
 
     void post_sync(const std::string &task_name, const std::string &event_id, const std::string &url,
-                   const std::string &data) {
-        std::lock_guard<std::mutex> glk(mtx_event_cache_);
-        event_cache_.emplace(EventObject{task_name, event_id, url, data});
-        cv_event_cache_.notify_one();
-    }
+                   const std::string &data);
+
+    /**
+     * @brief 设置发往 url 的单个 POST 最多合并的事件数，覆盖 Options::max_batch
+     */
+    void set_max_batch(const std::string &url, size_t max_batch);
+
+    size_t pending() const { return spool_.size(); }
+    Stats stats() const { return {delivered_, dropped_, requests_, failures_}; }
 
 private:
-    EventSocket() {
-        thraed_handle_ = std::make_unique<gddi::Thread>(
-            [this]() {
-                while (running_) {
-                    std::unique_lock<std::mutex> ulk(mtx_event_cache_);
-                    cv_event_cache_.wait(ulk, [&] { return !running_ || event_cache_.size() > 0; });
-
-                    if (!running_) return;
-                    auto element = event_cache_.front();
-                    event_cache_.pop();
-                    ulk.unlock();
-
-                    HttpRequestPtr req(new HttpRequest);
-                    req->method = HTTP_POST;
-                    req->url = element.url;
-                    req->headers["Content-Type"] = "application/json";
-                    req->body = element.buffer;
-                    req->timeout = 10;
-
-                    sync_client_.sendAsync(req, [this, element](const HttpResponsePtr &resp) {
-                        try {
-                            if (resp == nullptr || resp->status_code != 200) {
-                                spdlog::error("Post event request failed, task: {}, url: {}, "
-                                              "resp-code: {}, resp-msg: {}",
-                                              element.task_name, element.url,
-                                              resp ? resp->status_code : -1,
-                                              resp ? resp->status_message() : "nullptr");
-                            }
-                        } catch (std::exception &exception) { spdlog::error(exception.what()); }
-                    });
-                }
-            },
-            gddi::Thread::DtorAction::join);
-        thraed_handle_->start();
-    }
+    struct Receiver {
+        std::chrono::steady_clock::time_point failing_since;
+        std::chrono::steady_clock::time_point retry_at;
+        std::chrono::milliseconds backoff;
+    };
+
+    struct Job {
+        std::vector<EventObject> events;
+        std::vector<uint64_t> ids;
+    };
+
+    struct Result {
+        std::string url;
+        std::vector<uint64_t> ids;
+        bool delivered;
+    };
 
-    ~EventSocket() { running_ = false; }
+    void run();
+    void run_sender();
+    size_t max_batch(const std::string &url);
+
+    /**
+     * @brief 投递一批事件，返回 true 表示可以出队
+     */
+    bool deliver(hv::HttpClient &client, const std::vector<EventObject> &events);
 
 private:
-    hv::HttpClient sync_client_;
+    Options options_;
+    EventSpool spool_;
+
+    std::atomic_bool running_{true};
+    bool wakeup_{false};
+    std::mutex mtx_wakeup_;
+    std::condition_variable cv_wakeup_;// 分发线程：新事件或投递结果
+    std::condition_variable cv_jobs_;  // 发送线程：新任务
+    std::deque<Job> jobs_;
+    std::deque<Result> results_;
 
-    bool running_{true};
-    std::unique_ptr<gddi::Thread> thraed_handle_;
+    std::mutex mtx_batch_;
+    std::map<std::string, size_t> url_max_batch_;
 
-    std::mutex mtx_event_cache_;
-    std::condition_variable cv_event_cache_;
-    std::queue<EventObject> event_cache_;
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> failures_{0};
+
+    std::unique_ptr<gddi::Thread> thread_handle_;
+    std::vector<std::unique_ptr<gddi::Thread>> sender_handles_;
 };
 
 }// namespace network
-}// namespace gddi
\ No newline at end of file
+}// namespace gddi
+
+#endif
@@ -0,0 +1,444 @@
+#include "event_spool.h"
+#include "spdlog/spdlog.h"
+#include <boost/crc.hpp>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace gddi {
+namespace network {
+
+static const uint32_t kRecordMagic = 0x54564547;// "GEVT"
+static const size_t kHeaderSize = 12;             // magic, 长度, CRC32
+static const size_t kAckSize = 20;                // 段号, 偏移, CRC32
+static const size_t kParkedWindows = 64;          // 只记录位置的事件最多为 window 的倍数
+
+static uint32_t crc32(const char *data, size_t size) {
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+static void put_string(std::string &out, const std::string &value) {
+    uint32_t size = value.size();
+    out.append((const char *)&size, sizeof(size));
+    out.append(value);
+}
+
+static bool get_string(const char *&data, const char *end, std::string &value) {
+    uint32_t size;
+    if ((size_t)(end - data) < sizeof(size)) { return false; }
+    memcpy(&size, data, sizeof(size));
+    data += sizeof(size);
+    if ((size_t)(end - data) < size) { return false; }
+    value.assign(data, size);
+    data += size;
+    return true;
+}
+
+static bool write_all(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        auto written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static bool pread_all(int fd, char *data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        auto bytes = ::pread(fd, data, size, offset);
+        if (bytes < 0 && errno == EINTR) { continue; }
+        if (bytes <= 0) { return false; }
+        data += bytes;
+        size -= bytes;
+        offset += bytes;
+    }
+    return true;
+}
+
+EventSpool::EventSpool(Options options) : options_(std::move(options)) {
+    if (options_.window == 0) { options_.window = 1; }
+    if (!options_.directory.empty() && !open()) {
+        spdlog::error("Failed to open event spool: {}, events are kept in memory only", options_.directory);
+        if (write_fd_ >= 0) { ::close(write_fd_); }
+        if (ack_fd_ >= 0) { ::close(ack_fd_); }
+        write_fd_ = ack_fd_ = -1;
+        segments_.clear();
+        pending_ = 0;
+    }
+}
+
+EventSpool::~EventSpool() {
+    for (int fd : {write_fd_, read_fd_, ack_fd_}) {
+        if (fd >= 0) { ::close(fd); }
+    }
+}
+
+std::string EventSpool::segment_path(uint64_t seq) const {
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.spool", (unsigned long long)seq);
+    return options_.directory + name;
+}
+
+bool EventSpool::open() {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(options_.directory, ec);
+    if (ec) { return false; }
+
+    for (boost::filesystem::directory_iterator iter(options_.directory, ec), end; !ec && iter != end; ++iter) {
+        if (iter->path().extension() != ".spool") { continue; }
+        try {
+            auto seq = std::stoull(iter->path().stem().string(), nullptr, 16);
+            segments_[seq] = boost::filesystem::file_size(iter->path());
+        } catch (std::exception &) { continue; }
+    }
+    if (ec) { return false; }
+
+    ack_fd_ = ::open((options_.directory + "/ack").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (ack_fd_ < 0) { return false; }
+
+    // ack 损坏时从最早的段重放，宁可重复也不丢
+    char buffer[kAckSize];
+    uint32_t checksum = 0;
+    bool valid = pread_all(ack_fd_, buffer, kAckSize, 0);
+    if (valid) { memcpy(&checksum, buffer + 16, 4); }
+    if (valid && checksum == crc32(buffer, 16)) {
+        memcpy(&ack_.seq, buffer, 8);
+        memcpy(&ack_.offset, buffer + 8, 8);
+    } else {
+        ack_ = {segments_.empty() ? 0 : segments_.begin()->first, 0};
+    }
+
+    remove_segments();
+    for (auto &[seq, size] : segments_) { pending_ += scan_segment(seq, seq == ack_.seq ? ack_.offset : 0); }
+
+    if (segments_.empty()) {
+        read_ = {ack_.seq + 1, 0};
+    } else {
+        auto seq = segments_.begin()->first;
+        read_ = {seq, seq == ack_.seq ? ack_.offset : 0};
+    }
+
+    // 总是写入新的段，不在上次可能写坏的段后追加
+    uint64_t seq = std::max(ack_.seq, segments_.empty() ? 0 : segments_.rbegin()->first) + 1;
+    if (!open_segment(seq)) { return false; }
+
+    if (pending_ > 0) { spdlog::info("Event spool {}: {} pending events to replay", options_.directory, pending_); }
+    return true;
+}
+
+bool EventSpool::open_segment(uint64_t seq) {
+    if (write_fd_ >= 0) { ::close(write_fd_); }
+    write_fd_ = ::open(segment_path(seq).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (write_fd_ < 0) { return false; }
+    write_seq_ = seq;
+    segments_[seq] = 0;
+    return true;
+}
+
+size_t EventSpool::scan_segment(uint64_t seq, uint64_t offset) {
+    auto &size = segments_[seq];
+    int fd = ::open(segment_path(seq).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        size = 0;
+        return 0;
+    }
+
+    size_t count = 0;
+    EventObject event;
+    uint64_t next;
+    offset = std::min(offset, size);
+    while (read_record(fd, offset, size, event, next)) {
+        offset = next;
+        ++count;
+    }
+    ::close(fd);
+
+    if (offset < size) {
+        spdlog::warn("Event spool {}: drop {} bytes of torn or corrupt records", segment_path(seq), size - offset);
+        size = offset;
+    }
+    return count;
+}
+
+bool EventSpool::read_record(int fd, uint64_t offset, uint64_t limit, EventObject &event, uint64_t &next) const {
+    uint32_t header[3];
+    if (limit < offset + kHeaderSize || !pread_all(fd, (char *)header, kHeaderSize, offset)) { return false; }
+    if (header[0] != kRecordMagic || header[1] > limit - offset - kHeaderSize) { return false; }
+
+    std::string payload(header[1], '\0');
+    if (!pread_all(fd, &payload[0], payload.size(), offset + kHeaderSize)) { return false; }
+    if (crc32(payload.data(), payload.size()) != header[2]) { return false; }
+
+    const char *data = payload.data(), *end = data + payload.size();
+    if (!get_string(data, end, event.task_name) || !get_string(data, end, event.event_id)
+        || !get_string(data, end, event.url) || !get_string(data, end, event.buffer)) {
+        return false;
+    }
+    event.num_of_retries = 0;
+    next = offset + kHeaderSize + payload.size();
+    return true;
+}
+
+bool EventSpool::append(const EventObject &event) {
+    std::string record(kHeaderSize, '\0');
+    put_string(record, event.task_name);
+    put_string(record, event.event_id);
+    put_string(record, event.url);
+    put_string(record, event.buffer);
+    uint32_t header[3] = {kRecordMagic, uint32_t(record.size() - kHeaderSize), 0};
+    header[2] = crc32(record.data() + kHeaderSize, header[1]);
+    memcpy(&record[0], header, kHeaderSize);
+
+    std::lock_guard<std::mutex> glk(mutex_);
+    if (write_fd_ < 0) {
+        if (loaded_ >= options_.window) {
+            spdlog::warn("Event queue full, drop event: {}", window_.front().event.event_id);
+            set_acked(window_.front());
+            advance_ack();
+        }
+        push_window(event, {0, 0}, {0, 0}, true);
+        ++pending_;
+        return true;
+    }
+
+    auto segment_size = segments_[write_seq_];
+    if (segment_size > 0 && segment_size + record.size() > options_.segment_bytes) {
+        if (!open_segment(write_seq_ + 1)) {
+            spdlog::error("Failed to create event spool segment: {}", segment_path(write_seq_ + 1));
+            return false;
+        }
+        segment_size = 0;
+    }
+
+    // 内存中的事件已追上磁盘且窗口未满时直接缓存，不必再读回
+    fill_window();
+    bool cache = read_.seq == write_seq_ && read_.offset == segment_size && loaded_ < options_.window
+        && window_.size() < options_.window * kParkedWindows;
+
+    if (!write_all(write_fd_, record.data(), record.size())) {
+        spdlog::error("Failed to write event spool: {}, {}", segment_path(write_seq_), strerror(errno));
+        // 写了一半的记录留在段尾，换新段继续
+        open_segment(write_seq_ + 1);
+        return false;
+    }
+    if (options_.fsync) { fdatasync(write_fd_); }
+    segments_[write_seq_] = segment_size + record.size();
+    ++pending_;
+
+    if (cache) {
+        auto begin = read_;
+        read_.offset += record.size();
+        push_window(event, begin, read_, true);
+    }
+    return true;
+}
+
+void EventSpool::fill_window(const std::set<std::string> &skip_urls) {
+    if (write_fd_ < 0) { return; }
+
+    // 窗口满后，若其中的事件都属于跳过的 url，继续读取直到找到其他 url 的事件
+    while (window_.size() < options_.window * kParkedWindows) {
+        bool full = loaded_ >= options_.window;
+        if (full && !blocked(skip_urls)) { break; }
+
+        auto iter = segments_.lower_bound(read_.seq);
+        if (iter == segments_.end()) { break; }
+        if (iter->first != read_.seq) { read_ = {iter->first, 0}; }
+
+        if (read_.offset >= iter->second) {
+            if (std::next(iter) == segments_.end()) { break; }
+            read_ = {std::next(iter)->first, 0};
+            continue;
+        }
+
+        if (read_fd_ < 0 || read_fd_seq_ != read_.seq) {
+            if (read_fd_ >= 0) { ::close(read_fd_); }
+            read_fd_ = ::open(segment_path(read_.seq).c_str(), O_RDONLY | O_CLOEXEC);
+            read_fd_seq_ = read_.seq;
+        }
+
+        EventObject event;
+        uint64_t next;
+        if (read_fd_ < 0 || !read_record(read_fd_, read_.offset, iter->second, event, next)) {
+            // 写入后又被破坏，跳过本段剩余部分并重新统计
+            spdlog::error("Event spool {}: corrupt record at {}", segment_path(read_.seq), read_.offset);
+            iter->second = read_.offset;
+            pending_ = std::count_if(window_.begin(), window_.end(), [](const Cached &c) { return !c.acked; });
+            for (auto it = std::next(iter); it != segments_.end(); ++it) { pending_ += scan_segment(it->first, 0); }
+            continue;
+        }
+
+        auto begin = read_;
+        read_.offset = next;
+        bool loaded = !full || skip_urls.count(event.url) == 0;
+        push_window(std::move(event), begin, read_, loaded);
+    }
+}
+
+bool EventSpool::blocked(const std::set<std::string> &skip_urls) const {
+    size_t skipped = 0;
+    for (const auto &url : skip_urls) {
+        auto iter = url_loaded_.find(url);
+        if (iter != url_loaded_.end()) { skipped += iter->second; }
+    }
+    return skipped >= loaded_;
+}
+
+void EventSpool::push_window(EventObject event, Position begin, Position end, bool loaded) {
+    if (loaded) {
+        ++loaded_;
+        ++url_loaded_[event.url];
+    } else {
+        std::string().swap(event.buffer);
+    }
+    window_.push_back({std::move(event), begin, end, next_id_++, false, loaded});
+}
+
+bool EventSpool::load_event(const Cached &cached, EventObject &event) const {
+    auto iter = segments_.find(cached.begin.seq);
+    if (iter == segments_.end()) { return false; }
+
+    int fd = ::open(segment_path(cached.begin.seq).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { return false; }
+    uint64_t next;
+    bool success = read_record(fd, cached.begin.offset, iter->second, event, next);
+    ::close(fd);
+    return success;
+}
+
+void EventSpool::set_acked(Cached &cached) {
+    if (cached.acked) { return; }
+    cached.acked = true;
+    --pending_;
+    if (cached.loaded) {
+        cached.loaded = false;
+        --loaded_;
+        auto iter = url_loaded_.find(cached.event.url);
+        if (--iter->second == 0) { url_loaded_.erase(iter); }
+    }
+}
+
+size_t EventSpool::front(std::vector<EventObject> &events, std::vector<uint64_t> &ids, size_t max_events,
+                         size_t max_bytes, const std::set<std::string> &skip_urls) {
+    std::lock_guard<std::mutex> glk(mutex_);
+    events.clear();
+    ids.clear();
+    fill_window(skip_urls);
+
+    // 跳过其他 url 的事件，同一 url 内保持顺序
+    size_t bytes = 0;
+    bool corrupt = false;
+    for (auto &cached : window_) {
+        if (events.size() >= max_events) { break; }
+        if (cached.acked) { continue; }
+        if (events.empty() ? skip_urls.count(cached.event.url) > 0 : cached.event.url != events.front().url) {
+            continue;
+        }
+
+        EventObject event;
+        if (!cached.loaded && !load_event(cached, event)) {
+            spdlog::error("Event spool {}: corrupt record at {}", segment_path(cached.begin.seq),
+                          cached.begin.offset);
+            set_acked(cached);
+            corrupt = true;
+            continue;
+        }
+        const auto &source = cached.loaded ? cached.event : event;
+        if (!events.empty() && bytes + source.buffer.size() > max_bytes) { break; }
+        bytes += source.buffer.size();
+        events.push_back(source);
+        ids.push_back(cached.id);
+    }
+    if (corrupt) { advance_ack(); }
+    return events.size();
+}
+
+void EventSpool::ack(const std::vector<uint64_t> &ids) {
+    std::lock_guard<std::mutex> glk(mutex_);
+    for (auto id : ids) {
+        auto iter = std::lower_bound(window_.begin(), window_.end(), id,
+                                     [](const Cached &cached, uint64_t id) { return cached.id < id; });
+        if (iter != window_.end() && iter->id == id) { set_acked(*iter); }
+    }
+    advance_ack();
+}
+
+size_t EventSpool::ack_url(const std::string &url) {
+    std::lock_guard<std::mutex> glk(mutex_);
+    fill_window();
+
+    size_t count = 0;
+    for (auto &cached : window_) {
+        if (!cached.acked && cached.event.url == url) {
+            set_acked(cached);
+            ++count;
+        }
+    }
+    advance_ack();
+    return count;
+}
+
+void EventSpool::advance_ack() {
+    // 已确认的事件并入前一条，前一条确认后 ack 位置一并越过，窗口中不会积压未确认事件之后已确认的事件
+    std::deque<Cached> window;
+    for (auto &cached : window_) {
+        if (cached.acked && !window.empty()) {
+            window.back().end = cached.end;
+        } else {
+            window.push_back(std::move(cached));
+        }
+    }
+    window_.swap(window);
+    if (window_.empty() || !window_.front().acked) { return; }
+
+    auto end = window_.front().end;
+    window_.pop_front();
+
+    if (write_fd_ >= 0) {
+        ack_ = end;
+        save_ack();
+        remove_segments();
+    }
+}
+
+size_t EventSpool::size() const {
+    std::lock_guard<std::mutex> glk(mutex_);
+    return pending_;
+}
+
+void EventSpool::save_ack() {
+    char buffer[kAckSize];
+    memcpy(buffer, &ack_.seq, 8);
+    memcpy(buffer + 8, &ack_.offset, 8);
+    uint32_t checksum = crc32(buffer, 16);
+    memcpy(buffer + 16, &checksum, 4);
+    if (::pwrite(ack_fd_, buffer, kAckSize, 0) != (ssize_t)kAckSize) {
+        spdlog::error("Failed to write event spool ack: {}", strerror(errno));
+    }
+    if (options_.fsync) { fdatasync(ack_fd_); }
+}
+
+void EventSpool::remove_segments() {
+    for (auto iter = segments_.begin(); iter != segments_.end();) {
+        bool consumed = iter->first < ack_.seq || (iter->first == ack_.seq && ack_.offset >= iter->second);
+        if (!consumed || (write_fd_ >= 0 && iter->first == write_seq_)) { break; }
+
+        if (read_fd_ >= 0 && read_fd_seq_ == iter->first) {
+            ::close(read_fd_);
+            read_fd_ = -1;
+        }
+        ::unlink(segment_path(iter->first).c_str());
+        iter = segments_.erase(iter);
+    }
+}
+
+}// namespace network
+}// namespace gddi
@@ -0,0 +1,126 @@
+#ifndef __EVENT_SPOOL_H__
+#define __EVENT_SPOOL_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace gddi {
+namespace network {
+
+struct EventObject {
+    std::string task_name;
+    std::string event_id;
+    std::string url;
+    std::string buffer;
+    std::size_t num_of_retries{0};
+};
+
+/**
+ * @brief 待上报事件的磁盘队列，进程崩溃或重启后未确认的事件按原顺序重放
+ *
+ *        事件追加写入分段文件 <段号>.spool，每条记录带长度和 CRC32，打开时截断末尾写了一半的记录；
+ *        已确认位置 (段号, 偏移) 记录在 ack 文件中，整段确认后删除该段。
+ *        内存中最多缓存 window 条未确认的事件，其余留在磁盘上按需读取。
+ *        窗口中的事件都属于 front() 跳过的 url 时继续向后读取，跳过的 url 的事件只记录位置，
+ *        发送时再从磁盘读取，一个不可用的接收端不会占满窗口而阻塞其他 url。
+ *        directory 为空或无法创建时退化为内存队列，超过 window 丢弃最旧的事件。
+ *        窗口中的事件可以不按顺序确认，ack 文件只推进到连续确认的位置，重启后其后已确认的事件可能重发。
+ *        所有接口线程安全，但 front() / ack() 应由同一个发送线程调用
+ */
+class EventSpool {
+public:
+    struct Options {
+        std::string directory;
+        size_t segment_bytes{4 << 20};// 单个分段文件大小
+        size_t window{1024};          // 内存中缓存的未确认事件数
+        bool fsync{false};            // 每次写入后 fdatasync，防止掉电丢失
+    };
+
+    explicit EventSpool(Options options);
+    ~EventSpool();
+
+    EventSpool(const EventSpool &) = delete;
+    EventSpool &operator=(const EventSpool &) = delete;
+
+    bool append(const EventObject &event);
+
+    /**
+     * @brief 取窗口中第一个未确认且 url 不在 skip_urls 中的事件，以及其后同一 url 的未确认事件，
+     *        最多 max_events 条，总大小不超过 max_bytes（至少一条），不出队。ids 用于 ack()
+     */
+    size_t front(std::vector<EventObject> &events, std::vector<uint64_t> &ids, size_t max_events, size_t max_bytes,
+                 const std::set<std::string> &skip_urls = {});
+
+    /**
+     * @brief 确认 ids 对应的事件已送达或丢弃
+     */
+    void ack(const std::vector<uint64_t> &ids);
+
+    /**
+     * @brief 确认窗口中所有发往 url 的事件，返回确认的数量
+     */
+    size_t ack_url(const std::string &url);
+
+    size_t size() const;
+    bool persistent() const { return write_fd_ >= 0; }
+
+private:
+    struct Position {
+        uint64_t seq;
+        uint64_t offset;
+    };
+
+    struct Cached {
+        EventObject event;// 只记录位置时 buffer 为空
+        Position begin;
+        Position end;// 其后已确认并移出窗口的事件的结束位置
+        uint64_t id;
+        bool acked;
+        bool loaded;
+    };
+
+    bool open();
+    bool open_segment(uint64_t seq);
+    size_t scan_segment(uint64_t seq, uint64_t offset);
+    bool read_record(int fd, uint64_t offset, uint64_t limit, EventObject &event, uint64_t &next) const;
+    void fill_window(const std::set<std::string> &skip_urls = {});
+    bool blocked(const std::set<std::string> &skip_urls) const;
+    void push_window(EventObject event, Position begin, Position end, bool loaded);
+    bool load_event(const Cached &cached, EventObject &event) const;
+    void set_acked(Cached &cached);
+    void advance_ack();
+    void save_ack();
+    void remove_segments();
+    std::string segment_path(uint64_t seq) const;
+
+private:
+    Options options_;
+    mutable std::mutex mutex_;
+
+    std::map<uint64_t, uint64_t> segments_;// 段号 -> 有效长度
+    int write_fd_{-1};
+    uint64_t write_seq_{0};
+
+    int read_fd_{-1};
+    uint64_t read_fd_seq_{0};
+    Position read_{0, 0};// 下一条读入内存的记录
+    Position ack_{0, 0}; // 已确认的位置
+    int ack_fd_{-1};
+
+    std::deque<Cached> window_;// id 递增，除第一条外都未确认
+    uint64_t next_id_{0};
+    size_t pending_{0};                      // 未确认的事件数
+    size_t loaded_{0};                       // 窗口中已读入内存的未确认事件数
+    std::map<std::string, size_t> url_loaded_;// url -> 窗口中已读入内存的未确认事件数
+};
+
+}// namespace network
+}// namespace gddi
+
+#endif
@@ -0,0 +1,190 @@
+#include "upload_parser.h"
+#include "json.hpp"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <strings.h>
+
+namespace gddi {
+namespace network {
+
+static std::string_view trim(std::string_view value) {
+    while (!value.empty() && isspace((unsigned char)value.front())) { value.remove_prefix(1); }
+    while (!value.empty() && isspace((unsigned char)value.back())) { value.remove_suffix(1); }
+    return value;
+}
+
+/**
+ * @brief 取 "k1=v1; k2="v2"" 中 key 的值，去掉引号
+ */
+static std::string_view header_param(std::string_view header, std::string_view key) {
+    size_t pos = 0;
+    while (pos < header.size()) {
+        auto end = header.find(';', pos);
+        if (end == std::string_view::npos) { end = header.size(); }
+
+        auto item = trim(header.substr(pos, end - pos));
+        auto eq = item.find('=');
+        if (eq != std::string_view::npos && trim(item.substr(0, eq)).size() == key.size()
+            && strncasecmp(item.data(), key.data(), key.size()) == 0) {
+            auto value = trim(item.substr(eq + 1));
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+                value = value.substr(1, value.size() - 2);
+            }
+            return value;
+        }
+        pos = end + 1;
+    }
+    return {};
+}
+
+static bool parse_part_headers(std::string_view headers, FormPart &part) {
+    size_t pos = 0;
+    while (pos < headers.size()) {
+        auto end = headers.find("\r\n", pos);
+        if (end == std::string_view::npos) { end = headers.size(); }
+
+        auto line = headers.substr(pos, end - pos);
+        auto colon = line.find(':');
+        if (colon != std::string_view::npos) {
+            auto name = trim(line.substr(0, colon));
+            auto value = trim(line.substr(colon + 1));
+            if (name.size() == 19 && strncasecmp(name.data(), "Content-Disposition", 19) == 0) {
+                part.name = header_param(value, "name");
+                part.filename = header_param(value, "filename");
+            } else if (name.size() == 12 && strncasecmp(name.data(), "Content-Type", 12) == 0) {
+                part.content_type = value;
+            }
+        }
+        pos = end + 2;
+    }
+    return !part.name.empty();
+}
+
+bool parse_multipart(std::string_view content_type, std::string_view body, std::vector<FormPart> &parts) {
+    auto boundary = header_param(content_type, "boundary");
+    if (boundary.empty()) { return false; }
+
+    // 分隔符 "\r\n--boundary"，第一个分隔符前没有 "\r\n"
+    std::string delimiter = "\r\n--" + std::string(boundary);
+    std::boyer_moore_horspool_searcher searcher(delimiter.begin(), delimiter.end());
+
+    auto first = std::string_view(delimiter).substr(2);
+    size_t pos;
+    if (body.substr(0, first.size()) == first) {
+        pos = first.size();
+    } else {
+        auto iter = std::search(body.begin(), body.end(), searcher);
+        if (iter == body.end()) { return false; }
+        pos = iter - body.begin() + delimiter.size();
+    }
+
+    while (true) {
+        // 结束分隔符 "--boundary--"
+        if (body.substr(pos, 2) == "--") { return true; }
+        if (body.substr(pos, 2) != "\r\n") { return false; }
+        pos += 2;
+
+        auto header_end = body.find("\r\n\r\n", pos);
+        if (header_end == std::string_view::npos) { return false; }
+
+        auto iter = std::search(body.begin() + header_end + 4, body.end(), searcher);
+        if (iter == body.end()) { return false; }
+        size_t data_end = iter - body.begin();
+
+        FormPart part;
+        if (parse_part_headers(body.substr(pos, header_end - pos), part)) {
+            part.data = body.substr(header_end + 4, data_end - header_end - 4);
+            parts.emplace_back(part);
+        }
+        pos = data_end + delimiter.size();
+    }
+}
+
+/**
+ * @brief 只记录需要的字段，其它值直接丢弃
+ */
+class UploadSaxHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    UploadSaxHandler(std::map<std::string, RegionMap> &regions, std::string *image)
+        : regions_(regions), image_(image) {}
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t val) override { return on_number(val); }
+    bool number_unsigned(number_unsigned_t val) override { return on_number(val); }
+    bool number_float(number_float_t val, const string_t &) override { return on_number(val); }
+    bool binary(binary_t &) override { return true; }
+
+    bool string(string_t &val) override {
+        if (image_ && frames_.size() == 1 && frames_[0].key == "image") { *image_ = std::move(val); }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        frames_.push_back({false, {}});
+        return true;
+    }
+
+    bool key(string_t &val) override {
+        frames_.back().key = std::move(val);
+        return true;
+    }
+
+    bool end_object() override {
+        frames_.pop_back();
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        // root{name} -> {"regions_with_label"} -> {label} -> [points] -> [x, y]
+        if (in_regions()) {
+            if (frames_.size() == 3) {
+                current_points_ = &regions_[frames_[0].key][frames_[2].key];
+            } else if (frames_.size() == 4 && frames_[3].array && current_points_) {
+                current_points_->emplace_back();
+            }
+        }
+        frames_.push_back({true, {}});
+        return true;
+    }
+
+    bool end_array() override {
+        frames_.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override { return false; }
+
+private:
+    struct Frame {
+        bool array;
+        std::string key;
+    };
+
+    bool in_regions() const {
+        return frames_.size() >= 3 && !frames_[0].array && !frames_[1].array && !frames_[2].array
+            && frames_[1].key == "regions_with_label";
+    }
+
+    bool on_number(float val) {
+        if (frames_.size() == 5 && in_regions() && frames_[3].array && frames_[4].array && current_points_
+            && !current_points_->empty()) {
+            current_points_->back().push_back(val);
+        }
+        return true;
+    }
+
+    std::map<std::string, RegionMap> &regions_;
+    std::string *image_;
+    std::vector<Frame> frames_;
+    std::vector<std::vector<float>> *current_points_{nullptr};
+};
+
+bool parse_upload_json(std::string_view json, std::map<std::string, RegionMap> &regions, std::string *image) {
+    UploadSaxHandler handler(regions, image);
+    return nlohmann::json::sax_parse(json.begin(), json.end(), &handler);
+}
+
+}// namespace network
+}// namespace gddi
@@ -0,0 +1,47 @@
+#ifndef __UPLOAD_PARSER_H__
+#define __UPLOAD_PARSER_H__
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gddi {
+namespace network {
+
+/**
+ * @brief multipart/form-data 中的一段，各字段都指向原始 body，body 释放前有效
+ */
+struct FormPart {
+    std::string_view name;
+    std::string_view filename;
+    std::string_view content_type;
+    std::string_view data;
+};
+
+/**
+ * @brief 区域标签 -> 多边形顶点 [[x, y], ...]
+ */
+using RegionMap = std::map<std::string, std::vector<std::vector<float>>>;
+
+/**
+ * @brief 按 Content-Type 中的 boundary 拆分 multipart/form-data，不复制 body
+ * @return 格式错误时返回 false
+ */
+bool parse_multipart(std::string_view content_type, std::string_view body, std::vector<FormPart> &parts);
+
+/**
+ * @brief SAX 方式解析上传的 JSON，不构造 DOM
+ *
+ *        识别根对象下 {"<name>": {"regions_with_label": {"<label>": [[x, y], ...]}}}，结果按 name 存入 regions，
+ *        image 不为空时根对象下的 "image" 字符串直接移动到 image 中。
+ *        旧接口 {"image": "...", "additional": {...}} 的区域存在 regions["additional"] 中
+ *
+ * @return 格式错误时返回 false
+ */
+bool parse_upload_json(std::string_view json, std::map<std::string, RegionMap> &regions, std::string *image = nullptr);
+
+}// namespace network
+}// namespace gddi
+
+#endif//__UPLOAD_PARSER_H__
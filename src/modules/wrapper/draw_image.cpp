@@ -162,7 +162,7 @@ void DrawImage::draw_frame(const std::shared_ptr<nodes::FrameInfo> &frame_info)
     if (back_ext_info.algo_type == AlgoType::kDetection || back_ext_info.algo_type == AlgoType::kClassification) {
         for (const auto &[_, item] : back_ext_info.tracked_box) {
             auto color = back_ext_info.map_class_color.at(item.class_id);
-            graphics_->draw_rect(item.box, item.prob, back_ext_info.map_class_color[item.class_id], 2);
+            graphics_->draw_rect(item.box, item.prob, color, 2);
             graphics_->draw_text_fill(Point2i{(int)item.box.x - 3, (int)item.box.y - 20},
                                       back_ext_info.map_class_label.at(item.class_id) + " "
                                           + std::to_string(item.prob).substr(0, 4),
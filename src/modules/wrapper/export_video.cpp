@@ -74,19 +74,12 @@ void ExportVideo::write_frame(const std::shared_ptr<nodes::FrameInfo> &frame_inf
 
     av_image_fill_arrays(avframe->data, avframe->linesize, buffer.get(), AV_PIX_FMT_NV12, avframe->width,
                          avframe->height, 1);
-    SwsContext *conversion;
-    if (frame_info->tgt_frame.channels() == 3) {
-        conversion =
-            sws_getContext(frame_info->tgt_frame.cols, frame_info->tgt_frame.rows, AV_PIX_FMT_BGR24, avframe->width,
-                           avframe->height, AV_PIX_FMT_NV12, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-    } else {
-        conversion =
-            sws_getContext(frame_info->tgt_frame.cols, frame_info->tgt_frame.rows, AV_PIX_FMT_BGRA, avframe->width,
-                           avframe->height, AV_PIX_FMT_NV12, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-    }
-    sws_scale(conversion, &frame_info->tgt_frame.data, cvLinesizes, 0, frame_info->tgt_frame.rows, avframe->data,
+    auto src_format = frame_info->tgt_frame.channels() == 3 ? AV_PIX_FMT_BGR24 : AV_PIX_FMT_BGRA;
+    sws_ctx_ = sws_getCachedContext(sws_ctx_, frame_info->tgt_frame.cols, frame_info->tgt_frame.rows, src_format,
+                                    avframe->width, avframe->height, AV_PIX_FMT_NV12, SWS_FAST_BILINEAR, NULL, NULL,
+                                    NULL);
+    sws_scale(sws_ctx_, &frame_info->tgt_frame.data, cvLinesizes, 0, frame_info->tgt_frame.rows, avframe->data,
               avframe->linesize);
-    sws_freeContext(conversion);
     encoder_->encode_frame(avframe);
 #endif
 }
@@ -94,6 +87,8 @@ void ExportVideo::write_frame(const std::shared_ptr<nodes::FrameInfo> &frame_inf
 void ExportVideo::close_video() {
     encoder_->close_encoder();
     remuxer_->close_stream();
+    sws_freeContext(sws_ctx_);
+    sws_ctx_ = nullptr;
 }
 
 }// namespace gddi
\ No newline at end of file
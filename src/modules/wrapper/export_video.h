@@ -19,6 +19,7 @@ public:
 private:
     std::unique_ptr<av_wrapper::Encoder_v3> encoder_;
     std::unique_ptr<av_wrapper::Remuxer_v3> remuxer_;
+    SwsContext *sws_ctx_{nullptr};// 同一视频的帧尺寸不变，复用转换上下文
 };
 
 }// namespace gddi
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "image_decoder.h"
+#include "tsing_wrapper.hpp"
+#include <cstring>
+#include <opencv2/imgcodecs.hpp>
+#include <stdexcept>
+#include <vector>
+
+#if defined(WITH_TURBOJPEG)
+#include <turbojpeg.h>
+#endif
+
+#if defined(WITH_LIBPNG)
+#include <png.h>
+#endif
+
+namespace gddi {
+namespace image_wrapper {
+
+/**
+ * @brief 线程私有的中间帧，尺寸或格式变化时才重新分配
+ */
+static std::shared_ptr<AVFrame> thread_frame(AVPixelFormat format, int width, int height) {
+    thread_local std::shared_ptr<AVFrame> frame;
+    if (!frame || frame->format != format || frame->width != width || frame->height != height) {
+        frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+        frame->format = format;
+        frame->width = width;
+        frame->height = height;
+        if (av_frame_get_buffer(frame.get(), 32) < 0) { throw std::runtime_error("Failed to alloc decode frame"); }
+    }
+    return frame;
+}
+
+#if !defined(WITH_TURBOJPEG) || !defined(WITH_LIBPNG)
+/**
+ * @brief 未启用 libjpeg-turbo / libpng 时的全尺寸解码
+ */
+static std::shared_ptr<MemObject<AVFrame>> image_dec_opencv(ImagePool &mem_pool, const unsigned char *raw_image,
+                                                            size_t dsize) {
+    auto bgr = cv::imdecode(cv::Mat(1, dsize, CV_8UC1, (void *)raw_image), cv::ImreadModes::IMREAD_COLOR);
+    if (bgr.empty()) { throw std::runtime_error("Failed to decode image"); }
+
+    // 只借用 cv::Mat 的数据，转换完成前 bgr 一直有效
+    auto frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+    frame->format = AV_PIX_FMT_BGR24;
+    frame->width = bgr.cols;
+    frame->height = bgr.rows;
+    frame->data[0] = bgr.data;
+    frame->linesize[0] = bgr.step;
+    return image_from_avframe(mem_pool, frame);
+}
+#endif
+
+#if defined(WITH_TURBOJPEG)
+/**
+ * @brief 线程私有的解压句柄和色度平面
+ */
+class TurboJpegDecompressor {
+public:
+    TurboJpegDecompressor() : handle_(tjInitDecompress()) {}
+    ~TurboJpegDecompressor() {
+        if (handle_) { tjDestroy(handle_); }
+    }
+
+    std::shared_ptr<MemObject<AVFrame>> decode(ImagePool &mem_pool, const unsigned char *raw_image, size_t dsize,
+                                               int fit_width, int fit_height, int *src_width, int *src_height) {
+        if (!handle_) { throw std::runtime_error("Failed to init jpeg decompressor"); }
+
+        int width, height, subsamp, colorspace;
+        if (tjDecompressHeader3(handle_, raw_image, dsize, &width, &height, &subsamp, &colorspace) != 0) {
+            throw std::runtime_error(tjGetErrorStr2(handle_));
+        }
+        if (src_width) { *src_width = width; }
+        if (src_height) { *src_height = height; }
+
+        // 从 1/8 开始找第一个不需要放大的缩放系数
+        tjscalingfactor factor{1, 1};
+        if (fit_width > 0 && fit_height > 0) {
+            for (int denom : {8, 4, 2}) {
+                tjscalingfactor scale{1, denom};
+                if (TJSCALED(width, scale) >= fit_width || TJSCALED(height, scale) >= fit_height) {
+                    factor = scale;
+                    break;
+                }
+            }
+        }
+        int dst_width = TJSCALED(width, factor);
+        int dst_height = TJSCALED(height, factor);
+
+        // 偶数尺寸的 4:2:0 和灰度图直接写入 NV12，其它采样格式解码为 RGB 后转换
+        bool even = dst_width % 2 == 0 && dst_height % 2 == 0;
+        if ((subsamp == TJSAMP_420 && even) || subsamp == TJSAMP_GRAY) {
+            auto mem_obj = alloc_nv12_frame(mem_pool, dst_width, dst_height);
+            auto &frame = mem_obj->data;
+
+            int chroma_width = (dst_width + 1) / 2;
+            int chroma_height = (dst_height + 1) / 2;
+            u_plane_.resize(chroma_width * chroma_height);
+            v_plane_.resize(chroma_width * chroma_height);
+
+            unsigned char *planes[3] = {frame->data[0], u_plane_.data(), v_plane_.data()};
+            int strides[3] = {frame->linesize[0], chroma_width, chroma_width};
+            if (tjDecompressToYUVPlanes(handle_, raw_image, dsize, planes, dst_width, strides, dst_height,
+                                        TJFLAG_FASTDCT)
+                != 0) {
+                throw std::runtime_error(tjGetErrorStr2(handle_));
+            }
+
+            for (int y = 0; y < chroma_height; y++) {
+                uint8_t *uv = frame->data[1] + y * frame->linesize[1];
+                if (subsamp == TJSAMP_GRAY) {
+                    memset(uv, 128, chroma_width * 2);
+                    continue;
+                }
+                const uint8_t *u = u_plane_.data() + y * chroma_width;
+                const uint8_t *v = v_plane_.data() + y * chroma_width;
+                for (int x = 0; x < chroma_width; x++) {
+                    uv[2 * x] = u[x];
+                    uv[2 * x + 1] = v[x];
+                }
+            }
+            return mem_obj;
+        }
+
+        auto rgb = thread_frame(AV_PIX_FMT_RGB24, dst_width, dst_height);
+        if (tjDecompress2(handle_, raw_image, dsize, rgb->data[0], dst_width, rgb->linesize[0], dst_height, TJPF_RGB,
+                          TJFLAG_FASTDCT)
+            != 0) {
+            throw std::runtime_error(tjGetErrorStr2(handle_));
+        }
+        return image_from_avframe(mem_pool, rgb);
+    }
+
+private:
+    tjhandle handle_;
+    std::vector<uint8_t> u_plane_;
+    std::vector<uint8_t> v_plane_;
+};
+#endif
+
+bool image_jpeg_dec_available() {
+#if defined(WITH_TURBOJPEG)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool image_png_dec_available() {
+#if defined(WITH_LIBPNG)
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<MemObject<AVFrame>> image_jpeg_dec(ImagePool &mem_pool, const unsigned char *raw_image, size_t dsize,
+                                                   int fit_width, int fit_height, int *src_width, int *src_height) {
+#if defined(WITH_TURBOJPEG)
+    thread_local TurboJpegDecompressor decompressor;
+    return decompressor.decode(mem_pool, raw_image, dsize, fit_width, fit_height, src_width, src_height);
+#else
+    auto mem_obj = image_dec_opencv(mem_pool, raw_image, dsize);
+    if (src_width) { *src_width = mem_obj->data->width; }
+    if (src_height) { *src_height = mem_obj->data->height; }
+    return mem_obj;
+#endif
+}
+
+std::shared_ptr<MemObject<AVFrame>> image_png_dec(ImagePool &mem_pool, const unsigned char *raw_image, size_t dsize) {
+#if defined(WITH_LIBPNG)
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&image, raw_image, dsize)) { throw std::runtime_error(image.message); }
+
+    image.format = PNG_FORMAT_RGB;
+    auto rgb = thread_frame(AV_PIX_FMT_RGB24, image.width, image.height);
+    if (!png_image_finish_read(&image, nullptr, rgb->data[0], rgb->linesize[0], nullptr)) {
+        png_image_free(&image);
+        throw std::runtime_error(image.message);
+    }
+    return image_from_avframe(mem_pool, rgb);
+#else
+    return image_dec_opencv(mem_pool, raw_image, dsize);
+#endif
+}
+
+}// namespace image_wrapper
+}// namespace gddi
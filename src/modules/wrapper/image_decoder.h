@@ -0,0 +1,43 @@
+#ifndef __IMAGE_DECODER_H__
+#define __IMAGE_DECODER_H__
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+#include "../mem_pool.hpp"
+#include <cstddef>
+#include <memory>
+
+namespace gddi {
+
+using ImagePool = gddi::MemPool<AVFrame, int, int>;
+
+namespace image_wrapper {
+
+/**
+ * @brief 编译时是否启用了 libjpeg-turbo / libpng，未启用时使用 cv::imdecode 全尺寸解码
+ */
+bool image_jpeg_dec_available();
+bool image_png_dec_available();
+
+/**
+ * @brief thread-safe, 解码 JPEG 为 NV12，目标帧从 mem_pool 中复用，失败时抛出 std::runtime_error
+ *
+ *        fit_width/fit_height 大于 0 时在 DCT 域按 1/2、1/4、1/8 缩小解码，取按比例缩放到
+ *        fit_width x fit_height 时不需要放大的最小尺寸；4:2:0 的图像直接写入 NV12，不经过全尺寸 BGR。
+ *        src_width/src_height 返回原图尺寸，用于把结果坐标换算回原图
+ */
+std::shared_ptr<MemObject<AVFrame>> image_jpeg_dec(ImagePool &mem_pool, const unsigned char *raw_image, size_t dsize,
+                                                   int fit_width = 0, int fit_height = 0, int *src_width = nullptr,
+                                                   int *src_height = nullptr);
+
+/**
+ * @brief thread-safe, 解码 PNG 为 NV12，目标帧从 mem_pool 中复用，失败时抛出 std::runtime_error
+ */
+std::shared_ptr<MemObject<AVFrame>> image_png_dec(ImagePool &mem_pool, const unsigned char *raw_image, size_t dsize);
+
+}// namespace image_wrapper
+}// namespace gddi
+
+#endif//__IMAGE_DECODER_H__
@@ -0,0 +1,194 @@
+#include "jpeg_encoder.h"
+#include "common_basic/thread_worker.hpp"
+#include "tsing_jpeg_encode.h"
+#include <algorithm>
+#include <cstdio>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+#if defined(WITH_TURBOJPEG)
+#include <turbojpeg.h>
+#endif
+
+namespace codec {
+
+#if defined(WITH_TURBOJPEG)
+/**
+ * @brief 工作线程私有的压缩句柄，色度平面和输出缓冲按最大分辨率保留
+ */
+class TurboJpegCompressor {
+public:
+    TurboJpegCompressor() : handle_(tjInitCompress()) {}
+    ~TurboJpegCompressor() {
+        if (handle_) { tjDestroy(handle_); }
+        tjFree(jpeg_buf_);
+    }
+
+    bool encode(const AVFrame *frame, const int quality, std::vector<uint8_t> &jpeg_data) {
+        if (!handle_) { return false; }
+
+        const unsigned char *planes[3];
+        int strides[3];
+        int chroma_width = (frame->width + 1) / 2;
+        int chroma_height = (frame->height + 1) / 2;
+
+        if (frame->format == AV_PIX_FMT_NV12) {
+            // turbojpeg 只接受平面格式，拆分交错的 UV
+            u_plane_.resize(chroma_width * chroma_height);
+            v_plane_.resize(chroma_width * chroma_height);
+            for (int y = 0; y < chroma_height; y++) {
+                const uint8_t *uv = frame->data[1] + y * frame->linesize[1];
+                uint8_t *u = u_plane_.data() + y * chroma_width;
+                uint8_t *v = v_plane_.data() + y * chroma_width;
+                for (int x = 0; x < chroma_width; x++) {
+                    u[x] = uv[2 * x];
+                    v[x] = uv[2 * x + 1];
+                }
+            }
+            planes[0] = frame->data[0];
+            planes[1] = u_plane_.data();
+            planes[2] = v_plane_.data();
+            strides[0] = frame->linesize[0];
+            strides[1] = chroma_width;
+            strides[2] = chroma_width;
+        } else if (frame->format == AV_PIX_FMT_YUV420P || frame->format == AV_PIX_FMT_YUVJ420P) {
+            for (int i = 0; i < 3; i++) {
+                planes[i] = frame->data[i];
+                strides[i] = frame->linesize[i];
+            }
+        } else {
+            spdlog::error("TurboJpegCompressor: unsupported frame format: {}", frame->format);
+            return false;
+        }
+
+        auto buf_size = tjBufSize(frame->width, frame->height, TJSAMP_420);
+        if (buf_size > jpeg_buf_size_) {
+            tjFree(jpeg_buf_);
+            jpeg_buf_ = tjAlloc(buf_size);
+            jpeg_buf_size_ = jpeg_buf_ ? buf_size : 0;
+            if (!jpeg_buf_) { return false; }
+        }
+
+        unsigned long jpeg_size = jpeg_buf_size_;
+        if (tjCompressFromYUVPlanes(handle_, planes, frame->width, strides, frame->height, TJSAMP_420, &jpeg_buf_,
+                                    &jpeg_size, quality, TJFLAG_NOREALLOC | TJFLAG_FASTDCT)
+            != 0) {
+            spdlog::error("TurboJpegCompressor: {}", tjGetErrorStr2(handle_));
+            return false;
+        }
+
+        jpeg_data.assign(jpeg_buf_, jpeg_buf_ + jpeg_size);
+        return true;
+    }
+
+private:
+    tjhandle handle_;
+    unsigned char *jpeg_buf_{nullptr};
+    unsigned long jpeg_buf_size_{0};
+    std::vector<uint8_t> u_plane_;
+    std::vector<uint8_t> v_plane_;
+};
+#endif
+
+JpegEncodePool::JpegEncodePool(size_t thread_num)
+    : thread_num_(thread_num), workers_(std::make_unique<gddi::WorkerPool>("jpeg-enc", thread_num)) {}
+
+JpegEncodePool::~JpegEncodePool() {}
+
+JpegEncodePool &JpegEncodePool::get_instance() {
+    static JpegEncodePool instance(std::max(1u, std::thread::hardware_concurrency()));
+    return instance;
+}
+
+bool JpegEncodePool::available() {
+#if defined(WITH_TURBOJPEG)
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::future<std::vector<uint8_t>> JpegEncodePool::encode(const std::shared_ptr<AVFrame> &frame, const int quality,
+                                                         std::vector<uint8_t> buffer) {
+    auto task = std::make_shared<std::packaged_task<std::vector<uint8_t>()>>(
+        [frame, quality, buffer = std::move(buffer)]() mutable {
+#if defined(WITH_TURBOJPEG)
+            thread_local TurboJpegCompressor compressor;
+            if (!compressor.encode(frame.get(), quality, buffer)) { buffer.clear(); }
+#else
+            buffer.clear();
+#endif
+            return std::move(buffer);
+        });
+
+    auto result = task->get_future();
+    workers_->enqueue([task]() { (*task)(); });
+    return result;
+}
+
+JpegEncoder::JpegEncoder(std::string backend) : backend_(std::move(backend)) {
+    if (backend_ != "auto" && backend_ != "tsing" && backend_ != "cpu") {
+        spdlog::warn("Undefined jpeg encoder backend: {}, using auto", backend_);
+        backend_ = "auto";
+    }
+}
+
+JpegEncoder::~JpegEncoder() {}
+
+bool JpegEncoder::init_codecer(const uint32_t width, const uint32_t height, const int quality) {
+    width_ = width;
+    height_ = height;
+    quality_ = quality;
+
+    if (backend_ != "cpu") {
+        hw_encoder_ = std::make_unique<TsingJpegEncode>();
+        if (!hw_encoder_->init_codecer(width, height, quality)) {
+            hw_encoder_.reset();
+            if (backend_ == "tsing") { return false; }
+            spdlog::info("No idle jpeg encode channel, using cpu encoder");
+        }
+    }
+
+    return hw_encoder_ || JpegEncodePool::available();
+}
+
+uint32_t JpegEncoder::codec_image(const std::shared_ptr<AVFrame> &frame, std::vector<uint8_t> &jpeg_data,
+                                  const int quality) {
+    // 通道的质量创建后不能修改，质量不同时交给 CPU 线程池
+    bool hw_frame = hw_encoder_ && frame->width == (int)width_ && frame->height == (int)height_
+        && (quality == quality_ || backend_ == "tsing" || !JpegEncodePool::available());
+    if (hw_frame) {
+        std::unique_lock<std::mutex> lock(hw_mutex_, std::defer_lock);
+        // 只有硬件后端时等待通道空闲，否则转到 CPU 线程池
+        if (backend_ == "tsing" || !JpegEncodePool::available()) {
+            lock.lock();
+        } else {
+            lock.try_lock();
+        }
+
+        if (lock.owns_lock()) {
+            jpeg_data.resize(frame->width * frame->height);
+            auto jpeg_size = hw_encoder_->codec_image(frame, jpeg_data.data());
+            jpeg_data.resize(jpeg_size);
+            return jpeg_size;
+        }
+    }
+
+    if (backend_ == "tsing") { return 0; }
+    jpeg_data = JpegEncodePool::get_instance().encode(frame, quality, std::move(jpeg_data)).get();
+    return jpeg_data.size();
+}
+
+bool JpegEncoder::save_image(const std::shared_ptr<AVFrame> &frame, const std::string &path, const int quality) {
+    std::vector<uint8_t> jpeg_data;
+    if (codec_image(frame, jpeg_data, quality) == 0) { return false; }
+
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (fp == nullptr) { return false; }
+    fwrite(jpeg_data.data(), 1, jpeg_data.size(), fp);
+    fclose(fp);
+
+    return true;
+}
+
+}// namespace codec
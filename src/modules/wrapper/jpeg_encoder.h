@@ -0,0 +1,101 @@
+#ifndef __JPEG_ENCODER_H__
+#define __JPEG_ENCODER_H__
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gddi {
+class WorkerPool;
+}
+
+namespace codec {
+
+class TsingJpegEncode;
+
+/**
+ * @brief CPU JPEG 编码线程池 (libjpeg-turbo)
+ *
+ *        直接从 NV12/I420 平面编码，不转换为 BGR。每个工作线程持有自己的压缩句柄和缓冲区，
+ *        编码结果写入调用者传入的 buffer，多次调用间复用同一个 buffer 时不再分配内存。
+ */
+class JpegEncodePool {
+public:
+    JpegEncodePool(const JpegEncodePool &) = delete;
+    JpegEncodePool &operator=(const JpegEncodePool &) = delete;
+
+    /**
+     * @brief 进程内共享的线程池，线程数与 CPU 核数相同
+     */
+    static JpegEncodePool &get_instance();
+
+    /**
+     * @brief 编译时是否启用了 libjpeg-turbo
+     */
+    static bool available();
+
+    /**
+     * @brief thread-safe, 异步编码，失败时返回空的 buffer
+     */
+    std::future<std::vector<uint8_t>> encode(const std::shared_ptr<AVFrame> &frame, const int quality,
+                                             std::vector<uint8_t> buffer = {});
+
+    size_t thread_num() const { return thread_num_; }
+
+private:
+    explicit JpegEncodePool(size_t thread_num);
+    ~JpegEncodePool();
+
+private:
+    size_t thread_num_;
+    std::unique_ptr<gddi::WorkerPool> workers_;
+};
+
+/**
+ * @brief JPEG 编码器
+ *
+ *        backend:
+ *          auto  - 优先使用硬件编码通道，通道用尽或正在编码时转到 CPU 线程池 (默认)
+ *          tsing - 只使用硬件编码通道
+ *          cpu   - 只使用 CPU 线程池，不依赖加速卡
+ *
+ *        硬件通道按 init_codecer 的尺寸和质量创建，codec_image 的帧尺寸或 quality 与之不同时转到 CPU 线程池，
+ *        tsing 后端没有 CPU 线程池，按通道创建时的质量编码。
+ */
+class JpegEncoder {
+public:
+    explicit JpegEncoder(std::string backend = "auto");
+    ~JpegEncoder();
+
+    bool init_codecer(const uint32_t width, const uint32_t height, const int quality = 85);
+
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+
+    /**
+     * @brief thread-safe, 编码结果写入 jpeg_data，返回 JPEG 大小，失败时返回 0
+     */
+    uint32_t codec_image(const std::shared_ptr<AVFrame> &frame, std::vector<uint8_t> &jpeg_data,
+                         const int quality = 85);
+
+    bool save_image(const std::shared_ptr<AVFrame> &frame, const std::string &path, const int quality = 85);
+
+private:
+    std::string backend_;
+    uint32_t width_{0};
+    uint32_t height_{0};
+    int quality_{85};
+
+    std::unique_ptr<TsingJpegEncode> hw_encoder_;
+    std::mutex hw_mutex_;// 硬件通道同一时间只编码一帧
+};
+
+}// namespace codec
+
+#endif//__JPEG_ENCODER_H__
@@ -192,6 +192,7 @@ int jpeg_encode_init(JPEG_CONFIG_S *init_para) {
     usr_custom.venc_chn_cfg.enType = PT_JPEG;
     usr_custom.venc_chn_cfg.stSize.u32Width = pInSize.u32Width;
     usr_custom.venc_chn_cfg.stSize.u32Height = pInSize.u32Height;
+    usr_custom.venc_chn_cfg.fixQp = init_para->quality;
 
     ret = jpeg_jenc_start(jenc_chn, &usr_custom.venc_chn_cfg);
     if (TS_SUCCESS != ret) {
@@ -576,7 +577,7 @@ void show_running_fan(void) {
 }
 #endif
 
-static int set_chn_attr(VENC_CHN_ATTR_S *attr, int picWidth, int picHeight) {
+static int set_chn_attr(VENC_CHN_ATTR_S *attr, int picWidth, int picHeight, unsigned int qfactor) {
     JPEG_PRT("%s called!", __FUNCTION__);
 
     //	attr->stVencAttr.enType = _PT_JPEG;
@@ -601,7 +602,7 @@ static int set_chn_attr(VENC_CHN_ATTR_S *attr, int picWidth, int picHeight) {
     attr->stVencAttr.stAttrJpege.stMPFCfg.astLargeThumbNailSize[0].u32Height = 10;
     attr->stVencAttr.stAttrJpege.stMPFCfg.astLargeThumbNailSize[1].u32Width = 12;
     attr->stVencAttr.stAttrJpege.stMPFCfg.astLargeThumbNailSize[1].u32Height = 12;
-    attr->stRcAttr.stMjpegFixQp.u32Qfactor = 80;
+    attr->stRcAttr.stMjpegFixQp.u32Qfactor = qfactor == 0 ? 80 : (qfactor > 99 ? 99 : qfactor);// [1, 99]
 
     JPEG_PRT("%s exit!", __FUNCTION__);
     return 0;
@@ -644,7 +645,8 @@ static TS_S32 JPEG_CreatEx(VENC_CHN VencChn, JPEG_CHN_CONFIG_S *pChnCfg) {
     }
 
     if (stVencChnAttr.stVencAttr.enType == PT_JPEG) {
-        set_chn_attr(&stVencChnAttr, stVencChnAttr.stVencAttr.u32PicWidth, stVencChnAttr.stVencAttr.u32PicHeight);
+        set_chn_attr(&stVencChnAttr, stVencChnAttr.stVencAttr.u32PicWidth, stVencChnAttr.stVencAttr.u32PicHeight,
+                     pChnCfg->fixQp);
     }
 
     s32Ret = TS_MPI_VENC_CreateChn(VencChn, &stVencChnAttr);
@@ -1030,7 +1032,7 @@ TsingJpegEncode::~TsingJpegEncode() {
     }
 }
 
-bool TsingJpegEncode::init_codecer(const uint32_t width, const uint32_t height) {
+bool TsingJpegEncode::init_codecer(const uint32_t width, const uint32_t height, const uint32_t quality) {
     init_para_.jpeg_chn = -1;
 
     {
@@ -1049,6 +1051,7 @@ bool TsingJpegEncode::init_codecer(const uint32_t width, const uint32_t height)
     init_para_.image_width = width;
     init_para_.image_height = height;
     init_para_.consume_type = JPEG_COPY;
+    init_para_.quality = quality;
     jpeg_encode_init(&init_para_);
 
     return true;
@@ -97,6 +97,7 @@ typedef struct tsJPEG_CONFIG_S {
     unsigned int image_height;
     unsigned int jpeg_chn;
     enum JPEG_CONSUME_TYPE consume_type;
+    unsigned int quality; // Qfactor [1, 99], 0 为默认值 80
 } JPEG_CONFIG_S;
 
 typedef struct tsJPEG_CONFIG_MULTI_S {
@@ -147,7 +148,7 @@ public:
     TsingJpegEncode();
     ~TsingJpegEncode();
 
-    bool init_codecer(const uint32_t width, const uint32_t height);
+    bool init_codecer(const uint32_t width, const uint32_t height, const uint32_t quality = 80);
     uint32_t codec_image(const std::shared_ptr<AVFrame> &frame, const uint8_t *jpeg_data);
     bool save_image(const std::shared_ptr<AVFrame> &frame, const std::string &path);
 
@@ -11,6 +11,7 @@ extern "C" {
 
 #include "../mem_pool.hpp"
 #include "core/mem/buf_surface_util.h"
+#include "image_decoder.h"
 #include "types.hpp"
 #include <fstream>
 #include <map>
@@ -20,15 +21,13 @@ extern "C" {
 #include <opencv2/imgcodecs/imgcodecs.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "tscv_operator.h"
 #include "tsing_jpeg_encode.h"
 
 namespace gddi {
-
-using ImagePool = gddi::MemPool<AVFrame, int, int>;
-
 namespace image_wrapper {
 
 static bool preview_init = false;
@@ -48,24 +47,6 @@ inline AVPixelFormat convert_deprecated_format(enum AVPixelFormat format) {
     }
 }
 
-static std::shared_ptr<AVFrame> image_jpeg_dec(const unsigned char *raw_image, size_t dsize) {
-    // auto vec_data = std::vector<uchar>(dsize);
-    // memcpy(vec_data.data(), raw_image, dsize);
-
-    // auto mat_image = std::make_shared<cv::Mat>();
-    // *mat_image = cv::imdecode(vec_data, cv::ImreadModes::IMREAD_COLOR);
-    return nullptr;
-}
-
-static std::shared_ptr<AVFrame> image_png_dec(const unsigned char *raw_image, size_t dsize) {
-    auto vec_data = std::vector<uchar>(dsize);
-    memcpy(vec_data.data(), raw_image, dsize);
-
-    auto mat_image = std::make_shared<cv::Mat>();
-    *mat_image = cv::imdecode(vec_data, cv::ImreadModes::IMREAD_COLOR);
-    return nullptr;
-}
-
 static auto image_resize(const std::shared_ptr<AVFrame> &frame, int width, int height) {
     // auto resize_image = cv::Mat(frame->height, frame->width, CV_8UC3);
     // const int dstStride[] = {(int)resize_image.step1()};
@@ -140,25 +121,75 @@ static cv::Mat yuv420p_to_bgr888(const cv::Mat &image) {
     return bgr;
 }
 
+/**
+ * @brief 按 (宽高, 源格式) 缓存的 NV12 转换上下文，每个线程一份，不需要加锁
+ */
+class SwsContextCache {
+public:
+    ~SwsContextCache() {
+        for (auto &item : contexts_) { sws_freeContext(item.second); }
+    }
+
+    SwsContext *get(int width, int height, AVPixelFormat src_format) {
+        auto key = std::make_tuple(width, height, src_format);
+        auto iter = contexts_.find(key);
+        if (iter != contexts_.end()) { return iter->second; }
+
+        if (contexts_.size() >= kMaxContexts) {
+            for (auto &item : contexts_) { sws_freeContext(item.second); }
+            contexts_.clear();
+        }
+
+        auto sws_ctx = sws_getContext(width, height, src_format, width, height, AV_PIX_FMT_NV12, SWS_BICUBIC,
+                                      nullptr, nullptr, nullptr);
+        if (sws_ctx) { contexts_[key] = sws_ctx; }
+        return sws_ctx;
+    }
+
+    static SwsContextCache &thread_instance() {
+        thread_local SwsContextCache cache;
+        return cache;
+    }
+
+private:
+    static constexpr size_t kMaxContexts = 16;
+    std::map<std::tuple<int, int, AVPixelFormat>, SwsContext *> contexts_;
+};
+
+/**
+ * @brief 从 mem_pool 中取可写的 NV12 帧，稳定分辨率下不再分配帧内存
+ */
+static std::shared_ptr<MemObject<AVFrame>> alloc_nv12_frame(ImagePool &mem_pool, int width, int height) {
+    auto mem_obj = mem_pool.alloc_mem_attach(width, height);
+    auto &dst_frame = mem_obj->data;
+
+    // 新申请、尺寸变化或者帧仍被其它地方引用时重新分配
+    if (!dst_frame->buf[0] || dst_frame->width != width || dst_frame->height != height || dst_frame.use_count() > 1
+        || !av_frame_is_writable(dst_frame.get())) {
+        dst_frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
+        dst_frame->format = AV_PIX_FMT_NV12;
+        dst_frame->width = width;
+        dst_frame->height = height;
+        if (av_frame_get_buffer(dst_frame.get(), 1) < 0) { throw std::runtime_error("Failed to alloc NV12 frame"); }
+    }
+
+    return mem_obj;
+}
+
+/**
+ * @brief 转换为 NV12，NV12 帧直接引用；其它格式的目标帧从 mem_pool 中复用，稳定解码时不再分配帧内存
+ */
 static std::shared_ptr<MemObject<AVFrame>> image_from_avframe(ImagePool &mem_pool,
                                                               const std::shared_ptr<AVFrame> &frame) {
-    auto mem_obj = mem_pool.alloc_mem_detach(frame->width, frame->height);
-
-    if (frame->format == AV_PIX_FMT_NV12) {
-        mem_obj->data = frame;
-    } else {
-        mem_obj->data = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame *ptr) { av_frame_free(&ptr); });
-        mem_obj->data->format = AV_PIX_FMT_NV12;
-        mem_obj->data->width = frame->width;
-        mem_obj->data->height = frame->height;
-        av_frame_get_buffer(mem_obj->data.get(), 1);
-
-        auto sws_ctx = sws_getContext(frame->width, frame->height, AV_PIX_FMT_YUV420P, frame->width, frame->height,
-                                      AV_PIX_FMT_NV12, SWS_BICUBIC, nullptr, nullptr, nullptr);
-        sws_scale(sws_ctx, frame->data, frame->linesize, 0, frame->height, mem_obj->data->data,
-                  mem_obj->data->linesize);
-        sws_freeContext(sws_ctx);
-    }
+    if (frame->format == AV_PIX_FMT_NV12) { return std::make_shared<MemObject<AVFrame>>(frame); }
+
+    auto mem_obj = alloc_nv12_frame(mem_pool, frame->width, frame->height);
+    auto &dst_frame = mem_obj->data;
+
+    auto sws_ctx = SwsContextCache::thread_instance().get(frame->width, frame->height,
+                                                          convert_deprecated_format((AVPixelFormat)frame->format));
+    if (!sws_ctx) { throw std::runtime_error("Failed to get SwsContext"); }
+    sws_scale(sws_ctx, frame->data, frame->linesize, 0, frame->height, dst_frame->data, dst_frame->linesize);
 
     return mem_obj;
 }
@@ -46,6 +46,9 @@ private:
     }
 
     void parse_nodes(const nlohmann::json &j) {
+        if (j.contains("executor") && j.at("executor").get<std::string>() == "pool") {
+            executor_ = RunnerExecutor::shared_instance();
+        }
         if (j.contains("nodes")) {
             auto nodes = j.at("nodes");
             for (const auto &n : nodes) {
@@ -141,7 +144,7 @@ private:
     std::shared_ptr<gddi::ngraph::Runner> &get_runner(const std::string &name) {
         if (runners_.count(name) == 0) {
 
-            runners_[name] = std::make_shared<gddi::ngraph::Runner>(name);
+            runners_[name] = std::make_shared<gddi::ngraph::Runner>(name, executor_);
             runners_[name]->set_quit_listener([this](int code) {
                 for (const auto &r: runners_) {
                     r.second->post_quit_loop(code);
@@ -173,6 +176,7 @@ protected:
     int quit_code_{};
     std::unordered_map<int, std::shared_ptr<gddi::ngraph::NodeAny>> nodes_;
     std::unordered_map<std::string, std::shared_ptr<gddi::ngraph::Runner>> runners_;
+    std::shared_ptr<RunnerExecutor> executor_;
 };
 
 }
@@ -0,0 +1,199 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef INFERENCE_ENGINE_SRC_NODE_METRICS_HPP_
+#define INFERENCE_ENGINE_SRC_NODE_METRICS_HPP_
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gddi {
+namespace ngraph {
+namespace metrics {
+
+/**
+ * @brief 按 2 的幂分桶的耗时直方图(微秒)，只使用 relaxed 原子操作，写入端开销可以忽略
+ */
+class Histogram {
+public:
+    static constexpr int kBuckets = 24;// [0, 1us], (1us, 2us] ... (4.2s, 8.4s], +Inf
+
+    struct Snapshot {
+        std::array<uint64_t, kBuckets + 1> buckets{};// 最后一个桶为 +Inf
+        uint64_t count{0};
+        uint64_t sum_us{0};
+
+        double average_us() const { return count ? (double)sum_us / count : 0; }
+
+        /**
+         * @brief 按桶上界估算分位数
+         */
+        uint64_t percentile_us(double q) const {
+            if (count == 0) { return 0; }
+            auto target = (uint64_t)(q * count);
+            uint64_t accumulated = 0;
+            for (int i = 0; i < kBuckets; i++) {
+                accumulated += buckets[i];
+                if (accumulated > target) { return bucket_upper_us(i); }
+            }
+            return bucket_upper_us(kBuckets - 1);
+        }
+    };
+
+    static uint64_t bucket_upper_us(int idx) { return uint64_t(1) << idx; }
+
+    void record(int64_t us) {
+        if (us < 0) { us = 0; }
+        int idx = 0;
+        while (idx < kBuckets && (uint64_t)us > bucket_upper_us(idx)) { idx++; }
+        buckets_[idx].fetch_add(1, std::memory_order_relaxed);
+        sum_us_.fetch_add((uint64_t)us, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<class Duration_>
+    void record(const Duration_ &duration) {
+        record((int64_t)std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    }
+
+    Snapshot snapshot() const {
+        Snapshot snapshot;
+        for (int i = 0; i <= kBuckets; i++) { snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed); }
+        snapshot.count = count_.load(std::memory_order_relaxed);
+        snapshot.sum_us = sum_us_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    std::array<std::atomic_uint64_t, kBuckets + 1> buckets_{};
+    std::atomic_uint64_t count_{0};
+    std::atomic_uint64_t sum_us_{0};
+};
+
+/**
+ * @brief 每个端点的消息计数，超出范围的端点计入最后一个
+ */
+class EndpointCounters {
+public:
+    static constexpr int kMaxEndpoints = 16;
+
+    void inc(int endpoint) {
+        if (endpoint < 0) { return; }
+        if (endpoint >= kMaxEndpoints) { endpoint = kMaxEndpoints - 1; }
+        counters_[endpoint].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::vector<uint64_t> snapshot() const {
+        std::vector<uint64_t> values;
+        for (const auto &c : counters_) { values.push_back(c.load(std::memory_order_relaxed)); }
+        while (!values.empty() && values.back() == 0) { values.pop_back(); }
+        return values;
+    }
+
+private:
+    std::array<std::atomic_uint64_t, kMaxEndpoints> counters_{};
+};
+
+struct NodeMetrics {
+    Histogram queue_wait;     // 消息在 Runner 队列中的等待时间
+    Histogram handle_time;    // 消息处理耗时
+    EndpointCounters input;   // 输入消息数
+    EndpointCounters output;  // 输出消息数
+};
+
+struct EdgeStats {
+    const void *to_;
+    int from_ep_;
+    int to_ep_;
+    uint64_t messages;
+};
+
+/**
+ * @brief Prometheus 文本格式输出，按指标名归组，保证每个指标的 HELP/TYPE 只输出一次
+ */
+class PrometheusText {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    void add(const std::string &family, const std::string &type, const std::string &help, const Labels &labels,
+             double value, const std::string &suffix = {}) {
+        auto &f = families_[family];
+        f.type = type;
+        f.help = help;
+        std::ostringstream oss;
+        oss << family << suffix << format_labels(labels) << " " << value << "\n";
+        f.lines += oss.str();
+    }
+
+    void add_histogram(const std::string &family, const std::string &help, const Labels &labels,
+                       const Histogram::Snapshot &snapshot) {
+        uint64_t accumulated = 0;
+        for (int i = 0; i <= Histogram::kBuckets; i++) {
+            accumulated += snapshot.buckets[i];
+            auto bucket_labels = labels;
+            bucket_labels.emplace_back(
+                "le", i < Histogram::kBuckets ? format_seconds(Histogram::bucket_upper_us(i)) : "+Inf");
+            add(family, "histogram", help, bucket_labels, (double)accumulated, "_bucket");
+        }
+        add(family, "histogram", help, labels, snapshot.sum_us / 1e6, "_sum");
+        add(family, "histogram", help, labels, (double)snapshot.count, "_count");
+    }
+
+    std::string str() const {
+        std::ostringstream oss;
+        for (const auto &f : families_) {
+            oss << "# HELP " << f.first << " " << f.second.help << "\n";
+            oss << "# TYPE " << f.first << " " << f.second.type << "\n";
+            oss << f.second.lines;
+        }
+        return oss.str();
+    }
+
+private:
+    static std::string format_seconds(uint64_t us) {
+        std::ostringstream oss;
+        oss << us / 1e6;
+        return oss.str();
+    }
+
+    static std::string format_labels(const Labels &labels) {
+        if (labels.empty()) { return {}; }
+        std::string text = "{";
+        for (size_t i = 0; i < labels.size(); i++) {
+            if (i) { text += ","; }
+            text += labels[i].first + "=\"";
+            for (auto c : labels[i].second) {
+                if (c == '\\' || c == '"') {
+                    text += '\\';
+                    text += c;
+                } else if (c == '\n') {
+                    text += "\\n";
+                } else {
+                    text += c;
+                }
+            }
+            text += "\"";
+        }
+        return text + "}";
+    }
+
+    struct Family {
+        std::string type;
+        std::string help;
+        std::string lines;
+    };
+    std::map<std::string, Family> families_;
+};
+
+}// namespace metrics
+}// namespace ngraph
+}// namespace gddi
+
+#endif//INFERENCE_ENGINE_SRC_NODE_METRICS_HPP_
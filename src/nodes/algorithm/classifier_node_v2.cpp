@@ -5,7 +5,7 @@ namespace gddi {
 namespace nodes {
 
 void Classifier_v2::on_setup() {
-    classifier_ = algo::make_algo_impl();
+    classifier_ = algo::ModelRegistry::get_instance().acquire(parms_);
 
     classifier_->register_init_callback([this](const std::vector<std::string> &vec_labels) {
         try {
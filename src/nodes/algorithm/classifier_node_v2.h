@@ -6,7 +6,7 @@
 #define __CLASSIFICATION_NODE_V2_H__
 
 #include "message_templates.hpp"
-#include "modules/algorithm/algo_factory.h"
+#include "modules/algorithm/model_registry.h"
 #include "node_any_basic.hpp"
 #include "node_msg_def.h"
 
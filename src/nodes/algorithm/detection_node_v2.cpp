@@ -7,7 +7,7 @@ namespace gddi {
 namespace nodes {
 
 void Detection_v2::on_setup() {
-    detecter_ = algo::make_algo_impl();
+    detecter_ = algo::ModelRegistry::get_instance().acquire(parms_);
 
     detecter_->register_init_callback([this](const std::vector<std::string> &vec_labels) {
         try {
@@ -1,5 +1,6 @@
 #include "inference_node_v2.h"
 #include "algorithm/abstract_algo.h"
+#include "algorithm/batch_inference.h"
 #include "common_basic/thread_dbg_utils.hpp"
 #include "node_struct_def.h"
 #include <chrono>
@@ -20,48 +21,41 @@ void Inference_v2::on_setup() {
             std::mutex infer_mtx;
             std::map<int64_t, std::shared_ptr<msgs::cv_frame>> infer_frames;
 
-            auto algo_impl = algo::make_algo_impl();
-
-            algo_impl->register_init_callback([this](const std::vector<std::string> &vec_labels) {
-                try {
-                    int index = 0;
-                    if (mod_label_objs_.count("all")) {
-                        for (auto &item : vec_labels) {
-                            map_class_label_[index] = item;
-                            map_class_color_[index] = {0, 0, 255, int(255 * 0.8)};
-                            index++;
-                        }
-                    } else {
-                        for (auto &item : vec_labels) {
-                            if (mod_label_objs_.count(item) > 0 && mod_label_objs_[item]["checked"].get<bool>()) {
-                                map_class_label_[index] = mod_label_objs_[item]["label"].get<std::string>();
-                                auto color = mod_label_objs_[item]["color"].get<std::vector<int>>();
-                                map_class_color_[index] = {color[0], color[1], color[2], int(255 * 0.8)};
-                            }
-                            index++;
-                        }
-                    }
-                } catch (const std::exception &e) {
-                    spdlog::error(e.what());
-                    quit_runner_(TaskErrorCode::kInference);
+            algo::InferCallback infer_callback = [this, &infer_mtx, &infer_frames](
+                                                     const int64_t frame_idx, const AlgoType type,
+                                                     const std::vector<algo::AlgoOutput> &vec_output) {
+                std::shared_ptr<msgs::cv_frame> frame;
+                {
+                    std::lock_guard<std::mutex> lck(infer_mtx);
+                    frame = infer_frames.at(frame_idx);
+                    infer_frames.erase(frame_idx);
                 }
-            });
 
-            algo_impl->register_infer_callback(
-                [this, &infer_mtx, &infer_frames](const int64_t frame_idx, const AlgoType type,
-                                                  const std::vector<algo::AlgoOutput> &vec_output) {
-                    std::shared_ptr<msgs::cv_frame> frame;
-                    {
-                        std::lock_guard<std::mutex> lck(infer_mtx);
-                        frame = infer_frames.at(frame_idx);
-                        infer_frames.erase(frame_idx);
-                    }
-
-                    frame->frame_info->ext_info.emplace_back(parser_output(type, vec_output));
-                    output_result_(frame);
-                });
+                frame->frame_info->ext_info.emplace_back(parser_output(type, vec_output));
+                output_result_(frame);
+            };
 
-            auto future = std::async(std::launch::async, [&algo_impl, this]() { return algo_impl->init(parms_); });
+            // 模型由所有任务共享，batch_size > 1 时同时共享批量推理服务
+            std::unique_ptr<algo::AbstractAlgo> algo_impl;
+            std::shared_ptr<algo::BatchInferenceService::Client> batch_client;
+            std::shared_future<bool> future;
+            if (parms_.batch_size > 1) {
+                batch_client = std::make_shared<algo::BatchInferenceService::Client>(
+                    algo::BatchInferenceService::acquire(parms_), infer_callback);
+                future = std::async(std::launch::async, [service = batch_client->service(), this]() {
+                             auto loaded = service->ready().get();
+                             if (loaded) { init_labels_(service->labels()); }
+                             return loaded;
+                         }).share();
+            } else {
+                algo_impl = algo::ModelRegistry::get_instance().acquire(parms_, i);
+                algo_impl->register_init_callback(
+                    [this](const std::vector<std::string> &vec_labels) { init_labels_(vec_labels); });
+                algo_impl->register_infer_callback(infer_callback);
+                future = std::async(std::launch::async, [&algo_impl, this]() {
+                             return algo_impl->init(parms_);
+                         }).share();
+            }
 
             std::shared_ptr<msgs::cv_frame> frame;
             while (active) {
@@ -76,8 +70,11 @@ void Inference_v2::on_setup() {
                         if (frame->task_type == TaskType::kImage || frame->task_type == TaskType::kAsyncImage
                             || frame->task_type == TaskType::kVideo) {
                             future.get();
+                            future = {};
                         } else if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-                            if (!future.get()) {
+                            auto loaded = future.get();
+                            future = {};
+                            if (!loaded) {
                                 // 模型加载失败
                                 quit_runner_(TaskErrorCode::kInference);
                                 break;
@@ -103,7 +100,10 @@ void Inference_v2::on_setup() {
                             }
 
                             // 一阶段
-                            if (frame->task_type == TaskType::kImage || frame->task_type == TaskType::kAsyncImage) {
+                            if (batch_client) {
+                                batch_client->submit(frame->task_name, frame->frame_info);
+                            } else if (frame->task_type == TaskType::kImage
+                                       || frame->task_type == TaskType::kAsyncImage) {
                                 algo_impl->inference(frame->task_name, frame->frame_info, algo::InferType::kSync);
                             } else {
                                 algo_impl->inference(frame->task_name, frame->frame_info, algo::InferType::kAsync);
@@ -111,7 +111,10 @@ void Inference_v2::on_setup() {
                         } else {
                             // 多阶段
                             std::map<int, std::vector<algo::AlgoOutput>> outputs;
-                            auto algo_type = algo_impl->inference(frame->task_name, frame->frame_info, outputs);
+                            auto algo_type =
+                                batch_client
+                                    ? batch_client->service()->inference(frame->task_name, frame->frame_info, outputs)
+                                    : algo_impl->inference(frame->task_name, frame->frame_info, outputs);
                             frame->frame_info->ext_info.emplace_back(
                                 parser_output(algo_type, frame->frame_info->ext_info.back(), outputs));
                             output_result_(frame);
@@ -123,6 +126,42 @@ void Inference_v2::on_setup() {
     }
 }
 
+void Inference_v2::init_labels_(const std::vector<std::string> &vec_labels) {
+    try {
+        std::map<int, std::string> class_label;
+        std::map<int, std::vector<int>> class_color;
+        int index = 0;
+        if (mod_label_objs_.count("all")) {
+            for (auto &item : vec_labels) {
+                class_label[index] = item;
+                class_color[index] = {0, 0, 255, int(255 * 0.8)};
+                index++;
+            }
+        } else {
+            for (auto &item : vec_labels) {
+                if (mod_label_objs_.count(item) > 0 && mod_label_objs_[item]["checked"].get<bool>()) {
+                    class_label[index] = mod_label_objs_[item]["label"].get<std::string>();
+                    auto color = mod_label_objs_[item]["color"].get<std::vector<int>>();
+                    class_color[index] = {color[0], color[1], color[2], int(255 * 0.8)};
+                }
+                index++;
+            }
+        }
+
+        std::map<int, Scalar> class_color_map, stage_color_map;
+        for (auto &[class_id, color] : class_color) {
+            class_color_map[class_id] = {(float)color[0], (float)color[1], (float)color[2], (float)color[3]};
+            stage_color_map[class_id] = {(float)color[0], (float)color[1], (float)color[2], 1};
+        }
+        map_class_label_ = std::move(class_label);
+        map_class_color_ = std::move(class_color_map);
+        map_stage_color_ = std::move(stage_color_map);
+    } catch (const std::exception &e) {
+        spdlog::error(e.what());
+        quit_runner_(TaskErrorCode::kInference);
+    }
+}
+
 Inference_v2::~Inference_v2() {
     active = false;
     for (auto &handle : thread_handle_) {
@@ -131,7 +170,9 @@ Inference_v2::~Inference_v2() {
 }
 
 void Inference_v2::on_cv_frame(const std::shared_ptr<msgs::cv_frame> &frame) {
-    if (cache_frames_.size_approx() > 20) {
+    // 输入端已限制积压帧数时不在这里丢帧，离线模式下由解码线程等待；结束帧总是保留
+    bool bounded = frame->frame_type == FrameType::kNone || (frame->frame_info && frame->frame_info->release_token);
+    if (!bounded && cache_frames_.size_approx() > 20) {
         spdlog::info("Inference_v2 cache_frames_size: {}", cache_frames_.size_approx());
         return;
     }
@@ -146,10 +187,7 @@ void Inference_v2::on_cv_frame(const std::shared_ptr<msgs::cv_frame> &frame) {
 nodes::FrameExtInfo Inference_v2::parser_output(const AlgoType type, const std::vector<algo::AlgoOutput> &vec_output) {
     nodes::FrameExtInfo ext_info(type, parms_.mod_id, parms_.mod_name, parms_.mod_thres);
     ext_info.map_class_label = map_class_label_;
-    for (auto &item : map_class_color_) {
-        ext_info.map_class_color[item.first] = {(float)item.second[0], (float)item.second[1], (float)item.second[2],
-                                                (float)item.second[3]};
-    }
+    ext_info.map_class_color = map_class_color_;
 
     int index = 0;
     for (const auto &item : vec_output) {
@@ -175,7 +213,7 @@ nodes::FrameExtInfo Inference_v2::parser_output(const AlgoType type, const std::
             } else if (type == AlgoType::kSegmentation) {
                 ext_info.seg_width = item.seg_width;
                 ext_info.seg_height = item.seg_height;
-                ext_info.seg_map = std::move(item.seg_map);
+                ext_info.seg_map = std::make_shared<const std::vector<uint8_t>>(std::move(item.seg_map));
             } else if (type == AlgoType::kOCR_DET) {
                 for (auto &ocr_info : item.vec_ocr_info) {
                     ext_info.map_ocr_info.insert(std::make_pair(index, ocr_info));
@@ -193,9 +231,7 @@ nodes::FrameExtInfo Inference_v2::parser_output(const AlgoType type, const Frame
                                                 const std::map<int, std::vector<algo::AlgoOutput>> &outputs) {
     nodes::FrameExtInfo ext_info(type, parms_.mod_id, parms_.mod_name, parms_.mod_thres);
     ext_info.map_class_label = map_class_label_;
-    for (auto &item : map_class_color_) {
-        ext_info.map_class_color[item.first] = {(float)item.second[0], (float)item.second[1], (float)item.second[2], 1};
-    }
+    ext_info.map_class_color = map_stage_color_;
 
     int index = 0;
     for (const auto &[prev_id, output] : outputs) {
@@ -256,7 +292,7 @@ nodes::FrameExtInfo Inference_v2::parser_output(const AlgoType type, const Frame
                         }
                         ext_info.map_key_points.insert(std::make_pair(index, vec_key_points));
                     } else if (type == AlgoType::kSegmentation) {
-                        ext_info.seg_map = std::move(item.seg_map);
+                        ext_info.seg_map = std::make_shared<const std::vector<uint8_t>>(std::move(item.seg_map));
                     }
                 } else if (type == AlgoType::kOCR) {
                     std::vector<PoseKeyPoint> pose_key_point;
@@ -307,7 +343,7 @@ nodes::FrameExtInfo Inference_v2::parser_output(const AlgoType type, const Frame
                 } else if (type == AlgoType::kSegmentation) {
                     ext_info.seg_width = item.seg_width;
                     ext_info.seg_height = item.seg_height;
-                    ext_info.seg_map = std::move(item.seg_map);
+                    ext_info.seg_map = std::make_shared<const std::vector<uint8_t>>(std::move(item.seg_map));
                 } else if (type == AlgoType::kOCR_DET) {
                     for (auto &ocr_info : item.vec_ocr_info) {
                         ext_info.map_ocr_info.insert(std::make_pair(index, ocr_info));
@@ -7,7 +7,7 @@
 
 #include "blockingconcurrentqueue.h"
 #include "message_templates.hpp"
-#include "modules/algorithm/algo_factory.h"
+#include "modules/algorithm/model_registry.h"
 #include "node_any_basic.hpp"
 #include "node_msg_def.h"
 #include <thread>
@@ -28,12 +28,14 @@ public:
         bind_simple_property("mod_iter_id", parms_.mod_id, "模型ID");
         bind_simple_property("mod_name", parms_.mod_name, "模型名称");
         bind_simple_property("mod_path", parms_.mod_path, "模型文件");
+        bind_simple_property("backend", parms_.backend, "推理后端，为空时使用默认后端");
         bind_simple_property("mod_labels", mod_label_objs_, "标签列表");
         bind_simple_property("lib_paths", parms_.lib_paths, "特征库路径");
         bind_simple_property("best_threshold", parms_.mod_thres, "模型阈值", ngraph::PropAccess::kProtected);
         bind_simple_property("frame_rate", parms_.frame_rate, "推理帧率");
         bind_simple_property("instances", parms_.instances, "推理实例数");
         bind_simple_property("batch_size", parms_.batch_size, "批量数");
+        bind_simple_property("batch_wait_ms", parms_.batch_wait_ms, "凑批最长等待时间(ms)");
 
         bind_simple_flags("support_preview", true);
 
@@ -47,6 +49,7 @@ public:
 private:
     void on_setup() override;
     void on_cv_frame(const std::shared_ptr<msgs::cv_frame> &frame);
+    void init_labels_(const std::vector<std::string> &vec_labels);
 
     nodes::FrameExtInfo parser_output(const AlgoType type, const std::vector<algo::AlgoOutput> &vec_output);
     nodes::FrameExtInfo parser_output(const AlgoType type, const FrameExtInfo &back_ext_info,
@@ -57,8 +60,10 @@ private:
     std::vector<std::thread> thread_handle_;
     nlohmann::json mod_label_objs_;
 
-    std::map<int, std::string> map_class_label_;
-    std::map<int, std::vector<int>> map_class_color_;
+    // 标签加载时一次性构建，每帧赋值给 FrameExtInfo 时只复制指针
+    CowMap<int, std::string> map_class_label_;
+    CowMap<int, Scalar> map_class_color_;    // 单阶段推理结果的颜色
+    CowMap<int, Scalar> map_stage_color_;    // 多阶段推理结果的颜色，透明度为 1
 
     int64_t infer_frame_idx_{1};
 
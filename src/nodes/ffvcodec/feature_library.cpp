@@ -1,6 +1,9 @@
 #include "feature_library.h"
+#include "common_basic/thread_worker.hpp"
 #include <boost/filesystem.hpp>
 #include <cstdint>
+#include <deque>
+#include <future>
 #include <opencv2/imgcodecs.hpp>
 #include <unordered_map>
 
@@ -11,18 +14,45 @@ extern "C" {
 namespace gddi {
 namespace nodes {
 
+template<class Func>
+static auto submit(WorkerPool &workers, Func &&func) {
+    auto task = std::make_shared<std::packaged_task<decltype(func())()>>(std::forward<Func>(func));
+    auto result = task->get_future();
+    workers.enqueue([task]() { (*task)(); });
+    return result;
+}
+
+/**
+ * @brief 读取失败时返回空
+ */
+static std::vector<uint8_t> sha256_file(const std::string &file) {
+    std::vector<uint8_t> sha256;
+    if (!utils::sha256sum(file, sha256)) { sha256.clear(); }
+    return sha256;
+}
+
 FeatureLibrary_v2::~FeatureLibrary_v2() {}
 
 void FeatureLibrary_v2::on_setup() {
+    auto thread_num = std::max(1u, std::thread::hardware_concurrency());
+    workers_ = std::make_unique<WorkerPool>("feature-lib", thread_num);
+
     // 获取目录下所有的图片文件
     get_image_files(path_suffix_ + folder_path_);
-    // 读取特征库信息
+    // 读取特征库信息，已有特征的图片从 file_list_ 中移除
     load_feature_v1(path_suffix_ + folder_path_);
 
+    // 并行解码，按文件顺序输出，限制同时解码的图片数量
+    std::deque<std::pair<std::string, std::future<cv::Mat>>> decoding;
     int index = 0;
-    for (const auto &[file, _] : file_list_) {
-        auto image = cv::imread(file);
-        if (image.empty()) { continue; }
+    auto output_front = [this, &decoding, &index]() {
+        auto file = std::move(decoding.front().first);
+        auto image = decoding.front().second.get();
+        decoding.pop_front();
+        if (image.empty()) {
+            spdlog::warn("Failed to decode image: {}", file);
+            return;
+        }
 
 #if defined(WITH_JETSON)
         auto mem_obj = mem_pool_.alloc_mem_detach(0, 0);
@@ -40,7 +70,15 @@ void FeatureLibrary_v2::on_setup() {
         auto frame = std::make_shared<msgs::cv_frame>(file, TaskType::kAsyncImage, 1);
         frame->frame_info = std::make_shared<FrameInfo>(++index, mem_obj);
         output_image_(frame);
+    };
+
+    for (const auto &item : file_list_) {
+        auto file = item.first;
+        decoding.emplace_back(file, submit(*workers_, [file]() { return cv::imread(file); }));
+        if (decoding.size() >= thread_num * 2) { output_front(); }
     }
+    while (!decoding.empty()) { output_front(); }
+    workers_.reset();
 
     auto frame = std::make_shared<msgs::cv_frame>(task_name_, TaskType::kAsyncImage, 1, gddi::FrameType::kNone);
     output_image_(frame);
@@ -49,6 +87,7 @@ void FeatureLibrary_v2::on_setup() {
 void FeatureLibrary_v2::on_response(const std::shared_ptr<msgs::cv_frame> &frame) {
     if (frame->frame_type == gddi::FrameType::kNone) {
         save_feature_v1(path_suffix_ + folder_path_);
+        manifest_.save(path_suffix_ + folder_path_ + "/features.manifest");
         quit_runner_(TaskErrorCode::kFeatureLibrary);
         return;
     }
@@ -56,52 +95,83 @@ void FeatureLibrary_v2::on_response(const std::shared_ptr<msgs::cv_frame> &frame
     auto &ext_info = frame->frame_info->ext_info.back();
     if (ext_info.algo_type == AlgoType::kFace) {
         if (ext_info.features.size() == 1) {
-            auto iter = std::find_if(feature_info_.begin(), feature_info_.end(),
-                                     [&frame](const FeatureInfo_v1 &info) { return info.path == frame->task_name; });
-            if (iter != feature_info_.end()) {
-                memcpy(iter->feature, ext_info.features[0].data(), ext_info.features[0].size());
+            auto &feature = ext_info.features.begin()->second;
+            auto relative_path = frame->task_name.substr(path_suffix_.size());
+            auto iter = feature_rows_.find(relative_path);
+            size_t row;
+            if (iter != feature_rows_.end()) {
+                row = iter->second;
+                memcpy(feature_info_[row].feature, feature.data(), feature.size() * sizeof(float));
             } else {
                 FeatureInfo_v1 info;
                 memset(&info, 0, sizeof(info));
-                memcpy(info.path, frame->task_name.c_str() + 11, frame->task_name.size() - 11 + 1);
+                memcpy(info.path, relative_path.c_str(), relative_path.size() + 1);
                 auto &sha256 = file_list_[frame->task_name];
                 memcpy(info.sha256, sha256.data(), sha256.size());
-                auto &feature = ext_info.features.begin()->second;
                 memcpy(info.feature, feature.data(), feature.size() * sizeof(float));
+                row = feature_info_.size();
                 feature_info_.emplace_back(std::move(info));
+                feature_rows_.emplace(relative_path, row);
             }
+            feature_index_.add(row, feature_info_[row].feature);
         }
     }
 }
 
 void FeatureLibrary_v2::get_image_files(const std::string &path) {
-    if (boost::filesystem::is_directory(path)) {
-        boost::filesystem::recursive_directory_iterator end_iter;
-        boost::filesystem::recursive_directory_iterator dir_iter(path);
-        while (dir_iter != end_iter) {
-            if (boost::filesystem::is_regular_file(dir_iter->status())) {
-                if (dir_iter->path().filename().string() == "cover.jpg") {
-                    ++dir_iter;
-                    continue;
-                }
-
-                // 判断文件是否是图片
-                auto ext = dir_iter->path().extension().string();
-                if (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp") {
-                    utils::sha256sum(dir_iter->path().string(), file_list_[dir_iter->path().string()]);
-                }
-
-            } else if (boost::filesystem::is_directory(dir_iter->status())) {
-                get_image_files(dir_iter->path().c_str());
-            }
-            ++dir_iter;
+    if (!boost::filesystem::is_directory(path)) { return; }
+    manifest_.load(path + "/features.manifest");
+
+    algo::FeatureManifest manifest;
+    std::vector<std::pair<std::string, std::future<std::vector<uint8_t>>>> hashing;
+
+    boost::filesystem::recursive_directory_iterator end_iter;
+    for (boost::filesystem::recursive_directory_iterator dir_iter(path); dir_iter != end_iter; ++dir_iter) {
+        if (!boost::filesystem::is_regular_file(dir_iter->status())) { continue; }
+        if (dir_iter->path().filename().string() == "cover.jpg") { continue; }
+
+        // 判断文件是否是图片
+        auto ext = dir_iter->path().extension().string();
+        if (ext != ".jpg" && ext != ".jpeg" && ext != ".png" && ext != ".bmp") { continue; }
+
+        boost::system::error_code size_ec, time_ec;
+        algo::FeatureManifest::Entry info;
+        info.size = boost::filesystem::file_size(dir_iter->path(), size_ec);
+        info.mtime = boost::filesystem::last_write_time(dir_iter->path(), time_ec);
+        if (size_ec || time_ec) { continue; }
+
+        auto file = dir_iter->path().string();
+        auto relative_path = file.substr(path.size());
+        if (auto unchanged = manifest_.find_unchanged(relative_path, info.size, info.mtime)) {
+            // 大小和修改时间都未变化，沿用上次的 sha256
+            memcpy(info.sha256, unchanged->sha256, sizeof(info.sha256));
+            file_list_[file].assign(info.sha256, info.sha256 + sizeof(info.sha256));
+        } else {
+            hashing.emplace_back(file, submit(*workers_, [file]() { return sha256_file(file); }));
         }
+        manifest.entries()[relative_path] = info;
     }
+
+    for (auto &[file, result] : hashing) {
+        auto sha256 = result.get();
+        auto relative_path = file.substr(path.size());
+        if (sha256.empty()) {
+            spdlog::warn("Failed to read file: {}", file);
+            manifest.entries().erase(relative_path);
+            continue;
+        }
+        memcpy(manifest.entries()[relative_path].sha256, sha256.data(), sizeof(algo::FeatureManifest::Entry::sha256));
+        file_list_[file] = std::move(sha256);
+    }
+
+    spdlog::info("Image files: {}, hashed: {}", manifest.entries().size(), hashing.size());
+    manifest_ = std::move(manifest);
 }
 
 void FeatureLibrary_v2::load_feature_v1(const std::string &path) {
     rename((path + "/features.bin").c_str(), (path + "/.features.bin.bak").c_str());
     rename((path + "/features.txt").c_str(), (path + "/.features.txt.bak").c_str());
+    rename((path + "/features.idx").c_str(), (path + "/.features.idx.bak").c_str());
 
     std::ifstream ifs(path + "/.features.bin.bak", std::ios::binary);
     if (ifs.is_open()) {
@@ -117,26 +187,45 @@ void FeatureLibrary_v2::load_feature_v1(const std::string &path) {
         ifs.close();
     }
 
-    for (auto iter = feature_info_.begin(); iter != feature_info_.end();) {
-        auto file_iter = std::find_if(file_list_.begin(), file_list_.end(),
-                                      [&iter](const std::pair<std::string, std::vector<uint8_t>> &file) {
-                                          return memcmp(iter->sha256, file.second.data(), sizeof(iter->sha256)) == 0;
-                                      });
+    // 索引与 features.bin 一一对应时增量更新，否则重建
+    if (!feature_index_.load(path + "/.features.idx.bak") || feature_index_.size() != feature_info_.size()
+        || (!feature_info_.empty() && !feature_index_.contains(feature_info_.size() - 1))) {
+        feature_index_.clear();
+        for (size_t row = 0; row < feature_info_.size(); row++) { feature_index_.add(row, feature_info_[row].feature); }
+    }
 
-        auto relative_path = file_iter->first.c_str() + 11;
-        if (file_iter == file_list_.end()) {
-            spdlog::info("Remove file: {}", iter->path);
-            iter = feature_info_.erase(iter);
-        } else {
-            if (strcmp(iter->path, relative_path) != 0) {
-                // 文件名不一致，更新文件名
-                spdlog::info("Update file name: {} -> {}", iter->path, relative_path);
-                memcpy(iter->path, relative_path, strlen(relative_path) + 1);
-            }
-            file_list_.erase(file_iter);
-            ++iter;
+    std::unordered_multimap<std::string, std::string> sha256_files;
+    for (const auto &[file, sha256] : file_list_) {
+        sha256_files.emplace(std::string(sha256.begin(), sha256.end()), file);
+    }
+
+    // 删除图片已不存在的记录，rows[旧序号] 为新序号
+    std::vector<uint32_t> rows(feature_info_.size(), algo::FeatureIndex::kInvalidLabel);
+    std::vector<FeatureInfo_v1> feature_info;
+    for (size_t row = 0; row < feature_info_.size(); row++) {
+        auto &info = feature_info_[row];
+        auto file_iter = sha256_files.find(std::string((const char *)info.sha256, sizeof(info.sha256)));
+        if (file_iter == sha256_files.end()) {
+            spdlog::info("Remove file: {}", info.path);
+            continue;
+        }
+
+        auto relative_path = file_iter->second.c_str() + path_suffix_.size();
+        if (strcmp(info.path, relative_path) != 0) {
+            // 文件名不一致，更新文件名
+            spdlog::info("Update file name: {} -> {}", info.path, relative_path);
+            memcpy(info.path, relative_path, strlen(relative_path) + 1);
         }
+        file_list_.erase(file_iter->second);
+        sha256_files.erase(file_iter);
+
+        rows[row] = feature_info.size();
+        feature_rows_[info.path] = feature_info.size();
+        feature_info.emplace_back(info);
     }
+
+    feature_info_ = std::move(feature_info);
+    feature_index_.relabel(rows);
 }
 
 void FeatureLibrary_v2::save_feature_v1(const std::string &path) {
@@ -156,8 +245,12 @@ void FeatureLibrary_v2::save_feature_v1(const std::string &path) {
         ofs_success.close();
     }
 
+    // 保存检索索引
+    feature_index_.save(path + "/.features.idx.tmp");
+
     rename((path + "/.features.bin.tmp").c_str(), (path + "/features.bin").c_str());
     rename((path + "/.features.txt.tmp").c_str(), (path + "/features.txt").c_str());
+    rename((path + "/.features.idx.tmp").c_str(), (path + "/features.idx").c_str());
 }
 
 }// namespace nodes
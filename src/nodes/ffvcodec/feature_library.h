@@ -2,13 +2,26 @@
 #define _FEATURE_LIBRARY_H_
 
 #include "message_templates.hpp"
+#include "modules/algorithm/feature_index.h"
+#include "modules/algorithm/feature_manifest.h"
 #include "node_any_basic.hpp"
 #include "node_msg_def.h"
 #include "utils.hpp"
+#include <unordered_map>
 
 namespace gddi {
+class WorkerPool;
+
 namespace nodes {
 
+/**
+ * @brief 提取目录下图片的特征，保存为 features.bin，同时维护检索用的 HNSW 索引 features.idx
+ *
+ *        features.idx 的 label 为记录在 features.bin 中的序号，图片增删时增量更新。
+ *        features.manifest 记录每个图片的大小、修改时间和 sha256，两者都未变化的图片不再重新计算 sha256，
+ *        清单带校验和，截断或损坏时整体作废、全部重新计算，
+ *        计算 sha256 和解码图片在线程池中并行
+ */
 class FeatureLibrary_v2 : public node_any_basic<FeatureLibrary_v2> {
 
 public:
@@ -41,8 +54,12 @@ private:
     std::string folder_path_;
     ImagePool mem_pool_;
 
+    std::unique_ptr<WorkerPool> workers_;
+    algo::FeatureManifest manifest_;
     std::map<std::string, std::vector<uint8_t>> file_list_;
     std::vector<FeatureInfo_v1> feature_info_;
+    std::unordered_map<std::string, size_t> feature_rows_;// 相对路径 -> feature_info_ 下标
+    algo::FeatureIndex feature_index_{sizeof(FeatureInfo_v1::feature) / sizeof(float)};
 
     message_pipe<msgs::cv_frame> output_image_;
 };
@@ -1,15 +1,20 @@
 #include "image_server_node_v2.h"
 #include "base64.h"
 #include "common_basic/thread_dbg_utils.hpp"
+#include "modules/algorithm/model_registry.h"
 #include "modules/network/downloader.h"
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <memory>
+#include <mutex>
 #include <opencv2/core/base.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgcodecs.hpp>
+#include <set>
 #include <spdlog/spdlog.h>
 #include <stdexcept>
 #include <string>
@@ -27,7 +32,15 @@ const int skeleton[][2] = {{15, 13}, {13, 11}, {16, 14}, {14, 12}, {11, 12}, {5,
                            {7, 9},   {8, 10},  {1, 2},   {0, 1},   {0, 2},   {1, 3},  {2, 4},  {3, 5}, {4, 6}};
 const int skeleton_5[][2] = {{0, 1}, {0, 2}, {1, 2}, {0, 3}, {1, 4}, {2, 3}, {2, 4}, {3, 4}};
 
-ImageServer_v2::~ImageServer_v2() { http_server_stop(&server_); }
+ImageServer_v2::~ImageServer_v2() {
+    http_server_stop(&server_);
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        batch_stop_ = true;
+    }
+    batch_cv_.notify_all();
+    if (batch_watchdog_.joinable()) { batch_watchdog_.join(); }
+}
 
 static ImageFormat get_image_format(const unsigned char *buffer, const size_t buffer_size) {
     if (((*buffer & 0x00FF) == 0xFF) && (*(buffer + 1) & 0xFF) == 0xD8) {
@@ -111,6 +124,121 @@ static Rect2f algin_rect(const Rect2f &rect, int img_w, int img_h, float factor)
     return resize_rect;
 }
 
+/**
+ * @brief 批量上传的结果按图片顺序汇总，全部完成后一次返回
+ *
+ *        每张图片的回调持有该对象，图片被下游丢弃时回调随帧释放，最后一个引用释放时
+ *        未返回的图片记为 dropped；超时未完成时由 expire() 返回，未完成的图片记为 timeout。
+ */
+class BatchResponse {
+public:
+    BatchResponse(HttpContextPtr ctx, std::vector<std::string> names)
+        : ctx_(std::move(ctx)), names_(std::move(names)), results_(names_.size()), remaining_(names_.size()) {}
+
+    ~BatchResponse() { finish_("dropped"); }
+
+    void reply(const size_t index, nlohmann::json ack) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sent_) { return; }
+        ack["name"] = names_[index];
+        results_[index] = std::move(ack);
+        if (--remaining_ == 0) { send_(); }
+    }
+
+    void expire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finish_("timeout");
+    }
+
+private:
+    void finish_(const char *error) {
+        if (sent_) { return; }
+        for (size_t i = 0; i < results_.size(); i++) {
+            if (!results_[i].is_null()) { continue; }
+            results_[i]["success"] = false;
+            results_[i]["error"] = error;
+            results_[i]["name"] = names_[i];
+        }
+        send_();
+    }
+
+    void send_() {
+        sent_ = true;
+        auto ack_json = nlohmann::json::object();
+        ack_json["success"] = true;
+        ack_json["data"] = std::move(results_);
+        ctx_->send(ack_json.dump());
+    }
+
+private:
+    std::mutex mutex_;
+    HttpContextPtr ctx_;
+    std::vector<std::string> names_;
+    std::vector<nlohmann::json> results_;
+    size_t remaining_;
+    bool sent_{false};
+};
+
+/**
+ * @brief 按比例换算一个坐标值，整数四舍五入后仍为整数
+ */
+static void scale_number(nlohmann::json &object, const char *key, float scale) {
+    auto iter = object.find(key);
+    if (iter == object.end()) { return; }
+    if (iter->is_number_unsigned()) {
+        *iter = (uint64_t)std::llround(iter->get<double>() * scale);
+    } else if (iter->is_number_integer()) {
+        *iter = (int64_t)std::llround(iter->get<double>() * scale);
+    } else if (iter->is_number_float()) {
+        *iter = iter->get<double>() * scale;
+    }
+}
+
+/**
+ * @brief 对 object[key] 数组中的每个对象调用 func
+ */
+template<typename Func>
+static void for_each_object(nlohmann::json &object, const char *key, Func func) {
+    auto iter = object.find(key);
+    if (iter == object.end() || !iter->is_array()) { return; }
+    for (auto &item : *iter) {
+        if (item.is_object()) { func(item); }
+    }
+}
+
+static void scale_box(nlohmann::json &box, float scale_x, float scale_y) {
+    scale_number(box, "left_top_x", scale_x);
+    scale_number(box, "left_top_y", scale_y);
+    scale_number(box, "right_bottom_x", scale_x);
+    scale_number(box, "right_bottom_y", scale_y);
+}
+
+/**
+ * @brief 缩小解码时把结果中的目标框、关键点、骨架线和马赛克区域换算回原图，其他字段不变
+ */
+static void scale_coordinates(nlohmann::json &data, float scale_x, float scale_y) {
+    if (!data.is_object()) { return; }
+
+    for_each_object(data, "targets", [scale_x, scale_y](nlohmann::json &target) {
+        auto bbox = target.find("bbox");
+        if (bbox != target.end() && bbox->is_object()) {
+            auto box = bbox->find("box");
+            if (box != bbox->end() && box->is_object()) { scale_box(*box, scale_x, scale_y); }
+        }
+        for_each_object(target, "key_points", [scale_x, scale_y](nlohmann::json &point) {
+            scale_number(point, "x", scale_x);
+            scale_number(point, "y", scale_y);
+        });
+        for_each_object(target, "key_lines", [scale_x, scale_y](nlohmann::json &line) {
+            scale_number(line, "start_x", scale_x);
+            scale_number(line, "start_y", scale_y);
+            scale_number(line, "end_x", scale_x);
+            scale_number(line, "end_y", scale_y);
+        });
+    });
+    for_each_object(data, "mosaics", [scale_x, scale_y](nlohmann::json &box) { scale_box(box, scale_x, scale_y); });
+}
+
 void ImageServer_v2::on_setup() {
     size_t concurrency = std::thread::hardware_concurrency();
     downloader_ = std::make_unique<network::Downloader>();
@@ -120,6 +248,8 @@ void ImageServer_v2::on_setup() {
     mem_pool_.register_free_callback([](cv::cuda::GpuMat *image) { cudaFree(image->data); });
 #endif
 
+    batch_watchdog_ = std::thread([this]() { watch_batches_(); });
+
     router_.POST("/api/predict", [=](const HttpContextPtr &ctx) {
         on_request(ctx);
         return 0;
@@ -138,37 +268,16 @@ void ImageServer_v2::on_setup() {
 
 void ImageServer_v2::on_request(const HttpContextPtr &ctx) {
     try {
-        auto req_obj = nlohmann::json::parse(ctx->body());
-
-        auto raw_data = req_obj["image"].get<std::string>();
-        nlohmann::json additional;
-        if (req_obj.count("additional") > 0) { additional = req_obj["additional"]; }
-
-        std::vector<uchar> img_data;
-        if (raw_data.substr(0, 4) == "http") {
-            downloader_->async_http_get(
-                raw_data, [ctx, additional, this](const bool success, const std::vector<unsigned char> &img_data) {
-                    if (success) {
-                        on_construct(img_data, additional, ctx);
-                    } else {
-                        auto ack_json = nlohmann::json::object();
-                        ack_json["success"] = false;
-                        ack_json["error"] = std::string(img_data.begin(), img_data.end());
-                        ctx->send(ack_json.dump());
-                    }
-                });
+        if (ctx->is(MULTIPART_FORM_DATA)) {
+            on_multipart_request(ctx);
+        } else if (ctx->is(APPLICATION_OCTET_STREAM)) {
+            // body 就是一张图片，不带区域
+            const auto &body = ctx->body();
+            on_construct((const unsigned char *)body.data(), body.size(), {},
+                         [ctx](const nlohmann::json &ack) { ctx->send(ack.dump()); });
         } else {
-            auto ptr = raw_data.data();
-            int data_size = raw_data.size();
-            if (raw_data.substr(0, 4) == "data") {
-                auto pos = raw_data.find_first_of(',');
-                if (pos == std::string::npos) { throw std::runtime_error("unsupport base64 format"); }
-                ptr = raw_data.data() + pos + 1;
-                data_size = raw_data.size() - pos - 1;
-            }
-            on_construct(Base64::decode(ptr, data_size, 0), additional, ctx);
+            on_json_request(ctx);
         }
-
     } catch (std::exception &exception) {
         auto ack_json = nlohmann::json::object();
         ack_json["success"] = false;
@@ -177,182 +286,206 @@ void ImageServer_v2::on_request(const HttpContextPtr &ctx) {
     }
 }
 
-void ImageServer_v2::on_construct(const std::vector<uchar> &img_data, const nlohmann::json &additional,
-                                  const HttpContextPtr &ctx) {
-    try {
-        auto format = get_image_format(img_data.data(), img_data.size());
-
-        if (format == ImageFormat::kJPEG) {
-            auto mem_obj = mem_pool_.alloc_mem_detach(0, 0);
-            mem_obj->data = image_wrapper::image_jpeg_dec(img_data.data(), img_data.size());
-
-            auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
-            auto frame = std::make_shared<msgs::cv_frame>(uuid, TaskType::kAsyncImage, 1);
-            frame->frame_info = std::make_shared<FrameInfo>(++frame_idx_, mem_obj);
-            frame->response_callback_ = [ctx](const nlohmann::json &data, const bool code) {
+void ImageServer_v2::on_json_request(const HttpContextPtr &ctx) {
+    std::string raw_data;
+    std::map<std::string, network::RegionMap> regions;
+    if (!network::parse_upload_json(ctx->body(), regions, &raw_data)) { throw std::runtime_error("invalid json body"); }
+    if (raw_data.empty()) { throw std::runtime_error("image is empty"); }
+
+    auto reply = [ctx](const nlohmann::json &ack) { ctx->send(ack.dump()); };
+    if (raw_data.compare(0, 4, "http") == 0) {
+        downloader_->async_http_get(raw_data, [ctx, reply, regions = regions["additional"],
+                                               this](const bool success, const std::vector<unsigned char> &img_data) {
+            if (success) {
+                on_construct(img_data.data(), img_data.size(), regions, reply);
+            } else {
                 auto ack_json = nlohmann::json::object();
-                ack_json["success"] = true;
-                ack_json["data"] = data;
+                ack_json["success"] = false;
+                ack_json["error"] = std::string(img_data.begin(), img_data.end());
                 ctx->send(ack_json.dump());
-            };
-
-            std::map<std::string, std::vector<std::vector<float>>> regions;
-            if (additional.count("regions_with_label") > 0) {
-                regions =
-                    additional["regions_with_label"].get<std::map<std::string, std::vector<std::vector<float>>>>();
             }
+        });
+    } else {
+        auto ptr = raw_data.data();
+        int data_size = raw_data.size();
+        if (raw_data.compare(0, 4, "data") == 0) {
+            auto pos = raw_data.find_first_of(',');
+            if (pos == std::string::npos) { throw std::runtime_error("unsupport base64 format"); }
+            ptr = raw_data.data() + pos + 1;
+            data_size = raw_data.size() - pos - 1;
+        }
+        std::vector<uchar> img_data = Base64::decode(ptr, data_size, 0);
+        on_construct(img_data.data(), img_data.size(), regions["additional"], reply);
+    }
+}
 
-            if (!regions.empty()) {
-                // 构造一阶段检测的 ext_info
-                nodes::FrameExtInfo ext_info(AlgoType::kDetection, "", "", 0);
+void ImageServer_v2::on_multipart_request(const HttpContextPtr &ctx) {
+    const auto &body = ctx->body();
+    std::vector<network::FormPart> parts;
+    if (!network::parse_multipart(ctx->header("Content-Type"), body, parts)) {
+        throw std::runtime_error("invalid multipart body");
+    }
 
-                int index = 0;
-                std::vector<Point2i> points;
-                for (const auto &[key, values] : regions) {
-                    std::vector<Point2i> points;
-                    for (auto point : values) {
-                        // 兼容比例和坐标
-                        if (point[0] < 1) { point[0] = point[0] * frame->frame_info->width(); }
-                        if (point[1] < 1) { point[1] = point[1] * frame->frame_info->height(); }
-                        points.emplace_back(point[0], point[1]);
-                    }
-                    frame->frame_info->roi_points[key] = points;
-
-                    auto x_compare = [](const Point2i &first, const Point2i &second) { return first.x < second.x; };
-                    auto y_compare = [](const Point2i &first, const Point2i &second) { return first.y < second.y; };
-                    float min_x = (*std::min_element(points.begin(), points.end(), x_compare)).x;
-                    float min_y = (*std::min_element(points.begin(), points.end(), y_compare)).y;
-                    float max_x = (*std::max_element(points.begin(), points.end(), x_compare)).x;
-                    float max_y = (*std::max_element(points.begin(), points.end(), y_compare)).y;
-                    float width = max_x - min_x;
-                    float height = max_y - min_y;
-
-                    if (width > height) {
-                        min_y = min_y - (width - height) / 2;
-                        height = width;
-                    } else {
-                        min_x = min_x - (height - width) / 2;
-                        width = height;
-                    }
-
-                    ext_info.map_target_box.insert(std::make_pair(
-                        index,
-                        BoxInfo{.prev_id = 0,
-                                .class_id = 0,
-                                .prob = 1,
-                                .box = {0, 0, (float)frame->frame_info->width(), (float)frame->frame_info->height()},
-                                .roi_id = key,
-                                .track_id = 0}));
-
-                    ext_info.crop_rects[index] = algin_rect({min_x, min_y, width, height}, frame->frame_info->width(),
-                                                            frame->frame_info->height(), scale_factor_);
-
-                    ++index;
-                }
+    // 可选的 metadata 段按图片段的 name 给出区域，其它段都是图片
+    std::map<std::string, network::RegionMap> regions;
+    std::vector<const network::FormPart *> images;
+    for (const auto &part : parts) {
+        if (part.name == "metadata") {
+            if (!network::parse_upload_json(part.data, regions)) { throw std::runtime_error("invalid metadata"); }
+        } else {
+            images.emplace_back(&part);
+        }
+    }
+    if (images.empty()) { throw std::runtime_error("no image in request"); }
+    if ((int)images.size() > max_batch_images_) {
+        throw std::runtime_error("too many images in request, max: " + std::to_string(max_batch_images_));
+    }
+
+    std::vector<std::string> names;
+    for (const auto &image : images) { names.emplace_back(image->name); }
+    auto batch = std::make_shared<BatchResponse>(ctx, names);
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        batches_.emplace_back(std::chrono::steady_clock::now() + std::chrono::milliseconds(batch_timeout_ms_), batch);
+    }
+    batch_cv_.notify_one();
 
-                ext_info.flag_crop = true;
-                ext_info.crop_images = image_wrapper::image_crop(mem_obj->data, ext_info.crop_rects);
+    for (size_t i = 0; i < images.size(); i++) {
+        on_construct((const unsigned char *)images[i]->data.data(), images[i]->data.size(), regions[names[i]],
+                     [batch, i](nlohmann::json ack) { batch->reply(i, std::move(ack)); });
+    }
+}
 
-                frame->frame_info->ext_info.emplace_back(ext_info);
+void ImageServer_v2::watch_batches_() {
+    std::unique_lock<std::mutex> lock(batch_mutex_);
+    while (!batch_stop_) {
+        // 超时时间相同，按加入顺序到期
+        if (batches_.empty()) {
+            batch_cv_.wait(lock);
+            continue;
+        }
+        if (batch_cv_.wait_until(lock, batches_.front().first) != std::cv_status::timeout) { continue; }
+
+        auto now = std::chrono::steady_clock::now();
+        while (!batches_.empty() && batches_.front().first <= now) {
+            auto batch = batches_.front().second.lock();
+            batches_.pop_front();
+            if (batch) {
+                lock.unlock();
+                batch->expire();
+                batch.reset();
+                lock.lock();
             }
+        }
+    }
+}
 
-            output_image_(frame);
-        } else if (format == ImageFormat::kPNG) {
-            auto mem_obj = mem_pool_.alloc_mem_detach(0, 0);
-            mem_obj->data = image_wrapper::image_png_dec(img_data.data(), img_data.size());
+std::pair<int, int> ImageServer_v2::fit_size_() const {
+    if (decode_size_ > 0) { return {decode_size_, decode_size_}; }
 
-            auto frame = std::make_shared<msgs::cv_frame>(task_name_, TaskType::kAsyncImage, 1);
-            frame->frame_info = std::make_shared<FrameInfo>(++frame_idx_, mem_obj);
-            frame->response_callback_ = [ctx](const nlohmann::json &data, const bool code) {
-                auto ack_json = nlohmann::json::object();
-                ack_json["success"] = true;
-                ack_json["data"] = data;
-                ctx->send(ack_json.dump());
-            };
+    // 模型加载完成前解码原图
+    std::pair<int, int> fit_size{0, 0};
+    for (const auto &mod_path : decode_models_) {
+        auto input_size = algo::ModelRegistry::get_instance().input_size(mod_path);
+        if (input_size.first <= 0 || input_size.second <= 0) { return {0, 0}; }
+        fit_size.first = std::max(fit_size.first, input_size.first);
+        fit_size.second = std::max(fit_size.second, input_size.second);
+    }
+    return fit_size;
+}
 
-            std::map<std::string, std::vector<std::vector<float>>> regions;
-            if (additional.count("regions_with_label") > 0) {
-                regions =
-                    additional["regions_with_label"].get<std::map<std::string, std::vector<std::vector<float>>>>();
-            }
+void ImageServer_v2::on_construct(const unsigned char *data, const size_t size, const network::RegionMap &regions,
+                                  const ReplyCallback &reply) {
+    try {
+        // 区域按原图坐标裁剪，有区域时不缩小解码
+        auto fit_size = regions.empty() ? fit_size_() : std::pair<int, int>{0, 0};
+        int src_width = 0;
+        int src_height = 0;
 
-            if (!regions.empty()) {
-                // 构造一阶段检测的 ext_info
-                nodes::FrameExtInfo ext_info(AlgoType::kDetection, "", "", 0);
+        std::shared_ptr<MemObject<AVFrame>> mem_obj;
+        auto format = size >= 2 ? get_image_format(data, size) : ImageFormat::kNone;
+        if (format == ImageFormat::kJPEG) {
+            mem_obj = image_wrapper::image_jpeg_dec(mem_pool_, data, size, fit_size.first, fit_size.second,
+                                                    &src_width, &src_height);
+        } else if (format == ImageFormat::kPNG) {
+            mem_obj = image_wrapper::image_png_dec(mem_pool_, data, size);
+        } else {
+            throw std::runtime_error("unsupport image format");
+        }
 
-                int index = 0;
+        float scale_x = src_width > 0 ? (float)src_width / mem_obj->data->width : 1;
+        float scale_y = src_height > 0 ? (float)src_height / mem_obj->data->height : 1;
+
+        auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
+        auto frame = std::make_shared<msgs::cv_frame>(uuid, TaskType::kAsyncImage, 1);
+        frame->frame_info = std::make_shared<FrameInfo>(++frame_idx_, mem_obj);
+        frame->response_callback_ = [reply, scale_x, scale_y](const nlohmann::json &data, const bool code) {
+            auto ack_json = nlohmann::json::object();
+            ack_json["success"] = true;
+            ack_json["data"] = data;
+            if (scale_x != 1 || scale_y != 1) { scale_coordinates(ack_json["data"], scale_x, scale_y); }
+            reply(std::move(ack_json));
+        };
+
+        if (!regions.empty()) {
+            // 构造一阶段检测的 ext_info
+            nodes::FrameExtInfo ext_info(AlgoType::kDetection, "", "", 0);
+
+            int index = 0;
+            for (const auto &[key, values] : regions) {
                 std::vector<Point2i> points;
-                for (const auto &[key, values] : regions) {
-                    std::vector<Point2i> points;
-                    for (auto point : values) {
-                        // 兼容比例和坐标
-                        if (point[0] < 1) { point[0] = point[0] * frame->frame_info->width(); }
-                        if (point[1] < 1) { point[1] = point[1] * frame->frame_info->height(); }
-                        points.emplace_back(point[0], point[1]);
-                    }
-                    frame->frame_info->roi_points[key] = points;
-
-                    auto x_compare = [](const Point2i &first, const Point2i &second) { return first.x < second.x; };
-                    auto y_compare = [](const Point2i &first, const Point2i &second) { return first.y < second.y; };
-                    float min_x = (*std::min_element(points.begin(), points.end(), x_compare)).x;
-                    float min_y = (*std::min_element(points.begin(), points.end(), y_compare)).y;
-                    float max_x = (*std::max_element(points.begin(), points.end(), x_compare)).x;
-                    float max_y = (*std::max_element(points.begin(), points.end(), y_compare)).y;
-                    float width = max_x - min_x;
-                    float height = max_y - min_y;
-
-                    if (width > height) {
-                        min_y = min_y - (width - height) / 2;
-                        height = width;
-                    } else {
-                        min_x = min_x - (height - width) / 2;
-                        width = height;
-                    }
-
-                    ext_info.map_target_box.insert(std::make_pair(
-                        index,
-                        BoxInfo{.prev_id = 0,
-                                .class_id = 0,
-                                .prob = 1,
-                                .box = {0, 0, (float)frame->frame_info->width(), (float)frame->frame_info->height()},
-                                .roi_id = key,
-                                .track_id = 0}));
-
-                    ext_info.crop_rects[index] = algin_rect({min_x, min_y, width, height}, frame->frame_info->width(),
-                                                            frame->frame_info->height(), scale_factor_);
-
-                    ++index;
+                for (auto point : values) {
+                    // 兼容比例和坐标
+                    if (point[0] < 1) { point[0] = point[0] * frame->frame_info->width(); }
+                    if (point[1] < 1) { point[1] = point[1] * frame->frame_info->height(); }
+                    points.emplace_back(point[0], point[1]);
+                }
+                frame->frame_info->roi_points[key] = points;
+
+                auto x_compare = [](const Point2i &first, const Point2i &second) { return first.x < second.x; };
+                auto y_compare = [](const Point2i &first, const Point2i &second) { return first.y < second.y; };
+                float min_x = (*std::min_element(points.begin(), points.end(), x_compare)).x;
+                float min_y = (*std::min_element(points.begin(), points.end(), y_compare)).y;
+                float max_x = (*std::max_element(points.begin(), points.end(), x_compare)).x;
+                float max_y = (*std::max_element(points.begin(), points.end(), y_compare)).y;
+                float width = max_x - min_x;
+                float height = max_y - min_y;
+
+                if (width > height) {
+                    min_y = min_y - (width - height) / 2;
+                    height = width;
+                } else {
+                    min_x = min_x - (height - width) / 2;
+                    width = height;
                 }
 
-                ext_info.flag_crop = true;
-                ext_info.crop_images = image_wrapper::image_crop(mem_obj->data, ext_info.crop_rects);
-
-                // index = 0;
-                // for (const auto &item : ext_info.crop_images) {
-                //     cv::Mat crop_image;
-                //     item.second.download(crop_image);
-
-                //     for (const auto &point : frame->frame_info->roi_points[ext_info.map_target_box[index].roi_id]) {
-                //         cv::circle(crop_image,
-                //                    {point.x - ext_info.crop_rects[index].x, point.y - ext_info.crop_rects[index].y}, 2,
-                //                    cv::Scalar(0, 0, 255), -1);
-                //     }
+                ext_info.map_target_box.insert(std::make_pair(
+                    index,
+                    BoxInfo{.prev_id = 0,
+                            .class_id = 0,
+                            .prob = 1,
+                            .box = {0, 0, (float)frame->frame_info->width(), (float)frame->frame_info->height()},
+                            .roi_id = key,
+                            .track_id = 0}));
 
-                //     cv::imwrite("output_" + std::to_string(index++) + ".jpg", crop_image);
-                // }
+                ext_info.crop_rects[index] = algin_rect({min_x, min_y, width, height}, frame->frame_info->width(),
+                                                        frame->frame_info->height(), scale_factor_);
 
-                frame->frame_info->ext_info.emplace_back(ext_info);
+                ++index;
             }
 
-            output_image_(frame);
-        } else {
-            throw std::runtime_error("unsupport image format");
+            ext_info.flag_crop = true;
+            ext_info.crop_images = image_wrapper::image_crop(mem_obj->data, ext_info.crop_rects);
+
+            frame->frame_info->ext_info.emplace_back(std::move(ext_info));
         }
+
+        output_image_(frame);
     } catch (std::exception &exception) {
         auto ack_json = nlohmann::json::object();
         ack_json["success"] = false;
         ack_json["error"] = exception.what();
-        ctx->send(ack_json.dump());
+        reply(std::move(ack_json));
     }
 }
 
@@ -5,13 +5,19 @@
 #ifndef __IMAGE_NODE_V2_HPP__
 #define __IMAGE_NODE_V2_HPP__
 
+#include <chrono>
+#include <condition_variable>
 #include <hv/HttpServer.h>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <opencv2/core/hal/interface.h>
+#include <thread>
 
 #include "message_templates.hpp"
 #include "modules/network/downloader.h"
+#include "modules/network/upload_parser.h"
 #include "node_any_basic.hpp"
 #include "node_msg_def.h"
 #include "utils.hpp"
@@ -21,6 +27,8 @@ namespace nodes {
 
 enum class ImageFormat { kJPEG = 0, kPNG, kNV12, kBGR, kNone };
 
+class BatchResponse;
+
 class ImageServer_v2 : public node_any_basic<ImageServer_v2> {
 private:
     message_pipe<msgs::cv_frame> output_image_;
@@ -32,6 +40,10 @@ public:
         bind_simple_property("task_name", task_name_, ngraph::PropAccess::kPrivate);
         bind_simple_property("srv_port", srv_port_, ngraph::PropAccess::kProtected);
         bind_simple_property("scale_factor", scale_factor_, "缩放系数");
+        bind_simple_property("decode_size", decode_size_, "解码尺寸下限(0 为按下游模型输入尺寸)");
+        bind_simple_property("decode_models", decode_models_, ngraph::PropAccess::kPrivate);
+        bind_simple_property("max_batch_images", max_batch_images_, "批量上传单次最多的图片数");
+        bind_simple_property("batch_timeout_ms", batch_timeout_ms_, "批量上传的最长等待时间，超时未完成的图片返回错误");
 
         register_input_message_handler_(&ImageServer_v2::on_response, this);
     }
@@ -42,14 +54,32 @@ protected:
     void on_setup() override;
 
 private:
+    using ReplyCallback = std::function<void(nlohmann::json)>;
+
     void on_request(const HttpContextPtr &ctx);
-    void on_construct(const std::vector<uchar> &img_data, const nlohmann::json &additional, const HttpContextPtr &ctx);
+    void on_json_request(const HttpContextPtr &ctx);
+    void on_multipart_request(const HttpContextPtr &ctx);
+    void on_construct(const unsigned char *data, const size_t size, const network::RegionMap &regions,
+                      const ReplyCallback &reply);
     void on_response(const std::shared_ptr<msgs::cv_frame> &request);
+    void watch_batches_();
+    std::pair<int, int> fit_size_() const;
 
 private:
     std::string task_name_;
     int srv_port_;
     float scale_factor_{1.5};
+    int decode_size_{0};// 模型输入尺寸，JPEG 按 1/2、1/4、1/8 缩小解码到不小于该尺寸
+    std::vector<std::string> decode_models_;// decode_size 为 0 时取这些模型加载后的输入宽高，为空时解码原图
+    int max_batch_images_{16};// 推理节点最多缓存 20 帧，超出的帧会被丢弃
+    int batch_timeout_ms_{30000};
+
+    // 未完成的批量请求，到期后返回已有的结果
+    std::mutex batch_mutex_;
+    std::condition_variable batch_cv_;
+    std::list<std::pair<std::chrono::steady_clock::time_point, std::weak_ptr<BatchResponse>>> batches_;
+    bool batch_stop_{false};
+    std::thread batch_watchdog_;
 
     int64_t frame_idx_{0};
 
@@ -1,95 +1,59 @@
 #include "media_decoder_node_v2.h"
-#include "codec/mpp_decoder.h"
 #include "node_msg_def.h"
 #include "node_struct_def.h"
 #include "spdlog/spdlog.h"
 #include <algorithm>
-#include <cstdio>
-#include <cstring>
 
 namespace gddi {
 namespace nodes {
 
 void MediaDecoder_v2::on_setup() {
-    hw_type_ = AV_HWDEVICE_TYPE_NONE;
-    demuxer_ = std::make_shared<av_wrapper::Demuxer_v3>();
-    decoder_ = std::make_shared<av_wrapper::Decoder_v3>();
-    open_demuxer();
-}
-
-void MediaDecoder_v2::open_demuxer() {
-    demuxer_->register_open_callback([this](const std::shared_ptr<AVCodecParameters> &codecpar) {
-        frame_rate_ = demuxer_->get_video_frame_rate();
-
-        std::string lower_url;
-        for (char c : input_url_) { lower_url += std::tolower(c); }
-        if (strstr(lower_url.c_str(), "rtsp://") != nullptr || strstr(lower_url.c_str(), "rtmp://") != nullptr) {
-            this->task_type_ = TaskType::kCamera;
-        } else if (strstr(lower_url.c_str(), ".mp4") != nullptr) {
-            this->task_type_ = TaskType::kVideo;
-        } else if (strstr(lower_url.c_str(), ".jpg") != nullptr || strstr(lower_url.c_str(), ".png") != nullptr) {
-            this->task_type_ = TaskType::kImage;
-            frame_rate_ = 1;
-        } else {
-            this->task_type_ = TaskType::kUndefined;
-        }
+    if (frame_skip_ != "auto" && frame_skip_ != "none" && frame_skip_ != "nonref" && frame_skip_ != "key") {
+        spdlog::warn("Undefined frame_skip: {}, using auto", frame_skip_);
+        frame_skip_ = "auto";
+    }
 
-        if (frame_rate_ > 30) { spdlog::warn("Detect frame rate: {}", frame_rate_); }
-        open_decoder(codecpar);
-    });
+    static const std::map<std::string, av_wrapper::DecodeMode> decode_modes{
+        {"auto", av_wrapper::DecodeMode::kAuto},
+        {"hardware", av_wrapper::DecodeMode::kHardware},
+        {"software", av_wrapper::DecodeMode::kSoftware}};
+    auto decode_mode = decode_modes.find(decode_mode_);
+    if (decode_mode == decode_modes.end()) {
+        spdlog::warn("Undefined decode_mode: {}, using auto", decode_mode_);
+        decode_mode = decode_modes.find("auto");
+    }
 
-    demuxer_->register_video_callback([this](const int64_t pakcet_idx, const std::shared_ptr<AVPacket> &packet) {
-        return decoder_->decode_packet(packet);
-    });
+    if (offline_.segment_count < 1 || offline_.segment_index < 0
+        || offline_.segment_index >= offline_.segment_count) {
+        spdlog::warn("Invalid segment: {}/{}, processing the whole file", offline_.segment_index,
+                     offline_.segment_count);
+        offline_.segment_count = 1;
+        offline_.segment_index = 0;
+    }
 
-    demuxer_->register_close_callback([this](bool normal_exit) {
-        if (task_type_ == TaskType::kCamera) {
-            quit_runner_(normal_exit ? TaskErrorCode::kNormal : TaskErrorCode::kDemuxer);
-        } else if (task_type_ == TaskType::kVideo) {
-            auto frame = std::make_shared<msgs::cv_frame>(task_name_, task_type_, frame_rate_, gddi::FrameType::kNone);
-            output_cv_frame_(frame);
-        }
-    });
+    if (offline_.enable && max_pending_frames_ <= 0) {
+        // 离线模式下游不再丢帧，积压只能由解码线程等待来限制
+        spdlog::warn("max_pending_frames must be positive in offline mode, using 8");
+        max_pending_frames_ = 8;
+    }
 
-    demuxer_->open_stream(input_url_,
-                          av_wrapper::DemuxerOptions{.tcp_transport = true, .jump_first_video_i_frame = true});
-}
+    StreamSubscriber subscriber;
+    subscriber.task_name = task_name_;
+    subscriber.frame_rate_limit = frame_rate_limit_;
+    subscriber.frame_skip = frame_skip_;
+    subscriber.decode_mode = decode_mode->second;
+    subscriber.max_pending_frames = std::max(max_pending_frames_, 0);
+    subscriber.packet_ring = av_wrapper::PacketRingRegistry::get_instance().acquire(task_name_);
+    subscriber.offline = offline_;
 
-void MediaDecoder_v2::open_decoder(const std::shared_ptr<AVCodecParameters> &codecpar) {
-    decoder_->register_open_callback([this](const std::shared_ptr<AVCodecParameters> &codecpar) {
+    subscriber.open_cb = [this](const std::shared_ptr<AVCodecParameters> &codecpar) {
         output_open_decoder_(std::make_shared<msgs::av_decode_open>(codecpar.get()));
-    });
-
-    decoder_->register_deocde_callback([this](const int64_t frame_idx, const std::shared_ptr<AVFrame> &avframe) {
-        if (frame_rate_ > 60 || frame_rate_ <= 0) {
-            if (frame_idx == 1) { timestamp_ = std::chrono::system_clock::now(); }
-            if (frame_idx <= 25 * 60) {
-                // 计算 1 min 的平均帧率
-                if (this->task_type_ == TaskType::kCamera) {
-                    frame_rate_ = frame_idx * 1000.0
-                        / std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()
-                                                                                - timestamp_)
-                              .count();
-                } else if (this->task_type_ == TaskType::kImage) {
-                    frame_rate_ = 1;
-                }
-            }
-        }
-        if (frame_idx == 25 * 60) { spdlog::warn("Final frame rate: {}", frame_rate_); }
+    };
+    subscriber.frame_cb = [this](const std::shared_ptr<msgs::cv_frame> &frame) { output_cv_frame_(frame); };
+    subscriber.close_cb = [this](TaskErrorCode exit_code) { quit_runner_(exit_code); };
 
-        auto frame = std::make_shared<msgs::cv_frame>(task_name_, task_type_, frame_rate_);
-        auto mem_obj = image_wrapper::image_from_avframe(mem_pool_, avframe);
-        frame->frame_info = std::make_shared<nodes::FrameInfo>(frame_idx, mem_obj);
-        output_cv_frame_(frame);
-        return true;
-    });
-
-    if (decoder_->open_decoder(codecpar, hw_type_)) {
-        spdlog::info("Success to open decoder");
-    } else {
-        quit_runner_(TaskErrorCode::kDecoder);
-    }
+    subscription_ = StreamRegistry::get_instance().subscribe(input_url_, std::move(subscriber), share_stream_);
 }
 
 }// namespace nodes
-}// namespace gddi
\ No newline at end of file
+}// namespace gddi
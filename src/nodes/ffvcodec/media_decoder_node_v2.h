@@ -7,15 +7,10 @@
 
 #include "basic_logs.hpp"
 #include "message_templates.hpp"
-#include "modules/codec/decode_video_v3.h"
-#include "modules/codec/demux_stream_v3.h"
-#include "modules/codec/filter_video_v3.h"
-#include "modules/codec/mpp_decoder.h"
 #include "node_any_basic.hpp"
 #include "node_msg_def.h"
+#include "stream_registry.h"
 #include "utils.hpp"
-#include <chrono>
-#include <map>
 
 namespace gddi {
 namespace nodes {
@@ -28,6 +23,14 @@ public:
     explicit MediaDecoder_v2(std::string name) : node_any_basic(std::move(name)) {
         bind_simple_property("input_url", input_url_, "输入源地址");
         bind_simple_property("input_type", input_type_, ngraph::PropAccess::kProtected);
+        bind_simple_property("frame_rate_limit", frame_rate_limit_, "解码输出帧率上限，0 表示不限制");
+        bind_simple_property("frame_skip", frame_skip_, "解码跳帧方式: auto, none, nonref, key");
+        bind_simple_property("decode_mode", decode_mode_, "解码方式: auto, hardware, software");
+        bind_simple_property("share_stream", share_stream_, "与使用同一实时流的任务共享解码");
+        bind_simple_property("max_pending_frames", max_pending_frames_, "下游积压帧数上限，超过时丢帧，0 表示不限制");
+        bind_simple_property("offline", offline_.enable, "离线分析视频文件: 不按帧率限速，下游积压时等待而不丢帧");
+        bind_simple_property("segment_count", offline_.segment_count, "离线分析时把视频文件按关键帧切成多段");
+        bind_simple_property("segment_index", offline_.segment_index, "本任务处理的段，多个任务并行处理各段");
 
         //        bind_simple_property("enable_acc", enable_acc_);  // 暂不处理音频
         bind_simple_property("task_name", task_name_, ngraph::PropAccess::kPrivate);
@@ -36,33 +39,25 @@ public:
         output_cv_frame_ = register_output_message_<msgs::cv_frame>();
     }
 
-    ~MediaDecoder_v2() { demuxer_.reset(); }
+    ~MediaDecoder_v2() { subscription_.reset(); }
 
 protected:
     void on_setup() override;
 
-    void open_demuxer();
-    void open_decoder(const std::shared_ptr<AVCodecParameters> &codecpar);
-
 private:
     std::string task_name_;
     std::string input_url_;
     std::string input_type_;
     bool enable_acc_ = false;
 
-    TaskType task_type_ = TaskType::kCamera;
-    ImagePool mem_pool_;
-    AVHWDeviceType hw_type_ = AV_HWDEVICE_TYPE_NONE;
-
-    double frame_rate_{25};
-    std::chrono::system_clock::time_point timestamp_;
-    std::shared_ptr<av_wrapper::Demuxer_v3> demuxer_;
+    float frame_rate_limit_{0};     // 超出部分在转换图像之前丢弃
+    std::string frame_skip_{"auto"};// auto: 按帧率上限和关键帧间隔自动选择
+    std::string decode_mode_{"auto"};// auto: 优先硬件解码，失败时使用软件解码
+    bool share_stream_{true};
+    int max_pending_frames_{8};
+    OfflineOptions offline_;
 
-#if defined(WITH_RV1126)
-    std::shared_ptr<av_wrapper::MppDecoder> decoder_;
-#else
-    std::shared_ptr<av_wrapper::Decoder_v3> decoder_;
-#endif
+    std::unique_ptr<StreamSubscription> subscription_;
 };
 
 }// namespace nodes
@@ -0,0 +1,385 @@
+#include "stream_registry.h"
+#include "node_struct_def.h"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace gddi {
+namespace nodes {
+
+av_wrapper::FrameSkip select_frame_skip(const std::string &mode, float frame_rate_limit, double frame_rate,
+                                        int64_t key_interval, TaskType task_type) {
+    if (mode == "nonref") { return av_wrapper::FrameSkip::kNonRef; }
+    if (mode == "key") { return av_wrapper::FrameSkip::kNonKey; }
+    if (mode == "auto" && task_type != TaskType::kImage && frame_rate_limit > 0 && frame_rate > 0) {
+        if (key_interval > 0 && frame_rate_limit * key_interval <= frame_rate) {
+            // 关键帧已足够达到帧率上限
+            return av_wrapper::FrameSkip::kNonKey;
+        } else if (frame_rate_limit * 3 <= frame_rate) {
+            // IBBP 结构下参考帧仍不低于帧率上限
+            return av_wrapper::FrameSkip::kNonRef;
+        }
+    }
+    return av_wrapper::FrameSkip::kNone;
+}
+
+std::shared_ptr<FrameReleaseToken> make_release_token(size_t max_pending_frames,
+                                                      const std::shared_ptr<std::atomic<size_t>> &pending_frames,
+                                                      const std::shared_ptr<std::condition_variable> &frame_released) {
+    if (max_pending_frames == 0) { return nullptr; }
+
+    ++*pending_frames;
+    return std::make_shared<FrameReleaseToken>([pending_frames, frame_released]() {
+        --*pending_frames;
+        frame_released->notify_all();
+    });
+}
+
+std::string normalize_stream_url(const std::string &url) {
+    auto first = url.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) { return ""; }
+    auto result = url.substr(first, url.find_last_not_of(" \t\r\n") - first + 1);
+
+    auto scheme_end = result.find("://");
+    if (scheme_end == std::string::npos) { return result; }
+
+    // 协议和主机名不区分大小写，用户名密码和路径区分
+    auto host_begin = scheme_end + 3;
+    auto host_end = std::min(result.find('/', host_begin), result.size());
+    auto at = result.rfind('@', host_end);
+    if (at != std::string::npos && at >= host_begin) { host_begin = at + 1; }
+    std::transform(result.begin(), result.begin() + scheme_end, result.begin(), ::tolower);
+    std::transform(result.begin() + host_begin, result.begin() + host_end, result.begin() + host_begin, ::tolower);
+
+    static const std::map<std::string, std::string> default_ports{
+        {"rtsp", ":554"}, {"rtmp", ":1935"}, {"http", ":80"}, {"https", ":443"}};
+    auto port = default_ports.find(result.substr(0, scheme_end));
+    if (port != default_ports.end() && host_end - host_begin > port->second.size()
+        && result.compare(host_end - port->second.size(), port->second.size(), port->second) == 0) {
+        result.erase(host_end - port->second.size(), port->second.size());
+    }
+
+    while (result.size() > scheme_end + 3 && result.back() == '/') { result.pop_back(); }
+    return result;
+}
+
+TaskType task_type_from_url(const std::string &url) {
+    std::string lower_url;
+    for (char c : url) { lower_url += std::tolower(c); }
+    if (lower_url.find("rtsp://") != std::string::npos || lower_url.find("rtmp://") != std::string::npos) {
+        return TaskType::kCamera;
+    } else if (lower_url.find(".mp4") != std::string::npos) {
+        return TaskType::kVideo;
+    } else if (lower_url.find(".jpg") != std::string::npos || lower_url.find(".png") != std::string::npos) {
+        return TaskType::kImage;
+    }
+    return TaskType::kUndefined;
+}
+
+SharedStream::SharedStream(std::string url, const OfflineOptions &offline, av_wrapper::DecodeMode decode_mode)
+    : url_(std::move(url)), task_type_(task_type_from_url(url_)), offline_(offline), decode_mode_(decode_mode) {
+    if (task_type_ == TaskType::kCamera) { offline_ = {}; }
+    offline_.segment_count = std::max(offline_.segment_count, 1);
+    demuxer_ = std::make_unique<av_wrapper::Demuxer_v3>();
+    decoder_ = std::make_unique<av_wrapper::Decoder_v3>();
+    decoder_->set_decode_mode(decode_mode_);
+}
+
+SharedStream::~SharedStream() {
+    // 先停止解封装线程，之后不会再有回调
+    demuxer_.reset();
+    decoder_.reset();
+}
+
+void SharedStream::open() {
+    demuxer_->register_open_callback(
+        [this](const std::shared_ptr<AVCodecParameters> &codecpar) { on_demuxer_open(codecpar); });
+    demuxer_->register_video_callback([this](const int64_t packet_idx, const std::shared_ptr<AVPacket> &packet) {
+        return on_packet(packet_idx, packet);
+    });
+    demuxer_->register_close_callback([this](bool normal_exit) { on_close(normal_exit); });
+
+    decoder_->register_open_callback(
+        [this](const std::shared_ptr<AVCodecParameters> &codecpar) { decoder_codecpar_ = codecpar; });
+    decoder_->register_deocde_callback([this](const int64_t frame_idx, const std::shared_ptr<AVFrame> &avframe) {
+        return on_frame(frame_idx, avframe);
+    });
+
+    demuxer_->open_stream(url_, av_wrapper::DemuxerOptions{.tcp_transport = true,
+                                                           .jump_first_video_i_frame = true,
+                                                           .offline = offline_.enable,
+                                                           .segment_count = offline_.segment_count,
+                                                           .segment_index = offline_.segment_index});
+}
+
+int SharedStream::subscribe(StreamSubscriber subscriber) {
+    std::unique_lock<std::mutex> lk(mutex_);
+
+    // 输入源已打开，加入前补发打开回调；补发期间解码器重新打开时再补发一次
+    std::shared_ptr<AVCodecParameters> replayed_codecpar;
+    while (subscriber.open_cb && decoder_codecpar_ != replayed_codecpar) {
+        replayed_codecpar = decoder_codecpar_;
+        lk.unlock();
+        subscriber.open_cb(replayed_codecpar);
+        lk.lock();
+    }
+
+    auto id = next_id_++;
+    auto &subscription = subscriptions_[id];
+    subscription.decimator = FrameDecimator(subscriber.frame_rate_limit);
+    subscription.pending_frames = std::make_shared<std::atomic<size_t>>(0);
+    subscription.subscriber = std::move(subscriber);
+
+    // 预录缓存从下一个关键帧开始
+    auto &added = subscription.subscriber;
+    if (demuxer_codecpar_ && added.packet_ring && task_type_ != TaskType::kImage) {
+        added.packet_ring->open(demuxer_codecpar_, time_base_, av_d2q(frame_rate_, 1000));
+    }
+
+    if (subscriptions_.size() > 1) {
+        spdlog::info("Share stream: {}, task: {}, subscribers: {}", url_, added.task_name, subscriptions_.size());
+    }
+    update_frame_skip_();
+    return id;
+}
+
+void SharedStream::unsubscribe(int id) {
+    std::unique_lock<std::mutex> lk(mutex_);
+    auto iter = subscriptions_.find(id);
+    if (iter == subscriptions_.end()) { return; }
+    if (iter->second.dropped_frames > 0) {
+        spdlog::info("Stream: {}, task: {}, dropped {} frames for slow consumer", url_,
+                     iter->second.subscriber.task_name, iter->second.dropped_frames);
+    }
+    subscriptions_.erase(iter);
+    update_frame_skip_();
+    frame_released_->notify_all();
+
+    // 解码线程可能正在调用该订阅者复制出的回调
+    if (dispatching_ && dispatch_thread_ != std::this_thread::get_id()) {
+        dispatch_done_.wait(lk, [this] { return !dispatching_; });
+    }
+}
+
+void SharedStream::dispatch_(std::unique_lock<std::mutex> &lk, std::vector<std::function<void()>> &calls) {
+    if (calls.empty()) { return; }
+
+    dispatching_ = true;
+    dispatch_thread_ = std::this_thread::get_id();
+    lk.unlock();
+    for (auto &call : calls) { call(); }
+    calls.clear();
+    lk.lock();
+    dispatching_ = false;
+    dispatch_done_.notify_all();
+}
+
+void SharedStream::on_demuxer_open(const std::shared_ptr<AVCodecParameters> &codecpar) {
+    std::unique_lock<std::mutex> lk(mutex_);
+    std::vector<std::function<void()>> calls;
+    frame_rate_ = demuxer_->get_video_frame_rate();
+    time_base_ = demuxer_->get_video_time_base();
+    if (task_type_ == TaskType::kImage) { frame_rate_ = 1; }
+    if (frame_rate_ > 30) { spdlog::warn("Detect frame rate: {}", frame_rate_); }
+
+    demuxer_codecpar_ = codecpar;
+    if (task_type_ != TaskType::kImage) {
+        for (auto &[id, subscription] : subscriptions_) {
+            if (subscription.subscriber.packet_ring) {
+                subscription.subscriber.packet_ring->open(codecpar, time_base_, av_d2q(frame_rate_, 1000));
+            }
+        }
+    }
+
+    if (!decoder_->open_decoder(codecpar)) {
+        for (auto &[id, subscription] : subscriptions_) {
+            if (auto close_cb = subscription.subscriber.close_cb) {
+                calls.emplace_back([close_cb]() { close_cb(TaskErrorCode::kDecoder); });
+            }
+        }
+        dispatch_(lk, calls);
+        return;
+    }
+
+    spdlog::info("Success to open decoder");
+    for (auto &[id, subscription] : subscriptions_) {
+        if (auto open_cb = subscription.subscriber.open_cb) {
+            calls.emplace_back([open_cb, codecpar = decoder_codecpar_]() { open_cb(codecpar); });
+        }
+    }
+    update_frame_skip_();
+    dispatch_(lk, calls);
+}
+
+bool SharedStream::on_packet(int64_t packet_idx, const std::shared_ptr<AVPacket> &packet) {
+    {
+        std::lock_guard<std::mutex> glk(mutex_);
+        // 分段读取时包序号从该段在文件中的位置开始
+        if (frame_idx_offset_ < 0) { frame_idx_offset_ = offline_.segment_count > 1 ? packet_idx - 1 : 0; }
+        if (packet->flags & AV_PKT_FLAG_KEY) {
+            if (last_key_packet_idx_ > 0) { key_interval_ = packet_idx - last_key_packet_idx_; }
+            last_key_packet_idx_ = packet_idx;
+            update_frame_skip_();
+        }
+        // 摄像头和视频文件都缓存压缩包，事件视频直接从中导出
+        if (task_type_ != TaskType::kImage) {
+            for (auto &[id, subscription] : subscriptions_) {
+                if (subscription.subscriber.packet_ring) { subscription.subscriber.packet_ring->push_packet(packet); }
+            }
+        }
+    }
+    return decoder_->decode_packet(packet);
+}
+
+void SharedStream::update_frame_rate_(int64_t frame_idx) {
+    if (frame_rate_ > 60 || frame_rate_ <= 0) {
+        if (frame_idx == 1) { timestamp_ = std::chrono::system_clock::now(); }
+        if (frame_idx <= 25 * 60) {
+            // 计算 1 min 的平均帧率
+            if (task_type_ == TaskType::kCamera) {
+                frame_rate_ = frame_idx * 1000.0
+                    / std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()
+                                                                            - timestamp_)
+                          .count();
+            } else if (task_type_ == TaskType::kImage) {
+                frame_rate_ = 1;
+            }
+        }
+    }
+    if (frame_idx == 25 * 60) { spdlog::warn("Final frame rate: {}", frame_rate_); }
+}
+
+bool SharedStream::backlogged_() const {
+    for (const auto &[id, subscription] : subscriptions_) {
+        auto max_pending_frames = subscription.subscriber.max_pending_frames;
+        if (max_pending_frames > 0 && *subscription.pending_frames >= max_pending_frames) { return true; }
+    }
+    return false;
+}
+
+bool SharedStream::on_frame(int64_t frame_idx, const std::shared_ptr<AVFrame> &avframe) {
+    std::unique_lock<std::mutex> lk(mutex_);
+    if (offline_.enable) {
+        // 离线模式不丢帧，解码线程等待最慢的节点释放积压的帧，解封装随之阻塞
+        // 释放帧时不持有 mutex_，通知可能错过，等待超时后重新检查
+        while (backlogged_()) { frame_released_->wait_for(lk, std::chrono::milliseconds(10)); }
+    }
+    update_frame_rate_(frame_idx);
+    auto video_frame_idx = frame_idx + std::max<int64_t>(frame_idx_offset_, 0);
+
+    // 只有至少一个订阅者需要这一帧时才转换图像，转换结果所有订阅者共享
+    std::shared_ptr<MemObject<AVFrame>> mem_obj;
+    std::vector<std::function<void()>> calls;
+    for (auto &[id, subscription] : subscriptions_) {
+        auto &subscriber = subscription.subscriber;
+        if (!subscription.decimator.accept(frame_idx, frame_rate_)) { continue; }
+        bool limited = subscription.decimator.limited(frame_rate_);
+        auto infer_frame_idx = subscription.output_frame_idx++;
+
+        // 下游来不及处理时只丢弃该任务的帧，不影响其它订阅者
+        auto &pending_frames = subscription.pending_frames;
+        if (subscriber.max_pending_frames > 0 && *pending_frames >= subscriber.max_pending_frames) {
+            if (subscription.dropped_frames++ % 250 == 0) {
+                spdlog::warn("Stream: {}, task: {} is too slow, {} frames pending, dropped {} frames", url_,
+                             subscriber.task_name, pending_frames->load(), subscription.dropped_frames);
+            }
+            continue;
+        }
+
+        if (!mem_obj) { mem_obj = image_wrapper::image_from_avframe(mem_pool_, avframe); }
+        auto frame = std::make_shared<msgs::cv_frame>(subscriber.task_name, task_type_, frame_rate_);
+        frame->frame_info = std::make_shared<nodes::FrameInfo>(video_frame_idx, mem_obj);
+
+        // 下游节点拷贝 cv_frame 时共享凭证，所有拷贝都释放后才算处理完
+        frame->frame_info->release_token =
+            make_release_token(subscriber.max_pending_frames, pending_frames, frame_released_);
+        if (offline_.enable) {
+            // 离线分析比实时快，使用帧在文件中的时间
+            frame->frame_info->timestamp = std::llround((video_frame_idx - 1) * 1000.0 / frame_rate_);
+        }
+        if (limited) {
+            // 下游按推理帧序号和推理帧率继续抽帧，抽帧后两者都以输出帧为准
+            frame->infer_frame_rate = subscription.decimator.frame_rate_limit();
+            frame->frame_info->infer_frame_idx = infer_frame_idx;
+        }
+        if (auto frame_cb = subscriber.frame_cb) { calls.emplace_back([frame_cb, frame]() { frame_cb(frame); }); }
+    }
+    dispatch_(lk, calls);
+    return true;
+}
+
+void SharedStream::on_close(bool normal_exit) {
+    std::unique_lock<std::mutex> lk(mutex_);
+    closed_ = true;
+    std::vector<std::function<void()>> calls;
+    for (auto &[id, subscription] : subscriptions_) {
+        auto &subscriber = subscription.subscriber;
+        if (task_type_ == TaskType::kCamera && subscriber.close_cb) {
+            auto exit_code = normal_exit ? TaskErrorCode::kNormal : TaskErrorCode::kDemuxer;
+            calls.emplace_back([close_cb = subscriber.close_cb, exit_code]() { close_cb(exit_code); });
+        } else if (task_type_ == TaskType::kVideo && subscriber.frame_cb) {
+            auto frame =
+                std::make_shared<msgs::cv_frame>(subscriber.task_name, task_type_, frame_rate_, gddi::FrameType::kNone);
+            calls.emplace_back([frame_cb = subscriber.frame_cb, frame]() { frame_cb(frame); });
+        }
+    }
+    dispatch_(lk, calls);
+}
+
+void SharedStream::update_frame_skip_() {
+    // 取所有订阅者中跳得最少的方式，保证每个订阅者都能拿到需要的帧
+    auto skip = av_wrapper::FrameSkip::kNonKey;
+    for (const auto &[id, subscription] : subscriptions_) {
+        const auto &subscriber = subscription.subscriber;
+        skip = std::min(skip, select_frame_skip(subscriber.frame_skip, subscriber.frame_rate_limit, frame_rate_,
+                                                key_interval_, task_type_));
+    }
+    if (subscriptions_.empty()) { skip = av_wrapper::FrameSkip::kNone; }
+    decoder_->set_frame_skip(skip);
+}
+
+StreamRegistry &StreamRegistry::get_instance() {
+    static StreamRegistry instance;
+    return instance;
+}
+
+std::unique_ptr<StreamSubscription> StreamRegistry::subscribe(const std::string &url, StreamSubscriber subscriber,
+                                                              bool share) {
+    auto key = normalize_stream_url(url);
+    share = share && task_type_from_url(key) == TaskType::kCamera;
+
+    std::shared_ptr<SharedStream> stream;
+    bool created = false;
+    {
+        std::lock_guard<std::mutex> glk(mutex_);
+        if (share) { stream = streams_[key].lock(); }
+        if (!stream || stream->closed()) {
+            stream = std::make_shared<SharedStream>(key, subscriber.offline, subscriber.decode_mode);
+            created = true;
+            if (share) { streams_[key] = stream; }
+        } else if (stream->decode_mode() != subscriber.decode_mode) {
+            spdlog::warn("Share stream: {}, task: {}, decode mode is decided by the first task", key,
+                         subscriber.task_name);
+        }
+
+        // 清理已关闭的输入源
+        for (auto iter = streams_.begin(); iter != streams_.end();) {
+            iter = iter->second.expired() ? streams_.erase(iter) : ++iter;
+        }
+    }
+
+    auto id = stream->subscribe(std::move(subscriber));
+    if (created) { stream->open(); }
+    return std::make_unique<StreamSubscription>(stream, id);
+}
+
+size_t StreamRegistry::stream_count() {
+    std::lock_guard<std::mutex> glk(mutex_);
+    size_t count = 0;
+    for (const auto &[key, stream] : streams_) { count += !stream.expired(); }
+    return count;
+}
+
+}// namespace nodes
+}// namespace gddi
@@ -0,0 +1,239 @@
+#ifndef __STREAM_REGISTRY_H__
+#define __STREAM_REGISTRY_H__
+
+#include "modules/codec/decode_video_v3.h"
+#include "modules/codec/demux_stream_v3.h"
+#include "modules/codec/packet_ring_buffer.h"
+#include "modules/wrapper/image_decoder.h"
+#include "node_msg_def.h"
+#include "runnable_node.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gddi {
+namespace nodes {
+
+/**
+ * @brief 按帧率上限抽帧，frame_idx 为码流帧序号，跳帧解码时可以不连续
+ */
+class FrameDecimator {
+public:
+    explicit FrameDecimator(float frame_rate_limit = 0) : frame_rate_limit_(frame_rate_limit) {}
+
+    bool limited(double frame_rate) const { return frame_rate_limit_ > 0 && frame_rate_limit_ < frame_rate; }
+
+    bool accept(int64_t frame_idx, double frame_rate) {
+        if (!limited(frame_rate)) { return true; }
+        if (frame_idx < next_output_idx_) { return false; }
+        auto step = frame_rate / frame_rate_limit_;
+        next_output_idx_ += step;
+        if (next_output_idx_ <= frame_idx) { next_output_idx_ = frame_idx + step; }
+        return true;
+    }
+
+    float frame_rate_limit() const { return frame_rate_limit_; }
+
+private:
+    float frame_rate_limit_;
+    double next_output_idx_{0};// 下一个输出帧的码流帧序号
+};
+
+/**
+ * @brief 按帧率上限和关键帧间隔选择解码跳帧方式
+ *
+ * @param mode auto, none, nonref, key
+ * @param key_interval 关键帧间隔(帧)，未知时为 0
+ */
+av_wrapper::FrameSkip select_frame_skip(const std::string &mode, float frame_rate_limit, double frame_rate,
+                                        int64_t key_interval, TaskType task_type);
+
+/**
+ * @brief 为输出帧计入一帧积压，返回帧所有拷贝释放时减回的凭证
+ *
+ *        max_pending_frames 为 0 (不限制) 时不计数并返回空，下游节点按无凭证的帧自行限制积压
+ */
+std::shared_ptr<FrameReleaseToken> make_release_token(size_t max_pending_frames,
+                                                      const std::shared_ptr<std::atomic<size_t>> &pending_frames,
+                                                      const std::shared_ptr<std::condition_variable> &frame_released);
+
+/**
+ * @brief 去掉首尾空白和末尾的 '/'，协议和主机名转小写，去掉协议默认端口，用于判断是否同一输入源
+ */
+std::string normalize_stream_url(const std::string &url);
+
+TaskType task_type_from_url(const std::string &url);
+
+/**
+ * @brief 视频文件的离线分析方式，实时流忽略
+ */
+struct OfflineOptions {
+    bool enable{false};  // 不按帧率限速读取，下游积压时等待最慢的节点而不丢帧
+    int segment_count{1};// 按关键帧把文件切成多段，每段由一个任务处理，各任务的结果按时间戳合并
+    int segment_index{0};// 本任务处理的段
+};
+
+/**
+ * @brief 输入源的一个订阅者(任务)，回调在解码线程中调用，调用时不持有 SharedStream 的锁
+ */
+struct StreamSubscriber {
+    std::string task_name;
+    float frame_rate_limit{0};      // 该任务的输出帧率上限，0 表示不限制
+    std::string frame_skip{"auto"}; // 该任务可接受的解码跳帧方式
+    size_t max_pending_frames{8};   // 已输出但下游未释放的帧数上限，超过时只丢弃该任务的帧，0 表示不限制
+                                    // 帧的所有拷贝都释放后才算释放，见 FrameInfo::release_token
+    std::shared_ptr<av_wrapper::PacketRingBuffer> packet_ring;// 事件预录，可以为空
+    OfflineOptions offline;                                   // 视频文件不共享，由唯一的订阅者决定
+    av_wrapper::DecodeMode decode_mode{av_wrapper::DecodeMode::kAuto};// 共享时由打开输入源的订阅者决定
+
+    std::function<void(const std::shared_ptr<AVCodecParameters> &)> open_cb;
+    std::function<void(const std::shared_ptr<msgs::cv_frame> &)> frame_cb;
+    std::function<void(TaskErrorCode exit_code)> close_cb;// 实时流退出或打开解码器失败
+};
+
+/**
+ * @brief 一个输入源的解封装和解码，解码帧转换一次后分发给所有订阅者
+ *
+ *        每个订阅者按自己的帧率上限抽帧，解码跳帧方式取所有订阅者中跳得最少的一种；
+ *        订阅者之间共享帧图像 (src_frame)，FrameInfo 各自独立。视频文件结束时输出 FrameType::kNone 帧。
+ *        最后一个订阅者退出后关闭输入源。
+ *        离线模式下帧序号为整个文件中的序号，时间戳为帧在文件中的时间(ms)，同一文件各段的结果可以直接合并。
+ */
+class SharedStream {
+public:
+    explicit SharedStream(std::string url, const OfflineOptions &offline = {},
+                          av_wrapper::DecodeMode decode_mode = av_wrapper::DecodeMode::kAuto);
+    ~SharedStream();
+
+    SharedStream(const SharedStream &) = delete;
+    SharedStream &operator=(const SharedStream &) = delete;
+
+    void open();
+
+    /**
+     * @brief 输入源已打开时先在调用线程中回调 open_cb 再加入，保证先收到 open_cb 再收到帧，返回订阅 ID
+     */
+    int subscribe(StreamSubscriber subscriber);
+
+    /**
+     * @brief 等待进行中的回调结束，返回后不再回调该订阅者；在回调中调用时不等待
+     */
+    void unsubscribe(int id);
+
+    bool closed() const { return closed_; }
+    const std::string &url() const { return url_; }
+    TaskType task_type() const { return task_type_; }
+    av_wrapper::DecodeMode decode_mode() const { return decode_mode_; }
+
+private:
+    struct Subscription {
+        StreamSubscriber subscriber;
+        FrameDecimator decimator;
+        int64_t output_frame_idx{1};
+        std::shared_ptr<std::atomic<size_t>> pending_frames;
+        size_t dropped_frames{0};
+    };
+
+    void on_demuxer_open(const std::shared_ptr<AVCodecParameters> &codecpar);
+    bool on_packet(int64_t packet_idx, const std::shared_ptr<AVPacket> &packet);
+    bool on_frame(int64_t frame_idx, const std::shared_ptr<AVFrame> &avframe);
+    void on_close(bool normal_exit);
+
+    void update_frame_skip_();
+    void update_frame_rate_(int64_t frame_idx);
+    bool backlogged_() const;
+
+    /**
+     * @brief 释放 mutex_ 后依次调用，回调中可以订阅或取消订阅
+     */
+    void dispatch_(std::unique_lock<std::mutex> &lk, std::vector<std::function<void()>> &calls);
+
+private:
+    std::string url_;
+    TaskType task_type_;
+    std::atomic_bool closed_{false};
+    OfflineOptions offline_;
+    av_wrapper::DecodeMode decode_mode_;
+
+    std::mutex mutex_;
+    std::map<int, Subscription> subscriptions_;
+    int next_id_{0};
+
+    bool dispatching_{false};// 解码线程正在调用回调
+    std::thread::id dispatch_thread_;
+    std::condition_variable dispatch_done_;
+
+    ImagePool mem_pool_;
+    double frame_rate_{25};
+    int64_t last_key_packet_idx_{0};
+    int64_t key_interval_{0};
+    std::chrono::system_clock::time_point timestamp_;
+    std::shared_ptr<AVCodecParameters> demuxer_codecpar_;
+    std::shared_ptr<AVCodecParameters> decoder_codecpar_;
+    AVRational time_base_{1, 90000};
+    int64_t frame_idx_offset_{-1};// 分段时第一个包在整个文件中的帧序号 - 1
+
+    // 下游释放帧时通知，离线模式下解码线程等待积压的帧被处理；帧可能比 SharedStream 活得久
+    std::shared_ptr<std::condition_variable> frame_released_{std::make_shared<std::condition_variable>()};
+
+    std::unique_ptr<av_wrapper::Demuxer_v3> demuxer_;
+    std::unique_ptr<av_wrapper::Decoder_v3> decoder_;
+};
+
+/**
+ * @brief 订阅凭证，析构时取消订阅，最后一个凭证释放后输入源随之关闭
+ */
+class StreamSubscription {
+public:
+    StreamSubscription(std::shared_ptr<SharedStream> stream, int id) : stream_(std::move(stream)), id_(id) {}
+    ~StreamSubscription() { stream_->unsubscribe(id_); }
+
+    StreamSubscription(const StreamSubscription &) = delete;
+    StreamSubscription &operator=(const StreamSubscription &) = delete;
+
+    const std::shared_ptr<SharedStream> &stream() const { return stream_; }
+
+private:
+    std::shared_ptr<SharedStream> stream_;
+    int id_;
+};
+
+/**
+ * @brief 进程内按输入源地址共享解码，多个任务使用同一路摄像头时只拉流解码一次
+ *
+ *        只共享实时流 (rtsp / rtmp)，视频文件和图片每个任务从头读取，不共享。
+ */
+class StreamRegistry {
+public:
+    StreamRegistry(const StreamRegistry &) = delete;
+    StreamRegistry &operator=(const StreamRegistry &) = delete;
+
+    static StreamRegistry &get_instance();
+
+    /**
+     * @brief 订阅输入源，share 为 false 时总是单独打开
+     */
+    std::unique_ptr<StreamSubscription> subscribe(const std::string &url, StreamSubscriber subscriber,
+                                                  bool share = true);
+
+    size_t stream_count();
+
+private:
+    StreamRegistry() = default;
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<SharedStream>> streams_;
+};
+
+}// namespace nodes
+}// namespace gddi
+
+#endif//__STREAM_REGISTRY_H__
@@ -6,7 +6,7 @@
 #define __JPEG_PREVIEWER_V2__
 
 #include "modules/network/zmq_socket.h"
-#include "modules/wrapper/tsing_jpeg_encode.h"
+#include "modules/wrapper/jpeg_encoder.h"
 #include "node_struct_def.h"
 #include "nodes/node_any_basic.hpp"
 #include <opencv2/imgcodecs.hpp>
@@ -40,15 +40,7 @@ public:
             if (masking_) {
                 // 每分钟更新一次背景
                 if (frame->frame_info->ext_info.front().infer_target_info.empty()) {
-                    if (!jpeg_encoder_) {
-                        jpeg_encoder_ = std::make_unique<codec::TsingJpegEncode>();
-                        if (!jpeg_encoder_->init_codecer(frame->frame_info->width(), frame->frame_info->height())) {
-                            jpeg_encoder_.reset();
-                            return;
-                        }
-                    }
-
-                    jpeg_encoder_->codec_image(frame->frame_info->src_frame->data, jpeg_data_.data());
+                    encode_image_(frame->frame_info->src_frame->data);
                 }
             }
 
@@ -296,15 +288,8 @@ public:
             auto tgt_frame =
                 image_wrapper::image_resize(frame->frame_info->src_frame->data, frame->frame_info->width() / scale_,
                                             frame->frame_info->height() / scale_);
-            if (!jpeg_encoder_) {
-                jpeg_encoder_ = std::make_unique<codec::TsingJpegEncode>();
-                if (!jpeg_encoder_->init_codecer(frame->frame_info->width(), frame->frame_info->height())) {
-                    jpeg_encoder_.reset();
-                    return;
-                }
-            }
-
-            int jpeg_data_size = jpeg_encoder_->codec_image(frame->frame_info->src_frame->data, jpeg_data_.data());
+            int jpeg_data_size = encode_image_(tgt_frame);
+            if (jpeg_data_size == 0) { return; }
             buffer = std::vector<uchar>(4 + jpeg_data_size + box_string.size());
             memcpy(buffer.data(), &jpeg_data_size, sizeof(jpeg_data_size));
             memcpy(buffer.data() + sizeof(jpeg_data_size), jpeg_data_.data(), jpeg_data_size);
@@ -314,6 +299,25 @@ public:
         });
     }
 
+private:
+    /**
+     * @brief 编码到 jpeg_data_，硬件通道按实际编码的 (缩放后) 尺寸和 quality 创建，尺寸变化时重新创建
+     */
+    uint32_t encode_image_(const std::shared_ptr<AVFrame> &image) {
+        if (jpeg_encoder_ && (jpeg_encoder_->width() != (uint32_t)image->width
+                              || jpeg_encoder_->height() != (uint32_t)image->height)) {
+            jpeg_encoder_.reset();
+        }
+        if (!jpeg_encoder_) {
+            jpeg_encoder_ = std::make_unique<codec::JpegEncoder>();
+            if (!jpeg_encoder_->init_codecer(image->width, image->height, quality_)) {
+                jpeg_encoder_.reset();
+                return 0;
+            }
+        }
+        return jpeg_encoder_->codec_image(image, jpeg_data_, quality_);
+    }
+
 private:
     std::string address_{"tcp://*:9000"};
     std::string node_name_;
@@ -321,9 +325,9 @@ private:
     int scale_{1};
     bool masking_{false};
 
-    std::array<uint8_t, 4096 * 2160> jpeg_data_;
+    std::vector<uint8_t> jpeg_data_;// 编码缓冲，多帧之间复用
 
-    std::unique_ptr<codec::TsingJpegEncode> jpeg_encoder_;
+    std::unique_ptr<codec::JpegEncoder> jpeg_encoder_;
 };// namespace nodes
 
 }// namespace nodes
@@ -87,7 +87,7 @@ inline ngraph::endpoint::DataFeatures gen_data_features() {
                     ? utils::demangle(typeid(typename has_simple_message<AnyMessageType_>::message_type).name())
                     : utils::demangle(typeid(AnyMessageType_).name());
 
-    return {rm_namespaces(rm_head_cls(rm_tail_ptr(fullname)))};
+    return {rm_namespaces(rm_head_cls(rm_tail_ptr(fullname))), ngraph::endpoint::type_id_of<AnyMessageType_>()};
 }
 
 }
@@ -62,24 +62,37 @@ public:
     using message_pipe = std::function<void(const std::shared_ptr<Message_> &)>;
 
 protected:
+    /**
+     * @brief 端点总是带有 Message_ 的类型标识，自定义的 data_feature 只替换名称
+     */
+    template<class Message_>
+    static ngraph::endpoint::DataFeatures typed_data_features_(const ngraph::endpoint::DataFeatures &data_feature) {
+        auto features = data_feature.data_features.empty() ? gen_data_features<Message_>() : data_feature;
+        features.type_id = ngraph::endpoint::type_id_of<Message_>();
+        return features;
+    }
+
     template<class Message_>
     message_pipe<Message_>
     register_output_message_(const ngraph::endpoint::DataFeatures &data_feature = {}) {
         int endpoint_id = (int)output_endpoints_.size();
-        output_endpoints_.push_back(data_feature.data_features.empty() ? gen_data_features<Message_>() : data_feature);
+        output_endpoints_.push_back(typed_data_features_<Message_>(data_feature));
         return [=](const std::shared_ptr<Message_> &message) { push_output_endpoint(endpoint_id, message); };
     }
 
+    /**
+     * @brief 消息类型已经在 connect_to 时按类型标识校验过，分发时直接 static_cast
+     */
     template<class Message_, class Class_>
     message_pipe<Message_>
     register_input_message_handler_(const ngraph::endpoint::DataFeatures &data_feature,
                                     void (Class_::* handler)(const std::shared_ptr<Message_> &),
                                     Class_ *this_ptr) {
         int endpoint_id = (int)input_endpoints_.size();
-        input_endpoints_.emplace_back(data_feature, [handler, this_ptr](const ngraph::MessagePtr &message) {
-            auto msg = std::dynamic_pointer_cast<Message_>(message);
-            if (msg) { (*this_ptr.*handler)(msg); }
-        });
+        input_endpoints_.emplace_back(typed_data_features_<Message_>(data_feature),
+                                      [handler, this_ptr](const ngraph::MessagePtr &message) {
+                                          (*this_ptr.*handler)(std::static_pointer_cast<Message_>(message));
+                                      });
         return [=](const std::shared_ptr<Message_> &message) { push_input_endpoint(endpoint_id, message); };
     }
 
@@ -88,11 +101,10 @@ protected:
     register_input_message_handler_(const ngraph::endpoint::DataFeatures &data_feature,
                                     const std::function<void(const std::shared_ptr<Message_> &)> &handler) {
         int endpoint_id = (int)input_endpoints_.size();
-        input_endpoints_.emplace_back(data_feature, [handler](const ngraph::MessagePtr &message) {
-
-            auto msg = std::dynamic_pointer_cast<Message_>(message);
-            if (msg) { handler(msg); }
-        });
+        input_endpoints_.emplace_back(typed_data_features_<Message_>(data_feature),
+                                      [handler](const ngraph::MessagePtr &message) {
+                                          handler(std::static_pointer_cast<Message_>(message));
+                                      });
         return [=](const std::shared_ptr<Message_> &message) { push_input_endpoint(endpoint_id, message); };
     }
 
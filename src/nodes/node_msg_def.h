@@ -91,8 +91,8 @@ public:
     TaskType task_type;   // 任务 Type
 
     std::function<void(const nlohmann::json &, const bool)> response_callback_;
-    std::function<FrameType(const std::vector<FrameExtInfo> &)> check_report_callback_{
-        [](const std::vector<FrameExtInfo> &) { return FrameType::kBase; }};
+    std::function<FrameType(const FrameExtInfoList &)> check_report_callback_{
+        [](const FrameExtInfoList &) { return FrameType::kBase; }};
 
     FrameType frame_type;                        // 帧类型
     float video_frame_rate;                      // 视频帧率
@@ -101,6 +101,7 @@ public:
 
     std::string name() const override { return utils::get_class_name(this); }
     std::string to_string() const override { return utils::fmts(task_name); }
+    size_t flow_key() const override { return std::hash<std::string>{}(task_name); }
 };
 
 class msg_hello : public ngraph::Message {
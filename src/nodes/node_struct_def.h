@@ -5,6 +5,7 @@
 #include "modules/types.hpp"
 #include <array>
 #include <chrono>
+#include <functional>
 #include <map>
 #include <memory>
 #include <utility>
@@ -97,6 +98,49 @@ struct FeatureInfo_v1 {
     float feature[512];
 };
 
+/**
+ * @brief 写时复制的 map，拷贝时只复制指针，用于模型标签、颜色等几乎不变的大字段
+ *
+ *        const 接口直接读取共享数据；operator[] 写入前若数据仍被共享则先复制一份
+ */
+template<class Key_, class Value_>
+class CowMap {
+public:
+    using map_type = std::map<Key_, Value_>;
+
+    CowMap() : data_(empty_map()) {}
+    CowMap(map_type map) : data_(std::make_shared<map_type>(std::move(map))) {}
+
+    CowMap &operator=(map_type map) {
+        data_ = std::make_shared<map_type>(std::move(map));
+        return *this;
+    }
+
+    operator const map_type &() const { return *data_; }
+    const map_type &get() const { return *data_; }
+
+    typename map_type::const_iterator begin() const { return data_->begin(); }
+    typename map_type::const_iterator end() const { return data_->end(); }
+    typename map_type::const_iterator find(const Key_ &key) const { return data_->find(key); }
+    size_t size() const { return data_->size(); }
+    bool empty() const { return data_->empty(); }
+    size_t count(const Key_ &key) const { return data_->count(key); }
+    const Value_ &at(const Key_ &key) const { return data_->at(key); }
+
+    Value_ &operator[](const Key_ &key) {
+        if (data_.use_count() > 1) { data_ = std::make_shared<map_type>(*data_); }
+        return (*data_)[key];
+    }
+
+private:
+    static const std::shared_ptr<map_type> &empty_map() {
+        static const auto map = std::make_shared<map_type>();
+        return map;
+    }
+
+    std::shared_ptr<map_type> data_;
+};
+
 struct FrameExtInfo {
     explicit FrameExtInfo(const AlgoType type, std::string id, std::string name, const float thres)
         : algo_type(type), mod_id(std::move(id)), mod_name(std::move(name)), mod_thres(thres) {}
@@ -112,18 +156,18 @@ struct FrameExtInfo {
 
     std::map<int, Rect2f> crop_rects;// 扣图座标信息
 
-    std::map<int, std::string> map_class_label;// 标签映射
-    std::map<int, Scalar> map_class_color;     // 颜色映射
+    CowMap<int, std::string> map_class_label;// 标签映射
+    CowMap<int, Scalar> map_class_color;     // 颜色映射
 
     // 存储原始推理结果
-    std::map<int, BoxInfo> infer_target_info;
+    CowMap<int, BoxInfo> infer_target_info;
 
     // 目标框信息 -- (目标编号 - 框标信息)
     std::map<int, BoxInfo> map_target_box;
 
     int seg_width;                                          // 掩码图宽
     int seg_height;                                         // 掩码图高
-    std::vector<uint8_t> seg_map;                           // 分割掩码图
+    std::shared_ptr<const std::vector<uint8_t>> seg_map;    // 分割掩码图，只读共享
     std::map<uint8_t, std::vector<SegContour>> seg_contours;// 分割轮廓信息
 
     // 关键点信息
@@ -157,6 +201,52 @@ struct FrameExtInfo {
     nlohmann::json metadata;// 元数据，特定业务场景存放特定信息
 };
 
+/**
+ * @brief 多阶段推理结果，各阶段以共享指针保存，拷贝 FrameInfo 时只复制指针
+ *
+ *        默认只提供 const 访问；需要修改某一阶段时调用 mutable_xxx，若该阶段仍被其它帧共享则先复制再返回(写时复制)。
+ *        mutable_xxx 只能由独占该帧的节点调用(通常是刚拷贝出的 clone_frame)，拷贝帧之后不要再通过之前取得的引用修改。
+ */
+class FrameExtInfoList {
+public:
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+
+    const FrameExtInfo &operator[](size_t idx) const { return *items_[idx]; }
+    const FrameExtInfo &front() const { return *items_.front(); }
+    const FrameExtInfo &back() const { return *items_.back(); }
+
+    FrameExtInfo &mutable_at(size_t idx) {
+        auto &item = items_.at(idx);
+        if (item.use_count() > 1) { item = std::make_shared<FrameExtInfo>(*item); }
+        return *item;
+    }
+    FrameExtInfo &mutable_front() { return mutable_at(0); }
+    FrameExtInfo &mutable_back() { return mutable_at(items_.size() - 1); }
+
+    template<class... Args>
+    FrameExtInfo &emplace_back(Args &&...args) {
+        items_.emplace_back(std::make_shared<FrameExtInfo>(std::forward<Args>(args)...));
+        return *items_.back();
+    }
+
+private:
+    std::vector<std::shared_ptr<FrameExtInfo>> items_;
+};
+
+// 输入端积压计数的凭证，FrameInfo 的所有拷贝都释放后调用 on_release
+struct FrameReleaseToken {
+    explicit FrameReleaseToken(std::function<void()> callback) : on_release(std::move(callback)) {}
+    ~FrameReleaseToken() {
+        if (on_release) { on_release(); }
+    }
+
+    FrameReleaseToken(const FrameReleaseToken &) = delete;
+    FrameReleaseToken &operator=(const FrameReleaseToken &) = delete;
+
+    std::function<void()> on_release;
+};
+
 // 推理统一的返回结果，支持多 banch
 struct FrameInfo {
     explicit FrameInfo(int64_t const idx, std::shared_ptr<gddi::MemObject<AVFrame>> const &src)
@@ -182,17 +272,20 @@ struct FrameInfo {
         this->tgt_frame = other->tgt_frame;
         this->ext_info = other->ext_info;
         this->roi_points = other->roi_points;
+        this->release_token = other->release_token;
     }
 
     int64_t video_frame_idx;           // 解码帧帧 ID
     int64_t infer_frame_idx;           // 推理帧 ID
     int64_t timestamp;                 // 帧时间戳
-    std::vector<FrameExtInfo> ext_info;// 支持多阶段推理
+    FrameExtInfoList ext_info;         // 支持多阶段推理
     cv::Mat tgt_frame;                 // 已绘制帧图像
 
     int frame_event_result{-1};// 帧事件结果
 
     std::map<std::string, std::vector<Point2i>> roi_points;// ROI 信息
+
+    std::shared_ptr<FrameReleaseToken> release_token;// 拷贝时共享，为空表示输入端不限制积压
 };
 
 }// namespace nodes
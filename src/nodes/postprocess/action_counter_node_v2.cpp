@@ -43,7 +43,7 @@ void ActionCounter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame)
     }
 
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
-    auto &last_ext_info = clone_frame->frame_info->ext_info.back();
+    auto &last_ext_info = clone_frame->frame_info->ext_info.mutable_back();
     last_ext_info.action_type = ActionType::kCount;
 
     for (const auto &[track_id, item] : last_ext_info.tracked_box) {
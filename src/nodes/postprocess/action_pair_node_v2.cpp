@@ -59,7 +59,7 @@ void ActionPair_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
 
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
 
-    auto &back_ext_info = clone_frame->frame_info->ext_info.back();
+    auto &back_ext_info = clone_frame->frame_info->ext_info.mutable_back();
     for (const auto &[track_id, action] : back_ext_info.cur_action_score) {
         // 分数小于阈值
         if (action.second >= threshold_) { action_score_[track_id][action.first].emplace_back(action.second); }
@@ -19,16 +19,16 @@ void Aggregation_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame)
 
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
 
-    auto &back_ext_info = clone_frame->frame_info->ext_info.back();
+    auto &back_ext_info = clone_frame->frame_info->ext_info.mutable_back();
     size_t target_index = back_ext_info.map_target_box.size();
     for (auto &frame_info : cache_frame_info_[clone_frame->frame_info->video_frame_idx]) {
         size_t label_index = back_ext_info.map_class_label.size();
         for (auto &key_points : frame_info->ext_info.back().map_key_points) {
             back_ext_info.map_key_points[target_index] = key_points.second;
         }
-        for (auto &[target_id, box_info] : frame_info->ext_info.back().map_target_box) {
-            box_info.class_id += label_index;
+        for (const auto &[target_id, box_info] : frame_info->ext_info.back().map_target_box) {
             back_ext_info.map_target_box[target_index] = box_info;
+            back_ext_info.map_target_box[target_index].class_id += label_index;
 
             if (frame_info->ext_info.back().map_key_points.count(target_id) > 0) {
                 back_ext_info.map_key_points[target_index] = frame_info->ext_info.back().map_key_points.at(target_id);
@@ -16,7 +16,7 @@ void BoxFilter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
     }
 
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
-    auto &ext_info = clone_frame->frame_info->ext_info.back();
+    auto &ext_info = clone_frame->frame_info->ext_info.mutable_back();
 
     // BOX
     for (auto iter = ext_info.map_target_box.begin(); iter != ext_info.map_target_box.end();) {
@@ -51,7 +51,7 @@ void BoxFilter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
     }
 
     clone_frame->check_report_callback_ =
-        [callback = clone_frame->check_report_callback_](const std::vector<FrameExtInfo> &ext_info) {
+        [callback = clone_frame->check_report_callback_](const FrameExtInfoList &ext_info) {
             auto status = callback(ext_info);
 
             // 若过滤后目标数为零, 无需上报
@@ -61,7 +61,8 @@ void BoxFilter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
 
             // 若分割结果为空，无需上报
             if (ext_info.back().algo_type == AlgoType::kSegmentation) {
-                status = ext_info.back().seg_map.empty() ? FrameType::kBase : FrameType::kReport;
+                auto &seg_map = ext_info.back().seg_map;
+                status = !seg_map || seg_map->empty() ? FrameType::kBase : FrameType::kReport;
             }
 
             return status;
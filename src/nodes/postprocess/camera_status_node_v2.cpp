@@ -53,7 +53,7 @@ void CameraStatus_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame)
 //         } else if (prev_status_ == CameraStatus::kMoving && time(NULL) - prev_moving_time_ > staing_time_) {
 //             prev_status_ = CameraStatus::kStaing;
 //             prev_moving_time_ = time(NULL);
-//             frame->check_report_callback_ = [](const std::vector<FrameExtInfo> &) { return FrameType::kDisappear; };
+//             frame->check_report_callback_ = [](const FrameExtInfoList &) { return FrameType::kDisappear; };
 //         }
 
 //         prev_frame_ = src_frame;
@@ -28,7 +28,7 @@ void CheckMoving_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame)
         return;
     }
 
-    for (auto &[target_id, info] : frame->frame_info->ext_info.back().map_target_box) {
+    for (auto &[target_id, info] : frame->frame_info->ext_info.mutable_back().map_target_box) {
         auto iter = prev_bbox_.begin();
         for (; iter != prev_bbox_.end();) {
             if (calculate_iou(iter->second.box, info.box) > threshold_) {
@@ -40,10 +40,10 @@ void CheckMoving_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame)
 
         if (iter == prev_bbox_.end()) {
             info.moving = true;
-            frame->check_report_callback_ = [](const std::vector<FrameExtInfo> &) { return FrameType::kReport; };
+            frame->check_report_callback_ = [](const FrameExtInfoList &) { return FrameType::kReport; };
             spdlog::debug("target {} is moving", target_id);
         } else {
-            frame->check_report_callback_ = [](const std::vector<FrameExtInfo> &) { return FrameType::kBase; };
+            frame->check_report_callback_ = [](const FrameExtInfoList &) { return FrameType::kBase; };
         }
     }
 
@@ -49,9 +49,10 @@ void CropImage_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
     frame->infer_frame_rate = frame->infer_frame_rate / interlaced_number_;
 
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
-    clone_frame->frame_info->ext_info.back().flag_crop = true;
+    auto &back_ext_info = clone_frame->frame_info->ext_info.mutable_back();
+    back_ext_info.flag_crop = true;
 
-    auto &map_target_box = clone_frame->frame_info->ext_info.back().map_target_box;
+    auto &map_target_box = back_ext_info.map_target_box;
 
     std::vector<std::pair<int, BoxInfo>> vec_target_box(map_target_box.begin(), map_target_box.end());
     std::sort(vec_target_box.begin(), vec_target_box.end(),
@@ -64,15 +65,15 @@ void CropImage_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
     int crop_target_number = std::min(map_target_box.size(), max_target_number_);
 
     for (int i = 0; i < crop_target_number; i++) {
-        clone_frame->frame_info->ext_info.back().crop_rects[vec_target_box[i].first] =
+        back_ext_info.crop_rects[vec_target_box[i].first] =
             algin_rect(vec_target_box[i].second.box, clone_frame->frame_info->width(),
                        clone_frame->frame_info->height(), expansion_factor_);
     }
 
     try {
-        if (!clone_frame->frame_info->ext_info.back().crop_rects.empty()) {
-            clone_frame->frame_info->ext_info.back().crop_images = image_wrapper::image_crop(
-                clone_frame->frame_info->src_frame->data, clone_frame->frame_info->ext_info.back().crop_rects);
+        if (!back_ext_info.crop_rects.empty()) {
+            back_ext_info.crop_images =
+                image_wrapper::image_crop(clone_frame->frame_info->src_frame->data, back_ext_info.crop_rects);
         }
     } catch (const std::exception &e) { spdlog::error("CropImage_v2: {}", e.what()); }
 
@@ -34,7 +34,8 @@ static Rect2f algin_rect(const Rect2f &rect, int img_w, int img_h, float factor)
 void CropImage_v3::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
 
-    auto &map_target_box = clone_frame->frame_info->ext_info.back().map_target_box;
+    auto &back_ext_info = clone_frame->frame_info->ext_info.mutable_back();
+    auto &map_target_box = back_ext_info.map_target_box;
 
     std::vector<std::pair<int, BoxInfo>> vec_target_box(map_target_box.begin(), map_target_box.end());
     std::sort(vec_target_box.begin(), vec_target_box.end(),
@@ -47,14 +48,14 @@ void CropImage_v3::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
     int crop_target_number = std::min(map_target_box.size(), max_target_number_);
 
     for (int i = 0; i < crop_target_number; i++) {
-        clone_frame->frame_info->ext_info.back().crop_rects[vec_target_box[i].first] =
+        back_ext_info.crop_rects[vec_target_box[i].first] =
             algin_rect(vec_target_box[i].second.box, clone_frame->frame_info->width(),
                        clone_frame->frame_info->height(), expansion_factor_);
     }
 
     try {
-        clone_frame->frame_info->ext_info.back().crop_images = image_wrapper::image_crop(
-            clone_frame->frame_info->src_frame->data, clone_frame->frame_info->ext_info.back().crop_rects);
+        back_ext_info.crop_images =
+            image_wrapper::image_crop(clone_frame->frame_info->src_frame->data, back_ext_info.crop_rects);
     } catch (const std::exception &e) { spdlog::error("CropImage_v3: {}", e.what()); }
 
     output_result_(clone_frame);
@@ -55,7 +55,7 @@ void CrossCounter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame)
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
 
     std::map<int, Rect2f> rects;
-    auto &back_ext_info = clone_frame->frame_info->ext_info.back();
+    auto &back_ext_info = clone_frame->frame_info->ext_info.mutable_back();
     for (const auto &[track_id, item] : back_ext_info.tracked_box) {
         auto box_info = back_ext_info.map_target_box.at(item.target_id);
         rects[track_id] = item.box;
@@ -64,7 +64,7 @@ void CrossCounter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame)
     auto map_target_box = back_ext_info.map_target_box;
 
     auto result = cross_border_->update_position(rects);
-    clone_frame->check_report_callback_ = [result](const std::vector<FrameExtInfo> &ext_info) {
+    clone_frame->check_report_callback_ = [result](const FrameExtInfoList &ext_info) {
         for (const auto &item : result) {
             if (item.size() > 0) { return FrameType::kReport; }
         }
@@ -77,7 +77,7 @@ void CrossCounter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame)
             // value: 0 左 1 右
             int target_id = back_ext_info.tracked_box.at(track_id).target_id;
             auto &target_box = map_target_box.at(target_id);
-            ++cross_count_[i][frame->frame_info->ext_info.back().map_class_label[target_box.class_id]][value];
+            ++cross_count_[i][back_ext_info.map_class_label.at(target_box.class_id)][value];
         }
     }
 
@@ -17,9 +17,9 @@ void DelayTimer_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame) {
 
     if (time(NULL) - event_time_ >= duration_) {
         event_time_ = std::numeric_limits<time_t>::max();
-        frame->check_report_callback_ = [this](const std::vector<FrameExtInfo> &) { return FrameType::kReport; };
+        frame->check_report_callback_ = [this](const FrameExtInfoList &) { return FrameType::kReport; };
     } else {
-        frame->check_report_callback_ = [this](const std::vector<FrameExtInfo> &) { return FrameType::kBase; };
+        frame->check_report_callback_ = [this](const FrameExtInfoList &) { return FrameType::kBase; };
     }
 
     output_image_(frame);
@@ -10,7 +10,7 @@ void DialPlate_v2::on_cv_frame(const std::shared_ptr<msgs::cv_frame> &frame) {
     cv::Mat image = image_wrapper::image_to_mat(frame->frame_info->src_frame->data);
 
     auto &front_ext_info = frame->frame_info->ext_info.front();
-    auto &back_ext_info = frame->frame_info->ext_info.back();
+    auto &back_ext_info = frame->frame_info->ext_info.mutable_back();
     for (const auto &[idx, points] : back_ext_info.map_key_points) {
         std::vector<cv::Point2f> roi_points;
         for (const auto &point : frame->frame_info->roi_points[back_ext_info.map_target_box[idx].roi_id]) {
@@ -24,7 +24,7 @@ static float alc_angle(Point2f &point1, Point2f &point2) {
 void Direction_v2::on_setup() { prev_timestamp_ = time(NULL); }
 
 void Direction_v2::on_cv_frame(const std::shared_ptr<msgs::cv_frame> &frame) {
-    frame->frame_info->ext_info.back().map_target_box.clear();
+    frame->frame_info->ext_info.mutable_back().map_target_box.clear();
 
     for (const auto &[track_id, item] : frame->frame_info->ext_info.back().tracked_box) {
         Point2f cur_point{item.box.x + item.box.width / 2, item.box.y + item.box.height / 2};
@@ -50,7 +50,7 @@ void Direction_v2::on_cv_frame(const std::shared_ptr<msgs::cv_frame> &frame) {
                     });
                 if (dis_accum / sqrt(frame->frame_info->area()) > distance_thresh_) {
                     track_direction_[track_id].clear();
-                    frame->frame_info->ext_info.back()
+                    frame->frame_info->ext_info.mutable_back()
                         .map_target_box[(int)frame->frame_info->ext_info.back().map_target_box.size()] =
                         {.prev_id = 0, .class_id = item.class_id, .prob = item.prob, .box = item.box};
                 }
@@ -63,7 +63,7 @@ void Direction_v2::on_cv_frame(const std::shared_ptr<msgs::cv_frame> &frame) {
 
     if (!frame->frame_info->ext_info.back().map_target_box.empty()) {
         frame->check_report_callback_ = [callback =
-                                             frame->check_report_callback_](const std::vector<FrameExtInfo> &ext_info) {
+                                             frame->check_report_callback_](const FrameExtInfoList &ext_info) {
             return std::max(FrameType::kReport, callback(ext_info));
         };
     }
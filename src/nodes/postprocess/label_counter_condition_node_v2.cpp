@@ -12,7 +12,7 @@ void LabelCounterCondition_v2::on_setup() {
 }
 
 void LabelCounterCondition_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
-    auto back_ext_info = frame->frame_info->ext_info.back();
+    const auto &back_ext_info = frame->frame_info->ext_info.back();
 
     int count = 0;
     for (const auto &[idx, target] : back_ext_info.map_target_box) {
@@ -15,7 +15,7 @@ void LogicGate_v2::on_setup() {
 }
 
 void LogicGate_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
-    auto back_ext_info = frame->frame_info->ext_info.back();
+    const auto &back_ext_info = frame->frame_info->ext_info.back();
     if (operation_ == "NOT") {
         for (const auto &[idx, target] : back_ext_info.map_target_box) {
             // 标签存在更新时间
@@ -56,7 +56,7 @@ void LogicGate_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
         > duration_) {
         last_time_point_ = std::chrono::steady_clock::now();
         frame->check_report_callback_ = [callback =
-                                             frame->check_report_callback_](const std::vector<FrameExtInfo> &ext_info) {
+                                             frame->check_report_callback_](const FrameExtInfoList &ext_info) {
             return std::max(FrameType::kReport, callback(ext_info));
         };
         output_result_(frame);
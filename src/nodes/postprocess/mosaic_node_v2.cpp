@@ -10,7 +10,7 @@ void Mosaic_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
         return;
     }
 
-    auto &last_ext_info = frame->frame_info->ext_info.back();
+    auto &last_ext_info = frame->frame_info->ext_info.mutable_back();
 
     if (check_bbox_) {
         for (const auto &[idx, bbox] : last_ext_info.map_target_box) {
@@ -121,13 +121,13 @@ bool MsgSubscribe_v2::frame_info_to_string(const std::string &task_name, const s
             if (last_ext_info.algo_type == AlgoType::kFace) {
                 int buffer_size = 0;
                 std::vector<uchar> buffer;
+                const auto &crop_ext_info = frame_info->ext_info[frame_info->ext_info.size() - 2];
 #if defined(WITH_BM1684)
-                image_wrapper::image_jpeg_enc(
-                    (frame_info->ext_info.rbegin() + 1)->crop_images.second->at(target.prev_id), buffer, buffer_size);
+                image_wrapper::image_jpeg_enc(crop_ext_info.crop_images.second->at(target.prev_id), buffer, buffer_size);
 #elif defined(WITH_MLU220) || defined(WITH_MLU270) || defined(WITH_MLU370)
-                image_wrapper::image_jpeg_enc((frame_info->ext_info.rbegin() + 1)->crop_images[target.prev_id], buffer, buffer_size);
+                image_wrapper::image_jpeg_enc(crop_ext_info.crop_images.at(target.prev_id), buffer, buffer_size);
 #else
-                cv::imencode(".jpg", (frame_info->ext_info.rbegin() + 1)->crop_images[target.prev_id], buffer);
+                cv::imencode(".jpg", crop_ext_info.crop_images.at(target.prev_id), buffer);
 #endif
 
                 auto feature_obj = nlohmann::json::object();
@@ -12,7 +12,7 @@ void ProbFilter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
     }
 
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
-    auto &ext_info = clone_frame->frame_info->ext_info.back();
+    auto &ext_info = clone_frame->frame_info->ext_info.mutable_back();
 
     for (auto iter = ext_info.map_target_box.begin(); iter != ext_info.map_target_box.end();) {
         if (iter->second.prob < box_prob_) {
@@ -50,7 +50,7 @@ void RegionalAlert_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame)
         }
     }
 
-    for (auto &[idx, target] : frame->frame_info->ext_info.back().map_target_box) {
+    for (auto &[idx, target] : frame->frame_info->ext_info.mutable_back().map_target_box) {
         int bottom_cx = target.box.width / 2 + target.box.x;
         int bottom_cy = target.box.height + target.box.y;
         if (bottom_cx > 0 && bottom_cx < mask_img_.size[1] && bottom_cy > 0 && bottom_cy < mask_img_.size[0]) {
@@ -58,7 +58,7 @@ void RegionalAlert_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame)
             if (track_id_distance_.count(target.track_id) == 0 || value > track_id_distance_.at(target.track_id)) {
                 // 区域出现新目标 || 区域目标靠近
                 frame->check_report_callback_ =
-                    [callback = frame->check_report_callback_](const std::vector<FrameExtInfo> &ext_info) {
+                    [callback = frame->check_report_callback_](const FrameExtInfoList &ext_info) {
                         return std::max(FrameType::kReport, callback(ext_info));
                     };
                 track_id_distance_[target.track_id] = value;
@@ -5,7 +5,7 @@
 #include "modules/network/zmq_socket.h"
 #include "node_msg_def.h"
 #include "wrapper/draw_image.h"
-#include "wrapper/tsing_jpeg_encode.h"
+#include "wrapper/jpeg_encoder.h"
 #include <boost/filesystem.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
@@ -29,6 +29,13 @@ const int skeleton_5[][2] = {{0, 1}, {0, 2}, {1, 2}, {0, 3}, {1, 4}, {2, 3}, {2,
 
 inline void create_directories(const std::string &path) { mkdir(path.c_str(), 0755); }
 
+// 预录和导出事件视频时长时间持有的帧不计入输入端的积压，否则输入端会一直丢帧或等待
+static std::shared_ptr<FrameInfo> detach_frame_info(const std::shared_ptr<FrameInfo> &frame_info) {
+    auto detached = std::make_shared<FrameInfo>(frame_info);
+    detached->release_token.reset();
+    return detached;
+}
+
 void Report_v2::on_setup() {
     last_event_time_ = time(NULL) - time_interval_;
     event_folder_ = "/home/data/raw_image/" + task_name_;
@@ -36,12 +43,19 @@ void Report_v2::on_setup() {
     create_directories("/home/data/raw_image/" + task_name_);
     draw_image_ = std::make_unique<DrawImage>();
     draw_image_->init_drawing("/home/config/NotoSansCJK-Regular.ttc");
+
+    if (report_batch_ > 1) { network::EventSocket::get_instance().set_max_batch(report_url_, report_batch_); }
+
+    if ((codec_type_ == "h264" || codec_type_ == "hevc") && !clip_overlay_) {
+        packet_ring_ = av_wrapper::PacketRingRegistry::get_instance().acquire(task_name_);
+        packet_ring_->set_duration(save_time_);
+    }
 }
 
 void Report_v2::on_report(const std::shared_ptr<msgs::cv_frame> &frame) {
-    if (!jpeg_decoder_) {
-        jpeg_decoder_ = std::make_unique<codec::TsingJpegEncode>();
-        jpeg_decoder_->init_codecer(frame->frame_info->width(), frame->frame_info->height());
+    if (!jpeg_encoder_) {
+        jpeg_encoder_ = std::make_unique<codec::JpegEncoder>();
+        jpeg_encoder_->init_codecer(frame->frame_info->width(), frame->frame_info->height(), image_quality_);
     }
 
     if (frame->task_type == TaskType::kCamera) {
@@ -63,11 +77,9 @@ void Report_v2::on_report(const std::shared_ptr<msgs::cv_frame> &frame) {
         } else {
             // 检查上报条件
             if (frame->check_report_callback_(frame->frame_info->ext_info) < FrameType::kReport) {
-                if (codec_type_ == "h264" || codec_type_ == "hevc") {
-                    cache_frames_.push_back(frame->frame_info);
-                    if (cache_frames_.size() > frame->infer_frame_rate * save_time_) {
-                        cache_frames_.erase(cache_frames_.begin());
-                    }
+                if ((codec_type_ == "h264" || codec_type_ == "hevc") && clip_overlay_) {
+                    cache_frames_.push_back(detach_frame_info(frame->frame_info));
+                    if (cache_frames_.size() > frame->infer_frame_rate * save_time_) { cache_frames_.pop_front(); }
                 }
                 return;
             }
@@ -79,21 +91,26 @@ void Report_v2::on_report(const std::shared_ptr<msgs::cv_frame> &frame) {
                     if (async_result_.wait_for(std::chrono::milliseconds(40)) != std::future_status::ready) { return; }
                     async_result_.get();
                 }
-                async_result_ = std::async(std::launch::async, [this, frame, event_id]() {
-                    export_video_ = std::make_unique<ExportVideo>();
-                    export_video_->init_video(event_folder_ + "/" + event_id + ".mp4", frame->infer_frame_rate,
-                                              frame->frame_info->width(), frame->frame_info->height());
-                    auto cache_frames = this->cache_frames_;
-                    auto iter = cache_frames.begin();
-                    while (iter != cache_frames.end()) {
-                        draw_image_->draw_frame(*iter);
-                        export_video_->write_frame(*iter);
-                        cache_frames.erase(iter);
+                auto cache_frames = this->cache_frames_;
+                auto event_frame = std::make_shared<msgs::cv_frame>(frame);
+                event_frame->frame_info->release_token.reset();
+                async_result_ = std::async(std::launch::async, [this, frame = event_frame, event_id, cache_frames]() {
+                    auto video_path = event_folder_ + "/" + event_id + ".mp4";
+                    if (clip_overlay_) {
+                        export_video_ = std::make_unique<ExportVideo>();
+                        export_video_->init_video(video_path, frame->infer_frame_rate, frame->frame_info->width(),
+                                                  frame->frame_info->height());
+                        for (const auto &frame_info : cache_frames) {
+                            draw_image_->draw_frame(frame_info);
+                            export_video_->write_frame(frame_info);
+                        }
+                        export_video_->close_video();
+                    } else if (!packet_ring_->export_clip(video_path)) {
+                        spdlog::warn("No pre-event packets for: {}", video_path);
                     }
-                    export_video_->close_video();
 
-                    jpeg_decoder_->save_image(frame->frame_info->src_frame->data,
-                                              (event_folder_ + "/" + event_id + ".jpg").c_str());
+                    jpeg_encoder_->save_image(frame->frame_info->src_frame->data,
+                                              event_folder_ + "/" + event_id + ".jpg", image_quality_);
 
                     auto buffer = frame_info_to_string(frame->task_name, event_id, time(NULL), frame->frame_info);
                     network::EventSocket::get_instance().post_sync(frame->task_name, event_id, report_url_, buffer);
@@ -101,8 +118,8 @@ void Report_v2::on_report(const std::shared_ptr<msgs::cv_frame> &frame) {
                     spdlog::info("export video: {}", event_folder_ + "/" + event_id + ".mp4");
                 });
             } else {
-                jpeg_decoder_->save_image(frame->frame_info->src_frame->data,
-                                          (event_folder_ + "/" + event_id + ".jpg").c_str());
+                jpeg_encoder_->save_image(frame->frame_info->src_frame->data, event_folder_ + "/" + event_id + ".jpg",
+                                          image_quality_);
                 auto buffer = frame_info_to_string(frame->task_name, event_id, time(NULL), frame->frame_info);
                 network::EventSocket::get_instance().post_sync(frame->task_name, event_id, report_url_, buffer);
             }
@@ -6,16 +6,18 @@
 #define __REPORT_NODE_V2_HPP__
 
 #include <condition_variable>
+#include <deque>
 #include <future>
 #include <memory>
 #include <queue>
 
 #include "message_templates.hpp"
 #include "modules/codec/encode_video_v3.h"
+#include "modules/codec/packet_ring_buffer.h"
 #include "modules/codec/remux_stream_v3.h"
 #include "modules/wrapper/draw_image.h"
 #include "modules/wrapper/export_video.h"
-#include "modules/wrapper/tsing_jpeg_encode.h"
+#include "modules/wrapper/jpeg_encoder.h"
 #include "node_any_basic.hpp"
 #include "node_msg_def.h"
 
@@ -26,11 +28,13 @@ class Report_v2 : public node_any_basic<Report_v2> {
 public:
     explicit Report_v2(std::string name) : node_any_basic<Report_v2>(std::move(name)) {
         bind_simple_property("report_url", report_url_, "服务地址");
+        bind_simple_property("report_batch", report_batch_, "单次请求最多合并的事件数(body 为 JSON 数组)");
         bind_simple_property("time_interval", time_interval_, "时间间隔");
         bind_simple_property("image_quality", image_quality_, "图像编码质量(1-100)");
         bind_simple_property("real_time_push", real_time_push_, "实时推送");
         bind_simple_property("codec_type", codec_type_, "编码类型");
         bind_simple_property("save_time", save_time_, "编码时长");
+        bind_simple_property("clip_overlay", clip_overlay_, "事件视频叠加检测结果(重新编码)");
 
         bind_simple_property("task_name", task_name_, ngraph::PropAccess::kPrivate);
 
@@ -51,20 +55,23 @@ private:
 private:
     std::queue<std::pair<std::string, std::string>> que_taskid_record_;
     std::string report_url_;         // 服务地址
+    uint32_t report_batch_{1};       // 单次请求最多合并的事件数，1 表示不合并
     uint32_t time_interval_{0};      // 时间间隔
     uint32_t image_quality_{85};     // 编码质量
     bool real_time_push_{false};     // 实时推送标识
     std::string codec_type_{"mjpeg"};// 编码类型
     uint32_t save_time_{15};         // 保存时长
+    bool clip_overlay_{false};       // 重新编码叠加检测结果，否则直接封装原始码流
 
     time_t last_event_time_;// 最后一次上报时间
 
     std::string task_name_;
     std::string event_folder_;
 
-    std::unique_ptr<codec::TsingJpegEncode> jpeg_decoder_;
+    std::unique_ptr<codec::JpegEncoder> jpeg_encoder_;
 
-    std::vector<std::shared_ptr<nodes::FrameInfo>> cache_frames_;
+    std::deque<std::shared_ptr<nodes::FrameInfo>> cache_frames_;// 叠加模式下的预录帧
+    std::shared_ptr<av_wrapper::PacketRingBuffer> packet_ring_;// 预录压缩包
 
     std::unique_ptr<DrawImage> draw_image_;
     std::unique_ptr<ExportVideo> export_video_;
@@ -128,7 +128,7 @@ void RoiCrop_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame) {
         ext_info.crop_images = image_wrapper::image_crop(clone_frame->frame_info->src_frame->data, ext_info.crop_rects);
     } catch (const std::exception &e) { spdlog::error("CropImage_v2: {}", e.what()); }
 
-    clone_frame->frame_info->ext_info.emplace_back(ext_info);
+    clone_frame->frame_info->ext_info.emplace_back(std::move(ext_info));
 
     output_image_(clone_frame);
 }
@@ -1,5 +1,4 @@
 #include "roi_filter_node_v2.h"
-#include "modules/cvrelate/geometry.h"
 
 namespace gddi {
 namespace nodes {
@@ -33,8 +32,14 @@ void RoiFilter_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame) {
         return;
     }
 
-    // 预处理 ROI 区域
-    if (roi_points_.empty()) {
+    // 预处理 ROI 区域，画面尺寸变化时重新计算
+    if (roi_width_ != frame->frame_info->width() || roi_height_ != frame->frame_info->height()) {
+        roi_points_.clear();
+        roi_width_ = frame->frame_info->width();
+        roi_height_ = frame->frame_info->height();
+    }
+
+    if (roi_points_.empty() && !regions_with_label_.empty()) {
         for (auto &[key, points] : regions_with_label_) {
             std::vector<Point2i> new_region_points;
             for (auto &point : points) {
@@ -46,7 +51,7 @@ void RoiFilter_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame) {
             for (auto iter = roi_points_.begin(); iter != roi_points_.end();) {
                 if (geometry::has_intersection(iter->second, new_region_points)) {
                     tmp_roi_points.insert(*iter);
-                    roi_points_.erase(iter);
+                    iter = roi_points_.erase(iter);
                 } else {
                     iter++;
                 }
@@ -58,39 +63,58 @@ void RoiFilter_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame) {
                 roi_points_[key] = new_region_points;
             }
         }
+
+        std::vector<std::vector<Point2i>> regions;
+        for (auto &[key, points] : roi_points_) { regions.push_back(points); }
+        roi_index_.compile(regions, geometry::cover_mode_from_string(cover_mode_));
     }
 
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
-    auto &last_ext_info = clone_frame->frame_info->ext_info.back();
-    auto tmp_target_box = last_ext_info.map_target_box;
+    auto &last_ext_info = clone_frame->frame_info->ext_info.mutable_back();
     clone_frame->frame_info->roi_points = roi_points_;
 
-    if (!clone_frame->frame_info->roi_points.empty()) { last_ext_info.map_target_box.clear(); }
+    // 有 ROI 时目标框按区域重新写入，直接取走原结果，不再额外拷贝
+    std::map<int, BoxInfo> tmp_target_box;
+    if (!clone_frame->frame_info->roi_points.empty()) {
+        tmp_target_box = std::move(last_ext_info.map_target_box);
+        last_ext_info.map_target_box.clear();
+    }
 
     if (!clone_frame->frame_info->ext_info.empty()) {
 
+        // 目标框与ROI区域重叠面积需大于阈值，先按外接矩形筛出候选 ROI
+        roi_hits_.resize(roi_index_.size());
+        for (auto &hits : roi_hits_) { hits.clear(); }
+        for (auto &item : tmp_target_box) {
+            const auto &box = item.second.box;
+            float x1 = int(box.x), y1 = int(box.y), x2 = int(box.x + box.width), y2 = int(box.y + box.height);
+
+            // 阈值不大于 0 时不相交的 ROI 也满足条件
+            if (threshold_ > 0) {
+                roi_index_.query(x1, y1, x2, y2, roi_candidates_);
+            } else {
+                roi_candidates_.resize(roi_index_.size());
+                for (size_t i = 0; i < roi_candidates_.size(); i++) { roi_candidates_[i] = i; }
+            }
+
+            for (auto index : roi_candidates_) {
+                if (roi_index_.cover_rate(index, x1, y1, x2, y2) >= threshold_) { roi_hits_[index].push_back(&item); }
+            }
+        }
+
+        size_t roi_index = 0;
         for (const auto &[key, points] : roi_points_) {
 
-            // 目标框与ROI区域重叠面积需大于阈值
-            for (auto &item : tmp_target_box) {
-                std::vector<Point2i> box_points;
-                box_points.push_back({int(item.second.box.x), int(item.second.box.y)});
-                box_points.push_back({int(item.second.box.x), int(item.second.box.y + item.second.box.height)});
-                box_points.push_back(
-                    {int(item.second.box.x + item.second.box.width), int(item.second.box.y + item.second.box.height)});
-                box_points.push_back({int(item.second.box.x + item.second.box.width), int(item.second.box.y)});
-
-                if (geometry::area_cover_rate(box_points, points) >= threshold_) {
-                    item.second.roi_id = key;
-                    last_ext_info.map_target_box.insert(item);
-                }
+            for (auto *item : roi_hits_[roi_index]) {
+                item->second.roi_id = key;
+                last_ext_info.map_target_box.insert(*item);
             }
 
             // 姿态关键点需全部落在ROI区域内
             for (auto iter = last_ext_info.map_key_points.begin(); iter != last_ext_info.map_key_points.end();) {
                 int index = 0;
                 for (const auto &key_point : iter->second) {
-                    if (!geometry::point_within_area(Point2i(key_point.x, key_point.y), points)) {
+                    if (!roi_index_.within(roi_index, Point2i(key_point.x, key_point.y))) {
                         last_ext_info.map_target_box.erase(iter->first);
                         iter = last_ext_info.map_key_points.erase(iter);
                         break;
@@ -104,12 +128,14 @@ void RoiFilter_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame) {
             for (auto iter = last_ext_info.map_ocr_info.begin(); iter != last_ext_info.map_ocr_info.end();) {
                 std::vector<Point2i> ocr_points;
                 for (const auto &point : iter->second.points) { ocr_points.push_back({int(point.x), int(point.y)}); }
-                if (geometry::area_cover_rate(ocr_points, points) >= threshold_) {
+                if (roi_index_.cover_rate(roi_index, ocr_points) >= threshold_) {
                     ++iter;
                 } else {
                     iter = last_ext_info.map_ocr_info.erase(iter);
                 }
             }
+
+            ++roi_index;
         }
     }
 
@@ -6,6 +6,7 @@
 #define INFERENCE_ENGINE_ROI_NODE_V1_HPP
 
 #include "message_templates.hpp"
+#include "modules/cvrelate/roi_mask.h"
 #include "node_any_basic.hpp"
 #include "node_msg_def.h"
 #include "utils.hpp"
@@ -21,6 +22,7 @@ public:
         bind_simple_property("regions", regions_, "区域");
         bind_simple_property("regions_with_label", regions_with_label_, "区域");
         bind_simple_property("threshold", threshold_, "阈值");
+        bind_simple_property("cover_mode", cover_mode_, "重叠面积计算方式, raster: 栅格积分图, exact: 精确多边形");
 
         bind_simple_flags("support_preview", true);
 
@@ -39,6 +41,14 @@ private:
     std::map<std::string, std::vector<std::vector<float>>> regions_with_label_;
     std::map<std::string, std::vector<Point2i>> roi_points_;
     float threshold_{0.5};
+    std::string cover_mode_{"raster"};
+
+    // roi_points_ 的预编译结果，下标按 roi_points_ 顺序
+    geometry::RoiMaskIndex roi_index_;
+    int roi_width_{0};
+    int roi_height_{0};
+    std::vector<size_t> roi_candidates_;
+    std::vector<std::vector<std::pair<const int, BoxInfo> *>> roi_hits_;
 };
 }// namespace nodes
 }// namespace gddi
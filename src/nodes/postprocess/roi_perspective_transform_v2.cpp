@@ -128,7 +128,7 @@ void RoiPerspectiveTransform_v2::on_cv_image_(const std::shared_ptr<msgs::cv_fra
         transform_matrix_ = cv::getPerspectiveTransform(input_quad, output_quad);
     }
 
-    for (auto &[target_id, bbox] : frame->frame_info->ext_info.back().map_target_box) {
+    for (auto &[target_id, bbox] : frame->frame_info->ext_info.mutable_back().map_target_box) {
         std::vector<Point2i> box_points;
         box_points.push_back({int(bbox.box.x), int(bbox.box.y)});
         box_points.push_back({int(bbox.box.x), int(bbox.box.y + bbox.box.height)});
@@ -156,7 +156,7 @@ void RoiPerspectiveTransform_v2::on_cv_image_(const std::shared_ptr<msgs::cv_fra
     // frame->frame_info->src_frame->data = image_wrapper::mat_to_image(transform_image);
 #endif
 
-    for (auto &[_, value] : frame->frame_info->ext_info.back().map_target_box) {
+    for (auto &[_, value] : frame->frame_info->ext_info.mutable_back().map_target_box) {
         std::vector<cv::Point2f> bbox{{value.box.x, value.box.y},
                                       {value.box.x + value.box.width, value.box.y},
                                       {value.box.x + value.box.width, value.box.y + value.box.height},
@@ -189,8 +189,8 @@ void RoiPerspectiveTransform_v2::on_cv_image_(const std::shared_ptr<msgs::cv_fra
             }
         }
 
-        if (frame->frame_info->ext_info.back().tracked_box.count(value.track_id) > 0) {
-            frame->frame_info->ext_info.back().tracked_box.at(value.track_id).box = value.box;
+        if (frame->frame_info->ext_info.mutable_back().tracked_box.count(value.track_id) > 0) {
+            frame->frame_info->ext_info.mutable_back().tracked_box.at(value.track_id).box = value.box;
         }
     }
 
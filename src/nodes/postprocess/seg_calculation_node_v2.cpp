@@ -81,7 +81,7 @@ void SegCalculation_v2::on_setup() {
 
 void SegCalculation_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame) {
     auto clone_frame = std::make_shared<msgs::cv_frame>(frame);
-    auto &back_ext_info = clone_frame->frame_info->ext_info.back();
+    auto &back_ext_info = clone_frame->frame_info->ext_info.mutable_back();
     std::vector<uint8_t> vec_labels;
     for (const auto &[idx, label] : back_ext_info.map_class_label) {
         if (idx != 0) { vec_labels.push_back(idx); }
@@ -90,13 +90,15 @@ void SegCalculation_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame
     if (enable_area_ || enable_length_) {
         cv::Mat output_mask;
         auto input_mask = cv::Mat(clone_frame->frame_info->height(), clone_frame->frame_info->width(), CV_8UC1);
-        memcpy(input_mask.data, back_ext_info.seg_map.data(), back_ext_info.seg_map.size());
+        if (back_ext_info.seg_map) {
+            memcpy(input_mask.data, back_ext_info.seg_map->data(), back_ext_info.seg_map->size());
+        }
         bev_trans_->PostProcess(input_mask, &output_mask);
         seg_by_contours_->PostProcess(
             output_mask, vec_labels,
             const_cast<std::map<uint8_t, std::vector<nodes::SegContour>> &>(back_ext_info.seg_contours));
         clone_frame->check_report_callback_ =
-            [callback = frame->check_report_callback_](const std::vector<FrameExtInfo> &ext_info) {
+            [callback = frame->check_report_callback_](const FrameExtInfoList &ext_info) {
                 return std::max(FrameType::kReport, callback(ext_info));
             };
 
@@ -108,7 +110,9 @@ void SegCalculation_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame
     } else if (enable_volume_) {
         cv::Mat output_mask;
         cv::Mat input_mask = cv::Mat(back_ext_info.seg_height, back_ext_info.seg_width, CV_8UC1);
-        memcpy(input_mask.data, back_ext_info.seg_map.data(), back_ext_info.seg_map.size());
+        if (back_ext_info.seg_map) {
+            memcpy(input_mask.data, back_ext_info.seg_map->data(), back_ext_info.seg_map->size());
+        }
 
         camera_distort_->update_mask(input_mask, output_mask);
         seg_by_contours_->PostProcess(output_mask, vec_labels, back_ext_info.seg_contours);
@@ -33,18 +33,18 @@ void SequenceOfEventsStatistic_v2::on_cv_image(const std::shared_ptr<msgs::cv_fr
 
     if (zero_to_one_ && result == EventChange::kZeroToOne) {
         spdlog::debug("event happened report");
-        last_one_frame_->check_report_callback_ = [](const std::vector<FrameExtInfo> &) { return FrameType::kReport; };
+        last_one_frame_->check_report_callback_ = [](const FrameExtInfoList &) { return FrameType::kReport; };
         output_result_(last_one_frame_);
     } else if (one_to_one_ && result == EventChange::kOneToOne) {
         spdlog::debug("event continue report");
-        last_one_frame_->check_report_callback_ = [](const std::vector<FrameExtInfo> &) { return FrameType::kReport; };
+        last_one_frame_->check_report_callback_ = [](const FrameExtInfoList &) { return FrameType::kReport; };
         output_result_(last_one_frame_);
     } else if (one_to_zero_ && result == EventChange::kOneToZero) {
         spdlog::debug("event end report");
-        last_zero_frame_->check_report_callback_ = [](const std::vector<FrameExtInfo> &) { return FrameType::kReport; };
+        last_zero_frame_->check_report_callback_ = [](const FrameExtInfoList &) { return FrameType::kReport; };
         output_result_(last_zero_frame_);
     } else {
-        frame->check_report_callback_ = [](const std::vector<FrameExtInfo> &) { return FrameType::kBase; };
+        frame->check_report_callback_ = [](const FrameExtInfoList &) { return FrameType::kBase; };
         output_result_(frame);
     }
 }
@@ -32,7 +32,7 @@ void TargetCounter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame)
     }
 
     if (frame->check_report_callback_(frame->frame_info->ext_info) == FrameType::kReport) {
-        frame->frame_info->ext_info.back().target_counts = target_counts_;
+        frame->frame_info->ext_info.mutable_back().target_counts = target_counts_;
 
         for (auto &[key, value] : target_counts_) {
             if (key == index_label_) {
@@ -82,7 +82,7 @@ void TargetCounter_v2::on_cv_image(const std::shared_ptr<msgs::cv_frame> &frame)
             spdlog::info("=========================== label: {}, count: {}", label, count);
         }
 
-        frame->frame_info->ext_info.back().target_counts = target_counts_;
+        frame->frame_info->ext_info.mutable_back().target_counts = target_counts_;
     }
 
     output_result_(frame);
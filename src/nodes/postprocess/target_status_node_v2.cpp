@@ -7,25 +7,18 @@ namespace nodes {
 
 void TargetStatus_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame) {
     for (const auto &[track_id, track_info] : frame->frame_info->ext_info.back().tracked_box) {
-        if (prev_tracked_points_.count(track_id) == 0) {
-            prev_tracked_points_[track_id] = std::vector<Point2i>{
-                {int(track_info.box.x), int(track_info.box.y)},
-                {int(track_info.box.x), int(track_info.box.y + track_info.box.height)},
-                {int(track_info.box.x + track_info.box.width), int(track_info.box.y + track_info.box.height)},
-                {int(track_info.box.x + track_info.box.width), int(track_info.box.y)},
-            };
+        // 与多边形计算时一致，角点先取整
+        Rect curr_rect{int(track_info.box.x), int(track_info.box.y), 0, 0};
+        curr_rect.width = int(track_info.box.x + track_info.box.width) - curr_rect.x;
+        curr_rect.height = int(track_info.box.y + track_info.box.height) - curr_rect.y;
+
+        auto prev_iter = prev_tracked_rects_.find(track_id);
+        if (prev_iter == prev_tracked_rects_.end()) {
+            prev_tracked_rects_.emplace(track_id, curr_rect);
             continue;
         }
 
-        auto prev_points = prev_tracked_points_.at(track_id);
-        std::vector<Point2i> curr_points{
-            {int(track_info.box.x), int(track_info.box.y)},
-            {int(track_info.box.x), int(track_info.box.y + track_info.box.height)},
-            {int(track_info.box.x + track_info.box.width), int(track_info.box.y + track_info.box.height)},
-            {int(track_info.box.x + track_info.box.width), int(track_info.box.y)},
-        };
-
-        if (geometry::area_cover_rate(prev_points, curr_points) >= iou_threshold_) {
+        if (geometry::rect_cover_rate(prev_iter->second, curr_rect) >= iou_threshold_) {
             if (stating_) {
                 event_group_[track_id].emplace_back(1);
                 break;
@@ -44,7 +37,7 @@ void TargetStatus_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame)
         }
     }
 
-    frame->check_report_callback_ = [](const std::vector<FrameExtInfo> &) { return FrameType::kBase; };
+    frame->check_report_callback_ = [](const FrameExtInfoList &) { return FrameType::kBase; };
     for (auto iter = event_group_.begin(); iter != event_group_.end();) {
         if (iter->second.size() >= int(interval_ * frame->infer_frame_rate)) {
             float count = 0;
@@ -54,10 +47,10 @@ void TargetStatus_v2::on_cv_image_(const std::shared_ptr<msgs::cv_frame> &frame)
 
             if (count / iter->second.size() >= cnt_threshold_) {
                 if (iter->second.back() != 1) { break; }
-                frame->check_report_callback_ = [](const std::vector<FrameExtInfo> &) { return FrameType::kReport; };
+                frame->check_report_callback_ = [](const FrameExtInfoList &) { return FrameType::kReport; };
             }
 
-            prev_tracked_points_.erase(iter->first);
+            prev_tracked_rects_.erase(iter->first);
             iter = event_group_.erase(iter);
         } else {
             ++iter;
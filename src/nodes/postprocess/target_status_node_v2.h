@@ -48,7 +48,7 @@ private:
     bool moving_{false};
 
     std::map<int, std::vector<int>> event_group_;
-    std::map<int, std::vector<Point2i>> prev_tracked_points_;
+    std::map<int, Rect> prev_tracked_rects_;
 };
 
 }// namespace nodes
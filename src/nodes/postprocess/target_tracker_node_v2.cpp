@@ -21,8 +21,8 @@ void TargetTracker_v2::on_cv_frame(const std::shared_ptr<msgs::cv_frame> &frame)
                         .max_frame_lost = int(max_lost_time_ * frame->infer_frame_rate)});
     }
 
-    auto &front_ext_info = frame->frame_info->ext_info.front();
-    auto &back_ext_info = frame->frame_info->ext_info.back();
+    auto &front_ext_info = frame->frame_info->ext_info.mutable_front();
+    auto &back_ext_info = frame->frame_info->ext_info.mutable_back();
     std::vector<TrackObject> vec_objects;
 
     if (frame->frame_info->ext_info.size() > 1) {
@@ -82,7 +82,7 @@ void TargetTracker_v2::on_cv_frame(const std::shared_ptr<msgs::cv_frame> &frame)
 
     frame->check_report_callback_ = [that = std::reinterpret_pointer_cast<TargetTracker_v2>(shared_from_this()),
                                      callback =
-                                         frame->check_report_callback_](const std::vector<FrameExtInfo> &ext_info) {
+                                         frame->check_report_callback_](const FrameExtInfoList &ext_info) {
         FrameType result{FrameType::kBase};
 
         for (const auto &[track_id, item] : ext_info.back().tracked_box) {
@@ -4,17 +4,130 @@
 
 #include "runnable_node.hpp"
 #include <common_basic/thread_dbg_utils.hpp>
+#include <deque>
 
 namespace gddi {
 namespace ngraph {
 bool endpoint::is_connectable(const endpoint::DataFeatures &from,
                               const endpoint::DataFeatures &to) {
-    return (!from.data_features.empty()) && (from.data_features == to.data_features);
+    if (from.data_features.empty() || from.data_features != to.data_features) { return false; }
+
+    // 任意一端带有类型标识时，必须是同一个消息类型，接收端依赖这里的一次性校验直接 static_cast
+    if (from.type_id || to.type_id) { return from.type_id == to.type_id; }
+    return true;
 }
 bool endpoint::is_valid(const endpoint::DataFeatures &data_features) {
     return !data_features.data_features.empty();
 }
 
+bool queue::policy_from_string(const std::string &text, queue::OverflowPolicy &policy) {
+    static const std::map<std::string, OverflowPolicy> policies{{"block", OverflowPolicy::kBlock},
+                                                                {"drop_oldest", OverflowPolicy::kDropOldest},
+                                                                {"drop_newest", OverflowPolicy::kDropNewest},
+                                                                {"keep_latest", OverflowPolicy::kKeepLatest}};
+    auto iter = policies.find(text);
+    if (iter != policies.end()) {
+        policy = iter->second;
+        return true;
+    }
+    return false;
+}
+
+std::string queue::policy_to_string(queue::OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::kBlock: return "block";
+        case OverflowPolicy::kDropOldest: return "drop_oldest";
+        case OverflowPolicy::kDropNewest: return "drop_newest";
+        case OverflowPolicy::kKeepLatest: return "keep_latest";
+    }
+    return "unknown";
+}
+
+// 当前线程正在处理消息的 Runner，用于避免 kBlock 策略下阻塞消费者
+static thread_local const Runner *tls_current_runner_ = nullptr;
+
+/**
+ * @brief 有界消息队列，实际消息存放在这里，Runner 的消息队列中只投递占位消息
+ *
+ *        占位消息数量始终等于队列中的消息数量：替换或丢弃旧消息时不再投递新的占位消息。
+ */
+class Runner::BoundedQueue {
+public:
+    BoundedQueue(std::string name, const queue::Options &options) : name_(std::move(name)), options_(options) {}
+
+    /**
+     * @return true 需要向 Runner 投递一条占位消息
+     */
+    bool push(RunnerMessage &&message, bool can_wait) {
+        RunnerMessage dropped;
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (options_.policy == queue::OverflowPolicy::kKeepLatest) {
+            auto key = message.message->flow_key();
+            for (auto &item : queued_) {
+                if (item.port_in == message.port_in && item.message->flow_key() == key
+                    && !item.receiver.owner_before(message.receiver) && !message.receiver.owner_before(item.receiver)) {
+                    dropped = std::move(item);
+                    item = std::move(message);
+                    dropped_++;
+                    return false;
+                }
+            }
+        }
+
+        if (queued_.size() < options_.capacity) {
+            queued_.emplace_back(std::move(message));
+            return true;
+        }
+
+        switch (options_.policy) {
+            case queue::OverflowPolicy::kBlock:
+                // 不允许等待或等待超时，退化为丢弃最新消息
+                if (can_wait
+                    && not_full_.wait_for(lock, std::chrono::milliseconds(options_.block_timeout_ms),
+                                          [this] { return queued_.size() < options_.capacity; })) {
+                    queued_.emplace_back(std::move(message));
+                    return true;
+                }
+                dropped_++;
+                return false;
+            case queue::OverflowPolicy::kDropNewest: dropped_++; return false;
+            case queue::OverflowPolicy::kDropOldest:
+            case queue::OverflowPolicy::kKeepLatest:
+                dropped = std::move(queued_.front());
+                queued_.pop_front();
+                queued_.emplace_back(std::move(message));
+                dropped_++;
+                return false;
+        }
+        return false;
+    }
+
+    bool pop(RunnerMessage &message) {
+        {
+            std::lock_guard<std::mutex> lock_guard(mutex_);
+            if (queued_.empty()) { return false; }
+            message = std::move(queued_.front());
+            queued_.pop_front();
+        }
+        not_full_.notify_one();
+        return true;
+    }
+
+    queue::Stats stats() const {
+        std::lock_guard<std::mutex> lock_guard(mutex_);
+        return {name_, queue::policy_to_string(options_.policy), options_.capacity, queued_.size(), dropped_.load()};
+    }
+
+private:
+    std::string name_;
+    queue::Options options_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::deque<RunnerMessage> queued_;
+    std::atomic_uint64_t dropped_{0};
+};
+
 class RunnerEventWatcher {
 public:
     ~RunnerEventWatcher() {
@@ -69,101 +182,268 @@ private:
     moodycamel::BlockingConcurrentQueue<Event> action_queue_;
 };
 
-void Runner::_run() {
-    RunnerMessage message;
-    spdlog::debug("Runner started! {}", thread_.native_handle());
+void Runner::_init_nodes() {
+    auto &&nodes_to_init = attached_node_manager_->take_attach_nodes();
+    if (!nodes_to_init.empty()) {
+        for (const auto &item : nodes_to_init) { item.second.on_setup(); }
+    }
+}
 
-    auto init_nodes = [this] {
-        auto &&nodes_to_init = attached_node_manager_->take_attach_nodes();
-        if (!nodes_to_init.empty()) {
-            for (const auto &item : nodes_to_init) { item.second.on_setup(); }
-        }
-    };
-    int quit_code_ = 0;
-    gddi::thread_utils::set_cur_thread_name(std::string("rn|" + name_));
+Runner::~Runner() {
+    if (executor_) {
+        _stop_pooled_in_place();
+        // 最后一个切片结束时 Runner 在工作线程上析构，如果同时释放线程池的最后一个引用，线程池会 join 自身，
+        // 所以交给事件线程释放
+        RunnerEventWatcher::get_instance().push_action([executor = std::move(executor_)] {});
+    } else {
+        stop();
+    }
+    spdlog::debug("destructor: {}, Runner: {}", utils::get_class_name(this), name_);
+}
 
-    // 1. init setup all node
-    init_nodes();
+void Runner::set_queue_options(const queue::Options &options) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
 
-    // 2. loop the queued message
-    while (true) {
-        message_queue_.wait_dequeue(message);
+    if (options.capacity > 0) {
+        runner_queue_ = std::make_shared<BoundedQueue>(name_, options);
+    } else {
+        runner_queue_.reset();
+    }
+}
 
-        // DEBUG, for queued message is too many
-        auto queued_message_num = message_queue_.size_approx();
-        if (queued_message_num > 5) {
-            spdlog::warn("too many message in queue! {}: {}", name_, queued_message_num);
-        }
+void Runner::set_input_queue_options(const std::shared_ptr<NodeAny> &node, int endpoint,
+                                     const queue::Options &options) {
+    std::lock_guard<std::mutex> lock_guard(mutex_);
 
+    auto &node_queues = edge_queues_[node];
+    if (options.capacity > 0) {
+        node_queues[endpoint] =
+            std::make_shared<BoundedQueue>(node->name() + ":" + std::to_string(endpoint), options);
+    } else {
+        node_queues.erase(endpoint);
+    }
+}
 
-        // take and init all
-        if (message.is_echo) {
-            init_nodes();
-            continue;
-        }
+std::vector<queue::Stats> Runner::get_queue_stats() const {
+    std::vector<queue::Stats> stats;
+    if (runner_queue_) { stats.emplace_back(runner_queue_->stats()); }
+    for (const auto &node_queues : edge_queues_) {
+        for (const auto &item : node_queues.second) { stats.emplace_back(item.second->stats()); }
+    }
+    return stats;
+}
 
-        // quit loop if read empty message
-        if (message.message == nullptr) {
-            quit_code_ = message.port_in;
-            break;
+Runner::BoundedQueue *Runner::_find_bounded_queue(const std::weak_ptr<NodeAny> &node, int endpoint) const {
+    if (!edge_queues_.empty()) {
+        auto iter = edge_queues_.find(node);
+        if (iter != edge_queues_.end()) {
+            auto ep_iter = iter->second.find(endpoint);
+            if (ep_iter != iter->second.end()) { return ep_iter->second.get(); }
         }
+    }
+    return runner_queue_.get();
+}
+
+bool Runner::_process_message(RunnerMessage &message, int &quit_code) {
+    // DEBUG, for queued message is too many
+    auto queued_message_num = message_queue_.size_approx();
+    if (queued_message_num > 5 && !message.bounded) {
+        spdlog::warn("too many message in queue! {}: {}", name_, queued_message_num);
+    }
 
-        // process message
-        auto receiver = message.receiver.lock();
-        message.message->message_queued_size = message_queue_.size_approx();
-        if (receiver) { receiver->handle_message(message.port_in, message.message); }
+    // take and init all
+    if (message.is_echo) {
+        _init_nodes();
+        return true;
     }
+
+    // take the real message from bounded queue
+    if (message.bounded && !message.bounded->pop(message)) { return true; }
+
+    // quit loop if read empty message
+    if (message.message == nullptr) {
+        quit_code = message.port_in;
+        return false;
+    }
+
+    // process message
+    auto receiver = message.receiver.lock();
+    message.message->message_queued_size = queued_message_num;
+    if (receiver) {
+        auto time_start = std::chrono::steady_clock::now();
+        receiver->metrics_.queue_wait.record(time_start - message.queued_at);
+        receiver->handle_message(message.port_in, message.message);
+        receiver->metrics_.handle_time.record(std::chrono::steady_clock::now() - time_start);
+    }
+    return true;
+}
+
+void Runner::_notify_quit(int quit_code) {
     spdlog::debug("Runner loop over: {}", name_);
 
     if (on_quit_) {
         auto quit_tmp_ = on_quit_;
-        RunnerEventWatcher::get_instance().push_action([quit_tmp_, quit_code_] {
+        RunnerEventWatcher::get_instance().push_action([quit_tmp_, quit_code] {
             /**
              * 找不到 BUG 请打开注释
              * 
              * std::this_thread::sleep_for(std::chrono::milliseconds(5));
              */
-            quit_tmp_(quit_code_);
+            quit_tmp_(quit_code);
         });
     }
 }
 
+void Runner::_run() {
+    RunnerMessage message;
+    spdlog::debug("Runner started! {}", name_);// start() 可能仍在给 thread_ 赋值
+
+    int quit_code_ = 0;
+    gddi::thread_utils::set_cur_thread_name(std::string("rn|" + name_));
+    tls_current_runner_ = this;
+
+    // 1. init setup all node
+    _init_nodes();
+
+    // 2. loop the queued message
+    while (true) {
+        message_queue_.wait_dequeue(message);
+        if (!_process_message(message, quit_code_)) { break; }
+    }
+
+    _notify_quit(quit_code_);
+}
+
+void Runner::_enqueue(RunnerMessage &&message) {
+    message_queue_.enqueue(std::move(message));
+
+    // 线程池模式下，由 0 -> 1 的投递者负责调度切片，保证同一时刻只有一个切片在运行
+    if (executor_ && pending_messages_.fetch_add(1) == 0) { _schedule_slice(); }
+}
+
+void Runner::_start_pooled() {
+    if (pooled_started_) { return; }
+    pooled_started_ = true;
+    spdlog::debug("Runner started! {} on {}", name_, executor_->name());
+
+    // 投递初始化消息，并释放启动前的占位，由当前调用者调度第一个切片
+    message_queue_.enqueue({std::weak_ptr<NodeAny>(), 0, nullptr, true});
+    pending_messages_.fetch_add(1);
+    _schedule_slice();
+}
+
+void Runner::_schedule_slice() {
+    executor_->schedule([self = shared_from_this()] { self->_run_slice(); });
+}
+
+void Runner::_run_slice() {
+    RunnerMessage message;
+    int64_t processed = 0;
+    tls_current_runner_ = this;
+
+    while (processed < kMaxMessagesPerSlice && message_queue_.try_dequeue(message)) {
+        processed++;
+        if (loop_over_) { continue; }// 退出后剩余的消息直接丢弃
+
+        int quit_code = 0;
+        if (!_process_message(message, quit_code)) { _finish_pooled_loop(quit_code); }
+    }
+    tls_current_runner_ = nullptr;
+
+    // 第一个切片同时释放启动前保留的占位
+    auto released = processed;
+    if (!slice_started_) {
+        slice_started_ = true;
+        released++;
+    }
+
+    if (pending_messages_.fetch_sub(released) - released > 0) { _schedule_slice(); }
+}
+
+void Runner::_finish_pooled_loop(int quit_code) {
+    {
+        std::lock_guard<std::mutex> lock_guard(loop_mutex_);
+        loop_over_ = true;
+    }
+    loop_cv_.notify_all();
+    _notify_quit(quit_code);
+}
+
+void Runner::_wait_pooled_loop_over() {
+    if (!pooled_started_) { return; }
+    std::unique_lock<std::mutex> lock(loop_mutex_);
+    loop_cv_.wait(lock, [this] { return loop_over_.load(); });
+}
+
+void Runner::_stop_pooled_in_place() {
+    // 析构时已经没有任何切片持有当前 Runner，直接在当前线程处理剩余消息，与线程模式的退出行为保持一致
+    if (!pooled_started_ || loop_over_) { return; }
+
+    RunnerMessage message;
+    int quit_code = 0;
+    while (message_queue_.try_dequeue(message)) {
+        if (!_process_message(message, quit_code)) { break; }
+    }
+    _finish_pooled_loop(quit_code);
+}
+
 void Runner::dispatch_message(const std::weak_ptr<NodeAny> &node, int endpoint,
                               const MessagePtr &message) {
     // std::cout << "[Queued] " << node->name() << ": " << message->name() << ", " << message->to_string() << std::endl;
-    message_queue_.enqueue({node, endpoint, message});
+    auto bounded = _find_bounded_queue(node, endpoint);
+    auto queued_at = std::chrono::steady_clock::now();
+    if (bounded == nullptr) {
+        _enqueue({node, endpoint, message, false, nullptr, queued_at});
+        return;
+    }
+
+    // 在消费者自身线程或共享线程池的工作线程上不能阻塞，否则消费者可能永远得不到调度
+    auto can_wait = tls_current_runner_ == nullptr || !(tls_current_runner_ == this || tls_current_runner_->is_pooled());
+    if (bounded->push({node, endpoint, message, false, nullptr, queued_at}, can_wait)) {
+        _enqueue({std::weak_ptr<NodeAny>(), endpoint, nullptr, false, bounded});
+    }
 }
 
 class NodeAny::NodeOutputManager {
 public:
     struct OutputTarget {
         explicit OutputTarget(int ep, std::weak_ptr<NodeAny> node)
-            : target_endpoint(ep), target_node(std::move(node)) {}
+            : target_endpoint(ep), target_node(std::move(node)),
+              sent_messages(std::make_shared<std::atomic_uint64_t>(0)) {}
         int target_endpoint;
         std::string dbg_target_name;
         std::string dbg_target_type;
         std::weak_ptr<NodeAny> target_node;
+        std::shared_ptr<std::atomic_uint64_t> sent_messages;    // 发送计数，在快照之间共享
     };
-    using OutputTargetList = std::list<OutputTarget>;
+    using OutputTargetList = std::vector<OutputTarget>;
+
+    /**
+     * @brief 输出节点链接表的只读快照，下标为输出端点
+     *
+     *        修改时复制一份新表并原子替换，raise_next 只需要一次原子读取，不加锁。
+     *        读取方持有快照的引用，旧表在最后一个读取方结束后释放。
+     */
+    using OutputTable = std::vector<OutputTargetList>;
 
 public:
     NodeAny *node_;
-    mutable std::mutex mutex_;
-    std::unordered_map<int, OutputTargetList> output_listeners;// 输出节点链接配置
+    mutable std::mutex mutex_;                          // 写入保护
+    std::shared_ptr<const OutputTable> output_table_;   // 输出节点链接配置(当前快照)，只能原子读写
+    std::atomic_bool has_invalid_target_{false};        // 发现失效的目标节点，等待清理
 
 public:
-    explicit NodeOutputManager(NodeAny *node) : node_(node) {}
+    explicit NodeOutputManager(NodeAny *node) : node_(node), output_table_(std::make_shared<OutputTable>()) {}
     ~NodeOutputManager() = default;
 
     std::ostream &debug_print_output_links(std::ostream &oss) const {
         auto old_flags = oss.flags();
 
-        {
-            std::lock_guard<std::mutex> lock_guard(mutex_);// 访问保护
-            for (const auto &item : output_listeners) {
-                oss << "Output Endpoint: " << item.first << ", Linked: " << item.second.size()
-                    << std::endl;
-            }
+        auto snapshot = std::atomic_load_explicit(&output_table_, std::memory_order_acquire);
+        const auto &table = *snapshot;
+        for (size_t endpoint = 0; endpoint < table.size(); endpoint++) {
+            if (table[endpoint].empty()) { continue; }
+            oss << "Output Endpoint: " << endpoint << ", Linked: " << table[endpoint].size() << std::endl;
         }
 
         oss.flags(old_flags);
@@ -182,14 +462,17 @@ public:
             target_node->get_endpoint_features(endpoint::Type::Input, target_endpoint);
 
         auto connectable = [&]() {
-            std::lock_guard<std::mutex> lock_guard(mutex_);// 访问保护
-
             if (output_endpoint_desc.success && target_endpoint_desc.success) {
                 if (is_connectable(output_endpoint_desc.result, target_endpoint_desc.result)) {
                     OutputTarget output_target(target_endpoint, target_node);
                     output_target.dbg_target_name = target_node->name();
                     output_target.dbg_target_type = target_node->type();
-                    output_listeners[output_endpoint].push_back(output_target);
+
+                    std::lock_guard<std::mutex> lock_guard(mutex_);// 访问保护
+                    auto table = copy_valid_table_();
+                    if ((int)table->size() <= output_endpoint) { table->resize(output_endpoint + 1); }
+                    (*table)[output_endpoint].push_back(output_target);
+                    publish_table_(std::move(table));
                     return true;
                 }
             }
@@ -217,48 +500,35 @@ public:
     }
 
     void raise_next(int endpoint, const MessagePtr &message) {
-        std::lock_guard<std::mutex> lock_guard(mutex_);// 访问保护
-
-        auto &&iter = output_listeners.find(endpoint);
-        if (iter != output_listeners.end()) {
-            auto &output_target_list = iter->second;
-            auto list_iter = output_target_list.begin();
-
-            // 循环发送消息，删除已经失效的消息节点
-            int invalid_node_count = 0;
-            int cur_size = (int)output_target_list.size();
-            for (; list_iter != output_target_list.end();) {
-                auto shared_p = list_iter->target_node.lock();
-                if (shared_p) {
-                    shared_p->push_input_endpoint(list_iter->target_endpoint, message);
-                    list_iter++;
-                } else {
-                    // DEBUG info
-                    spdlog::debug("***===*** Node target lost, from: {}({}) => {}({})",
-                                  node_->type(), node_->name(), list_iter->dbg_target_type,
-                                  list_iter->dbg_target_name, output_target_list.size() - 1);
-                    list_iter = output_target_list.erase(list_iter);
-                    invalid_node_count++;
-                }
-            }
-
-            if (invalid_node_count) {
-                spdlog::debug("======================INVALID OUTPUT: {}, {} to {} "
-                              "====================================",
-                              invalid_node_count, cur_size, (int)output_target_list.size());
+        auto snapshot = std::atomic_load_explicit(&output_table_, std::memory_order_acquire);
+        const auto &table = *snapshot;
+        if (endpoint < 0 || endpoint >= (int)table.size()) { return; }
+
+        bool has_invalid = false;
+        for (const auto &target : table[endpoint]) {
+            auto shared_p = target.target_node.lock();
+            if (shared_p) {
+                shared_p->push_input_endpoint(target.target_endpoint, message);
+                target.sent_messages->fetch_add(1, std::memory_order_relaxed);
+            } else {
+                has_invalid = true;
             }
         }
+
+        // 延迟清理失效的目标节点，不阻塞消息发送
+        if (has_invalid && !has_invalid_target_.exchange(true)) { prune_invalid_targets_(); }
     }
 
     void get_connections(std::vector<NodeConnectionLine> &connections) const {
-        std::lock_guard<std::mutex> lock_guard(mutex_);// 访问保护
+        auto snapshot = std::atomic_load_explicit(&output_table_, std::memory_order_acquire);
+        const auto &table = *snapshot;
 
-        for (const auto &cc : output_listeners) {
+        for (size_t endpoint = 0; endpoint < table.size(); endpoint++) {
             NodeConnectionLine connection_line{};
             connection_line.from_ = node_;
-            connection_line.from_ep_ = cc.first;
+            connection_line.from_ep_ = (int)endpoint;
 
-            for (const auto &c : cc.second) {
+            for (const auto &c : table[endpoint]) {
                 auto target_ = c.target_node.lock();
                 if (target_) {
                     connection_line.to_ = target_.get();
@@ -268,6 +538,67 @@ public:
             }
         }
     }
+
+    void get_edge_stats(std::vector<metrics::EdgeStats> &edge_stats) const {
+        auto snapshot = std::atomic_load_explicit(&output_table_, std::memory_order_acquire);
+        const auto &table = *snapshot;
+
+        for (size_t endpoint = 0; endpoint < table.size(); endpoint++) {
+            for (const auto &c : table[endpoint]) {
+                auto target_ = c.target_node.lock();
+                if (target_) {
+                    edge_stats.push_back({target_.get(), (int)endpoint, c.target_endpoint,
+                                          c.sent_messages->load(std::memory_order_relaxed)});
+                }
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief 复制当前快照，同时去掉已经失效的目标节点，需要持有 mutex_
+     */
+    std::shared_ptr<OutputTable> copy_valid_table_() {
+        auto snapshot = std::atomic_load_explicit(&output_table_, std::memory_order_acquire);
+        auto table = std::make_shared<OutputTable>(*snapshot);
+        has_invalid_target_ = false;
+
+        for (size_t endpoint = 0; endpoint < table->size(); endpoint++) {
+            auto &output_target_list = (*table)[endpoint];
+            auto cur_size = output_target_list.size();
+            for (auto iter = output_target_list.begin(); iter != output_target_list.end();) {
+                if (iter->target_node.expired()) {
+                    // DEBUG info
+                    spdlog::debug("***===*** Node target lost, from: {}({}) => {}({})", node_->type(), node_->name(),
+                                  iter->dbg_target_type, iter->dbg_target_name);
+                    iter = output_target_list.erase(iter);
+                } else {
+                    iter++;
+                }
+            }
+
+            if (cur_size != output_target_list.size()) {
+                spdlog::debug("======================INVALID OUTPUT: {}, {} to {} "
+                              "====================================",
+                              cur_size - output_target_list.size(), cur_size, output_target_list.size());
+            }
+        }
+        return table;
+    }
+
+    void publish_table_(std::shared_ptr<const OutputTable> table) {
+        std::atomic_store_explicit(&output_table_, std::move(table), std::memory_order_release);
+    }
+
+    void prune_invalid_targets_() {
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            // 正在 connect_to，由下一次发送重新尝试
+            has_invalid_target_ = false;
+            return;
+        }
+        publish_table_(copy_valid_table_());
+    }
 };
 
 NodeAny::NodeAny(std::string name)
@@ -287,6 +618,7 @@ bool NodeAny::connect_to(const std::shared_ptr<NodeAny> &target_node, int output
 }
 
 void NodeAny::push_output_endpoint(int endpoint, const MessagePtr &message) {
+    metrics_.output.inc(endpoint);
     node_output_manager_->raise_next(endpoint, message);
 }
 
@@ -314,6 +646,10 @@ void NodeAny::get_connections(std::vector<NodeConnectionLine> &connections) cons
     return node_output_manager_->get_connections(connections);
 }
 
+void NodeAny::get_edge_stats(std::vector<metrics::EdgeStats> &edge_stats) const {
+    return node_output_manager_->get_edge_stats(edge_stats);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 }// namespace ngraph
 }// namespace gddi
\ No newline at end of file
@@ -20,12 +20,17 @@
 #include <string>
 #include <type_traits>
 #include <chrono>
+#include <atomic>
+#include <condition_variable>
 #include <list>
 #include <map>
+#include <vector>
 #include "utils.hpp"
 #include "debug_tools.hpp"
 #include "node_property_table.hpp"
 #include "basic_logs.hpp"
+#include "runner_executor.hpp"
+#include "node_metrics.hpp"
 
 namespace gddi {
 
@@ -93,6 +98,11 @@ public:
         timestamp.ref = r->timestamp.ref;
     }
 
+    /**
+     * @brief 消息所属数据流的标识，用于 keep_latest 队列策略，同一数据流只保留最新的一条消息
+     */
+    virtual size_t flow_key() const { return 0; }
+
     // Runner init
     size_t message_queued_size;
 };
@@ -105,34 +115,81 @@ enum class Type {
     Output
 };
 
+/**
+ * @brief 编译期消息类型标识，每个类型对应一个唯一的地址
+ */
+template<class Ty_>
+struct type_tag {
+    static constexpr char id{};
+};
+
+template<class Ty_>
+constexpr const void *type_id_of() { return &type_tag<Ty_>::id; }
+
 struct DataFeatures {
     std::string data_features;
+    const void *type_id{nullptr};   // 消息类型标识，为空时只按名称匹配
 };
 
 bool is_connectable(const DataFeatures &from, const DataFeatures &to);
 bool is_valid(const DataFeatures &data_features);
 }
 
+namespace queue {
+/**
+ * @brief 有界队列满时的处理策略
+ */
+enum class OverflowPolicy {
+    kBlock,     // 阻塞生产者，超时后丢弃最新消息；生产者运行在共享线程池上时不阻塞
+    kDropOldest,// 丢弃队列中最旧的消息
+    kDropNewest,// 丢弃新到达的消息
+    kKeepLatest,// 同一数据流(Message::flow_key)只保留最新的消息，超出容量时丢弃最旧的
+};
+
+struct Options {
+    size_t capacity{0};                             // 0 表示不限制
+    OverflowPolicy policy{OverflowPolicy::kDropOldest};
+    int block_timeout_ms{1000};                     // kBlock 策略的最长等待时间
+};
+
+struct Stats {
+    std::string name;
+    std::string policy;
+    size_t capacity;
+    size_t queued;
+    uint64_t dropped;
+};
+
+bool policy_from_string(const std::string &text, OverflowPolicy &policy);
+std::string policy_to_string(OverflowPolicy policy);
+}
+
 /**
  * @brief 运行节点线程，保证线程安全，所提供的每一个公开接口调用
- * 
+ *
+ *        默认每个 Runner 独占一个线程；如果构造时指定了 RunnerExecutor，
+ *        则 Runner 不再创建线程，而是以串行切片的方式在共享线程池上调度运行。
  */
 class Runner : public std::enable_shared_from_this<Runner> {
 public:
     Runner() = delete;
-    explicit Runner(std::string name)
+    explicit Runner(std::string name, std::shared_ptr<RunnerExecutor> executor = nullptr)
         : name_(std::move(name)),
+          executor_(std::move(executor)),
           attached_node_manager_(std::make_unique<AttachedNodeManager>(this)) {}
-    virtual ~Runner() {
-        stop();
-        spdlog::debug("destructor: {}, Runner: {}", utils::get_class_name(this), name_);
-    }
+    virtual ~Runner();
 
     const std::string &name() const { return name_; }
+    bool is_pooled() const { return executor_ != nullptr; }
 
     void start() {
         std::lock_guard<std::mutex> lock_guard(mutex_);
 
+        if (executor_) {
+            _start_pooled();
+            return;
+        }
+
         _stop();
         thread_ = std::thread([this]() { _run(); });
     }
@@ -160,13 +217,15 @@ public:
 
     void join() {
         std::lock_guard<std::mutex> lock_guard(mutex_);
-        if (thread_.joinable()) {
+        if (executor_) {
+            _wait_pooled_loop_over();
+        } else if (thread_.joinable()) {
             thread_.join();
         }
     }
 
     void post_quit_loop(int code) {
-        message_queue_.enqueue({std::weak_ptr<NodeAny>(), code, nullptr});
+        _enqueue({std::weak_ptr<NodeAny>(), code, nullptr});
     }
 
     using MessageDispatch = std::function<void(const std::weak_ptr<NodeAny> &node,
@@ -179,10 +238,42 @@ public:
         return dispatch;
     }
 
+    /**
+     * @brief 设置 Runner 的默认有界队列，作用于所有未单独配置的输入端点
+     *
+     *        需要在 start() 之前调用
+     */
+    void set_queue_options(const queue::Options &options);
+
+    /**
+     * @brief 设置指定节点输入端点的有界队列，优先级高于 Runner 默认配置
+     *
+     *        需要在 start() 之前调用
+     */
+    void set_input_queue_options(const std::shared_ptr<NodeAny> &node, int endpoint, const queue::Options &options);
+
+    /**
+     * @brief 所有有界队列的当前状态及丢弃计数
+     */
+    std::vector<queue::Stats> get_queue_stats() const;
+
+    /**
+     * @brief 当前队列中等待处理的消息数(近似值)
+     */
+    size_t queue_depth() const { return message_queue_.size_approx(); }
+
 protected:
     void _run();
 
     void _stop() {
+        if (executor_) {
+            if (pooled_started_ && !loop_over_) {
+                _enqueue({std::weak_ptr<NodeAny>(), 0, nullptr});
+                _wait_pooled_loop_over();
+            }
+            return;
+        }
+
         if (thread_.joinable()) {
             message_queue_.enqueue({std::weak_ptr<NodeAny>(), 0, nullptr});
             thread_.join();
@@ -245,23 +336,63 @@ private:
     };
 
     void _wakeup_queue_once() {
-        message_queue_.enqueue({std::weak_ptr<NodeAny>(), 0, nullptr, true});
+        _enqueue({std::weak_ptr<NodeAny>(), 0, nullptr, true});
     }
 
 private:
+    class BoundedQueue;
+
     struct RunnerMessage {
         std::weak_ptr<NodeAny> receiver;
         int port_in{};
         MessagePtr message;
         bool is_echo{false};
+        BoundedQueue *bounded{nullptr};     // 非空时，实际消息存放在对应的有界队列中
+        std::chrono::steady_clock::time_point queued_at{};  // 入队时间，用于统计排队耗时
     };
 
+    BoundedQueue *_find_bounded_queue(const std::weak_ptr<NodeAny> &node, int endpoint) const;
+
+    void _enqueue(RunnerMessage &&message);
+    void _init_nodes();
+
+    /**
+     * @brief 处理一条消息
+     * @return false 表示收到退出消息，quit_code 为退出代码
+     */
+    bool _process_message(RunnerMessage &message, int &quit_code);
+    void _notify_quit(int quit_code);
+
+    // 线程池模式
+    void _start_pooled();
+    void _schedule_slice();
+    void _run_slice();
+    void _finish_pooled_loop(int quit_code);
+    void _wait_pooled_loop_over();
+    void _stop_pooled_in_place();
+
+    // 每个切片最多处理的消息数，避免单个 Runner 长时间占用工作线程
+    static constexpr int64_t kMaxMessagesPerSlice = 16;
+
     moodycamel::BlockingConcurrentQueue<RunnerMessage> message_queue_;
     std::mutex mutex_;
     std::thread thread_;
     std::string name_;
     std::function<void(int)> on_quit_;
+    std::shared_ptr<RunnerExecutor> executor_;
     std::unique_ptr<AttachedNodeManager> attached_node_manager_;
+
+    std::atomic_int64_t pending_messages_{1};   // 线程池模式下未处理的消息数，启动前保留 1 个占位
+    bool slice_started_{false};                 // 仅在切片内访问
+    bool pooled_started_{false};
+    std::atomic_bool loop_over_{false};
+    std::mutex loop_mutex_;
+    std::condition_variable loop_cv_;
+
+    // 有界队列配置，start() 之后只读
+    std::shared_ptr<BoundedQueue> runner_queue_;
+    std::map<std::weak_ptr<NodeAny>, std::map<int, std::shared_ptr<BoundedQueue>>, std::owner_less<std::weak_ptr<NodeAny>>>
+        edge_queues_;
 };
 
 /**
@@ -300,7 +431,7 @@ public:
     }
 
     /**
-     * @brief 如果正在<connect_to>，这里会被阻塞。
+     * @brief 无锁发送，使用输出链接表的快照，与<connect_to>并发时不会被阻塞。
      * @param endpoint
      * @param message
      */
@@ -321,6 +452,16 @@ public:
 
     void get_connections(std::vector<NodeConnectionLine> &connections) const;
 
+    /**
+     * @brief 节点的排队/处理耗时直方图及端点消息计数，可在任意线程读取
+     */
+    const metrics::NodeMetrics &metrics() const { return metrics_; }
+
+    /**
+     * @brief 每条输出连接累计发送的消息数
+     */
+    void get_edge_stats(std::vector<metrics::EdgeStats> &edge_stats) const;
+
 public:
     NodePropertyTable &properties() { return property_table_; }
     const NodePropertyTable &properties() const { return property_table_; }
@@ -386,7 +527,7 @@ protected:
 
 protected:
     void handle_message(int endpoint, const MessagePtr &message) {
-        msg_stat_info_.in_inc(endpoint);
+        metrics_.input.inc(endpoint);
         on_input_message(endpoint, message);
     }
     std::ostream &_dbg_print_in_msg_hdr(std::ostream &oss, int endpoint, const MessagePtr &message) const {
@@ -408,23 +549,6 @@ protected:
      */
     void quit_runner_(TaskErrorCode exit_code) { dispatch_(std::weak_ptr<NodeAny>(), (int)exit_code, nullptr); }
 
-private:
-    struct node_msg_stat_info {
-        std::unordered_map<int, uint32_t> output_msg_nums;
-        std::unordered_map<int, uint32_t> input_msg_nums;
-
-        static void inc_var(int port, std::unordered_map<int, uint32_t> &vars) {
-            auto iter = vars.find(port);
-            if (iter != vars.end()) {
-                iter->second++;
-            } else {
-                vars[port] = 1;
-            }
-        }
-        void in_inc(int port) { inc_var(port, input_msg_nums); }
-        void out_inc(int port) { inc_var(port, output_msg_nums); }
-    };
-
 private:
     Runner::MessageDispatch dispatch_;                              // 当前节点入口消息缓冲函数
     std::weak_ptr<Runner> node_runner_;                             // 当前节点所绑定的Runner
@@ -437,7 +561,7 @@ private:
     friend class Runner;
 
     std::pair<int, std::map<int, std::string>> node_logs_{1, {}};   // 节点状态及日志
-    node_msg_stat_info msg_stat_info_;                              // 节点消息输入输出统计
+    metrics::NodeMetrics metrics_;                                  // 节点消息输入输出及耗时统计
 
     size_t input_endpoint_count_{0};                                // 输入端口数量
 
@@ -452,7 +576,7 @@ public:
 
 protected:
     void on_input_message(int endpoint, const MessagePtr &message) override {
-        NodeAny::on_input_message(endpoint, message);
+        push_output_endpoint(endpoint, message);
     }
 
     result_for<endpoint::DataFeatures> on_query_endpoint(
@@ -0,0 +1,94 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include "runner_executor.hpp"
+#include "common_basic/thread_dbg_utils.hpp"
+#include <mutex>
+#include <spdlog/spdlog.h>
+
+namespace gddi {
+namespace ngraph {
+
+// 当前线程所属的线程池与工作线程序号，用于本地投递
+static thread_local RunnerExecutor *tls_executor_ = nullptr;
+static thread_local std::size_t tls_worker_id_ = 0;
+
+RunnerExecutor::RunnerExecutor(std::string name, std::size_t worker_num) : name_(std::move(name)) {
+    if (worker_num == 0) { worker_num = std::max(1u, std::thread::hardware_concurrency()); }
+
+    for (std::size_t i = 0; i < worker_num; i++) { workers_.emplace_back(std::make_unique<Worker>()); }
+    for (std::size_t i = 0; i < worker_num; i++) {
+        workers_[i]->thread = std::thread([this, i] { run_worker_(i); });
+    }
+    spdlog::info("RunnerExecutor: {}, workers: {}", name_, worker_num);
+}
+
+RunnerExecutor::~RunnerExecutor() {
+    request_stop_ = true;
+    queued_sema_.signal((moodycamel::LightweightSemaphore::ssize_t)workers_.size());
+    for (auto &w : workers_) {
+        if (w->thread.joinable()) { w->thread.join(); }
+    }
+    spdlog::debug("destructor: RunnerExecutor: {}", name_);
+}
+
+void RunnerExecutor::schedule(std::function<void()> task) {
+    if (tls_executor_ == this) {
+        workers_[tls_worker_id_]->local_queue.enqueue(std::move(task));
+    } else {
+        global_queue_.enqueue(std::move(task));
+    }
+    queued_sema_.signal();
+}
+
+bool RunnerExecutor::try_take_(std::size_t wid, Task &task) {
+    // 1. 本地队列
+    if (workers_[wid]->local_queue.try_dequeue(task)) { return true; }
+
+    // 2. 全局队列
+    if (global_queue_.try_dequeue(task)) { return true; }
+
+    // 3. 从其它工作线程窃取
+    auto worker_num = workers_.size();
+    for (std::size_t i = 1; i < worker_num; i++) {
+        if (workers_[(wid + i) % worker_num]->local_queue.try_dequeue(task)) { return true; }
+    }
+    return false;
+}
+
+void RunnerExecutor::run_worker_(std::size_t wid) {
+    tls_executor_ = this;
+    tls_worker_id_ = wid;
+    thread_utils::set_cur_thread_name(name_ + std::to_string(wid));
+
+    Task task;
+    while (true) {
+        queued_sema_.wait();
+
+        // 信号量计数与队列可见性之间存在短暂的窗口，这里自旋等待任务可见
+        while (!try_take_(wid, task)) {
+            if (request_stop_) { return; }
+            std::this_thread::yield();
+        }
+
+        try {
+            task();
+        } catch (std::exception &exception) {
+            spdlog::error("RunnerExecutor: {}, {}", name_, exception.what());
+        }
+        task = nullptr;
+    }
+}
+
+std::shared_ptr<RunnerExecutor> RunnerExecutor::shared_instance() {
+    static std::mutex mutex;
+    static std::shared_ptr<RunnerExecutor> instance{nullptr};
+
+    std::lock_guard<std::mutex> lock_guard(mutex);
+    if (instance == nullptr) { instance = std::make_shared<RunnerExecutor>("pool"); }
+    return instance;
+}
+
+}// namespace ngraph
+}// namespace gddi
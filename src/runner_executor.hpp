@@ -0,0 +1,74 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#ifndef INFERENCE_ENGINE_SRC_RUNNER_EXECUTOR_HPP_
+#define INFERENCE_ENGINE_SRC_RUNNER_EXECUTOR_HPP_
+#include <atomic>
+#include <concurrentqueue.h>
+#include <functional>
+#include <lightweightsemaphore.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gddi {
+namespace ngraph {
+
+/**
+ * @brief 多个 Runner 共享的工作窃取线程池
+ *
+ *        每个工作线程拥有自己的本地队列，工作线程内部投递的任务优先进入本地队列，
+ *        外部线程投递的任务进入全局队列，空闲的工作线程会从其它线程的本地队列窃取任务。
+ *
+ *        Runner 在线程池上以"串行切片"的方式运行，同一个 Runner 的消息永远不会被并发处理。
+ */
+class RunnerExecutor {
+public:
+    /**
+     * @param name       线程名前缀
+     * @param worker_num 工作线程数量，0 表示使用 CPU 核心数
+     */
+    explicit RunnerExecutor(std::string name, std::size_t worker_num = 0);
+    ~RunnerExecutor();
+
+    RunnerExecutor(const RunnerExecutor &) = delete;
+    RunnerExecutor &operator=(const RunnerExecutor &) = delete;
+
+    /**
+     * @brief thread-safe, 投递一个任务
+     */
+    void schedule(std::function<void()> task);
+
+    std::size_t worker_num() const { return workers_.size(); }
+    const std::string &name() const { return name_; }
+
+    /**
+     * @brief 进程内共享的默认线程池，按需创建
+     */
+    static std::shared_ptr<RunnerExecutor> shared_instance();
+
+private:
+    using Task = std::function<void()>;
+
+    struct Worker {
+        moodycamel::ConcurrentQueue<Task> local_queue;
+        std::thread thread;
+    };
+
+    void run_worker_(std::size_t wid);
+    bool try_take_(std::size_t wid, Task &task);
+
+private:
+    std::string name_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    moodycamel::ConcurrentQueue<Task> global_queue_;
+    moodycamel::LightweightSemaphore queued_sema_;      // 已投递但未取走的任务数
+    std::atomic_bool request_stop_{false};
+};
+
+}// namespace ngraph
+}// namespace gddi
+
+#endif//INFERENCE_ENGINE_SRC_RUNNER_EXECUTOR_HPP_